@@ -2,6 +2,7 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 #include "Engine/Math/Vec3.hpp"
 
 //-----------------------------------------------------------------------------------------------
@@ -48,10 +49,39 @@ AudioSystem::~AudioSystem()
 }
 
 
+#if defined( ENGINE_TRACK_MEMORY )
+//fmod allocates through its own callbacks rather than new/delete, so route them to the audio tag
+static void* F_CALLBACK FMODTrackedAlloc(unsigned int size, FMOD_MEMORY_TYPE type, const char* sourceString)
+{
+	UNUSED(type);
+	UNUSED(sourceString);
+	return AllocateTaggedMemory(size, MemoryTag::AUDIO);
+}
+
+static void* F_CALLBACK FMODTrackedRealloc(void* block, unsigned int size, FMOD_MEMORY_TYPE type, const char* sourceString)
+{
+	UNUSED(type);
+	UNUSED(sourceString);
+	return ReallocateTaggedMemory(block, size, MemoryTag::AUDIO);
+}
+
+static void F_CALLBACK FMODTrackedFree(void* block, FMOD_MEMORY_TYPE type, const char* sourceString)
+{
+	UNUSED(type);
+	UNUSED(sourceString);
+	FreeTaggedMemory(block);
+}
+#endif
+
 //------------------------------------------------------------------------------------------------
 void AudioSystem::Startup()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::AUDIO)
 	FMOD_RESULT result;
+#if defined( ENGINE_TRACK_MEMORY )
+	result = FMOD::Memory_Initialize(nullptr, 0, FMODTrackedAlloc, FMODTrackedRealloc, FMODTrackedFree);
+	ValidateResult( result );
+#endif
 	result = FMOD::System_Create( &m_fmodSystem );
 	ValidateResult( result );
 
@@ -73,6 +103,7 @@ void AudioSystem::Shutdown()
 //-----------------------------------------------------------------------------------------------
 void AudioSystem::BeginFrame()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::AUDIO)
 	m_fmodSystem->update();
 }
 
@@ -86,6 +117,7 @@ void AudioSystem::EndFrame()
 //-----------------------------------------------------------------------------------------------
 SoundID AudioSystem::CreateOrGetSound( const std::string& soundFilePath )
 {
+	MEMORY_TAG_SCOPE(MemoryTag::AUDIO)
 	std::map< std::string, SoundID >::iterator found = m_registeredSoundIDs.find( soundFilePath );
 	if( found != m_registeredSoundIDs.end() )
 	{
@@ -111,6 +143,7 @@ SoundID AudioSystem::CreateOrGetSound( const std::string& soundFilePath )
 //-----------------------------------------------------------------------------------------------
 SoundPlaybackID AudioSystem::StartSound( SoundID soundID, bool isLooped, float volume, float balance, float speed, bool isPaused )
 {
+	MEMORY_TAG_SCOPE(MemoryTag::AUDIO)
 	size_t numSounds = m_registeredSounds.size();
 	if( soundID < 0 || soundID >= numSounds )
 		return MISSING_SOUND_ID;
@@ -227,6 +260,7 @@ void AudioSystem::UpdateListener(int listenerIndex, const Vec3& listenerPosition
 
 SoundPlaybackID AudioSystem::StartSoundAt(SoundID soundID, const Vec3& soundPosition, bool isLooped, float volume, float balance, float speed, bool isPaused)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::AUDIO)
 	size_t numSounds = m_registeredSounds.size();
 	if (soundID < 0 || soundID >= numSounds)
 		return MISSING_SOUND_ID;
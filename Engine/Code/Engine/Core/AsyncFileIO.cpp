@@ -0,0 +1,401 @@
+#ifdef _WIN32
+#define PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#include "Engine/Core/AsyncFileIO.hpp"
+#include "Engine/Core/Job.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <chrono>
+
+bool FileReadRequest::IsDone() const
+{
+	FileReadStatus status = GetStatus();
+	return status == FileReadStatus::COMPLETE || status == FileReadStatus::FAILED;
+}
+
+double FileReadRequest::GetLatencySeconds() const
+{
+	if (!IsDone())
+		return 0.0;
+
+	return ConvertRawTimeToSeconds(m_completedRawTime - m_queuedRawTime);
+}
+
+AsyncFileIO::AsyncFileIO(const AsyncFileIOConfig& config)
+	:m_config(config)
+{
+	if (m_config.m_maxRequestsPerBatch < 1)
+		m_config.m_maxRequestsPerBatch = 1;
+	if (m_config.m_maxRequestsPerBatch > ASYNC_FILE_IO_MAX_BATCH)
+		m_config.m_maxRequestsPerBatch = ASYNC_FILE_IO_MAX_BATCH;
+
+	m_latencyStat = RegisterHistogramStat("io.latency_ms");
+	m_bytesReadStat = RegisterCounterStat("io.bytes_read");
+	m_requestsCompletedStat = RegisterCounterStat("io.requests_completed");
+	m_pendingRequestsStat = RegisterGaugeStat("io.pending");
+	m_throughputStat = RegisterGaugeStat("io.throughput_mb_s");
+}
+
+void AsyncFileIO::Startup()
+{
+	m_isQuitting = false;
+	m_ioThreads.reserve(m_config.m_numIOThreads);
+	for (int i = 0; i < m_config.m_numIOThreads; i++)
+	{
+		m_ioThreads.push_back(new std::thread(&AsyncFileIO::IOThreadMain, this, i));
+	}
+}
+
+void AsyncFileIO::Shutdown()
+{
+	//reads already in flight finish, anything still queued is failed so its owner isn't left waiting forever
+	m_isQuitting = true;
+	for (int i = 0; i < m_ioThreads.size(); i++)
+	{
+		m_ioThreads[i]->join();
+		delete m_ioThreads[i];
+	}
+	m_ioThreads.clear();
+
+	m_queuedRequestsMutex.lock();
+	std::deque<FileReadRequest*> abandonedRequests;
+	abandonedRequests.swap(m_queuedRequests);
+	m_queuedRequestsMutex.unlock();
+	for (int i = 0; i < abandonedRequests.size(); i++)
+	{
+		CompleteRequest(abandonedRequests[i], false);
+	}
+	ProcessCompletedRequests();
+}
+
+void AsyncFileIO::BeginFrame()
+{
+	ProcessCompletedRequests();
+}
+
+void AsyncFileIO::EndFrame()
+{
+	uint64_t totalBytesRead = m_totalBytesRead.load(std::memory_order_relaxed);
+	uint64_t totalBusyRawTime = m_totalBusyRawTime.load(std::memory_order_relaxed);
+	uint64_t bytesReadThisFrame = totalBytesRead - m_lastFrameBytesRead;
+	double busySecondsThisFrame = ConvertRawTimeToSeconds(totalBusyRawTime - m_lastFrameBusyRawTime);
+	if (bytesReadThisFrame > 0 && busySecondsThisFrame > 0.0)
+	{
+		m_throughputMBPerSecond = ((double)bytesReadThisFrame / (1024.0 * 1024.0)) / busySecondsThisFrame;
+	}
+	m_lastFrameBytesRead = totalBytesRead;
+	m_lastFrameBusyRawTime = totalBusyRawTime;
+
+	SetStatGauge(m_throughputStat, m_throughputMBPerSecond);
+	SetStatGauge(m_pendingRequestsStat, m_numPendingRequests.load(std::memory_order_relaxed));
+}
+
+FileReadRequest* AsyncFileIO::QueueRead(const std::string& filePath, FileReadCallback callback, void* userData, Job* decodeJob)
+{
+	return QueueReadRange(filePath, 0, 0, callback, userData, decodeJob);
+}
+
+FileReadRequest* AsyncFileIO::QueueReadRange(const std::string& filePath, uint64_t fileOffset, size_t numBytes, FileReadCallback callback, void* userData, Job* decodeJob)
+{
+	GUARANTEE_OR_DIE(decodeJob == nullptr || m_config.m_jobSystem != nullptr, "AsyncFileIO needs a job system to queue decode jobs");
+
+	FileReadRequest* request = new FileReadRequest();
+	request->m_filePath = filePath;
+	request->m_fileOffset = fileOffset;
+	request->m_numBytesRequested = numBytes;
+	request->m_callback = callback;
+	request->m_callbackUserData = userData;
+	request->m_decodeJob = decodeJob;
+	return QueueRequest(request);
+}
+
+FileReadRequest* AsyncFileIO::QueueRequest(FileReadRequest* request)
+{
+	request->m_queuedRawTime = GetCurrentTimeRaw();
+	m_numPendingRequests.fetch_add(1, std::memory_order_relaxed);
+	m_queuedRequestsMutex.lock();
+	m_queuedRequests.push_back(request);
+	m_queuedRequestsMutex.unlock();
+	return request;
+}
+
+void AsyncFileIO::WaitForRequest(FileReadRequest* request)
+{
+	while (!request->IsDone())
+	{
+		std::this_thread::yield();
+	}
+
+	//the callback runs here instead of next frame, so the request is safe to delete once this returns
+	if (RemoveCompletedRequest(request) && request->m_callback)
+	{
+		request->m_callback(*request, request->m_callbackUserData);
+	}
+}
+
+void AsyncFileIO::ProcessCompletedRequests()
+{
+	m_completedRequestsMutex.lock();
+	std::deque<FileReadRequest*> completedRequests;
+	completedRequests.swap(m_completedRequests);
+	m_completedRequestsMutex.unlock();
+
+	for (int i = 0; i < completedRequests.size(); i++)
+	{
+		FileReadRequest* request = completedRequests[i];
+		if (request->m_callback)
+		{
+			request->m_callback(*request, request->m_callbackUserData);
+		}
+	}
+}
+
+int AsyncFileIO::GetNumPendingRequests() const
+{
+	return m_numPendingRequests.load(std::memory_order_relaxed);
+}
+
+double AsyncFileIO::GetThroughputMBPerSecond() const
+{
+	return m_throughputMBPerSecond;
+}
+
+void AsyncFileIO::IOThreadMain(int threadIndex)
+{
+	Profiler::GetGlobalProfiler().SetThreadName(Stringf("FileIO %d", threadIndex));
+	FileReadRequest* batch[ASYNC_FILE_IO_MAX_BATCH];
+	while (!m_isQuitting)
+	{
+		int numRequests = ClaimRequests(batch, m_config.m_maxRequestsPerBatch);
+		if (numRequests > 0)
+		{
+			PROFILE_SCOPE("AsyncFileIO::ReadBatch");
+			uint64_t batchStartRawTime = GetCurrentTimeRaw();
+			numRequests = ReadPackedRequests(batch, numRequests);
+			ReadBatch(batch, numRequests);
+			m_totalBusyRawTime.fetch_add(GetCurrentTimeRaw() - batchStartRawTime, std::memory_order_relaxed);
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+}
+
+int AsyncFileIO::ClaimRequests(FileReadRequest** outRequests, int maxRequests)
+{
+	m_queuedRequestsMutex.lock();
+	int numRequests = 0;
+	while (numRequests < maxRequests && !m_queuedRequests.empty())
+	{
+		outRequests[numRequests] = m_queuedRequests.front();
+		outRequests[numRequests]->m_status.store(FileReadStatus::READING, std::memory_order_relaxed);
+		m_queuedRequests.pop_front();
+		numRequests++;
+	}
+	m_queuedRequestsMutex.unlock();
+
+	//reads of the same file (pack file ranges) end up next to each other and in offset order
+	std::sort(outRequests, outRequests + numRequests, [](const FileReadRequest* a, const FileReadRequest* b)
+		{
+			if (a->m_filePath != b->m_filePath)
+				return a->m_filePath < b->m_filePath;
+			return a->m_fileOffset < b->m_fileOffset;
+		});
+	return numRequests;
+}
+
+int AsyncFileIO::ReadPackedRequests(FileReadRequest** requests, int numRequests)
+{
+	//anything in a mounted pack is copied or decoded out of the pack's mapping, only the rest goes on to the disk reads
+	int numLooseRequests = 0;
+	for (int i = 0; i < numRequests; i++)
+	{
+		FileReadRequest* request = requests[i];
+		const PackFile* packFile = nullptr;
+		const PackFileEntry* packEntry = FindMountedPackEntry(request->m_filePath.c_str(), &packFile);
+		if (packEntry == nullptr)
+		{
+			requests[numLooseRequests++] = request;
+			continue;
+		}
+
+		if (request->m_fileOffset > packEntry->m_originalSize)
+		{
+			CompleteRequest(request, false);
+			continue;
+		}
+
+		uint64_t bytesAvailable = packEntry->m_originalSize - request->m_fileOffset;
+		uint64_t bytesToRead = request->m_numBytesRequested == 0 || request->m_numBytesRequested > bytesAvailable ? bytesAvailable : request->m_numBytesRequested;
+		request->m_buffer.resize((size_t)bytesToRead);
+		int64_t bytesRead = packFile->ReadEntry(*packEntry, request->m_fileOffset, request->m_buffer.data(), request->m_buffer.size());
+		CompleteRequest(request, bytesRead == (int64_t)request->m_buffer.size());
+	}
+	return numLooseRequests;
+}
+
+#if defined( PLATFORM_WINDOWS )
+void AsyncFileIO::ReadBatch(FileReadRequest** requests, int numRequests)
+{
+	//every read in the batch is issued as overlapped io before waiting on any of them, so the os and the drive see
+	//the whole batch at once instead of one small read at a time
+	constexpr size_t MAX_BYTES_PER_READ = 1 << 30;
+	HANDLE fileHandles[ASYNC_FILE_IO_MAX_BATCH];
+	OVERLAPPED overlapped[ASYNC_FILE_IO_MAX_BATCH];
+	size_t bytesRead[ASYNC_FILE_IO_MAX_BATCH];
+	bool isReading[ASYNC_FILE_IO_MAX_BATCH];
+
+	auto issueRead = [&](int requestIndex) -> bool
+		{
+			FileReadRequest* request = requests[requestIndex];
+			size_t bytesLeft = request->m_buffer.size() - bytesRead[requestIndex];
+			uint64_t fileOffset = request->m_fileOffset + bytesRead[requestIndex];
+			overlapped[requestIndex] = {};
+			overlapped[requestIndex].Offset = (DWORD)(fileOffset & 0xFFFFFFFF);
+			overlapped[requestIndex].OffsetHigh = (DWORD)(fileOffset >> 32);
+			DWORD bytesToRead = (DWORD)(bytesLeft < MAX_BYTES_PER_READ ? bytesLeft : MAX_BYTES_PER_READ);
+			if (ReadFile(fileHandles[requestIndex], request->m_buffer.data() + bytesRead[requestIndex], bytesToRead, nullptr, &overlapped[requestIndex]))
+				return true;
+			return GetLastError() == ERROR_IO_PENDING;
+		};
+
+	for (int i = 0; i < numRequests; i++)
+	{
+		FileReadRequest* request = requests[i];
+		bytesRead[i] = 0;
+		isReading[i] = false;
+		fileHandles[i] = CreateFileA(request->m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		LARGE_INTEGER fileSize = {};
+		if (fileHandles[i] == INVALID_HANDLE_VALUE || !GetFileSizeEx(fileHandles[i], &fileSize) || request->m_fileOffset > (uint64_t)fileSize.QuadPart)
+			continue;
+
+		uint64_t bytesAvailable = (uint64_t)fileSize.QuadPart - request->m_fileOffset;
+		uint64_t bytesToRead = request->m_numBytesRequested == 0 || request->m_numBytesRequested > bytesAvailable ? bytesAvailable : request->m_numBytesRequested;
+		request->m_buffer.resize((size_t)bytesToRead);
+		isReading[i] = bytesToRead == 0 || issueRead(i);
+	}
+
+	for (int i = 0; i < numRequests; i++)
+	{
+		FileReadRequest* request = requests[i];
+		bool succeeded = isReading[i];
+		while (succeeded && bytesRead[i] < request->m_buffer.size())
+		{
+			DWORD bytesTransferred = 0;
+			if (!GetOverlappedResult(fileHandles[i], &overlapped[i], &bytesTransferred, TRUE) || bytesTransferred == 0)
+			{
+				succeeded = false;
+				break;
+			}
+
+			bytesRead[i] += bytesTransferred;
+			if (bytesRead[i] < request->m_buffer.size() && !issueRead(i))
+			{
+				succeeded = false;
+			}
+		}
+
+		if (fileHandles[i] != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(fileHandles[i]);
+		}
+		CompleteRequest(request, succeeded);
+	}
+}
+#else
+void AsyncFileIO::ReadBatch(FileReadRequest** requests, int numRequests)
+{
+	//no overlapped io here, the batch is read back to back with positioned reads
+	for (int i = 0; i < numRequests; i++)
+	{
+		FileReadRequest* request = requests[i];
+		int fileDescriptor = open(request->m_filePath.c_str(), O_RDONLY);
+		struct stat fileStats;
+		if (fileDescriptor < 0 || fstat(fileDescriptor, &fileStats) != 0 || request->m_fileOffset > (uint64_t)fileStats.st_size)
+		{
+			if (fileDescriptor >= 0)
+			{
+				close(fileDescriptor);
+			}
+			CompleteRequest(request, false);
+			continue;
+		}
+
+		uint64_t bytesAvailable = (uint64_t)fileStats.st_size - request->m_fileOffset;
+		uint64_t bytesToRead = request->m_numBytesRequested == 0 || request->m_numBytesRequested > bytesAvailable ? bytesAvailable : request->m_numBytesRequested;
+		request->m_buffer.resize((size_t)bytesToRead);
+		size_t bytesRead = 0;
+		while (bytesRead < request->m_buffer.size())
+		{
+			ssize_t result = pread(fileDescriptor, request->m_buffer.data() + bytesRead, request->m_buffer.size() - bytesRead, (off_t)(request->m_fileOffset + bytesRead));
+			if (result <= 0)
+				break;
+			bytesRead += (size_t)result;
+		}
+		close(fileDescriptor);
+		CompleteRequest(request, bytesRead == request->m_buffer.size());
+	}
+}
+#endif
+
+void AsyncFileIO::CompleteRequest(FileReadRequest* request, bool succeeded)
+{
+	if (!succeeded)
+	{
+		request->m_buffer.clear();
+	}
+
+	request->m_completedRawTime = GetCurrentTimeRaw();
+	m_totalBytesRead.fetch_add(request->m_buffer.size(), std::memory_order_relaxed);
+	AddToStatCounter(m_bytesReadStat, (int64_t)request->m_buffer.size());
+	AddToStatCounter(m_requestsCompletedStat);
+	RecordStatSample(m_latencyStat, ConvertRawTimeToSeconds(request->m_completedRawTime - request->m_queuedRawTime) * 1000.0);
+
+	//grab everything needed before publishing the status, the owner may delete the request as soon as it sees it done
+	Job* decodeJob = request->m_decodeJob;
+	bool hasCallback = request->m_callback != nullptr;
+	if (hasCallback)
+	{
+		m_completedRequestsMutex.lock();
+		m_completedRequests.push_back(request);
+		m_completedRequestsMutex.unlock();
+	}
+	request->m_status.store(succeeded ? FileReadStatus::COMPLETE : FileReadStatus::FAILED, std::memory_order_release);
+	m_numPendingRequests.fetch_sub(1, std::memory_order_relaxed);
+
+	//the decode job checks Succeeded() itself, it is queued either way so its owner's wait doesn't hang on a failed read
+	if (decodeJob)
+	{
+		m_config.m_jobSystem->QueueJobs(decodeJob);
+	}
+}
+
+bool AsyncFileIO::RemoveCompletedRequest(FileReadRequest* request)
+{
+	bool wasFound = false;
+	m_completedRequestsMutex.lock();
+	for (auto iter = m_completedRequests.begin(); iter != m_completedRequests.end(); ++iter)
+	{
+		if (*iter == request)
+		{
+			m_completedRequests.erase(iter);
+			wasFound = true;
+			break;
+		}
+	}
+	m_completedRequestsMutex.unlock();
+	return wasFound;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StatsRegistry.hpp"
+
+class Job;
+class JobSystem;
+class FileReadRequest;
+
+constexpr int ASYNC_FILE_IO_MAX_BATCH = 64;
+
+//runs on the thread that calls AsyncFileIO::ProcessCompletedRequests (or WaitForRequest), never on an io thread
+typedef void (*FileReadCallback)(FileReadRequest& request, void* userData);
+
+struct AsyncFileIOConfig
+{
+	int m_numIOThreads = 2;
+	int m_maxRequestsPerBatch = 16;			//an io thread claims up to this many queued reads and has them all in flight at once
+	JobSystem* m_jobSystem = nullptr;		//only needed for reads that kick off a decode job
+};
+
+enum class FileReadStatus
+{
+	QUEUED,
+	READING,
+	COMPLETE,
+	FAILED
+};
+
+//one read, owned by whoever queued it. it can be deleted once it is done and its callback (if any) has run,
+//including from inside the callback itself
+class FileReadRequest
+{
+	friend class AsyncFileIO;
+public:
+	const std::string& GetFilePath() const { return m_filePath; }
+	FileReadStatus GetStatus() const { return m_status.load(std::memory_order_acquire); }
+	bool IsDone() const;
+	bool Succeeded() const { return GetStatus() == FileReadStatus::COMPLETE; }
+	ByteSpan GetBytes() const { return ByteSpan(m_buffer); }
+	std::vector<uint8_t>& GetBuffer() { return m_buffer; }		//swap out of it to keep the bytes without a copy
+	double GetLatencySeconds() const;							//queued to bytes landing
+
+private:
+	std::string m_filePath;
+	uint64_t m_fileOffset = 0;
+	size_t m_numBytesRequested = 0;			//0 reads to the end of the file
+	std::vector<uint8_t> m_buffer;
+	std::atomic<FileReadStatus> m_status{ FileReadStatus::QUEUED };
+	FileReadCallback m_callback = nullptr;
+	void* m_callbackUserData = nullptr;
+	Job* m_decodeJob = nullptr;
+	uint64_t m_queuedRawTime = 0;
+	uint64_t m_completedRawTime = 0;
+};
+
+//reads files on dedicated io threads so nothing on the main thread or the job workers blocks on the disk. a read can
+//hand its bytes to a decode job, which is queued on the job system the moment the read lands rather than next frame
+class AsyncFileIO
+{
+public:
+	AsyncFileIO(const AsyncFileIOConfig& config);
+	void Startup();
+	void Shutdown();
+	void BeginFrame();
+	void EndFrame();
+
+	FileReadRequest* QueueRead(const std::string& filePath, FileReadCallback callback = nullptr, void* userData = nullptr, Job* decodeJob = nullptr);
+	FileReadRequest* QueueReadRange(const std::string& filePath, uint64_t fileOffset, size_t numBytes, FileReadCallback callback = nullptr, void* userData = nullptr, Job* decodeJob = nullptr);
+	void WaitForRequest(FileReadRequest* request);
+	void ProcessCompletedRequests();
+
+	int GetNumPendingRequests() const;
+	double GetThroughputMBPerSecond() const;		//while the io threads were busy, over the last frame that read anything
+
+private:
+	FileReadRequest* QueueRequest(FileReadRequest* request);
+	void IOThreadMain(int threadIndex);
+	int ClaimRequests(FileReadRequest** outRequests, int maxRequests);
+	int ReadPackedRequests(FileReadRequest** requests, int numRequests);		//returns how many are left for ReadBatch
+	void ReadBatch(FileReadRequest** requests, int numRequests);
+	void CompleteRequest(FileReadRequest* request, bool succeeded);
+	bool RemoveCompletedRequest(FileReadRequest* request);
+
+private:
+	AsyncFileIOConfig m_config;
+	std::vector<std::thread*> m_ioThreads;
+	std::atomic<bool> m_isQuitting = false;
+
+	std::deque<FileReadRequest*> m_queuedRequests;
+	mutable std::mutex m_queuedRequestsMutex;
+	std::atomic<int> m_numPendingRequests = 0;
+
+	std::deque<FileReadRequest*> m_completedRequests;		//waiting for their callbacks
+	std::mutex m_completedRequestsMutex;
+
+	std::atomic<uint64_t> m_totalBytesRead = 0;
+	std::atomic<uint64_t> m_totalBusyRawTime = 0;
+	uint64_t m_lastFrameBytesRead = 0;
+	uint64_t m_lastFrameBusyRawTime = 0;
+	double m_throughputMBPerSecond = 0.0;
+
+	StatID m_latencyStat = INVALID_STAT_ID;				//queued to bytes landing, in ms
+	StatID m_bytesReadStat = INVALID_STAT_ID;
+	StatID m_requestsCompletedStat = INVALID_STAT_ID;
+	StatID m_pendingRequestsStat = INVALID_STAT_ID;
+	StatID m_throughputStat = INVALID_STAT_ID;
+};
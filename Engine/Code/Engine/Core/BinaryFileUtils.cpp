@@ -0,0 +1,54 @@
+#include "Engine/Core/BinaryFileUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <string.h>
+
+constexpr size_t SECTION_PADDING_BLOCK_SIZE = 64;
+
+uint64_t ComputeFileChecksum(const void* data, size_t size, uint64_t checksum)
+{
+	//fnv-1a over 8 byte words instead of single bytes, so checking a big file costs about as much as touching it
+	constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+	const uint8_t* bytes = (const uint8_t*)data;
+	size_t numWords = size / 8;
+	for (size_t i = 0; i < numWords; i++)
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i * 8, sizeof(word));
+		checksum = (checksum ^ word) * FNV_PRIME;
+	}
+	for (size_t i = numWords * 8; i < size; i++)
+	{
+		checksum = (checksum ^ bytes[i]) * FNV_PRIME;
+	}
+	return checksum;
+}
+
+bool SectionedFileWriter::Open(const char* filepath)
+{
+	m_writeOffset = 0;
+	m_wroteEverything = true;
+	return m_fileStream.OpenForWrite(filepath);
+}
+
+void SectionedFileWriter::WriteSection(uint64_t sectionOffset, const void* data, size_t size)
+{
+	GUARANTEE_OR_DIE(sectionOffset >= m_writeOffset, "File sections have to be written in order without overlapping");
+
+	//sections are written straight from the caller's memory, only the padding comes from here
+	static const char padding[SECTION_PADDING_BLOCK_SIZE] = {};
+	while (m_writeOffset < sectionOffset)
+	{
+		size_t paddingSize = (size_t)(sectionOffset - m_writeOffset);
+		paddingSize = paddingSize < SECTION_PADDING_BLOCK_SIZE ? paddingSize : SECTION_PADDING_BLOCK_SIZE;
+		m_wroteEverything &= m_fileStream.WriteBytes(padding, paddingSize) == paddingSize;
+		m_writeOffset += paddingSize;
+	}
+	m_wroteEverything &= m_fileStream.WriteBytes((const char*)data, size) == size;
+	m_writeOffset = sectionOffset + size;
+}
+
+bool SectionedFileWriter::Close()
+{
+	m_fileStream.Close();
+	return m_wroteEverything;
+}
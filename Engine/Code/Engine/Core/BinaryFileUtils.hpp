@@ -0,0 +1,23 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "Engine/Core/FileUtils.hpp"
+
+//shared by the cooked file formats (meshes, textures, packs), which all lay out a header and a few aligned sections
+
+//fnv-1a over 8 byte words, chain calls by passing the previous result. each format seeds it with its own value
+uint64_t ComputeFileChecksum(const void* data, size_t size, uint64_t checksum);
+
+//writes sections at increasing offsets, filling the gaps between them with zeros
+class SectionedFileWriter
+{
+public:
+	bool Open(const char* filepath);
+	void WriteSection(uint64_t sectionOffset, const void* data, size_t size);
+	bool Close();		//false if any write came up short
+
+private:
+	FileStream m_fileStream;
+	uint64_t m_writeOffset = 0;
+	bool m_wroteEverything = true;
+};
@@ -0,0 +1,628 @@
+#include "Engine/Core/BinaryLog.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <limits.h>
+#include <stdio.h>
+
+static const char BINARY_LOG_FILE_TAG[4] = { 'B', 'L', 'O', 'G' };
+
+//set the first time a thread logs, the buffer itself is owned by the global log
+static thread_local BinaryLogThreadBuffer* t_binaryLogThreadBuffer = nullptr;
+static thread_local bool t_hasRetiredBinaryLogThreadBuffer = false;
+
+//retires the thread's buffer when the thread exits. kept apart from the raw pointer above, so logging doesn't pay for
+//a thread_local with a destructor
+struct BinaryLogThreadBufferRetirer
+{
+	BinaryLogThreadBuffer* m_threadBuffer = nullptr;
+
+	~BinaryLogThreadBufferRetirer()
+	{
+		if (m_threadBuffer == nullptr)
+			return;
+
+		BinaryLog::GetGlobalLog().RetireThreadBuffer(*m_threadBuffer);
+		t_binaryLogThreadBuffer = nullptr;
+		t_hasRetiredBinaryLogThreadBuffer = true;
+	}
+};
+static thread_local BinaryLogThreadBufferRetirer t_binaryLogThreadBufferRetirer;
+
+BinaryLogRecordBuilder::BinaryLogRecordBuilder(unsigned short formatID)
+{
+	uint64_t rawTime = GetCurrentTimeRaw();
+	memcpy(&m_bytes[2], &formatID, sizeof(formatID));
+	memcpy(&m_bytes[4], &rawTime, sizeof(rawTime));
+	m_numBytes = BINARY_LOG_RECORD_HEADER_BYTES;
+}
+
+void BinaryLogRecordBuilder::WriteArg(BinaryLogArgType type, const void* value, int valueBytes)
+{
+	//once an argument doesn't fit the rest are left out too, the decoder prints them as missing
+	if (m_isFull || m_numBytes + 1 + valueBytes > BINARY_LOG_MAX_RECORD_BYTES)
+	{
+		m_isFull = true;
+		return;
+	}
+
+	m_bytes[m_numBytes] = type;
+	memcpy(&m_bytes[m_numBytes + 1], value, valueBytes);
+	m_numBytes += 1 + valueBytes;
+}
+
+void BinaryLogRecordBuilder::WriteStringArg(const char* text, int textLength)
+{
+	if (textLength > BINARY_LOG_MAX_STRING_ARG_BYTES)
+	{
+		textLength = BINARY_LOG_MAX_STRING_ARG_BYTES;
+	}
+
+	if (m_isFull || m_numBytes + 2 + textLength > BINARY_LOG_MAX_RECORD_BYTES)
+	{
+		m_isFull = true;
+		return;
+	}
+
+	m_bytes[m_numBytes] = BINARY_LOG_ARG_STRING;
+	m_bytes[m_numBytes + 1] = (unsigned char)textLength;
+	if (textLength > 0)
+	{
+		memcpy(&m_bytes[m_numBytes + 2], text, textLength);
+	}
+	m_numBytes += 2 + textLength;
+}
+
+int BinaryLogRecordBuilder::Finish()
+{
+	unsigned short recordBytes = (unsigned short)m_numBytes;
+	memcpy(&m_bytes[0], &recordBytes, sizeof(recordBytes));
+	return m_numBytes;
+}
+
+BinaryLogThreadBuffer::BinaryLogThreadBuffer(unsigned short threadIndex)
+	:m_threadIndex(threadIndex)
+{
+	static_assert((BINARY_LOG_THREAD_BUFFER_BYTES & (BINARY_LOG_THREAD_BUFFER_BYTES - 1)) == 0, "Binary log thread buffer size must be a power of two");
+	m_bytes = new unsigned char[BINARY_LOG_THREAD_BUFFER_BYTES];
+	m_mask = BINARY_LOG_THREAD_BUFFER_BYTES - 1;
+}
+
+BinaryLogThreadBuffer::~BinaryLogThreadBuffer()
+{
+	delete[] m_bytes;
+	m_bytes = nullptr;
+}
+
+bool BinaryLogThreadBuffer::Push(const unsigned char* record, int recordBytes)
+{
+	unsigned int writePosition = m_writePosition.load(std::memory_order_relaxed);
+	unsigned int readPosition = m_readPosition.load(std::memory_order_acquire);
+	unsigned int freeBytes = (m_mask + 1) - (writePosition - readPosition);
+	if ((unsigned int)recordBytes > freeBytes)
+	{
+		m_numDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	//records wrap around the end of the buffer, the consumer copies them back out contiguously
+	unsigned int writeIndex = writePosition & m_mask;
+	unsigned int bytesUntilEnd = (m_mask + 1) - writeIndex;
+	if ((unsigned int)recordBytes <= bytesUntilEnd)
+	{
+		memcpy(&m_bytes[writeIndex], record, recordBytes);
+	}
+	else
+	{
+		memcpy(&m_bytes[writeIndex], record, bytesUntilEnd);
+		memcpy(&m_bytes[0], record + bytesUntilEnd, recordBytes - bytesUntilEnd);
+	}
+
+	m_writePosition.store(writePosition + recordBytes, std::memory_order_release);
+	return true;
+}
+
+void BinaryLogThreadBuffer::DrainInto(std::vector<unsigned char>& outBytes)
+{
+	unsigned int readPosition = m_readPosition.load(std::memory_order_relaxed);
+	unsigned int writePosition = m_writePosition.load(std::memory_order_acquire);
+	unsigned int numBytes = writePosition - readPosition;
+	if (numBytes == 0)
+		return;
+
+	size_t outStart = outBytes.size();
+	outBytes.resize(outStart + numBytes);
+	unsigned int readIndex = readPosition & m_mask;
+	unsigned int bytesUntilEnd = (m_mask + 1) - readIndex;
+	if (numBytes <= bytesUntilEnd)
+	{
+		memcpy(&outBytes[outStart], &m_bytes[readIndex], numBytes);
+	}
+	else
+	{
+		memcpy(&outBytes[outStart], &m_bytes[readIndex], bytesUntilEnd);
+		memcpy(&outBytes[outStart + bytesUntilEnd], &m_bytes[0], numBytes - bytesUntilEnd);
+	}
+
+	m_readPosition.store(writePosition, std::memory_order_release);
+}
+
+BinaryLog::~BinaryLog()
+{
+	CloseFile();
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		delete m_threadBuffers[i];
+	}
+	m_threadBuffers.clear();
+}
+
+BinaryLog& BinaryLog::GetGlobalLog()
+{
+	//function static so formats registered during static initialization still find the log
+	static BinaryLog s_globalLog;
+	return s_globalLog;
+}
+
+unsigned short BinaryLog::RegisterFormat(const char* format, const char* file, int line)
+{
+	//called once per BINARY_LOG call site, the strings are literals so only the pointers are kept
+	m_mutex.lock();
+	GUARANTEE_OR_DIE(m_formats.size() < 0xffff, "Too many binary log formats registered");
+	BinaryLogFormat newFormat;
+	newFormat.m_format = format;
+	newFormat.m_file = file;
+	newFormat.m_line = line;
+	unsigned short formatID = (unsigned short)m_formats.size();
+	m_formats.push_back(newFormat);
+	m_mutex.unlock();
+	return formatID;
+}
+
+BinaryLogThreadBuffer& BinaryLog::GetThreadBuffer()
+{
+	if (t_binaryLogThreadBuffer == nullptr)
+	{
+		m_mutex.lock();
+		if (!m_freeThreadBuffers.empty())
+		{
+			t_binaryLogThreadBuffer = m_freeThreadBuffers.back();
+			m_freeThreadBuffers.pop_back();
+		}
+		else
+		{
+			GUARANTEE_OR_DIE(m_threadBuffers.size() < 0xffff, "Too many threads writing to the binary log at once");
+			t_binaryLogThreadBuffer = new BinaryLogThreadBuffer((unsigned short)m_threadBuffers.size());
+			m_threadBuffers.push_back(t_binaryLogThreadBuffer);
+			m_numDroppedReported.push_back(0);
+			m_isThreadBufferRetired.push_back(false);
+		}
+		m_mutex.unlock();
+
+		//logging from another thread_local's destructor after the retirer has run keeps its buffer for good,
+		//the retirer can't be brought back to retire it again
+		if (!t_hasRetiredBinaryLogThreadBuffer)
+		{
+			t_binaryLogThreadBufferRetirer.m_threadBuffer = t_binaryLogThreadBuffer;
+		}
+	}
+
+	return *t_binaryLogThreadBuffer;
+}
+
+void BinaryLog::RetireThreadBuffer(BinaryLogThreadBuffer& threadBuffer)
+{
+	m_mutex.lock();
+	m_isThreadBufferRetired[threadBuffer.GetThreadIndex()] = true;
+	m_mutex.unlock();
+}
+
+bool BinaryLog::OpenFile(const char* filePath)
+{
+	m_mutex.lock();
+	if (m_isFileOpen)
+	{
+		m_file.Close();
+	}
+
+	m_isFileOpen = m_file.OpenForWrite(filePath);
+	if (m_isFileOpen)
+	{
+		//every file carries the formats it uses, so it decodes on its own
+		unsigned int version = BINARY_LOG_FILE_VERSION;
+		double secondsPerRawTick = ConvertRawTimeToSeconds(1);
+		m_file.WriteBytes(BINARY_LOG_FILE_TAG, sizeof(BINARY_LOG_FILE_TAG));
+		m_file.WriteBytes((const char*)&version, sizeof(version));
+		m_file.WriteBytes((const char*)&secondsPerRawTick, sizeof(secondsPerRawTick));
+		m_numFormatsWritten = 0;
+	}
+	m_mutex.unlock();
+	return m_isFileOpen;
+}
+
+void BinaryLog::CloseFile()
+{
+	m_mutex.lock();
+	if (m_isFileOpen)
+	{
+		m_file.Close();
+		m_isFileOpen = false;
+	}
+	m_mutex.unlock();
+}
+
+void BinaryLog::Flush(DevConsole* echoConsole)
+{
+	m_mutex.lock();
+	m_drainedBytes.clear();
+	m_pendingRecords.clear();
+	for (int bufferIndex = 0; bufferIndex < m_threadBuffers.size(); bufferIndex++)
+	{
+		BinaryLogThreadBuffer& threadBuffer = *m_threadBuffers[bufferIndex];
+		int recordOffset = (int)m_drainedBytes.size();
+		threadBuffer.DrainInto(m_drainedBytes);
+		while (recordOffset < (int)m_drainedBytes.size())
+		{
+			BinaryLogPendingRecord pendingRecord;
+			unsigned short recordBytes = 0;
+			memcpy(&recordBytes, &m_drainedBytes[recordOffset], sizeof(recordBytes));
+			memcpy(&pendingRecord.m_rawTime, &m_drainedBytes[recordOffset + 4], sizeof(pendingRecord.m_rawTime));
+			pendingRecord.m_byteOffset = recordOffset;
+			pendingRecord.m_threadIndex = threadBuffer.GetThreadIndex();
+			m_pendingRecords.push_back(pendingRecord);
+			recordOffset += recordBytes;
+		}
+
+		unsigned int numDropped = threadBuffer.GetNumDropped();
+		unsigned int numNewlyDropped = numDropped - m_numDroppedReported[bufferIndex];
+		if (numNewlyDropped > 0)
+		{
+			m_numDroppedReported[bufferIndex] = numDropped;
+			if (m_isFileOpen)
+			{
+				unsigned char chunkType = BINARY_LOG_CHUNK_DROPPED;
+				unsigned short threadIndex = threadBuffer.GetThreadIndex();
+				m_file.WriteBytes((const char*)&chunkType, sizeof(chunkType));
+				m_file.WriteBytes((const char*)&threadIndex, sizeof(threadIndex));
+				m_file.WriteBytes((const char*)&numNewlyDropped, sizeof(numNewlyDropped));
+			}
+			if (echoConsole)
+			{
+				echoConsole->AddLineFormatted(echoConsole->WARNING, "Binary log buffer of thread %d was full, %u records dropped", bufferIndex, numNewlyDropped);
+			}
+		}
+
+		//its thread is gone and everything it logged has just been drained, the next new thread can have it
+		if (m_isThreadBufferRetired[bufferIndex])
+		{
+			m_isThreadBufferRetired[bufferIndex] = false;
+			m_freeThreadBuffers.push_back(&threadBuffer);
+		}
+	}
+
+	//interleaves the threads by time. ties keep drain order, which stable_sort would too but it allocates
+	std::sort(m_pendingRecords.begin(), m_pendingRecords.end(), [](const BinaryLogPendingRecord& a, const BinaryLogPendingRecord& b)
+		{
+			if (a.m_rawTime != b.m_rawTime)
+				return a.m_rawTime < b.m_rawTime;
+			return a.m_byteOffset < b.m_byteOffset;
+		});
+
+	if (m_isFileOpen)
+	{
+		WriteNewFormatsToFile();
+	}
+
+	for (int recordIndex = 0; recordIndex < m_pendingRecords.size(); recordIndex++)
+	{
+		const BinaryLogPendingRecord& pendingRecord = m_pendingRecords[recordIndex];
+		const unsigned char* record = &m_drainedBytes[pendingRecord.m_byteOffset];
+		unsigned short recordBytes = 0;
+		unsigned short formatID = 0;
+		memcpy(&recordBytes, &record[0], sizeof(recordBytes));
+		memcpy(&formatID, &record[2], sizeof(formatID));
+
+		if (m_isFileOpen)
+		{
+			unsigned char chunkType = BINARY_LOG_CHUNK_RECORD;
+			m_file.WriteBytes((const char*)&chunkType, sizeof(chunkType));
+			m_file.WriteBytes((const char*)&pendingRecord.m_threadIndex, sizeof(pendingRecord.m_threadIndex));
+			m_file.WriteBytes((const char*)record, recordBytes);
+		}
+
+		if (echoConsole)
+		{
+			FormatBinaryLogRecord(m_formats[formatID].m_format, record + BINARY_LOG_RECORD_HEADER_BYTES, recordBytes - BINARY_LOG_RECORD_HEADER_BYTES, m_echoText);
+			echoConsole->AddLine(echoConsole->INFO_MINOR, m_echoText);
+		}
+	}
+	m_mutex.unlock();
+}
+
+int BinaryLog::GetNumFormats()
+{
+	m_mutex.lock();
+	int numFormats = (int)m_formats.size();
+	m_mutex.unlock();
+	return numFormats;
+}
+
+unsigned int BinaryLog::GetNumDropped()
+{
+	m_mutex.lock();
+	unsigned int numDropped = 0;
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		numDropped += m_threadBuffers[i]->GetNumDropped();
+	}
+	m_mutex.unlock();
+	return numDropped;
+}
+
+void BinaryLog::WriteNewFormatsToFile()
+{
+	//formats go out before the first record that could use them
+	for (; m_numFormatsWritten < (int)m_formats.size(); m_numFormatsWritten++)
+	{
+		const BinaryLogFormat& format = m_formats[m_numFormatsWritten];
+		unsigned char chunkType = BINARY_LOG_CHUNK_FORMAT;
+		unsigned short formatID = (unsigned short)m_numFormatsWritten;
+		unsigned short fileLength = (unsigned short)strlen(format.m_file);
+		unsigned short formatLength = (unsigned short)strlen(format.m_format);
+		m_file.WriteBytes((const char*)&chunkType, sizeof(chunkType));
+		m_file.WriteBytes((const char*)&formatID, sizeof(formatID));
+		m_file.WriteBytes((const char*)&format.m_line, sizeof(format.m_line));
+		m_file.WriteBytes((const char*)&fileLength, sizeof(fileLength));
+		m_file.WriteBytes(format.m_file, fileLength);
+		m_file.WriteBytes((const char*)&formatLength, sizeof(formatLength));
+		m_file.WriteBytes(format.m_format, formatLength);
+	}
+}
+
+static void AppendFormattedArg(std::string& outText, const char* specifier, const unsigned char* args, int argBytes, int& argOffset)
+{
+	//specifier is "%[flags][width][.precision]" plus the conversion character, without any length modifier
+	char conversion = specifier[strlen(specifier) - 1];
+	if (argOffset >= argBytes)
+	{
+		outText += "<missing>";
+		return;
+	}
+
+	char specifierWithLength[32];
+	char argText[256];
+	BinaryLogArgType type = (BinaryLogArgType)args[argOffset];
+	bool isIntegerConversion = strchr("diouxXc", conversion) != nullptr;
+	bool isFloatConversion = strchr("fFeEgGaA", conversion) != nullptr;
+	switch (type)
+	{
+	case BINARY_LOG_ARG_INT32:
+	case BINARY_LOG_ARG_INT64:
+	case BINARY_LOG_ARG_UINT32:
+	case BINARY_LOG_ARG_UINT64:
+	{
+		long long signedValue = 0;
+		unsigned long long unsignedValue = 0;
+		int valueBytes = (type == BINARY_LOG_ARG_INT32 || type == BINARY_LOG_ARG_UINT32) ? 4 : 8;
+		if (type == BINARY_LOG_ARG_INT32)		{ int value; memcpy(&value, &args[argOffset + 1], 4); signedValue = value; unsignedValue = (unsigned int)value; }
+		else if (type == BINARY_LOG_ARG_UINT32)	{ unsigned int value; memcpy(&value, &args[argOffset + 1], 4); signedValue = value; unsignedValue = value; }
+		else if (type == BINARY_LOG_ARG_INT64)	{ memcpy(&signedValue, &args[argOffset + 1], 8); unsignedValue = (unsigned long long)signedValue; }
+		else									{ memcpy(&unsignedValue, &args[argOffset + 1], 8); signedValue = (long long)unsignedValue; }
+		argOffset += 1 + valueBytes;
+
+		if (conversion == 'c')
+		{
+			snprintf(argText, sizeof(argText), specifier, (int)signedValue);
+		}
+		else if (isIntegerConversion)
+		{
+			snprintf(specifierWithLength, sizeof(specifierWithLength), "%.*sll%c", (int)strlen(specifier) - 1, specifier, conversion);
+			if (conversion == 'd' || conversion == 'i')
+				snprintf(argText, sizeof(argText), specifierWithLength, signedValue);
+			else
+				snprintf(argText, sizeof(argText), specifierWithLength, unsignedValue);
+		}
+		else if (isFloatConversion)
+		{
+			snprintf(argText, sizeof(argText), specifier, (double)signedValue);
+		}
+		else
+		{
+			snprintf(argText, sizeof(argText), "%lld", signedValue);
+		}
+		outText += argText;
+		break;
+	}
+	case BINARY_LOG_ARG_DOUBLE:
+	{
+		double value = 0.0;
+		memcpy(&value, &args[argOffset + 1], sizeof(value));
+		argOffset += 1 + (int)sizeof(value);
+		snprintf(argText, sizeof(argText), isFloatConversion ? specifier : "%f", value);
+		outText += argText;
+		break;
+	}
+	case BINARY_LOG_ARG_STRING:
+	{
+		int textLength = args[argOffset + 1];
+		const char* text = (const char*)&args[argOffset + 2];
+		argOffset += 2 + textLength;
+		if (conversion == 's' && strlen(specifier) > 2)
+		{
+			//width or precision given, the text isn't null terminated so it goes through a copy
+			char terminatedText[BINARY_LOG_MAX_STRING_ARG_BYTES + 1];
+			memcpy(terminatedText, text, textLength);
+			terminatedText[textLength] = '\0';
+			snprintf(argText, sizeof(argText), specifier, terminatedText);
+			outText += argText;
+		}
+		else
+		{
+			outText.append(text, textLength);
+		}
+		break;
+	}
+	case BINARY_LOG_ARG_POINTER:
+	{
+		uint64_t address = 0;
+		memcpy(&address, &args[argOffset + 1], sizeof(address));
+		argOffset += 1 + (int)sizeof(address);
+		snprintf(argText, sizeof(argText), "0x%llx", (unsigned long long)address);
+		outText += argText;
+		break;
+	}
+	default:
+		//unknown type, nothing after it can be trusted
+		argOffset = argBytes;
+		outText += "<bad arg>";
+		break;
+	}
+}
+
+void FormatBinaryLogRecord(const char* format, const unsigned char* args, int argBytes, std::string& outText)
+{
+	outText.clear();
+	int argOffset = 0;
+	const char* character = format;
+	while (*character != '\0')
+	{
+		if (*character != '%')
+		{
+			const char* runStart = character;
+			while (*character != '\0' && *character != '%')
+			{
+				character++;
+			}
+			outText.append(runStart, character - runStart);
+			continue;
+		}
+
+		if (character[1] == '%')
+		{
+			outText += '%';
+			character += 2;
+			continue;
+		}
+
+		//copy flags, width and precision, skip length modifiers since the recorded type decides those
+		char specifier[32];
+		int specifierLength = 0;
+		specifier[specifierLength++] = *character++;
+		while (*character != '\0' && strchr("-+ #0123456789.", *character) != nullptr && specifierLength < 28)
+		{
+			specifier[specifierLength++] = *character++;
+		}
+		while (*character != '\0' && strchr("hljztL", *character) != nullptr)
+		{
+			character++;
+		}
+		if (*character == '\0')
+			break;
+
+		specifier[specifierLength++] = *character++;
+		specifier[specifierLength] = '\0';
+		AppendFormattedArg(outText, specifier, args, argBytes, argOffset);
+	}
+}
+
+bool DecodeBinaryLogFile(const std::string& binaryLogPath, const std::string& textOutputPath)
+{
+	MappedFile mappedFile;
+	if (!mappedFile.Open(binaryLogPath, FileAccessPattern::SEQUENTIAL))
+		return false;
+
+	const uint8_t* fileBytes = mappedFile.GetData();
+	const int fileHeaderBytes = (int)(sizeof(BINARY_LOG_FILE_TAG) + sizeof(unsigned int) + sizeof(double));
+	if (mappedFile.GetSize() < (size_t)fileHeaderBytes || mappedFile.GetSize() > INT_MAX || memcmp(fileBytes, BINARY_LOG_FILE_TAG, sizeof(BINARY_LOG_FILE_TAG)) != 0)
+		return false;
+
+	unsigned int version = 0;
+	double secondsPerRawTick = 0.0;
+	memcpy(&version, &fileBytes[4], sizeof(version));
+	memcpy(&secondsPerRawTick, &fileBytes[8], sizeof(secondsPerRawTick));
+	if (version != BINARY_LOG_FILE_VERSION)
+		return false;
+
+	std::vector<std::string> formats;
+	std::string decodedText;
+	std::string recordText;
+	char linePrefix[64];
+	int byteOffset = fileHeaderBytes;
+	int numFileBytes = (int)mappedFile.GetSize();
+	while (byteOffset < numFileBytes)
+	{
+		unsigned char chunkType = fileBytes[byteOffset++];
+		if (chunkType == BINARY_LOG_CHUNK_FORMAT)
+		{
+			unsigned short formatID = 0;
+			int line = 0;
+			unsigned short fileLength = 0;
+			unsigned short formatLength = 0;
+			if (byteOffset + 8 > numFileBytes)
+				return false;
+			memcpy(&formatID, &fileBytes[byteOffset], sizeof(formatID));
+			memcpy(&line, &fileBytes[byteOffset + 2], sizeof(line));
+			memcpy(&fileLength, &fileBytes[byteOffset + 6], sizeof(fileLength));
+			byteOffset += 8 + fileLength;
+			if (byteOffset + 2 > numFileBytes)
+				return false;
+			memcpy(&formatLength, &fileBytes[byteOffset], sizeof(formatLength));
+			byteOffset += 2;
+			if (byteOffset + formatLength > numFileBytes)
+				return false;
+
+			if (formatID >= formats.size())
+			{
+				formats.resize(formatID + 1);
+			}
+			formats[formatID].assign((const char*)&fileBytes[byteOffset], formatLength);
+			byteOffset += formatLength;
+		}
+		else if (chunkType == BINARY_LOG_CHUNK_RECORD)
+		{
+			unsigned short threadIndex = 0;
+			unsigned short recordBytes = 0;
+			unsigned short formatID = 0;
+			uint64_t rawTime = 0;
+			if (byteOffset + 2 + BINARY_LOG_RECORD_HEADER_BYTES > numFileBytes)
+				return false;
+			memcpy(&threadIndex, &fileBytes[byteOffset], sizeof(threadIndex));
+			const unsigned char* record = &fileBytes[byteOffset + 2];
+			memcpy(&recordBytes, &record[0], sizeof(recordBytes));
+			memcpy(&formatID, &record[2], sizeof(formatID));
+			memcpy(&rawTime, &record[4], sizeof(rawTime));
+			if (recordBytes < BINARY_LOG_RECORD_HEADER_BYTES || byteOffset + 2 + recordBytes > numFileBytes || formatID >= formats.size())
+				return false;
+
+			FormatBinaryLogRecord(formats[formatID].c_str(), record + BINARY_LOG_RECORD_HEADER_BYTES, recordBytes - BINARY_LOG_RECORD_HEADER_BYTES, recordText);
+			snprintf(linePrefix, sizeof(linePrefix), "[%12.6f] [thread %d] ", (double)rawTime * secondsPerRawTick, threadIndex);
+			decodedText += linePrefix;
+			decodedText += recordText;
+			decodedText += '\n';
+			byteOffset += 2 + recordBytes;
+		}
+		else if (chunkType == BINARY_LOG_CHUNK_DROPPED)
+		{
+			unsigned short threadIndex = 0;
+			unsigned int numDropped = 0;
+			if (byteOffset + 6 > numFileBytes)
+				return false;
+			memcpy(&threadIndex, &fileBytes[byteOffset], sizeof(threadIndex));
+			memcpy(&numDropped, &fileBytes[byteOffset + 2], sizeof(numDropped));
+			decodedText += Stringf("[thread %d] %u records dropped\n", threadIndex, numDropped);
+			byteOffset += 6;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	FileStream textFile;
+	textFile.OpenForWrite(textOutputPath.c_str());
+	textFile.WriteBytes(decodedText.c_str(), decodedText.size());
+	textFile.Close();
+	return true;
+}
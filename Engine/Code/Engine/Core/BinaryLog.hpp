@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <string.h>
+#include "Engine/Core/FileUtils.hpp"
+
+class DevConsole;
+
+//records a format id and the raw arguments instead of the formatted text, so a log call from a job worker is a few
+//memcpys into that thread's buffer. the text is produced later by BinaryLog::Flush or offline by DecodeBinaryLogFile
+//	BINARY_LOG("Chunk %d,%d generated in %.3f ms", chunkX, chunkY, elapsedMs);
+#define BINARY_LOG(format, ...) \
+	do { \
+		static const unsigned short s_binaryLogFormatID = BinaryLog::GetGlobalLog().RegisterFormat(format, __FILE__, __LINE__); \
+		LogBinary(s_binaryLogFormatID, ##__VA_ARGS__); \
+	} while (0)
+
+constexpr int BINARY_LOG_THREAD_BUFFER_BYTES = 64 * 1024;		//per logging thread, power of two
+constexpr int BINARY_LOG_MAX_RECORD_BYTES = 512;
+constexpr int BINARY_LOG_MAX_STRING_ARG_BYTES = 128;			//longer string arguments are truncated
+constexpr int BINARY_LOG_RECORD_HEADER_BYTES = 12;				//record size, format id, raw time
+constexpr unsigned int BINARY_LOG_FILE_VERSION = 1;
+
+enum BinaryLogArgType : unsigned char
+{
+	BINARY_LOG_ARG_INT32,
+	BINARY_LOG_ARG_UINT32,
+	BINARY_LOG_ARG_INT64,
+	BINARY_LOG_ARG_UINT64,
+	BINARY_LOG_ARG_DOUBLE,
+	BINARY_LOG_ARG_STRING,
+	BINARY_LOG_ARG_POINTER,
+};
+
+enum BinaryLogFileChunkType : unsigned char
+{
+	BINARY_LOG_CHUNK_FORMAT,
+	BINARY_LOG_CHUNK_RECORD,
+	BINARY_LOG_CHUNK_DROPPED,
+};
+
+struct BinaryLogPendingRecord
+{
+	uint64_t m_rawTime = 0;
+	int m_byteOffset = 0;
+	unsigned short m_threadIndex = 0;
+};
+
+struct BinaryLogFormat
+{
+	const char* m_format = nullptr;
+	const char* m_file = nullptr;
+	int m_line = 0;
+};
+
+//assembled on the logging thread's stack, then copied into its buffer in one go
+class BinaryLogRecordBuilder
+{
+public:
+	BinaryLogRecordBuilder(unsigned short formatID);
+
+	void WriteArg(BinaryLogArgType type, const void* value, int valueBytes);
+	void WriteStringArg(const char* text, int textLength);
+	int Finish();
+
+	const unsigned char* GetBytes() const { return m_bytes; }
+	int GetNumBytes() const { return m_numBytes; }
+
+private:
+	unsigned char m_bytes[BINARY_LOG_MAX_RECORD_BYTES];
+	int m_numBytes = 0;
+	bool m_isFull = false;
+};
+
+//single producer (the owning thread), single consumer (whoever flushes). records are dropped and counted when full.
+//retired when its thread exits and handed to the next new thread once a flush has emptied it, so the thread index in a
+//log names a buffer and can be shared by threads that didn't live at the same time
+class BinaryLogThreadBuffer
+{
+public:
+	BinaryLogThreadBuffer(unsigned short threadIndex);
+	~BinaryLogThreadBuffer();
+
+	bool Push(const unsigned char* record, int recordBytes);
+	void DrainInto(std::vector<unsigned char>& outBytes);
+
+	unsigned short GetThreadIndex() const { return m_threadIndex; }
+	unsigned int GetNumDropped() const { return m_numDropped.load(); }
+
+private:
+	unsigned char* m_bytes = nullptr;
+	unsigned int m_mask = 0;
+	unsigned short m_threadIndex = 0;
+	alignas(64) std::atomic<unsigned int> m_writePosition{ 0 };
+	alignas(64) std::atomic<unsigned int> m_readPosition{ 0 };
+	std::atomic<unsigned int> m_numDropped{ 0 };
+};
+
+class BinaryLog
+{
+public:
+	~BinaryLog();
+	static BinaryLog& GetGlobalLog();
+
+	unsigned short RegisterFormat(const char* format, const char* file, int line);
+	BinaryLogThreadBuffer& GetThreadBuffer();
+	//called from the thread's exit, the buffer is reused once the next flush has drained what the thread left in it
+	void RetireThreadBuffer(BinaryLogThreadBuffer& threadBuffer);
+
+	bool OpenFile(const char* filePath);
+	void CloseFile();
+	//one thread at a time. drains every thread's buffer in timestamp order, writes the records to the open file
+	//and formats them into the console when one is given
+	void Flush(DevConsole* echoConsole = nullptr);
+
+	int GetNumFormats();
+	unsigned int GetNumDropped();
+
+private:
+	BinaryLog() = default;
+	void WriteNewFormatsToFile();
+
+private:
+	std::mutex m_mutex;
+	std::vector<BinaryLogFormat> m_formats;
+	std::vector<BinaryLogThreadBuffer*> m_threadBuffers;
+	FileStream m_file;
+	bool m_isFileOpen = false;
+	int m_numFormatsWritten = 0;
+	std::vector<unsigned int> m_numDroppedReported;
+	std::vector<bool> m_isThreadBufferRetired;					//by thread index, like m_numDroppedReported
+	std::vector<BinaryLogThreadBuffer*> m_freeThreadBuffers;	//retired and drained, still owned through m_threadBuffers
+
+	//reused between flushes
+	std::vector<unsigned char> m_drainedBytes;
+	std::vector<BinaryLogPendingRecord> m_pendingRecords;
+	std::string m_echoText;
+};
+
+//expands the record's arguments into the printf style format. arguments are printed by their recorded type,
+//so a mismatched specifier can't read garbage
+void FormatBinaryLogRecord(const char* format, const unsigned char* args, int argBytes, std::string& outText);
+//turns a file written by BinaryLog into text, one line per record
+bool DecodeBinaryLogFile(const std::string& binaryLogPath, const std::string& textOutputPath);
+
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, bool value)					{ int asInt = value ? 1 : 0; builder.WriteArg(BINARY_LOG_ARG_INT32, &asInt, sizeof(asInt)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, char value)					{ int asInt = value; builder.WriteArg(BINARY_LOG_ARG_INT32, &asInt, sizeof(asInt)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, signed char value)			{ int asInt = value; builder.WriteArg(BINARY_LOG_ARG_INT32, &asInt, sizeof(asInt)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, unsigned char value)		{ unsigned int asUInt = value; builder.WriteArg(BINARY_LOG_ARG_UINT32, &asUInt, sizeof(asUInt)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, short value)				{ int asInt = value; builder.WriteArg(BINARY_LOG_ARG_INT32, &asInt, sizeof(asInt)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, unsigned short value)		{ unsigned int asUInt = value; builder.WriteArg(BINARY_LOG_ARG_UINT32, &asUInt, sizeof(asUInt)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, int value)					{ builder.WriteArg(BINARY_LOG_ARG_INT32, &value, sizeof(value)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, unsigned int value)			{ builder.WriteArg(BINARY_LOG_ARG_UINT32, &value, sizeof(value)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, long value)					{ long long asLongLong = value; builder.WriteArg(BINARY_LOG_ARG_INT64, &asLongLong, sizeof(asLongLong)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, unsigned long value)		{ unsigned long long asULongLong = value; builder.WriteArg(BINARY_LOG_ARG_UINT64, &asULongLong, sizeof(asULongLong)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, long long value)			{ builder.WriteArg(BINARY_LOG_ARG_INT64, &value, sizeof(value)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, unsigned long long value)	{ builder.WriteArg(BINARY_LOG_ARG_UINT64, &value, sizeof(value)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, float value)				{ double asDouble = value; builder.WriteArg(BINARY_LOG_ARG_DOUBLE, &asDouble, sizeof(asDouble)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, double value)				{ builder.WriteArg(BINARY_LOG_ARG_DOUBLE, &value, sizeof(value)); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, const char* text)			{ builder.WriteStringArg(text, text ? (int)strlen(text) : 0); }
+inline void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, const std::string& text)	{ builder.WriteStringArg(text.c_str(), (int)text.size()); }
+
+template <typename T>
+void EncodeBinaryLogArg(BinaryLogRecordBuilder& builder, const T* pointer)
+{
+	uint64_t address = (uint64_t)(uintptr_t)pointer;
+	builder.WriteArg(BINARY_LOG_ARG_POINTER, &address, sizeof(address));
+}
+
+template <typename ...T_Args>
+void LogBinary(unsigned short formatID, const T_Args&... args)
+{
+	BinaryLogRecordBuilder builder(formatID);
+	int encodeEachArg[] = { 0, (EncodeBinaryLogArg(builder, args), 0)... };
+	(void)encodeEachArg;
+	int recordBytes = builder.Finish();
+	BinaryLog::GetGlobalLog().GetThreadBuffer().Push(builder.GetBytes(), recordBytes);
+}
@@ -1,5 +1,6 @@
 #include "Engine/Core/BufferUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
 
 EndianMode GetPlatformEndianess()
 {
@@ -23,6 +24,12 @@ BufferParser::BufferParser(const std::vector<uint8_t>& buffer)
 	m_endianess = m_platformEndianess;
 }
 
+BufferParser::BufferParser(const ByteSpan& bytes)
+	: m_readOrigin((uint8_t*)(bytes.m_data)), m_readHead(m_readOrigin), m_bufferSize(bytes.m_size), m_platformEndianess(GetPlatformEndianess())
+{
+	m_endianess = m_platformEndianess;
+}
+
 void BufferParser::SetEndianess(EndianMode mode)
 {
 	m_endianess = mode;
@@ -208,7 +215,7 @@ void BufferParser::ReadLengthPrecededString(std::string& outString)
 	size_t readSize = strLength;
 	if (IsReadWithinBounds(readSize))
 	{
-		memcpy((char*)(outString.data()), m_readHead, strLength);
+		outString.assign(reinterpret_cast<const char*>(m_readHead), strLength);
 		m_readHead += strLength;
 	}
 }
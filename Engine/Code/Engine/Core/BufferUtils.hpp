@@ -10,6 +10,8 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 
+struct ByteSpan;
+
 enum class EndianMode
 {
 	LITTLE,
@@ -21,6 +23,7 @@ class BufferParser
 public:
 	BufferParser(const void* buffer, size_t size);
 	BufferParser(const std::vector<uint8_t>& buffer);
+	BufferParser(const ByteSpan& bytes);
 	void SetEndianess(EndianMode mode);
 	void ForwardReadHead(size_t offset);
 	void MoveReadHeadToAbsoluteOffsetFromOrigin(size_t offset);
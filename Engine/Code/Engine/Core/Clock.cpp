@@ -1,7 +1,12 @@
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/StatsRegistry.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 
 static Clock g_systemClock;
+static bool s_hasSystemFrameStarted = false;
 
 Clock::Clock()
 {
@@ -82,7 +87,19 @@ double Clock::GetTimeDilation() const
 
 void Clock::SystemBeginFrame()
 {
+	//every app ticks the system clock once a frame, console or not, so the frame scoped core systems roll over here.
+	//the previous frame is closed out first, the same as ending it after everything else in it has run
+	if (s_hasSystemFrameStarted)
+	{
+		Profiler::GetGlobalProfiler().EndFrame();
+		MemoryTracker::GetGlobalTracker().EndFrame((float)g_systemClock.GetDeltaTime());
+		StatsRegistry::GetGlobalRegistry().EndFrame();
+		FrameArena::EndFrame();
+	}
+
 	g_systemClock.Tick();
+	Profiler::GetGlobalProfiler().BeginFrame();
+	s_hasSystemFrameStarted = true;
 }
 
 Clock& Clock::GetSystemClock()
@@ -0,0 +1,251 @@
+#include "Engine/Core/Compression.hpp"
+#include <string.h>
+#include <vector>
+
+constexpr size_t LZ4_MIN_MATCH = 4;
+constexpr size_t LZ4_LAST_LITERALS = 5;		//the format ends every block with at least this many literals
+constexpr size_t LZ4_MATCH_FIND_LIMIT = 12;	//and no match starts in its last 12 bytes
+constexpr size_t LZ4_MAX_OFFSET = 65535;
+constexpr int LZ4_HASH_BITS = 14;
+constexpr size_t LZ4_WILD_COPY_SIZE = 16;
+
+static uint32_t ReadUInt32(const uint8_t* bytes)
+{
+	uint32_t value;
+	memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+//fixed size copies, which compile to a couple of moves instead of a call. writes up to LZ4_WILD_COPY_SIZE - 1 bytes past
+//the end, so the caller checks there's room for that first
+static void WildCopyLZ4(uint8_t* output, const uint8_t* input, const uint8_t* outputEnd)
+{
+	do
+	{
+		memcpy(output, input, LZ4_WILD_COPY_SIZE);
+		output += LZ4_WILD_COPY_SIZE;
+		input += LZ4_WILD_COPY_SIZE;
+	} while (output < outputEnd);
+}
+
+static uint32_t HashLZ4Sequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+//literal and match lengths past 15 carry on in bytes of 255 and a final remainder
+static bool WriteLZ4Length(size_t length, uint8_t*& outputPos, const uint8_t* outputEnd)
+{
+	for (; length >= 255; length -= 255)
+	{
+		if (outputPos >= outputEnd)
+			return false;
+		*outputPos++ = 255;
+	}
+	if (outputPos >= outputEnd)
+		return false;
+	*outputPos++ = (uint8_t)length;
+	return true;
+}
+
+static bool WriteLZ4Sequence(const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength, uint8_t*& outputPos, const uint8_t* outputEnd)
+{
+	if (outputPos >= outputEnd)
+		return false;
+
+	uint8_t* token = outputPos++;
+	*token = (uint8_t)((numLiterals < 15 ? numLiterals : 15) << 4);
+	if (numLiterals >= 15 && !WriteLZ4Length(numLiterals - 15, outputPos, outputEnd))
+		return false;
+	if ((size_t)(outputEnd - outputPos) < numLiterals)
+		return false;
+	if (numLiterals > 0)
+	{
+		memcpy(outputPos, literals, numLiterals);
+		outputPos += numLiterals;
+	}
+
+	//the last sequence of a block is literals only
+	if (matchLength == 0)
+		return true;
+
+	if (outputEnd - outputPos < 2)
+		return false;
+	*outputPos++ = (uint8_t)(offset & 0xff);
+	*outputPos++ = (uint8_t)(offset >> 8);
+	size_t matchLengthCode = matchLength - LZ4_MIN_MATCH;
+	*token |= (uint8_t)(matchLengthCode < 15 ? matchLengthCode : 15);
+	return matchLengthCode < 15 || WriteLZ4Length(matchLengthCode - 15, outputPos, outputEnd);
+}
+
+size_t GetLZ4CompressBound(size_t inputSize)
+{
+	return inputSize + inputSize / 255 + 16;
+}
+
+size_t CompressLZ4(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputCapacity)
+{
+	uint8_t* outputPos = output;
+	const uint8_t* outputEnd = output + outputCapacity;
+	size_t anchor = 0;
+	if (inputSize > LZ4_MATCH_FIND_LIMIT)
+	{
+		//greedy, one candidate per hash. the step grows through runs without matches so incompressible data
+		//is skipped over quickly
+		std::vector<uint32_t> hashTable((size_t)1 << LZ4_HASH_BITS, 0);
+		size_t matchStartLimit = inputSize - LZ4_MATCH_FIND_LIMIT;
+		size_t matchEndLimit = inputSize - LZ4_LAST_LITERALS;
+		size_t position = 1;
+		hashTable[HashLZ4Sequence(ReadUInt32(input))] = 0;
+		int numMisses = 0;
+		while (position < matchStartLimit)
+		{
+			uint32_t sequence = ReadUInt32(input + position);
+			uint32_t& hashEntry = hashTable[HashLZ4Sequence(sequence)];
+			size_t candidate = hashEntry;
+			hashEntry = (uint32_t)position;
+			if (position - candidate > LZ4_MAX_OFFSET || ReadUInt32(input + candidate) != sequence)
+			{
+				position += 1 + (size_t)(numMisses++ >> 6);
+				continue;
+			}
+			numMisses = 0;
+
+			size_t matchStart = position;
+			while (matchStart > anchor && candidate > 0 && input[matchStart - 1] == input[candidate - 1])
+			{
+				matchStart--;
+				candidate--;
+			}
+			size_t matchEnd = position + LZ4_MIN_MATCH;
+			size_t candidateEnd = candidate + (matchEnd - matchStart);
+			while (matchEnd < matchEndLimit && input[matchEnd] == input[candidateEnd])
+			{
+				matchEnd++;
+				candidateEnd++;
+			}
+
+			if (!WriteLZ4Sequence(input + anchor, matchStart - anchor, matchStart - candidate, matchEnd - matchStart, outputPos, outputEnd))
+				return 0;
+
+			anchor = matchEnd;
+			position = matchEnd;
+			if (matchEnd - 2 < matchStartLimit)
+			{
+				hashTable[HashLZ4Sequence(ReadUInt32(input + matchEnd - 2))] = (uint32_t)(matchEnd - 2);
+			}
+		}
+	}
+
+	if (!WriteLZ4Sequence(input + anchor, inputSize - anchor, 0, 0, outputPos, outputEnd))
+		return 0;
+	return (size_t)(outputPos - output);
+}
+
+int64_t DecompressLZ4(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputCapacity)
+{
+	const uint8_t* inputPos = input;
+	const uint8_t* inputEnd = input + inputSize;
+	uint8_t* outputPos = output;
+	uint8_t* outputEnd = output + outputCapacity;
+	auto readLength = [&](size_t length, size_t& out_length) -> bool
+		{
+			if (length == 15)
+			{
+				uint8_t lengthByte = 255;
+				while (lengthByte == 255)
+				{
+					if (inputPos >= inputEnd)
+						return false;
+					lengthByte = *inputPos++;
+					length += lengthByte;
+				}
+			}
+			out_length = length;
+			return true;
+		};
+
+	//most sequences are a few literals and a short match. with room to spare on both sides those are single fixed size
+	//copies with no length bytes and no clamping, everything else goes the careful way
+	while (inputPos < inputEnd)
+	{
+		uint8_t token = *inputPos++;
+		size_t numLiterals = token >> 4;
+		if (numLiterals < 15 && (size_t)(inputEnd - inputPos) >= LZ4_WILD_COPY_SIZE + 2 && (size_t)(outputEnd - outputPos) >= 3 * LZ4_WILD_COPY_SIZE)
+		{
+			memcpy(outputPos, inputPos, LZ4_WILD_COPY_SIZE);
+			outputPos += numLiterals;
+			inputPos += numLiterals;
+		}
+		else
+		{
+			if (!readLength(numLiterals, numLiterals) || (size_t)(inputEnd - inputPos) < numLiterals)
+				return -1;
+
+			size_t numLiteralsToCopy = numLiterals < (size_t)(outputEnd - outputPos) ? numLiterals : (size_t)(outputEnd - outputPos);
+			if (numLiterals + LZ4_WILD_COPY_SIZE <= (size_t)(outputEnd - outputPos) && numLiterals + LZ4_WILD_COPY_SIZE <= (size_t)(inputEnd - inputPos))
+			{
+				WildCopyLZ4(outputPos, inputPos, outputPos + numLiterals);
+				outputPos += numLiterals;
+			}
+			else if (numLiteralsToCopy > 0)
+			{
+				memcpy(outputPos, inputPos, numLiteralsToCopy);
+				outputPos += numLiteralsToCopy;
+			}
+			inputPos += numLiterals;
+			if (outputPos == outputEnd || inputPos == inputEnd)
+				break;
+		}
+
+		if (inputEnd - inputPos < 2)
+			return -1;
+		size_t offset = (size_t)inputPos[0] | ((size_t)inputPos[1] << 8);
+		inputPos += 2;
+		if (offset == 0 || offset > (size_t)(outputPos - output))
+			return -1;
+
+		size_t matchLength = token & 15;
+		if (matchLength < 15 && offset >= LZ4_WILD_COPY_SIZE && (size_t)(outputEnd - outputPos) >= 2 * LZ4_WILD_COPY_SIZE)
+		{
+			//at most 18 bytes, and the source is far enough back that neither copy overlaps
+			memcpy(outputPos, outputPos - offset, LZ4_WILD_COPY_SIZE);
+			memcpy(outputPos + LZ4_WILD_COPY_SIZE, outputPos - offset + LZ4_WILD_COPY_SIZE, 2);
+			outputPos += matchLength + LZ4_MIN_MATCH;
+			continue;
+		}
+
+		if (!readLength(matchLength, matchLength))
+			return -1;
+		matchLength += LZ4_MIN_MATCH;
+		if (matchLength > (size_t)(outputEnd - outputPos))
+		{
+			matchLength = (size_t)(outputEnd - outputPos);
+		}
+
+		//an overlapping match repeats its last offset bytes, so it can also be copied from any multiple of offset back.
+		//a few single bytes first get that distance to a full wild copy, after which the copies never overlap
+		uint8_t* matchEnd = outputPos + matchLength;
+		size_t copyDistance = offset < LZ4_WILD_COPY_SIZE ? offset * ((LZ4_WILD_COPY_SIZE + offset - 1) / offset) : offset;
+		if ((size_t)(outputEnd - matchEnd) >= LZ4_WILD_COPY_SIZE && copyDistance - offset < matchLength)
+		{
+			for (uint8_t* leadingEnd = outputPos + (copyDistance - offset); outputPos < leadingEnd; outputPos++)
+			{
+				*outputPos = *(outputPos - offset);
+			}
+			WildCopyLZ4(outputPos, outputPos - copyDistance, matchEnd);
+			outputPos = matchEnd;
+		}
+		else
+		{
+			for (; outputPos < matchEnd; outputPos++)
+			{
+				*outputPos = *(outputPos - offset);
+			}
+		}
+		if (outputPos == outputEnd)
+			break;
+	}
+
+	return (int64_t)(outputPos - output);
+}
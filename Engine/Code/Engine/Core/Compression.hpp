@@ -0,0 +1,16 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//lz4 block format (no frame, no checksums), so anything written here also decodes with the reference lz4 library.
+//fast enough to decompress at load time that it is cheaper than reading the extra bytes from disk
+
+//worst case output for incompressible input
+size_t GetLZ4CompressBound(size_t inputSize);
+
+//returns the compressed size, or 0 if it didn't fit in outputCapacity
+size_t CompressLZ4(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputCapacity);
+
+//decodes until the input runs out or the output is full, so a prefix of the data can be decoded on its own. returns
+//the bytes written, or -1 if the input is malformed. never reads or writes outside the two ranges
+int64_t DecompressLZ4(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputCapacity);
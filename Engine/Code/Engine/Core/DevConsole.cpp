@@ -3,15 +3,27 @@
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/EngineBenchmarks.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/BinaryLog.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/StatsRegistry.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/Clock.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Window.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/MeshSimplifier.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Network/RemoteConsole.hpp"
 #include "Engine/Network/NetSystem.hpp"
 #include <string>
+#include <stdarg.h>
 
 DevConsole* g_theConsole = nullptr;
 extern InputSystem* g_theInput;
@@ -20,8 +32,9 @@ constexpr float caretLineThickness = 1.5f;
 constexpr float caretBlinkTime = 0.5f;
 
 DevConsole::DevConsole(const DevConsoleConfig& config)
-	:m_config(config)
+	:m_config(config), m_logRing(config.m_logRingCapacity)
 {
+	m_lines.resize(m_config.m_maxLinesInHistory);
 }
 
 DevConsole::~DevConsole()
@@ -54,6 +67,26 @@ void DevConsole::Startup()
 	SubscribeEventCallbackFunction("debugrenderclear", Command_DebugRenderClear);
 	SubscribeEventCallbackFunction("debugrendertoggle", Command_DebugRenderToggle);
 	SubscribeEventCallbackFunction("exec_command_script", Command_ExecuteCommandScript);
+	SubscribeEventCallbackFunction("decode_binary_log", Command_DecodeBinaryLog);
+	SubscribeEventCallbackFunction("profile_report", Command_ProfileReport);
+	SubscribeEventCallbackFunction("profile_capture", Command_ProfileCapture);
+	SubscribeEventCallbackFunction("stats", Command_Stats);
+	SubscribeEventCallbackFunction("stats_csv", Command_StatsCSV);
+	SubscribeEventCallbackFunction("memory_budget", Command_MemoryBudget);
+	SubscribeEventCallbackFunction("memory_steady_state", Command_MemorySteadyState);
+	SubscribeEventCallbackFunction("build_pack_file", Command_BuildPackFile);
+	SubscribeEventCallbackFunction("bench_file_load", Command_BenchFileLoad);
+	SubscribeEventCallbackFunction("bench_image_load", Command_BenchImageLoad);
+	SubscribeEventCallbackFunction("bench_texture_cook", Command_BenchTextureCook);
+	SubscribeEventCallbackFunction("bench_pack_file", Command_BenchPackFile);
+	SubscribeEventCallbackFunction("bench_event_fire", Command_BenchEventFire);
+	SubscribeEventCallbackFunction("bench_frame_arena", Command_BenchFrameArena);
+	SubscribeEventCallbackFunction("bench_log_ring", Command_BenchLogRing);
+	SubscribeEventCallbackFunction("bench_event_args", Command_BenchEventArgs);
+	SubscribeEventCallbackFunction("bench_string_intern", Command_BenchStringIntern);
+	SubscribeEventCallbackFunction("bench_mesh_load", Command_BenchMeshLoad);
+	SubscribeEventCallbackFunction("bench_obj_import", Command_BenchObjImport);
+	SubscribeEventCallbackFunction("bench_mesh_lod", Command_BenchMeshLod);
 
 	if (m_remoteConsole)
 	{
@@ -67,6 +100,11 @@ void DevConsole::Startup()
 		SubscribeEventCallbackFunction("rc_cmd_blacklist", Command_AddToCmdBlacklist);
 	}
 
+	if (!m_config.m_binaryLogFilePath.empty())
+	{
+		BinaryLog::GetGlobalLog().OpenFile(m_config.m_binaryLogFilePath.c_str());
+	}
+
 	m_caretStopwatch.Start(&m_clock, caretBlinkTime);
 	m_commandHistory.resize(m_config.m_maxCommandHistory);
 
@@ -76,12 +114,16 @@ void DevConsole::Startup()
 
 void DevConsole::Shutdown()
 {
+	BinaryLog::GetGlobalLog().Flush(m_config.m_echoBinaryLog ? this : nullptr);
+	BinaryLog::GetGlobalLog().CloseFile();
+	ProcessPendingLines();
 	FileStream logDump;
 	logDump.OpenForWrite("Data/ConsoleDump.txt");
 	char newLine = '\n';
-	for (int i = 0; i < m_lines.size(); i++)
+	for (int i = 0; i < m_numLines; i++)
 	{
-		logDump.WriteBytes(m_lines[i].m_text.c_str(), m_lines[i].m_text.size());
+		const DevConsoleLine& line = GetHistoryLine(i);
+		logDump.WriteBytes(line.m_text.c_str(), line.m_text.size());
 		logDump.WriteBytes(&newLine, 1);
 	}
 	logDump.Close();
@@ -96,11 +138,32 @@ void DevConsole::Shutdown()
 	UnsubscribeEventCallbackFunction("KeyPressed", Event_KeyPressed);
 	UnsubscribeEventCallbackFunction("CharInput", Event_CharInput);
 	UnsubscribeEventCallbackFunction("exec_command_script", Command_ExecuteCommandScript);
+	UnsubscribeEventCallbackFunction("decode_binary_log", Command_DecodeBinaryLog);
+	UnsubscribeEventCallbackFunction("profile_report", Command_ProfileReport);
+	UnsubscribeEventCallbackFunction("profile_capture", Command_ProfileCapture);
+	UnsubscribeEventCallbackFunction("stats", Command_Stats);
+	UnsubscribeEventCallbackFunction("stats_csv", Command_StatsCSV);
+	UnsubscribeEventCallbackFunction("memory_budget", Command_MemoryBudget);
+	UnsubscribeEventCallbackFunction("memory_steady_state", Command_MemorySteadyState);
+	UnsubscribeEventCallbackFunction("build_pack_file", Command_BuildPackFile);
+	UnsubscribeEventCallbackFunction("bench_file_load", Command_BenchFileLoad);
+	UnsubscribeEventCallbackFunction("bench_image_load", Command_BenchImageLoad);
+	UnsubscribeEventCallbackFunction("bench_texture_cook", Command_BenchTextureCook);
+	UnsubscribeEventCallbackFunction("bench_pack_file", Command_BenchPackFile);
+	UnsubscribeEventCallbackFunction("bench_event_fire", Command_BenchEventFire);
+	UnsubscribeEventCallbackFunction("bench_frame_arena", Command_BenchFrameArena);
+	UnsubscribeEventCallbackFunction("bench_log_ring", Command_BenchLogRing);
+	UnsubscribeEventCallbackFunction("bench_event_args", Command_BenchEventArgs);
+	UnsubscribeEventCallbackFunction("bench_string_intern", Command_BenchStringIntern);
+	UnsubscribeEventCallbackFunction("bench_mesh_load", Command_BenchMeshLoad);
+	UnsubscribeEventCallbackFunction("bench_obj_import", Command_BenchObjImport);
+	UnsubscribeEventCallbackFunction("bench_mesh_lod", Command_BenchMeshLod);
 }
 
 void DevConsole::BeginFrame()
 {
 	m_frameNumber++;
+	ProcessPendingLines();
 	if (m_caretStopwatch.CheckDurationElapsedAndDecrement())
 	{
 		m_canRenderCaret = !m_canRenderCaret;
@@ -117,7 +180,8 @@ void DevConsole::BeginFrame()
 
 void DevConsole::EndFrame()
 {
-
+	BinaryLog::GetGlobalLog().Flush(m_config.m_echoBinaryLog ? this : nullptr);
+	ProcessPendingLines();
 }
 
 void DevConsole::Execute(const std::string& consoleCommandText)
@@ -146,18 +210,57 @@ void DevConsole::Execute(const std::string& consoleCommandText)
 
 void DevConsole::AddLine(const Rgba8& color, const std::string& text)
 {
-	DevConsoleLine line;
-	line.m_text = text;
-	line.m_textColor = color;
-	line.m_frameNumber = m_frameNumber;
+	MEMORY_TAG_SCOPE(MemoryTag::CONSOLE)
+	m_logRing.Push(color, m_frameNumber.load(), text.c_str(), (int)text.size());
+}
+
+void DevConsole::AddLineFormatted(const Rgba8& color, char const* format, ...)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::CONSOLE)
+	va_list variableArgumentList;
+	va_start(variableArgumentList, format);
+	m_logRing.PushFormatted(color, m_frameNumber.load(), format, variableArgumentList);
+	va_end(variableArgumentList);
+}
+
+void DevConsole::ProcessPendingLines()
+{
+	MEMORY_TAG_SCOPE(MemoryTag::CONSOLE)
+	//single consumer of the log ring, everything else reads the history
+	std::string longLine;
+	const LogRecord* record = m_logRing.BeginPop();
+	while (record)
+	{
+		//a line split over several records is already complete in the ring once its first record can be popped
+		if (record->m_continuesInNextRecord || !longLine.empty())
+		{
+			longLine.append(record->m_text, record->m_textLength);
+			if (!record->m_continuesInNextRecord)
+			{
+				AddLineToHistory(record->m_color, longLine.c_str(), (int)longLine.size(), record->m_frameNumber);
+				longLine.clear();
+			}
+		}
+		else
+		{
+			AddLineToHistory(record->m_color, record->m_text, record->m_textLength, record->m_frameNumber);
+		}
+		m_logRing.EndPop();
+		record = m_logRing.BeginPop();
+	}
 
-	m_devConsoleLineMutex.lock();
-	m_lines.push_back(line);
-	m_devConsoleLineMutex.unlock();
+	unsigned int numDroppedLines = m_logRing.GetNumDropped();
+	if (numDroppedLines != m_numDroppedLinesReported)
+	{
+		std::string droppedWarning = Stringf("%u console lines dropped, log ring full", numDroppedLines - m_numDroppedLinesReported);
+		AddLineToHistory(WARNING, droppedWarning.c_str(), (int)droppedWarning.size(), m_frameNumber.load());
+		m_numDroppedLinesReported = numDroppedLines;
+	}
 }
 
 void DevConsole::Render(const AABB2& bounds, Renderer* rendererOverride) const
 {
+	MEMORY_TAG_SCOPE(MemoryTag::CONSOLE)
 	switch (m_mode)
 	{
 	case DevConsoleMode::OPEN_FULL:
@@ -176,7 +279,40 @@ void DevConsole::Render(const AABB2& bounds, Renderer* rendererOverride) const
 
 void DevConsole::RemoveAllLines()
 {
-	m_lines.clear();
+	ProcessPendingLines();
+	m_oldestLineIndex = 0;
+	m_numLines = 0;
+}
+
+void DevConsole::AddLineToHistory(const Rgba8& color, const char* text, int textLength, int frameNumber)
+{
+	int maxLines = (int)m_lines.size();
+	if (maxLines == 0)
+		return;
+
+	int writeIndex = 0;
+	if (m_numLines < maxLines)
+	{
+		writeIndex = (m_oldestLineIndex + m_numLines) % maxLines;
+		m_numLines++;
+	}
+	else
+	{
+		writeIndex = m_oldestLineIndex;
+		m_oldestLineIndex = (m_oldestLineIndex + 1) % maxLines;
+	}
+
+	//reuses the string's capacity once the history has wrapped
+	DevConsoleLine& line = m_lines[writeIndex];
+	line.m_text.assign(text, textLength);
+	line.m_textColor = color;
+	line.m_frameNumber = frameNumber;
+	m_totalLinesAdded++;
+}
+
+const DevConsoleLine& DevConsole::GetHistoryLine(int lineIndex) const
+{
+	return m_lines[(m_oldestLineIndex + lineIndex) % (int)m_lines.size()];
 }
 
 void DevConsole::ProcessCharacterCode(int charCode)
@@ -345,38 +481,45 @@ RemoteConsole* DevConsole::GetRemoteConsole() const
 	return m_remoteConsole;
 }
 
-int DevConsole::GetDevConsoleLineCount() const
+int DevConsole::GetDevConsoleLineCount()
 {
-	return static_cast<int>(m_lines.size());
+	ProcessPendingLines();
+	return m_totalLinesAdded;
 }
 
-Strings DevConsole::GetLastDevConsoleLines(int numLines) const
+Strings DevConsole::GetLastDevConsoleLines(int numLines)
 {
+	ProcessPendingLines();
 	Strings lines;
-	int lineIndex = static_cast<int>(m_lines.size()) - 1;
+	int lineIndex = m_numLines - 1;
 	int linesAdded = 0;
 	while (linesAdded < numLines)
 	{
 		if (lineIndex < 0)
 			break;
 
-		lines.push_back(m_lines[lineIndex--].m_text);
+		lines.push_back(GetHistoryLine(lineIndex--).m_text);
 		linesAdded++;
 	}
 
 	return lines;
 }
 
+const LogRingBuffer& DevConsole::GetLogRing() const
+{
+	return m_logRing;
+}
+
 void DevConsole::Render_OpenFull(const AABB2& bounds, Renderer& renderer, BitmapFont& font, float fontAspect) const
 {
 	renderer.SetBlendMode(BlendMode::ALPHA);
 
-	int maxLines = m_config.m_maxLinesToPrint < m_lines.size() ? m_config.m_maxLinesToPrint : (int)m_lines.size();
+	int maxLines = m_config.m_maxLinesToPrint < m_numLines ? m_config.m_maxLinesToPrint : m_numLines;
 	float textCellHeight = m_config.m_fontCellHeight;
 	if (bounds.m_maxs.y < (maxLines * m_config.m_fontCellHeight))
 		textCellHeight *= bounds.m_maxs.y / (maxLines * m_config.m_fontCellHeight);
 
-	std::vector<Vertex_PCU> verts;
+	FrameVector<Vertex_PCU> verts;
 	//add verts for dev console BG
 	AddVertsForAABB2D(verts, bounds, Rgba8(0, 0, 0, 127));
 
@@ -397,15 +540,14 @@ void DevConsole::Render_OpenFull(const AABB2& bounds, Renderer& renderer, Bitmap
 	renderer.DrawVertexArray((int)verts.size(), verts.data());
 	
 	verts.clear();
-	int startLine = Clamp(int(m_lines.size() - maxLines), 0, int(m_lines.size()));
+	int startLine = Clamp(m_numLines - maxLines, 0, m_numLines);
 	for (int i = 0; i < maxLines; i++)
 	{
 		AABB2 textBox;
 		textBox.m_mins = Vec2(bounds.m_mins.x, (maxLines - i) * textCellHeight);
 		textBox.m_maxs = Vec2(bounds.m_maxs.x, textBox.m_mins.y + textCellHeight);
-		std::string textToPrint = m_lines[startLine + i].m_text;
-		Rgba8 textColor = m_lines[startLine + i].m_textColor;
-		font.AddVertsForTextInBox2D(verts, textBox, textCellHeight, textToPrint, textColor,
+		const DevConsoleLine& line = GetHistoryLine(startLine + i);
+		font.AddVertsForTextInBox2D(verts, textBox, textCellHeight, line.m_text, line.m_textColor,
 			fontAspect, Vec2::ZERO);
 	}
 	font.AddVertsForTextInBox2D(verts, inputBox, textCellHeight, m_inputText, Rgba8::WHITE, fontAspect, Vec2::ZERO);
@@ -484,6 +626,375 @@ bool DevConsole::Command_ExecuteCommandScript(EventArgs& args)
 	return false;
 }
 
+bool DevConsole::Command_DecodeBinaryLog(EventArgs& args)
+{
+	std::string binaryLogPath = args.GetValue("path", g_theConsole->m_config.m_binaryLogFilePath.c_str());
+	std::string textOutputPath = args.GetValue("output", (binaryLogPath + ".txt").c_str());
+	if (DecodeBinaryLogFile(binaryLogPath, textOutputPath))
+	{
+		g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("Decoded %s to %s", binaryLogPath.c_str(), textOutputPath.c_str()));
+	}
+	else
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Failed to decode binary log %s", binaryLogPath.c_str()));
+	}
+	return false;
+}
+
+bool DevConsole::Command_ProfileReport(EventArgs& args)
+{
+	Profiler::GetGlobalProfiler().PrintLastFrameReport(*g_theConsole, (float)atof(args.GetValue("min", "0").c_str()));
+	return false;
+}
+
+bool DevConsole::Command_ProfileCapture(EventArgs& args)
+{
+	int numFrames = atoi(args.GetValue("frames", "60").c_str());
+	std::string outputPath = args.GetValue("path", "Data/ProfileCapture.json");
+	Profiler::GetGlobalProfiler().StartCapture(numFrames, outputPath);
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("Capturing %d frames to %s", numFrames, outputPath.c_str()));
+	return false;
+}
+
+bool DevConsole::Command_Stats(EventArgs& args)
+{
+	StatsRegistry::GetGlobalRegistry().PrintToConsole(*g_theConsole, args.GetValue("name", ""));
+	return false;
+}
+
+bool DevConsole::Command_StatsCSV(EventArgs& args)
+{
+	std::string outputPath = args.GetValue("path", "Data/Stats.csv");
+	StatsRegistry::GetGlobalRegistry().ExportCSV(outputPath);
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("Exported stats to %s", outputPath.c_str()));
+	return false;
+}
+
+bool DevConsole::Command_MemoryBudget(EventArgs& args)
+{
+	//"memory_budget tag=particles kb=2048" sets a budget, 0 clears it. with no tag it just prints the table
+	std::string tagName = args.GetValue("tag", "");
+	if (!tagName.empty())
+	{
+		MemoryTag tag = MemoryTag::UNTAGGED;
+		if (!GetMemoryTagFromName(tagName, tag))
+		{
+			g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Unknown memory tag %s", tagName.c_str()));
+			return false;
+		}
+		int64_t budgetBytes = (int64_t)(atof(args.GetValue("kb", "0").c_str()) * 1024.0);
+		MemoryTracker::GetGlobalTracker().SetBudget(tag, budgetBytes);
+	}
+	MemoryTracker::GetGlobalTracker().PrintBudgetTable(*g_theConsole);
+	return false;
+}
+
+bool DevConsole::Command_MemorySteadyState(EventArgs& args)
+{
+	std::string tagName = args.GetValue("tag", "");
+	MemoryTag tag = MemoryTag::UNTAGGED;
+	if (!GetMemoryTagFromName(tagName, tag))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Unknown memory tag %s", tagName.c_str()));
+		return false;
+	}
+
+	if (args.GetValue("off", "false") == "true")
+	{
+		MemoryTracker::GetGlobalTracker().DisarmSteadyStateCheck(tag);
+		g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("Stopped checking %s for steady state allocations", GetMemoryTagName(tag)));
+		return false;
+	}
+
+	int warmupFrames = atoi(args.GetValue("warmup", "0").c_str());
+	MemoryTracker::GetGlobalTracker().ArmSteadyStateCheck(tag, warmupFrames);
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("Any %s allocation after %d frames is now an error", GetMemoryTagName(tag), warmupFrames));
+	return false;
+}
+
+bool DevConsole::Command_BuildPackFile(EventArgs& args)
+{
+	//"build_pack_file dir=Data path=Data.pack", mount the result with MountPackFile on the next run
+	std::string directoryPath = args.GetValue("dir", "Data");
+	std::string packFilePath = args.GetValue("path", "Data.pack");
+	pack_file_options options;
+	options.m_compress = args.GetValue("compress", "true") == "true";
+	if (WritePackFileFromDirectory(packFilePath.c_str(), directoryPath.c_str(), options))
+	{
+		g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("Packed %s into %s", directoryPath.c_str(), packFilePath.c_str()));
+	}
+	else
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Failed to write pack file %s", packFilePath.c_str()));
+	}
+	return false;
+}
+
+bool DevConsole::Command_BenchFileLoad(EventArgs& args)
+{
+	//"bench_file_load path=Data/Big.bin repeats=4", best of the repeats
+	std::string filePath = args.GetValue("path", "");
+	int repeats = atoi(args.GetValue("repeats", "4").c_str());
+	FileLoadBenchmarkResults results;
+	if (!RunFileLoadBenchmark(filePath, repeats, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Couldn't benchmark loading %s", filePath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%s, %.1f MB: FileReadToBuffer %.0f MB/s, MappedFile in place %.0f MB/s", filePath.c_str(), results.m_fileSizeMB,
+		results.m_readToBufferMBPerSecond, results.m_mappedInPlaceMBPerSecond));
+	return false;
+}
+
+bool DevConsole::Command_BenchImageLoad(EventArgs& args)
+{
+	//"bench_image_load dir=Data/Images repeats=1"
+	std::string directoryPath = args.GetValue("dir", "Data/Images");
+	int repeats = atoi(args.GetValue("repeats", "1").c_str());
+	ImageLoadBenchmarkResults results;
+	if (!RunImageLoadBenchmark(directoryPath, g_theConsole->m_config.m_jobSystem, repeats, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("No images to benchmark under %s", directoryPath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d images, %.1f MB of texels: %.1f ms on this thread, %.1f ms on the job system", results.m_numImages,
+		results.m_totalTexelMB, results.m_serialMilliseconds, results.m_jobSystemMilliseconds));
+	return false;
+}
+
+bool DevConsole::Command_BenchTextureCook(EventArgs& args)
+{
+	//"bench_texture_cook path=Data/Images/Test.png format=bc7 refine=2"
+	std::string imageFilePath = args.GetValue("path", "");
+	std::string formatName = args.GetValue("format", "bc7");
+	int refinementPasses = atoi(args.GetValue("refine", "2").c_str());
+	eTextureFormat format = eTextureFormat::BC7_UNORM;
+	if (formatName == "bc1")
+	{
+		format = eTextureFormat::BC1_UNORM;
+	}
+	else if (formatName == "bc3")
+	{
+		format = eTextureFormat::BC3_UNORM;
+	}
+	else if (formatName != "bc7")
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Unknown format %s, use bc1, bc3 or bc7", formatName.c_str()));
+		return false;
+	}
+
+	TextureCookBenchmarkResults results;
+	if (!RunTextureCookBenchmark(imageFilePath, format, refinementPasses, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Couldn't benchmark cooking %s", imageFilePath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%s %dx%d %s: %.2f Mpix/s, %.1f dB, mips %.2f ms box %.2f ms kaiser", imageFilePath.c_str(), results.m_width,
+		results.m_height, formatName.c_str(), results.m_encodeMegapixelsPerSecond, results.m_psnr, results.m_boxMipsMilliseconds, results.m_kaiserMipsMilliseconds));
+	return false;
+}
+
+bool DevConsole::Command_BenchPackFile(EventArgs& args)
+{
+	//"bench_pack_file dir=Data path=Data.pack repeats=3", only with no pack mounted
+	std::string directoryPath = args.GetValue("dir", "Data");
+	std::string packFilePath = args.GetValue("path", "Data.pack");
+	int repeats = atoi(args.GetValue("repeats", "3").c_str());
+	PackFileBenchmarkResults results;
+	if (!RunPackFileBenchmark(directoryPath, packFilePath, repeats, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Couldn't benchmark %s against %s, is a pack already mounted?", packFilePath.c_str(), directoryPath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d files, %.1f MB: loose %.1f ms, %s %.1f ms", results.m_numFiles, results.m_totalMB, results.m_looseMilliseconds,
+		packFilePath.c_str(), results.m_packMilliseconds));
+	return false;
+}
+
+bool DevConsole::Command_BenchEventFire(EventArgs& args)
+{
+	//"bench_event_fire threads=8 fires=1000000", fires per thread at every thread count up to threads
+	int maxThreads = atoi(args.GetValue("threads", "8").c_str());
+	int firesPerThread = atoi(args.GetValue("fires", "1000000").c_str());
+	EventFireBenchmarkResults results;
+	bool everyFireReachedItsSubscribers = RunEventFireBenchmark(maxThreads, firesPerThread, results);
+	if (results.m_numEvents == 0)
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "Usage: bench_event_fire threads=8 fires=1000000");
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d events, %d subscription changes while firing, %.2f allocations per fire", results.m_numEvents,
+		results.m_numSubscriptionChanges, results.m_allocationsPerFire));
+	for (int threadIndex = 0; threadIndex < results.m_byIDFiresPerSecond.size(); threadIndex++)
+	{
+		g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("%d threads: by id %.2f M fires/s, by name %.2f M fires/s", threadIndex + 1,
+			results.m_byIDFiresPerSecond[threadIndex] / 1000000.0, results.m_byNameFiresPerSecond[threadIndex] / 1000000.0));
+	}
+	if (!everyFireReachedItsSubscribers)
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "Some fires missed a subscriber while the lists were being swapped");
+	}
+	return false;
+}
+
+bool DevConsole::Command_BenchFrameArena(EventArgs& args)
+{
+	//"bench_frame_arena boxes=200 frames=300", text boxes drawn with the console font
+	int numTextBoxes = atoi(args.GetValue("boxes", "200").c_str());
+	int numFrames = atoi(args.GetValue("frames", "300").c_str());
+	FrameArenaBenchmarkResults results;
+	if (!g_theConsole->m_textFont || !RunFrameArenaBenchmark(*g_theConsole->m_textFont, numTextBoxes, numFrames, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "Usage: bench_frame_arena boxes=200 frames=300");
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d boxes, %d verts per frame: std::vector %.3f ms and %.1f allocations, FrameVector %.3f ms and %.1f allocations",
+		numTextBoxes, results.m_numVertsPerFrame, results.m_vectorMillisecondsPerFrame, results.m_vectorAllocationsPerFrame, results.m_arenaMillisecondsPerFrame,
+		results.m_arenaAllocationsPerFrame));
+	return false;
+}
+
+bool DevConsole::Command_BenchLogRing(EventArgs& args)
+{
+	//"bench_log_ring threads=16 lines=100000 capacity=4096 drain_ms=16", drain_ms=0 drains as fast as it can
+	int numThreads = atoi(args.GetValue("threads", "16").c_str());
+	int linesPerThread = atoi(args.GetValue("lines", "100000").c_str());
+	int ringCapacity = atoi(args.GetValue("capacity", "4096").c_str());
+	int drainIntervalMilliseconds = atoi(args.GetValue("drain_ms", "16").c_str());
+	LogRingBenchmarkResults results;
+	bool countersMatch = RunLogRingBenchmark(numThreads, linesPerThread, ringCapacity, drainIntervalMilliseconds, results);
+	if (results.m_numLinesLogged == 0)
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "Usage: bench_log_ring threads=16 lines=100000 capacity=4096 drain_ms=16, capacity a power of two");
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d threads, %d lines: %.2f M lines/s, %d popped, %u dropped, %u truncated", numThreads, results.m_numLinesLogged,
+		results.m_linesPerSecond / 1000000.0, results.m_numLinesPopped, results.m_numDropped, results.m_numTruncated));
+	if (!countersMatch)
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "The ring's counters don't add up to the lines logged");
+	}
+	return false;
+}
+
+bool DevConsole::Command_BenchEventArgs(EventArgs& args)
+{
+	//"bench_event_args iterations=1000000"
+	int iterations = atoi(args.GetValue("iterations", "1000000").c_str());
+	EventArgsBenchmarkResults results;
+	if (!RunEventArgsBenchmark(iterations, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "Usage: bench_event_args iterations=1000000");
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("3 argument EventArgs built and read: %.1f ns and %.2f allocations per iteration", results.m_nanosecondsPerIteration,
+		results.m_allocationsPerIteration));
+	return false;
+}
+
+bool DevConsole::Command_BenchStringIntern(EventArgs& args)
+{
+	//"bench_string_intern keys=64 lookups=1000000"
+	int numKeys = atoi(args.GetValue("keys", "64").c_str());
+	int numLookups = atoi(args.GetValue("lookups", "1000000").c_str());
+	StringInternBenchmarkResults results;
+	if (!RunStringInternBenchmark(numKeys, numLookups, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "Usage: bench_string_intern keys=64 lookups=1000000");
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d keys, ns and allocations per map lookup:", results.m_numKeys));
+	g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("copied std::string key %.1f ns, %.2f allocations", results.m_copiedKeyFindNanoseconds, results.m_copiedKeyFindAllocations));
+	g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("interned key from std::string %.1f ns, %.2f allocations", results.m_stringFindNanoseconds, results.m_stringFindAllocations));
+	g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("prebuilt interned key %.1f ns, %.2f allocations", results.m_prebuiltKeyFindNanoseconds, results.m_prebuiltKeyFindAllocations));
+	g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("interned key equality %.2f ns", results.m_keyEqualityNanoseconds));
+	return false;
+}
+
+bool DevConsole::Command_BenchMeshLoad(EventArgs& args)
+{
+	//"bench_mesh_load obj=Data/Models/Test.obj mesh=Data/Models/Test.mesh repeats=5", mesh is cooked from obj if missing
+	std::string objFilePath = args.GetValue("obj", "");
+	std::string meshFilePath = args.GetValue("mesh", "");
+	int repeats = atoi(args.GetValue("repeats", "5").c_str());
+	MeshLoadBenchmarkResults results;
+	if (!RunMeshLoadBenchmark(objFilePath, meshFilePath, g_theConsole->m_config.m_jobSystem, repeats, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Couldn't benchmark loading %s against %s, do both hold the same mesh?", objFilePath.c_str(), meshFilePath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%d verts, %d indices, obj %.1f MB, mesh %.1f MB", results.m_numVertices, results.m_numIndices, results.m_objFileMB,
+		results.m_meshFileMB));
+	g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("OBJ import %.2f ms, MeshBuilder::Load %.2f ms, MeshFileView %.3f ms verified, %.3f ms unverified",
+		results.m_objImportMilliseconds, results.m_meshBuilderLoadMilliseconds, results.m_verifiedViewMilliseconds, results.m_unverifiedViewMilliseconds));
+	return false;
+}
+
+bool DevConsole::Command_BenchObjImport(EventArgs& args)
+{
+	//"bench_obj_import path=Data/Models/ObjImportBench.obj grid=600 repeats=3", the grid is only written if path doesn't exist
+	std::string objFilePath = args.GetValue("path", "Data/Models/ObjImportBench.obj");
+	int gridSize = atoi(args.GetValue("grid", "600").c_str());
+	int repeats = atoi(args.GetValue("repeats", "3").c_str());
+	ObjImportBenchmarkResults results;
+	bool outputsMatch = RunObjImportBenchmark(objFilePath, gridSize, g_theConsole->m_config.m_jobSystem, repeats, results);
+	if (results.m_fileSizeMB == 0.0)
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Couldn't read or write %s", objFilePath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%s%s, %.1f MB, %d tris: this thread %.1f MB/s %.2f M tris/s, job system %.1f MB/s %.2f M tris/s", objFilePath.c_str(),
+		results.m_wroteGridFile ? " (written)" : "", results.m_fileSizeMB, results.m_numTriangles, results.m_serialMBPerSecond, results.m_serialTrianglesPerSecond / 1000000.0,
+		results.m_jobSystemMBPerSecond, results.m_jobSystemTrianglesPerSecond / 1000000.0));
+	if (!outputsMatch)
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, "The chunked import doesn't match the single threaded one");
+	}
+	return false;
+}
+
+bool DevConsole::Command_BenchMeshLod(EventArgs& args)
+{
+	//"bench_mesh_lod path=Data/Models/MeshLodBench.obj segments=300 lods=4 ratio=0.5 max_error=0.02 lock_borders=false repeats=3",
+	//the torus is only written if path doesn't exist. errors are fractions of the mesh's extent
+	std::string objFilePath = args.GetValue("path", "Data/Models/MeshLodBench.obj");
+	int torusSegments = atoi(args.GetValue("segments", "300").c_str());
+	mesh_lod_options lodOptions;
+	lodOptions.m_numLods = atoi(args.GetValue("lods", "4").c_str());
+	lodOptions.m_triangleRatio = (float)atof(args.GetValue("ratio", "0.5").c_str());
+	lodOptions.m_maxError = (float)atof(args.GetValue("max_error", "0.02").c_str());
+	lodOptions.m_lockBorders = args.GetValue("lock_borders", "false") == "true";
+	int repeats = atoi(args.GetValue("repeats", "3").c_str());
+	MeshLodBenchmarkResults results;
+	if (!RunMeshLodBenchmark(objFilePath, torusSegments, lodOptions, repeats, results))
+	{
+		g_theConsole->AddLine(g_theConsole->ERRORTEXT, Stringf("Couldn't read or write %s", objFilePath.c_str()));
+		return false;
+	}
+
+	g_theConsole->AddLine(g_theConsole->INFO_MAJOR, Stringf("%s%s, %d tris: %d lods in %.2f ms, %.2f M tris/s", objFilePath.c_str(), results.m_wroteTorusFile ? " (written)" : "",
+		results.m_numTriangles, (int)results.m_lodTriangles.size() + 1, results.m_generateLodsMilliseconds, results.m_millionTrianglesPerSecond));
+	for (int lodIndex = 0; lodIndex < results.m_lodTriangles.size(); lodIndex++)
+	{
+		float reportedError = results.m_lodReportedErrors[lodIndex];
+		float measuredError = results.m_lodMeasuredErrors[lodIndex];
+		g_theConsole->AddLine(measuredError > reportedError ? g_theConsole->WARNING : g_theConsole->INFO_MINOR, Stringf("  lod %d: %d tris, error reported %.5f measured %.5f",
+			lodIndex + 1, results.m_lodTriangles[lodIndex], reportedError, measuredError));
+	}
+	return false;
+}
+
 bool DevConsole::Command_JoinHost(EventArgs& args)
 {
 	std::string hostAddressString = args.GetValue("addr", "");
@@ -575,8 +1086,8 @@ void DevConsole::ExecuteXmlCommandScriptNode(const XmlElement& commandScriptXmlE
 
 void DevConsole::ExecuteXmlCommandScriptFile(const std::string& commandScriptFilepath)
 {
-	tinyxml2::XMLDocument doc;
-	tinyxml2::XMLError status = doc.LoadFile(commandScriptFilepath.c_str());
+	XmlDocument doc;
+	tinyxml2::XMLError status = LoadXmlDocument(doc, commandScriptFilepath);
 	GUARANTEE_OR_DIE(status == tinyxml2::XML_SUCCESS, "Failed to load command script xml file");
 	tinyxml2::XMLElement* rootElement = doc.FirstChildElement();
 	ExecuteXmlCommandScriptNode(*rootElement);
@@ -1,8 +1,9 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <mutex>
+#include <atomic>
 #include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/LogRingBuffer.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Stopwatch.hpp"
 #include "Engine/Math/IntVec2.hpp"
@@ -11,6 +12,7 @@
 
 struct AABB2;
 class Renderer;
+class JobSystem;
 class BitmapFont;
 class NamedStrings;
 class RemoteConsole;
@@ -38,6 +40,11 @@ struct DevConsoleConfig
 	float m_fontCellHeight = 0.f;
 	int m_maxLinesToPrint = 10;
 	int m_maxCommandHistory = 128;
+	int m_logRingCapacity = 4096;				//power of two, lines logged between two drains beyond this are dropped
+	int m_maxLinesInHistory = 4096;
+	std::string m_binaryLogFilePath;			//empty to keep the binary log in memory only
+	bool m_echoBinaryLog = true;				//format binary log records into console lines when draining them
+	JobSystem* m_jobSystem = nullptr;			//the image, mesh and obj benchmarks also run on it when set
 };
 
 class DevConsole
@@ -52,14 +59,17 @@ public:
 
 	void Execute(const std::string& consoleCommandText);
 	void AddLine(const Rgba8& color, const std::string& text);
+	void AddLineFormatted(const Rgba8& color, char const* format, ...);
+	void ProcessPendingLines();
 	void Render(const AABB2& bounds, Renderer* rendererOverride = nullptr) const;
 
 	DevConsoleMode GetMode() const;
 	void SetMode(DevConsoleMode mode);
 	void ToggleMode(DevConsoleMode mode);
 	RemoteConsole* GetRemoteConsole() const;
-	int GetDevConsoleLineCount() const;
-	Strings GetLastDevConsoleLines(int numLines) const;
+	int GetDevConsoleLineCount();
+	Strings GetLastDevConsoleLines(int numLines);
+	const LogRingBuffer& GetLogRing() const;
 
 	Rgba8 ERRORTEXT;
 	Rgba8 WARNING;
@@ -70,6 +80,8 @@ public:
 protected:
 	void Render_OpenFull(const AABB2& bounds, Renderer& renderer, BitmapFont& font, float fontAspect = 1.f) const;
 	void RemoveAllLines();
+	void AddLineToHistory(const Rgba8& color, const char* text, int textLength, int frameNumber);
+	const DevConsoleLine& GetHistoryLine(int lineIndex) const;
 	void ProcessCharacterCode(int charCode);
 	void AddCharacterToInputStream(int charCode);
 	void PasteDataToInputStream(const std::string& pasteData);
@@ -89,6 +101,26 @@ protected:
 	static bool Command_DebugRenderClear(EventArgs& args);
 	static bool Command_DebugRenderToggle(EventArgs& args);
 	static bool Command_ExecuteCommandScript(EventArgs& args);
+	static bool Command_DecodeBinaryLog(EventArgs& args);
+	static bool Command_ProfileReport(EventArgs& args);
+	static bool Command_ProfileCapture(EventArgs& args);
+	static bool Command_Stats(EventArgs& args);
+	static bool Command_StatsCSV(EventArgs& args);
+	static bool Command_MemoryBudget(EventArgs& args);
+	static bool Command_MemorySteadyState(EventArgs& args);
+	static bool Command_BuildPackFile(EventArgs& args);
+	static bool Command_BenchFileLoad(EventArgs& args);
+	static bool Command_BenchImageLoad(EventArgs& args);
+	static bool Command_BenchTextureCook(EventArgs& args);
+	static bool Command_BenchPackFile(EventArgs& args);
+	static bool Command_BenchEventFire(EventArgs& args);
+	static bool Command_BenchFrameArena(EventArgs& args);
+	static bool Command_BenchLogRing(EventArgs& args);
+	static bool Command_BenchEventArgs(EventArgs& args);
+	static bool Command_BenchStringIntern(EventArgs& args);
+	static bool Command_BenchMeshLoad(EventArgs& args);
+	static bool Command_BenchObjImport(EventArgs& args);
+	static bool Command_BenchMeshLod(EventArgs& args);
 
 	//remote console commands
 	static bool Command_JoinHost(EventArgs& args);
@@ -103,9 +135,13 @@ protected:
 protected:
 	DevConsoleConfig m_config;
 	DevConsoleMode m_mode = DevConsoleMode::HIDDEN;
-	std::vector<DevConsoleLine> m_lines;
-	std::mutex m_devConsoleLineMutex;
-	int m_frameNumber = 0;
+	LogRingBuffer m_logRing;
+	std::vector<DevConsoleLine> m_lines;			//circular, only touched by the thread that drains the log ring
+	int m_oldestLineIndex = 0;
+	int m_numLines = 0;
+	int m_totalLinesAdded = 0;
+	unsigned int m_numDroppedLinesReported = 0;
+	std::atomic<int> m_frameNumber{ 0 };
 	BitmapFont* m_textFont = nullptr;
 	Clock m_clock;
 	std::string m_inputText;
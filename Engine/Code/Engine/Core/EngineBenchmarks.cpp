@@ -0,0 +1,1068 @@
+#include "Engine/Core/EngineBenchmarks.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/LogRingBuffer.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/TextureCooker.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctype.h>
+#include <filesystem>
+#include <float.h>
+#include <map>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+constexpr int NUM_BENCHMARK_EVENTS = 200;
+constexpr int NUM_SUBSCRIBERS_PER_BENCHMARK_EVENT = 2;
+
+static thread_local int64_t t_numBenchmarkEventCallbacks = 0;
+
+static int64_t GetTotalTrackedAllocations()
+{
+	//every tag on every thread, -1 when tracking is compiled out
+	if (!MemoryTracker::IsEnabled())
+		return -1;
+
+	int64_t totalAllocations = 0;
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		totalAllocations += MemoryTracker::GetGlobalTracker().GetTagStats((MemoryTag)tagIndex).m_totalAllocations;
+	}
+	return totalAllocations;
+}
+
+static void ListFilesInDirectory(const std::string& directoryPath, std::vector<std::string>& out_filePaths)
+{
+	//sorted so every run reads the same files in the same order
+	out_filePaths.clear();
+	std::error_code errorCode;
+	for (std::filesystem::recursive_directory_iterator fileIter(directoryPath, errorCode), endIter; !errorCode && fileIter != endIter; fileIter.increment(errorCode))
+	{
+		if (fileIter->is_regular_file(errorCode))
+		{
+			out_filePaths.push_back(fileIter->path().generic_string());
+		}
+		errorCode.clear();
+	}
+	std::sort(out_filePaths.begin(), out_filePaths.end());
+}
+
+static bool IsImageFilePath(const std::string& filePath)
+{
+	std::string extension = std::filesystem::path(filePath).extension().string();
+	for (int i = 0; i < extension.size(); i++)
+	{
+		extension[i] = (char)tolower((unsigned char)extension[i]);
+	}
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+static double ReadAllFiles(const std::vector<std::string>& filePaths, std::vector<uint8_t>& scratchBuffer, size_t& out_totalBytes)
+{
+	out_totalBytes = 0;
+	double startTime = GetCurrentTimeSeconds();
+	for (int i = 0; i < filePaths.size(); i++)
+	{
+		if (TryFileReadToBuffer(scratchBuffer, filePaths[i]))
+		{
+			out_totalBytes += scratchBuffer.size();
+		}
+	}
+	return (GetCurrentTimeSeconds() - startTime) * 1000.0;
+}
+
+bool RunFileLoadBenchmark(const std::string& filePath, int repeats, FileLoadBenchmarkResults& out_results)
+{
+	out_results = FileLoadBenchmarkResults();
+	int64_t fileSize = GetFileSizeInBytes(filePath);
+	if (fileSize <= 0)
+		return false;
+
+	double bestReadSeconds = 0.0;
+	double bestMappedSeconds = 0.0;
+	std::vector<uint8_t> buffer;
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		double startTime = GetCurrentTimeSeconds();
+		if (!TryFileReadToBuffer(buffer, filePath))
+			return false;
+		double readSeconds = GetCurrentTimeSeconds() - startTime;
+		std::vector<uint8_t>().swap(buffer);
+
+		//summing every byte is what makes the os actually page the mapping in
+		startTime = GetCurrentTimeSeconds();
+		MappedFile mappedFile(filePath, FileAccessPattern::SEQUENTIAL);
+		if (!mappedFile.IsOpen())
+			return false;
+		uint64_t byteSum = 0;
+		const uint8_t* bytes = mappedFile.GetData();
+		for (size_t i = 0; i < mappedFile.GetSize(); i++)
+		{
+			byteSum += bytes[i];
+		}
+		mappedFile.Close();
+		double mappedSeconds = GetCurrentTimeSeconds() - startTime;
+		volatile uint64_t keepSum = byteSum;
+		(void)keepSum;
+
+		bestReadSeconds = repeat == 0 || readSeconds < bestReadSeconds ? readSeconds : bestReadSeconds;
+		bestMappedSeconds = repeat == 0 || mappedSeconds < bestMappedSeconds ? mappedSeconds : bestMappedSeconds;
+	}
+
+	out_results.m_fileSizeMB = (double)fileSize / BYTES_PER_MB;
+	out_results.m_readToBufferMBPerSecond = bestReadSeconds > 0.0 ? out_results.m_fileSizeMB / bestReadSeconds : 0.0;
+	out_results.m_mappedInPlaceMBPerSecond = bestMappedSeconds > 0.0 ? out_results.m_fileSizeMB / bestMappedSeconds : 0.0;
+	return repeats > 0;
+}
+
+bool RunImageLoadBenchmark(const std::string& directoryPath, JobSystem* jobSystem, int repeats, ImageLoadBenchmarkResults& out_results)
+{
+	out_results = ImageLoadBenchmarkResults();
+	std::vector<std::string> filePaths;
+	ListFilesInDirectory(directoryPath, filePaths);
+	std::vector<std::string> imageFilePaths;
+	for (int i = 0; i < filePaths.size(); i++)
+	{
+		if (IsImageFilePath(filePaths[i]))
+		{
+			imageFilePaths.push_back(filePaths[i]);
+		}
+	}
+	if (imageFilePaths.empty() || repeats <= 0)
+		return false;
+
+	std::vector<Image*> images;
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		for (int pass = 0; pass < 2; pass++)
+		{
+			JobSystem* passJobSystem = pass == 0 ? nullptr : jobSystem;
+			if (pass == 1 && !passJobSystem)
+				continue;
+
+			double startTime = GetCurrentTimeSeconds();
+			LoadImages(imageFilePaths, images, passJobSystem);
+			double milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+			double& bestMilliseconds = pass == 0 ? out_results.m_serialMilliseconds : out_results.m_jobSystemMilliseconds;
+			bestMilliseconds = repeat == 0 || milliseconds < bestMilliseconds ? milliseconds : bestMilliseconds;
+
+			size_t totalTexels = 0;
+			for (int i = 0; i < images.size(); i++)
+			{
+				IntVec2 dimensions = images[i]->GetDimensions();
+				totalTexels += (size_t)dimensions.x * dimensions.y;
+				delete images[i];
+			}
+			images.clear();
+			out_results.m_totalTexelMB = (double)(totalTexels * sizeof(Rgba8)) / BYTES_PER_MB;
+		}
+	}
+
+	out_results.m_numImages = (int)imageFilePaths.size();
+	return true;
+}
+
+bool RunTextureCookBenchmark(const std::string& imageFilePath, eTextureFormat format, int refinementPasses, TextureCookBenchmarkResults& out_results)
+{
+	out_results = TextureCookBenchmarkResults();
+	if (format != eTextureFormat::BC1_UNORM && format != eTextureFormat::BC3_UNORM && format != eTextureFormat::BC7_UNORM)
+		return false;
+
+	Image image(IntVec2(1, 1), Rgba8::WHITE);
+	if (!image.LoadFromFile(imageFilePath.c_str()))
+		return false;
+
+	IntVec2 dimensions = image.GetDimensions();
+	const Rgba8* texels = (const Rgba8*)image.GetRawData();
+	size_t numTexels = (size_t)dimensions.x * dimensions.y;
+	out_results.m_width = dimensions.x;
+	out_results.m_height = dimensions.y;
+
+	std::vector<uint8_t> blocks;
+	double startTime = GetCurrentTimeSeconds();
+	CompressTexels(format, texels, dimensions, blocks, refinementPasses);
+	double encodeSeconds = GetCurrentTimeSeconds() - startTime;
+	out_results.m_encodeMegapixelsPerSecond = encodeSeconds > 0.0 ? (double)numTexels / 1000000.0 / encodeSeconds : 0.0;
+
+	std::vector<Rgba8> decodedTexels;
+	DecompressTexels(format, blocks.data(), dimensions, decodedTexels);
+	out_results.m_psnr = ComputePSNR(decodedTexels.data(), texels, numTexels, format != eTextureFormat::BC1_UNORM);
+
+	std::vector<Image> mips;
+	startTime = GetCurrentTimeSeconds();
+	GenerateMips(image, eMipFilter::BOX, mips);
+	out_results.m_boxMipsMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+	startTime = GetCurrentTimeSeconds();
+	GenerateMips(image, eMipFilter::KAISER, mips);
+	out_results.m_kaiserMipsMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+	return true;
+}
+
+bool RunPackFileBenchmark(const std::string& directoryPath, const std::string& packFilePath, int repeats, PackFileBenchmarkResults& out_results)
+{
+	out_results = PackFileBenchmarkResults();
+	if (GetNumMountedPackFiles() > 0 || repeats <= 0)
+		return false;
+
+	std::vector<std::string> filePaths;
+	ListFilesInDirectory(directoryPath, filePaths);
+	//the pack itself may sit in the directory, it isn't one of the files being compared
+	filePaths.erase(std::remove_if(filePaths.begin(), filePaths.end(), [&](const std::string& filePath)
+		{
+			std::error_code errorCode;
+			return std::filesystem::equivalent(filePath, packFilePath, errorCode);
+		}), filePaths.end());
+	if (filePaths.empty())
+		return false;
+
+	if (!DoesFileExist(packFilePath) && !WritePackFileFromDirectory(packFilePath.c_str(), directoryPath.c_str()))
+		return false;
+
+	std::vector<uint8_t> scratchBuffer;
+	size_t totalBytes = 0;
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		double looseMilliseconds = ReadAllFiles(filePaths, scratchBuffer, totalBytes);
+
+		double startTime = GetCurrentTimeSeconds();
+		if (!MountPackFile(packFilePath))
+			return false;
+		ReadAllFiles(filePaths, scratchBuffer, totalBytes);
+		double packMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+		UnmountAllPackFiles();
+
+		out_results.m_looseMilliseconds = repeat == 0 || looseMilliseconds < out_results.m_looseMilliseconds ? looseMilliseconds : out_results.m_looseMilliseconds;
+		out_results.m_packMilliseconds = repeat == 0 || packMilliseconds < out_results.m_packMilliseconds ? packMilliseconds : out_results.m_packMilliseconds;
+	}
+
+	out_results.m_numFiles = (int)filePaths.size();
+	out_results.m_totalMB = (double)totalBytes / BYTES_PER_MB;
+	return true;
+}
+
+static bool BenchmarkEventCallback(EventArgs& args)
+{
+	UNUSED(args);
+	t_numBenchmarkEventCallbacks++;
+	return false;
+}
+
+static bool ChurnedBenchmarkEventCallback(EventArgs& args)
+{
+	UNUSED(args);
+	return false;
+}
+
+static void FireBenchmarkEvents(EventSystem& eventSystem, const std::vector<EventID>& eventIDs, const std::vector<std::string>& eventNames, bool fireByName, int numFires)
+{
+	EventArgs args;
+	for (int fireIndex = 0; fireIndex < numFires; fireIndex++)
+	{
+		int eventIndex = fireIndex % NUM_BENCHMARK_EVENTS;
+		if (fireByName)
+		{
+			eventSystem.FireEvent(eventNames[eventIndex], args);
+		}
+		else
+		{
+			eventSystem.FireEvent(eventIDs[eventIndex], args);
+		}
+	}
+}
+
+bool RunEventFireBenchmark(int maxThreads, int firesPerThread, EventFireBenchmarkResults& out_results)
+{
+	out_results = EventFireBenchmarkResults();
+	if (maxThreads <= 0 || firesPerThread <= 0)
+		return false;
+
+	EventSystemConfig eventSystemConfig;
+	EventSystem eventSystem(eventSystemConfig);
+	std::vector<std::string> eventNames;
+	std::vector<EventID> eventIDs;
+	for (int eventIndex = 0; eventIndex < NUM_BENCHMARK_EVENTS; eventIndex++)
+	{
+		eventNames.push_back(Stringf("bench_event_%d", eventIndex));
+		eventIDs.push_back(MakeEventID(eventNames.back().c_str()));
+		for (int subscriberIndex = 0; subscriberIndex < NUM_SUBSCRIBERS_PER_BENCHMARK_EVENT; subscriberIndex++)
+		{
+			eventSystem.SubscribeEventCallbackFunction(eventNames.back(), BenchmarkEventCallback, true);
+		}
+	}
+	out_results.m_numEvents = NUM_BENCHMARK_EVENTS;
+
+	int64_t allocationsBefore = GetTotalTrackedAllocations();
+	FireBenchmarkEvents(eventSystem, eventIDs, eventNames, false, firesPerThread);
+	FireBenchmarkEvents(eventSystem, eventIDs, eventNames, true, firesPerThread);
+	int64_t allocationsAfter = GetTotalTrackedAllocations();
+	if (allocationsBefore >= 0)
+	{
+		out_results.m_allocationsPerFire = (double)(allocationsAfter - allocationsBefore) / (2.0 * firesPerThread);
+	}
+
+	bool everyFireReachedItsSubscribers = true;
+	for (int numThreads = 1; numThreads <= maxThreads; numThreads++)
+	{
+		for (int pass = 0; pass < 2; pass++)
+		{
+			bool fireByName = pass == 1;
+			std::atomic<bool> startFiring{ false };
+			std::atomic<int> numThreadsFinished{ 0 };
+			std::atomic<int64_t> numCallbacks{ 0 };
+			std::vector<std::thread*> firingThreads;
+			for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+			{
+				firingThreads.push_back(new std::thread([&]()
+					{
+						while (!startFiring.load())
+						{
+							std::this_thread::yield();
+						}
+						t_numBenchmarkEventCallbacks = 0;
+						FireBenchmarkEvents(eventSystem, eventIDs, eventNames, fireByName, firesPerThread);
+						numCallbacks.fetch_add(t_numBenchmarkEventCallbacks);
+						numThreadsFinished.fetch_add(1);
+					}));
+			}
+
+			//each change publishes a new list and EndFrame retires the old ones, all while the threads read them
+			double startTime = GetCurrentTimeSeconds();
+			startFiring.store(true);
+			for (int churnIndex = 0; numThreadsFinished.load() < numThreads; churnIndex++)
+			{
+				EventSubscriptionHandle handle = eventSystem.SubscribeEventCallbackFunction(eventNames[churnIndex % NUM_BENCHMARK_EVENTS], ChurnedBenchmarkEventCallback, true);
+				eventSystem.Unsubscribe(handle);
+				eventSystem.EndFrame();
+				out_results.m_numSubscriptionChanges += 2;
+				std::this_thread::yield();
+			}
+			double seconds = GetCurrentTimeSeconds() - startTime;
+
+			for (int threadIndex = 0; threadIndex < firingThreads.size(); threadIndex++)
+			{
+				firingThreads[threadIndex]->join();
+				delete firingThreads[threadIndex];
+			}
+
+			int64_t numFires = (int64_t)numThreads * firesPerThread;
+			if (numCallbacks.load() != numFires * NUM_SUBSCRIBERS_PER_BENCHMARK_EVENT)
+			{
+				everyFireReachedItsSubscribers = false;
+			}
+			std::vector<double>& firesPerSecond = fireByName ? out_results.m_byNameFiresPerSecond : out_results.m_byIDFiresPerSecond;
+			firesPerSecond.push_back(seconds > 0.0 ? (double)numFires / seconds : 0.0);
+		}
+	}
+	return everyFireReachedItsSubscribers;
+}
+
+template <typename VertexArray>
+static int BuildDebugTextFrame(BitmapFont& font, const std::vector<std::string>& boxTexts)
+{
+	//one vertex array per box, the way each debug and console text object builds its own every frame
+	int numVerts = 0;
+	for (int boxIndex = 0; boxIndex < boxTexts.size(); boxIndex++)
+	{
+		VertexArray verts;
+		Vec2 boxMins((float)(boxIndex % 10) * 160.f, (float)(boxIndex / 10) * 40.f);
+		AABB2 box(boxMins, boxMins + Vec2(150.f, 36.f));
+		AddVertsForAABB2D(verts, box, Rgba8(0, 0, 0, 128));
+		font.AddVertsForTextInBox2D(verts, box, 12.f, boxTexts[boxIndex], Rgba8::WHITE, 0.6f, Vec2(0.f, 1.f), TextBoxMode::OVERRUN);
+		numVerts += (int)verts.size();
+	}
+	return numVerts;
+}
+
+bool RunFrameArenaBenchmark(BitmapFont& font, int numTextBoxes, int numFrames, FrameArenaBenchmarkResults& out_results)
+{
+	out_results = FrameArenaBenchmarkResults();
+	if (numTextBoxes <= 0 || numFrames <= 0)
+		return false;
+
+	std::vector<std::string> boxTexts;
+	for (int boxIndex = 0; boxIndex < numTextBoxes; boxIndex++)
+	{
+		boxTexts.push_back(Stringf("entity %d\npos %.2f, %.2f, %.2f\nstate idle, health %d", boxIndex, boxIndex * 1.5f, boxIndex * -0.25f, 12.f, 100 - boxIndex % 100));
+	}
+
+	std::thread benchmarkThread([&]()
+		{
+			//two frames of each kind warm up the allocator and both arena buffers, they aren't counted
+			for (int pass = 0; pass < 2; pass++)
+			{
+				bool useArena = pass == 1;
+				int64_t allocationsBefore = 0;
+				double startTime = 0.0;
+				for (int frameIndex = -2; frameIndex < numFrames; frameIndex++)
+				{
+					if (frameIndex == 0)
+					{
+						allocationsBefore = GetTotalTrackedAllocations();
+						startTime = GetCurrentTimeSeconds();
+					}
+
+					if (useArena)
+					{
+						out_results.m_numVertsPerFrame = BuildDebugTextFrame<FrameVector<Vertex_PCU>>(font, boxTexts);
+						FrameArena::GetThreadArena().EndThreadFrame();
+					}
+					else
+					{
+						out_results.m_numVertsPerFrame = BuildDebugTextFrame<std::vector<Vertex_PCU>>(font, boxTexts);
+					}
+				}
+
+				double millisecondsPerFrame = (GetCurrentTimeSeconds() - startTime) * 1000.0 / numFrames;
+				int64_t allocationsAfter = GetTotalTrackedAllocations();
+				double allocationsPerFrame = allocationsBefore >= 0 ? (double)(allocationsAfter - allocationsBefore) / numFrames : -1.0;
+				(useArena ? out_results.m_arenaMillisecondsPerFrame : out_results.m_vectorMillisecondsPerFrame) = millisecondsPerFrame;
+				(useArena ? out_results.m_arenaAllocationsPerFrame : out_results.m_vectorAllocationsPerFrame) = allocationsPerFrame;
+			}
+		});
+	benchmarkThread.join();
+	return true;
+}
+
+static bool PushFormattedLogLine(LogRingBuffer& ring, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	bool wasPushed = ring.PushFormatted(Rgba8::WHITE, 0, format, args);
+	va_end(args);
+	return wasPushed;
+}
+
+static int DrainLogRing(LogRingBuffer& ring)
+{
+	int numLines = 0;
+	for (const LogRecord* record = ring.BeginPop(); record != nullptr; record = ring.BeginPop())
+	{
+		if (!record->m_continuesInNextRecord)
+		{
+			numLines++;
+		}
+		ring.EndPop();
+	}
+	return numLines;
+}
+
+bool RunLogRingBenchmark(int numThreads, int linesPerThread, int ringCapacity, int drainIntervalMilliseconds, LogRingBenchmarkResults& out_results)
+{
+	out_results = LogRingBenchmarkResults();
+	if (numThreads <= 0 || linesPerThread <= 0 || ringCapacity <= 0 || (ringCapacity & (ringCapacity - 1)) != 0)
+		return false;
+
+	LogRingBuffer ring(ringCapacity);
+	std::string multiRecordPadding(LOG_RECORD_TEXT_BYTES * 3, '-');
+	std::string overlongPadding(LOG_MAX_LINE_LENGTH + LOG_RECORD_TEXT_BYTES, '=');
+	std::atomic<bool> startLogging{ false };
+	std::atomic<int> numThreadsFinished{ 0 };
+	std::atomic<int> numLinesNotPushed{ 0 };
+	std::vector<std::thread*> loggingThreads;
+	for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+	{
+		loggingThreads.push_back(new std::thread([&, threadIndex]()
+			{
+				while (!startLogging.load())
+				{
+					std::this_thread::yield();
+				}
+				int numNotPushed = 0;
+				for (int lineIndex = 0; lineIndex < linesPerThread; lineIndex++)
+				{
+					const char* padding = (lineIndex & 255) == 255 ? overlongPadding.c_str() : ((lineIndex & 15) == 15 ? multiRecordPadding.c_str() : "");
+					if (!PushFormattedLogLine(ring, "thread %d line %d value %.3f %s", threadIndex, lineIndex, lineIndex * 0.125f, padding))
+					{
+						numNotPushed++;
+					}
+				}
+				numLinesNotPushed.fetch_add(numNotPushed);
+				numThreadsFinished.fetch_add(1);
+			}));
+	}
+
+	double startTime = GetCurrentTimeSeconds();
+	startLogging.store(true);
+	while (numThreadsFinished.load() < numThreads)
+	{
+		if (drainIntervalMilliseconds > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(drainIntervalMilliseconds));
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+		out_results.m_numLinesPopped += DrainLogRing(ring);
+	}
+	double seconds = GetCurrentTimeSeconds() - startTime;
+
+	for (int threadIndex = 0; threadIndex < loggingThreads.size(); threadIndex++)
+	{
+		loggingThreads[threadIndex]->join();
+		delete loggingThreads[threadIndex];
+	}
+	out_results.m_numLinesPopped += DrainLogRing(ring);
+
+	out_results.m_numLinesLogged = numThreads * linesPerThread;
+	out_results.m_numDropped = ring.GetNumDropped();
+	out_results.m_numTruncated = ring.GetNumTruncated();
+	out_results.m_linesPerSecond = seconds > 0.0 ? (double)out_results.m_numLinesLogged / seconds : 0.0;
+
+	int numOverlongLines = numThreads * (linesPerThread / 256);
+	return out_results.m_numDropped == (unsigned int)numLinesNotPushed.load() && out_results.m_numTruncated == (unsigned int)numOverlongLines &&
+		out_results.m_numLinesPopped + (int)out_results.m_numDropped == out_results.m_numLinesLogged;
+}
+
+static int BuildAndReadEventArgs(int iteration)
+{
+	EventArgs args;
+	args.SetValue("name", "player");
+	args.SetValue("state", "idle");
+	args.SetValue("health", iteration);
+	return (int)args.GetValue("name", "").size() + (int)args.GetValue("state", "").size() + args.GetValue("health", 0);
+}
+
+bool RunEventArgsBenchmark(int iterations, EventArgsBenchmarkResults& out_results)
+{
+	out_results = EventArgsBenchmarkResults();
+	if (iterations <= 0)
+		return false;
+
+	//the first build interns the keys, which allocates once
+	volatile int readSum = BuildAndReadEventArgs(0);
+	int64_t allocationsBefore = GetTotalTrackedAllocations();
+	double startTime = GetCurrentTimeSeconds();
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		readSum = readSum + BuildAndReadEventArgs(iteration);
+	}
+	double seconds = GetCurrentTimeSeconds() - startTime;
+	int64_t allocationsAfter = GetTotalTrackedAllocations();
+
+	out_results.m_nanosecondsPerIteration = seconds * 1000000000.0 / iterations;
+	if (allocationsBefore >= 0)
+	{
+		out_results.m_allocationsPerIteration = (double)(allocationsAfter - allocationsBefore) / iterations;
+	}
+	return true;
+}
+
+template <typename T_Work>
+static void MeasurePerIteration(int iterations, T_Work work, double& out_nanoseconds, double& out_allocations)
+{
+	int64_t allocationsBefore = GetTotalTrackedAllocations();
+	double startTime = GetCurrentTimeSeconds();
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		work(iteration);
+	}
+	double seconds = GetCurrentTimeSeconds() - startTime;
+	int64_t allocationsAfter = GetTotalTrackedAllocations();
+
+	out_nanoseconds = seconds * 1000000000.0 / iterations;
+	out_allocations = allocationsBefore >= 0 ? (double)(allocationsAfter - allocationsBefore) / iterations : -1.0;
+}
+
+bool RunStringInternBenchmark(int numKeys, int numLookups, StringInternBenchmarkResults& out_results)
+{
+	out_results = StringInternBenchmarkResults();
+	if (numKeys <= 0 || numLookups <= 0)
+		return false;
+
+	std::vector<std::string> keyStrings;
+	std::vector<HashedCaseInsensitiveString> keys;
+	std::map<std::string, int> copiedKeyMap;
+	std::map<HashedCaseInsensitiveString, int> internedKeyMap;
+	for (int keyIndex = 0; keyIndex < numKeys; keyIndex++)
+	{
+		keyStrings.push_back(Stringf("Engine.Benchmark.Key_%06d", keyIndex));
+		keys.push_back(HashedCaseInsensitiveString(keyStrings.back()));
+		std::string lowerKey = keyStrings.back();
+		std::transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(), ToLowerAscii);
+		copiedKeyMap[lowerKey] = keyIndex;
+		internedKeyMap[keys.back()] = keyIndex;
+	}
+	out_results.m_numKeys = numKeys;
+
+	volatile int foundSum = 0;
+	MeasurePerIteration(numLookups, [&](int iteration)
+		{
+			std::string lowerKey = keyStrings[iteration % numKeys];
+			std::transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(), ToLowerAscii);
+			foundSum = foundSum + copiedKeyMap.find(lowerKey)->second;
+		}, out_results.m_copiedKeyFindNanoseconds, out_results.m_copiedKeyFindAllocations);
+	MeasurePerIteration(numLookups, [&](int iteration)
+		{
+			foundSum = foundSum + internedKeyMap.find(HashedCaseInsensitiveString(keyStrings[iteration % numKeys]))->second;
+		}, out_results.m_stringFindNanoseconds, out_results.m_stringFindAllocations);
+	MeasurePerIteration(numLookups, [&](int iteration)
+		{
+			foundSum = foundSum + internedKeyMap.find(keys[iteration % numKeys])->second;
+		}, out_results.m_prebuiltKeyFindNanoseconds, out_results.m_prebuiltKeyFindAllocations);
+
+	double keyEqualityAllocations = 0.0;
+	MeasurePerIteration(numLookups, [&](int iteration)
+		{
+			foundSum = foundSum + (keys[iteration % numKeys] == keys[(iteration * 7) % numKeys] ? 1 : 0);
+		}, out_results.m_keyEqualityNanoseconds, keyEqualityAllocations);
+	return true;
+}
+
+static void KeepBestMilliseconds(int repeat, double startTime, double& bestMilliseconds)
+{
+	double milliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+	bestMilliseconds = repeat == 0 || milliseconds < bestMilliseconds ? milliseconds : bestMilliseconds;
+}
+
+bool RunMeshLoadBenchmark(const std::string& objFilePath, const std::string& meshFilePath, JobSystem* jobSystem, int repeats, MeshLoadBenchmarkResults& out_results)
+{
+	out_results = MeshLoadBenchmarkResults();
+	if (repeats <= 0)
+		return false;
+
+	mesh_import_options importOptions;
+	importOptions.m_jobSystem = jobSystem;
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		MeshBuilder importedMesh;
+		double startTime = GetCurrentTimeSeconds();
+		if (!importedMesh.ImportFromOBJFile(objFilePath.c_str(), importOptions))
+			return false;
+		KeepBestMilliseconds(repeat, startTime, out_results.m_objImportMilliseconds);
+
+		out_results.m_numVertices = (int)importedMesh.GetNumVertices();
+		out_results.m_numIndices = (int)importedMesh.GetNumIndices();
+		if (repeat == 0 && !DoesFileExist(meshFilePath) && !importedMesh.Save(meshFilePath.c_str()))
+			return false;
+	}
+
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		MeshBuilder loadedMesh;
+		double startTime = GetCurrentTimeSeconds();
+		if (!loadedMesh.Load(meshFilePath.c_str()))
+			return false;
+		KeepBestMilliseconds(repeat, startTime, out_results.m_meshBuilderLoadMilliseconds);
+
+		if ((int)loadedMesh.GetNumVertices() != out_results.m_numVertices || (int)loadedMesh.GetNumIndices() != out_results.m_numIndices)
+			return false;
+
+		for (int pass = 0; pass < 2; pass++)
+		{
+			bool verifyChecksum = pass == 0;
+			MeshFileView meshView;
+			startTime = GetCurrentTimeSeconds();
+			if (!meshView.Open(meshFilePath.c_str(), verifyChecksum))
+				return false;
+			meshView.Close();
+			KeepBestMilliseconds(repeat, startTime, verifyChecksum ? out_results.m_verifiedViewMilliseconds : out_results.m_unverifiedViewMilliseconds);
+		}
+	}
+
+	out_results.m_objFileMB = (double)GetFileSizeInBytes(objFilePath) / BYTES_PER_MB;
+	out_results.m_meshFileMB = (double)GetFileSizeInBytes(meshFilePath) / BYTES_PER_MB;
+	return true;
+}
+
+constexpr int OBJ_BENCHMARK_POLYGON_CORNERS = 64;
+
+static bool WriteObjImportBenchmarkGrid(const std::string& objFilePath, int gridSize)
+{
+	//each row's vertices are followed by the faces joining it to the row before, referenced relative to the end of the
+	//file so far. every 8th face uses absolute indices instead, and the last row closes with one big polygon
+	std::string objText = "# ObjImportBenchmark grid\nvn 0 1 0\n";
+	for (int row = 0; row < gridSize; row++)
+	{
+		for (int column = 0; column < gridSize; column++)
+		{
+			objText += Stringf("v %.4f %.4f %.4f\nvt %.5f %.5f\n", column * 0.1f, (float)((column * row) % 7) * 0.01f, row * 0.1f,
+				(float)column / (gridSize - 1), (float)row / (gridSize - 1));
+		}
+
+		for (int column = 0; row > 0 && column < gridSize - 1; column++)
+		{
+			int corners[4] = { column - 2 * gridSize, column + 1 - 2 * gridSize, column + 1 - gridSize, column - gridSize };
+			if (column % 8 == 7)
+			{
+				for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+				{
+					corners[cornerIndex] += (row + 1) * gridSize + 1;
+				}
+			}
+			objText += Stringf("f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", corners[0], corners[0], corners[1], corners[1], corners[2], corners[2], corners[3], corners[3]);
+		}
+	}
+
+	objText += "f";
+	for (int cornerIndex = 0; cornerIndex < OBJ_BENCHMARK_POLYGON_CORNERS; cornerIndex++)
+	{
+		int relativeIndex = -OBJ_BENCHMARK_POLYGON_CORNERS + cornerIndex;
+		objText += Stringf(" %d/%d/1", relativeIndex, relativeIndex);
+	}
+	objText += "\n";
+
+	FileStream objFile;
+	if (!objFile.OpenForWrite(objFilePath.c_str()))
+		return false;
+	size_t bytesWritten = objFile.WriteBytes(objText.data(), objText.size());
+	objFile.Close();
+	return bytesWritten == objText.size();
+}
+
+bool RunObjImportBenchmark(const std::string& objFilePath, int gridSize, JobSystem* jobSystem, int repeats, ObjImportBenchmarkResults& out_results)
+{
+	out_results = ObjImportBenchmarkResults();
+	if (repeats <= 0)
+		return false;
+
+	if (!DoesFileExist(objFilePath))
+	{
+		if (gridSize < OBJ_BENCHMARK_POLYGON_CORNERS || !WriteObjImportBenchmarkGrid(objFilePath, gridSize))
+			return false;
+		out_results.m_wroteGridFile = true;
+	}
+	out_results.m_fileSizeMB = (double)GetFileSizeInBytes(objFilePath) / BYTES_PER_MB;
+
+	MeshBuilder importedMeshes[2];
+	double bestMilliseconds[2] = {};
+	for (int pass = 0; pass < 2; pass++)
+	{
+		mesh_import_options importOptions;
+		importOptions.m_jobSystem = pass == 0 ? nullptr : jobSystem;
+		if (pass == 1 && !jobSystem)
+			continue;
+
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			importedMeshes[pass] = MeshBuilder();
+			double startTime = GetCurrentTimeSeconds();
+			if (!importedMeshes[pass].ImportFromOBJFile(objFilePath.c_str(), importOptions))
+				return false;
+			KeepBestMilliseconds(repeat, startTime, bestMilliseconds[pass]);
+		}
+	}
+
+	out_results.m_numTriangles = (int)importedMeshes[0].GetNumIndices() / 3;
+	double serialSeconds = bestMilliseconds[0] / 1000.0;
+	out_results.m_serialMBPerSecond = serialSeconds > 0.0 ? out_results.m_fileSizeMB / serialSeconds : 0.0;
+	out_results.m_serialTrianglesPerSecond = serialSeconds > 0.0 ? out_results.m_numTriangles / serialSeconds : 0.0;
+	if (!jobSystem)
+		return true;
+
+	double jobSystemSeconds = bestMilliseconds[1] / 1000.0;
+	out_results.m_jobSystemMBPerSecond = jobSystemSeconds > 0.0 ? out_results.m_fileSizeMB / jobSystemSeconds : 0.0;
+	out_results.m_jobSystemTrianglesPerSecond = jobSystemSeconds > 0.0 ? out_results.m_numTriangles / jobSystemSeconds : 0.0;
+
+	const std::vector<Vertex_PNCU>& serialVertices = importedMeshes[0].GetVerticesData();
+	const std::vector<Vertex_PNCU>& jobSystemVertices = importedMeshes[1].GetVerticesData();
+	if (serialVertices.size() != jobSystemVertices.size() || importedMeshes[0].GetIndicesData() != importedMeshes[1].GetIndicesData())
+		return false;
+	if (!serialVertices.empty() && memcmp(serialVertices.data(), jobSystemVertices.data(), serialVertices.size() * sizeof(Vertex_PNCU)) != 0)
+		return false;
+
+	int numGridTriangles = (gridSize - 1) * (gridSize - 1) * 2 + OBJ_BENCHMARK_POLYGON_CORNERS - 2;
+	return !out_results.m_wroteGridFile || out_results.m_numTriangles == numGridTriangles;
+}
+
+static bool WriteMeshLodBenchmarkTorus(const std::string& objFilePath, int numSegments)
+{
+	//ripples run around the tube so the lods have real curvature to lose, a smooth torus simplifies almost for free
+	int numSides = numSegments / 2;
+	std::string objText = "# MeshLodBenchmark torus\n";
+	for (int segment = 0; segment < numSegments; segment++)
+	{
+		float segmentDegrees = 360.f * (float)segment / (float)numSegments;
+		for (int side = 0; side < numSides; side++)
+		{
+			float sideDegrees = 360.f * (float)side / (float)numSides;
+			float tubeRadius = 0.3f + 0.02f * SinDegrees(7.f * segmentDegrees) * SinDegrees(5.f * sideDegrees);
+			float ringRadius = 1.f + tubeRadius * CosDegrees(sideDegrees);
+			objText += Stringf("v %.5f %.5f %.5f\n", ringRadius * CosDegrees(segmentDegrees), ringRadius * SinDegrees(segmentDegrees), tubeRadius * SinDegrees(sideDegrees));
+		}
+	}
+
+	for (int segment = 0; segment < numSegments; segment++)
+	{
+		int nextSegment = (segment + 1) % numSegments;
+		for (int side = 0; side < numSides; side++)
+		{
+			int nextSide = (side + 1) % numSides;
+			objText += Stringf("f %d %d %d %d\n", segment * numSides + side + 1, nextSegment * numSides + side + 1,
+				nextSegment * numSides + nextSide + 1, segment * numSides + nextSide + 1);
+		}
+	}
+
+	FileStream objFile;
+	if (!objFile.OpenForWrite(objFilePath.c_str()))
+		return false;
+	size_t bytesWritten = objFile.WriteBytes(objText.data(), objText.size());
+	objFile.Close();
+	return bytesWritten == objText.size();
+}
+
+//uniform grid over a mesh's triangles, each triangle listed in every cell its bounds touch
+struct MeshSurfaceGrid
+{
+	const std::vector<Vertex_PNCU>* m_vertices = nullptr;
+	const unsigned int* m_indices = nullptr;
+	float m_mins[3] = {};
+	float m_cellSize = 1.f;
+	int m_numCells[3] = {};
+	std::vector<int> m_cellStarts;			//one past the last cell too, offsets into m_cellTriangles
+	std::vector<int> m_cellTriangles;
+};
+
+static int GetSurfaceGridCell(const MeshSurfaceGrid& grid, float coordinate, int axis)
+{
+	return Clamp(RoundDownToInt((coordinate - grid.m_mins[axis]) / grid.m_cellSize), 0, grid.m_numCells[axis] - 1);
+}
+
+static void BuildMeshSurfaceGrid(MeshSurfaceGrid& grid, const std::vector<Vertex_PNCU>& vertices, const unsigned int* indices, int numIndices, const Vec3& mins, const Vec3& maxs)
+{
+	//sized so a surface crosses a few triangles per cell, a query then only looks at a handful of cells
+	int numTriangles = numIndices / 3;
+	grid.m_vertices = &vertices;
+	grid.m_indices = indices;
+	grid.m_mins[0] = mins.x;
+	grid.m_mins[1] = mins.y;
+	grid.m_mins[2] = mins.z;
+	float sizes[3] = { maxs.x - mins.x, maxs.y - mins.y, maxs.z - mins.z };
+	float extent = sizes[0] > sizes[1] ? sizes[0] : sizes[1];
+	extent = extent > sizes[2] ? extent : sizes[2];
+	int resolution = Clamp((int)sqrtf((float)numTriangles * 0.25f), 1, 128);
+	grid.m_cellSize = extent > 0.f ? extent / (float)resolution : 1.f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		grid.m_numCells[axis] = Clamp((int)ceilf(sizes[axis] / grid.m_cellSize), 1, resolution);
+	}
+
+	int numCells = grid.m_numCells[0] * grid.m_numCells[1] * grid.m_numCells[2];
+	grid.m_cellStarts.assign(numCells + 1, 0);
+	std::vector<int> cellFills;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		//counts first, then the triangles themselves into the ranges the counts add up to
+		if (pass == 1)
+		{
+			for (int cellIndex = 0; cellIndex < numCells; cellIndex++)
+			{
+				grid.m_cellStarts[cellIndex + 1] += grid.m_cellStarts[cellIndex];
+			}
+			grid.m_cellTriangles.resize(grid.m_cellStarts[numCells]);
+			cellFills.assign(grid.m_cellStarts.begin(), grid.m_cellStarts.end() - 1);
+		}
+
+		for (int triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+		{
+			const Vec3& cornerA = vertices[indices[triangleIndex * 3]].m_position;
+			const Vec3& cornerB = vertices[indices[triangleIndex * 3 + 1]].m_position;
+			const Vec3& cornerC = vertices[indices[triangleIndex * 3 + 2]].m_position;
+			float cornerCoordinates[3][3] = { { cornerA.x, cornerB.x, cornerC.x }, { cornerA.y, cornerB.y, cornerC.y }, { cornerA.z, cornerB.z, cornerC.z } };
+			int firstCells[3];
+			int lastCells[3];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const float* coordinates = cornerCoordinates[axis];
+				float minCoordinate = coordinates[0] < coordinates[1] ? coordinates[0] : coordinates[1];
+				float maxCoordinate = coordinates[0] > coordinates[1] ? coordinates[0] : coordinates[1];
+				firstCells[axis] = GetSurfaceGridCell(grid, minCoordinate < coordinates[2] ? minCoordinate : coordinates[2], axis);
+				lastCells[axis] = GetSurfaceGridCell(grid, maxCoordinate > coordinates[2] ? maxCoordinate : coordinates[2], axis);
+			}
+
+			for (int z = firstCells[2]; z <= lastCells[2]; z++)
+			{
+				for (int y = firstCells[1]; y <= lastCells[1]; y++)
+				{
+					for (int x = firstCells[0]; x <= lastCells[0]; x++)
+					{
+						int cellIndex = (z * grid.m_numCells[1] + y) * grid.m_numCells[0] + x;
+						if (pass == 0)
+						{
+							grid.m_cellStarts[cellIndex]++;
+						}
+						else
+						{
+							grid.m_cellTriangles[cellFills[cellIndex]++] = triangleIndex;
+						}
+					}
+				}
+			}
+		}
+
+		if (pass == 0)
+		{
+			//shifted up one so the running sum leaves each cell's start rather than its end
+			for (int cellIndex = numCells; cellIndex > 0; cellIndex--)
+			{
+				grid.m_cellStarts[cellIndex] = grid.m_cellStarts[cellIndex - 1];
+			}
+			grid.m_cellStarts[0] = 0;
+		}
+	}
+}
+
+static float GetDistanceToMeshSurface(const MeshSurfaceGrid& grid, const Vec3& point)
+{
+	//searches shells of cells outwards from the point's cell. once the nearest triangle found is closer than any cell
+	//outside the shells searched so far could be, nothing further out can beat it
+	float coordinates[3] = { point.x, point.y, point.z };
+	int centerCells[3] = { GetSurfaceGridCell(grid, point.x, 0), GetSurfaceGridCell(grid, point.y, 1), GetSurfaceGridCell(grid, point.z, 2) };
+	const std::vector<Vertex_PNCU>& vertices = *grid.m_vertices;
+	float nearestDistanceSquared = FLT_MAX;
+	for (int shell = 0; ; shell++)
+	{
+		for (int z = centerCells[2] - shell; z <= centerCells[2] + shell; z++)
+		{
+			for (int y = centerCells[1] - shell; y <= centerCells[1] + shell; y++)
+			{
+				for (int x = centerCells[0] - shell; x <= centerCells[0] + shell; x++)
+				{
+					bool isOnShell = abs(x - centerCells[0]) == shell || abs(y - centerCells[1]) == shell || abs(z - centerCells[2]) == shell;
+					if (!isOnShell || x < 0 || y < 0 || z < 0 || x >= grid.m_numCells[0] || y >= grid.m_numCells[1] || z >= grid.m_numCells[2])
+						continue;
+
+					int cellIndex = (z * grid.m_numCells[1] + y) * grid.m_numCells[0] + x;
+					for (int listIndex = grid.m_cellStarts[cellIndex]; listIndex < grid.m_cellStarts[cellIndex + 1]; listIndex++)
+					{
+						const unsigned int* corners = grid.m_indices + grid.m_cellTriangles[listIndex] * 3;
+						Vec3 nearestPoint = GetNearestPointOnTriangle3D(point, vertices[corners[0]].m_position, vertices[corners[1]].m_position, vertices[corners[2]].m_position);
+						float distanceSquared = GetDistanceSquared3D(point, nearestPoint);
+						nearestDistanceSquared = distanceSquared < nearestDistanceSquared ? distanceSquared : nearestDistanceSquared;
+					}
+				}
+			}
+		}
+
+		float unsearchedDistance = FLT_MAX;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (centerCells[axis] - shell > 0)
+			{
+				float distanceToLowerSide = coordinates[axis] - (grid.m_mins[axis] + (float)(centerCells[axis] - shell) * grid.m_cellSize);
+				unsearchedDistance = distanceToLowerSide < unsearchedDistance ? distanceToLowerSide : unsearchedDistance;
+			}
+			if (centerCells[axis] + shell < grid.m_numCells[axis] - 1)
+			{
+				float distanceToUpperSide = grid.m_mins[axis] + (float)(centerCells[axis] + shell + 1) * grid.m_cellSize - coordinates[axis];
+				unsearchedDistance = distanceToUpperSide < unsearchedDistance ? distanceToUpperSide : unsearchedDistance;
+			}
+		}
+		if (unsearchedDistance == FLT_MAX || nearestDistanceSquared <= unsearchedDistance * unsearchedDistance)
+			break;
+	}
+	return sqrtf(nearestDistanceSquared);
+}
+
+static float GetMaxDistanceToMeshSurface(const MeshSurfaceGrid& grid, const std::vector<Vertex_PNCU>& vertices, const unsigned int* indices, int numIndices)
+{
+	//samples every vertex the triangles use once, plus each triangle's edge midpoints and center
+	float maxDistance = 0.f;
+	std::vector<bool> isVertexSampled(vertices.size(), false);
+	for (int triangleStart = 0; triangleStart + 2 < numIndices; triangleStart += 3)
+	{
+		const Vec3& cornerA = vertices[indices[triangleStart]].m_position;
+		const Vec3& cornerB = vertices[indices[triangleStart + 1]].m_position;
+		const Vec3& cornerC = vertices[indices[triangleStart + 2]].m_position;
+		Vec3 samplePoints[4] = { (cornerA + cornerB) * 0.5f, (cornerB + cornerC) * 0.5f, (cornerC + cornerA) * 0.5f, (cornerA + cornerB + cornerC) * (1.f / 3.f) };
+		for (int sampleIndex = 0; sampleIndex < 4; sampleIndex++)
+		{
+			float distance = GetDistanceToMeshSurface(grid, samplePoints[sampleIndex]);
+			maxDistance = distance > maxDistance ? distance : maxDistance;
+		}
+
+		for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+		{
+			unsigned int vertexIndex = indices[triangleStart + cornerIndex];
+			if (isVertexSampled[vertexIndex])
+				continue;
+
+			isVertexSampled[vertexIndex] = true;
+			float distance = GetDistanceToMeshSurface(grid, vertices[vertexIndex].m_position);
+			maxDistance = distance > maxDistance ? distance : maxDistance;
+		}
+	}
+	return maxDistance;
+}
+
+bool RunMeshLodBenchmark(const std::string& objFilePath, int torusSegments, const mesh_lod_options& lodOptions, int repeats, MeshLodBenchmarkResults& out_results)
+{
+	out_results = MeshLodBenchmarkResults();
+	if (repeats <= 0)
+		return false;
+
+	if (!DoesFileExist(objFilePath))
+	{
+		if (torusSegments < 8 || !WriteMeshLodBenchmarkTorus(objFilePath, torusSegments))
+			return false;
+		out_results.m_wroteTorusFile = true;
+	}
+
+	MeshBuilder fullMesh;
+	if (!fullMesh.ImportFromOBJFile(objFilePath.c_str(), mesh_import_options()))
+		return false;
+	out_results.m_numTriangles = (int)fullMesh.GetNumIndices() / 3;
+	if (out_results.m_wroteTorusFile && out_results.m_numTriangles != torusSegments * (torusSegments / 2) * 2)
+		return false;
+
+	MeshBuilder lodMesh;
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		lodMesh = fullMesh;
+		double startTime = GetCurrentTimeSeconds();
+		lodMesh.GenerateLods(lodOptions);
+		KeepBestMilliseconds(repeat, startTime, out_results.m_generateLodsMilliseconds);
+	}
+	double seconds = out_results.m_generateLodsMilliseconds / 1000.0;
+	out_results.m_millionTrianglesPerSecond = seconds > 0.0 ? (double)out_results.m_numTriangles / seconds / 1000000.0 : 0.0;
+
+	//every lod indexes the full mesh's verts, so one set of bounds covers all their grids
+	const std::vector<Vertex_PNCU>& vertices = lodMesh.GetVerticesData();
+	const std::vector<unsigned int>& indices = lodMesh.GetIndicesData();
+	if (vertices.empty() || indices.empty())
+		return false;
+
+	Vec3 mins = vertices[0].m_position;
+	Vec3 maxs = vertices[0].m_position;
+	for (int i = 1; i < vertices.size(); i++)
+	{
+		const Vec3& position = vertices[i].m_position;
+		mins = Vec3(position.x < mins.x ? position.x : mins.x, position.y < mins.y ? position.y : mins.y, position.z < mins.z ? position.z : mins.z);
+		maxs = Vec3(position.x > maxs.x ? position.x : maxs.x, position.y > maxs.y ? position.y : maxs.y, position.z > maxs.z ? position.z : maxs.z);
+	}
+
+	float meshExtent = GetMeshExtent(vertices);
+	MeshSurfaceGrid fullMeshGrid;
+	BuildMeshSurfaceGrid(fullMeshGrid, vertices, indices.data(), out_results.m_numTriangles * 3, mins, maxs);
+	for (unsigned int lodIndex = 1; lodIndex < lodMesh.GetNumLods(); lodIndex++)
+	{
+		MeshLod lod = lodMesh.GetLod(lodIndex);
+		const unsigned int* lodIndices = indices.data() + lod.m_firstIndex;
+		MeshSurfaceGrid lodGrid;
+		BuildMeshSurfaceGrid(lodGrid, vertices, lodIndices, (int)lod.m_numIndices, mins, maxs);
+		float lodToFullMeshDistance = GetMaxDistanceToMeshSurface(fullMeshGrid, vertices, lodIndices, (int)lod.m_numIndices);
+		float fullMeshToLodDistance = GetMaxDistanceToMeshSurface(lodGrid, vertices, indices.data(), out_results.m_numTriangles * 3);
+		float measuredDistance = lodToFullMeshDistance > fullMeshToLodDistance ? lodToFullMeshDistance : fullMeshToLodDistance;
+
+		out_results.m_lodTriangles.push_back((int)lod.m_numIndices / 3);
+		out_results.m_lodReportedErrors.push_back(meshExtent > 0.f ? lod.m_error / meshExtent : 0.f);
+		out_results.m_lodMeasuredErrors.push_back(meshExtent > 0.f ? measuredDistance / meshExtent : 0.f);
+	}
+	return true;
+}
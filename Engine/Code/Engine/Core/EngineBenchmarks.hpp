@@ -0,0 +1,162 @@
+#pragma once
+#include <string>
+#include <vector>
+
+class JobSystem;
+class BitmapFont;
+struct mesh_lod_options;
+enum class eTextureFormat : int;
+
+//the measurements behind the bench_* console commands, so the numbers quoted for the engine's hot paths can be taken again
+//on any machine. file reads hit whatever the os file cache holds, so drop it first for cold numbers. allocation counts
+//come from the MemoryTracker and are -1 unless the engine is built with ENGINE_TRACK_MEMORY
+
+struct FileLoadBenchmarkResults
+{
+	double m_fileSizeMB = 0.0;
+	double m_readToBufferMBPerSecond = 0.0;		//FileReadToBuffer into an owned buffer
+	double m_mappedInPlaceMBPerSecond = 0.0;	//MappedFile with every byte touched in place
+};
+
+struct ImageLoadBenchmarkResults
+{
+	int m_numImages = 0;
+	double m_totalTexelMB = 0.0;
+	double m_serialMilliseconds = 0.0;			//LoadImages on the calling thread
+	double m_jobSystemMilliseconds = 0.0;		//LoadImages on the job system, 0 without one
+};
+
+struct TextureCookBenchmarkResults
+{
+	int m_width = 0;
+	int m_height = 0;
+	double m_encodeMegapixelsPerSecond = 0.0;
+	float m_psnr = 0.f;							//rgba for formats with alpha, rgb for BC1
+	double m_boxMipsMilliseconds = 0.0;
+	double m_kaiserMipsMilliseconds = 0.0;
+};
+
+struct PackFileBenchmarkResults
+{
+	int m_numFiles = 0;
+	double m_totalMB = 0.0;
+	double m_looseMilliseconds = 0.0;
+	double m_packMilliseconds = 0.0;			//includes mounting the pack
+};
+
+struct EventFireBenchmarkResults
+{
+	int m_numEvents = 0;
+	int m_numSubscriptionChanges = 0;				//subscribes and unsubscribes made while the events were firing
+	double m_allocationsPerFire = -1.0;				//by id and by name on one thread
+	std::vector<double> m_byIDFiresPerSecond;		//one per thread count from 1, summed over the firing threads
+	std::vector<double> m_byNameFiresPerSecond;
+};
+
+struct FrameArenaBenchmarkResults
+{
+	int m_numVertsPerFrame = 0;
+	double m_vectorMillisecondsPerFrame = 0.0;		//a std::vector per text box
+	double m_arenaMillisecondsPerFrame = 0.0;		//a FrameVector per text box
+	double m_vectorAllocationsPerFrame = -1.0;
+	double m_arenaAllocationsPerFrame = -1.0;
+};
+
+struct LogRingBenchmarkResults
+{
+	int m_numLinesLogged = 0;					//every push, dropped ones included
+	int m_numLinesPopped = 0;
+	unsigned int m_numDropped = 0;				//the ring's own overflow and truncation counters
+	unsigned int m_numTruncated = 0;
+	double m_linesPerSecond = 0.0;				//logged by all threads together
+};
+
+struct EventArgsBenchmarkResults
+{
+	double m_nanosecondsPerIteration = 0.0;
+	double m_allocationsPerIteration = -1.0;
+};
+
+struct StringInternBenchmarkResults
+{
+	int m_numKeys = 0;
+	double m_copiedKeyFindNanoseconds = 0.0;		//map keyed by lowercased std::string copies, what the keys were before interning
+	double m_copiedKeyFindAllocations = -1.0;
+	double m_stringFindNanoseconds = 0.0;			//interned key built from a std::string for every lookup
+	double m_stringFindAllocations = -1.0;
+	double m_prebuiltKeyFindNanoseconds = 0.0;
+	double m_prebuiltKeyFindAllocations = -1.0;
+	double m_keyEqualityNanoseconds = 0.0;
+};
+
+struct MeshLoadBenchmarkResults
+{
+	int m_numVertices = 0;
+	int m_numIndices = 0;
+	double m_objFileMB = 0.0;
+	double m_meshFileMB = 0.0;
+	double m_objImportMilliseconds = 0.0;
+	double m_meshBuilderLoadMilliseconds = 0.0;
+	double m_verifiedViewMilliseconds = 0.0;		//MeshFileView::Open checking the checksum
+	double m_unverifiedViewMilliseconds = 0.0;
+};
+
+struct ObjImportBenchmarkResults
+{
+	double m_fileSizeMB = 0.0;
+	int m_numTriangles = 0;
+	double m_serialMBPerSecond = 0.0;
+	double m_serialTrianglesPerSecond = 0.0;
+	double m_jobSystemMBPerSecond = 0.0;			//chunked across the job system, 0 without one
+	double m_jobSystemTrianglesPerSecond = 0.0;
+	bool m_wroteGridFile = false;
+};
+
+struct MeshLodBenchmarkResults
+{
+	int m_numTriangles = 0;
+	double m_generateLodsMilliseconds = 0.0;
+	double m_millionTrianglesPerSecond = 0.0;		//full mesh triangles through GenerateLods per second
+	std::vector<int> m_lodTriangles;				//one per lod after the full mesh
+	std::vector<float> m_lodReportedErrors;			//MeshLod::m_error over the mesh's extent, the units of mesh_lod_options::m_maxError
+	std::vector<float> m_lodMeasuredErrors;			//furthest sampled distance between the lod and the full mesh either way, same units
+	bool m_wroteTorusFile = false;
+};
+
+//each run is repeated and the best one kept, false if the inputs couldn't be read
+bool RunFileLoadBenchmark(const std::string& filePath, int repeats, FileLoadBenchmarkResults& out_results);
+//every image under the directory (png, jpg, tga, bmp), decoded by the same path the renderer's batch loads use
+bool RunImageLoadBenchmark(const std::string& directoryPath, JobSystem* jobSystem, int repeats, ImageLoadBenchmarkResults& out_results);
+//BC1, BC3 or BC7 encode speed and quality on one image, plus the time for its whole mip chain with each filter
+bool RunTextureCookBenchmark(const std::string& imageFilePath, eTextureFormat format, int refinementPasses, TextureCookBenchmarkResults& out_results);
+//every file under the directory read loose, then out of the pack (built from the directory if it doesn't exist yet).
+//needs nothing mounted beforehand, the pack is unmounted again afterwards
+bool RunPackFileBenchmark(const std::string& directoryPath, const std::string& packFilePath, int repeats, PackFileBenchmarkResults& out_results);
+//fires from 1 up to maxThreads threads at once, by id and by name, while this thread keeps subscribing, unsubscribing and
+//reclaiming so the firing threads always read freshly swapped subscriber lists. uses an event system of its own and fails
+//if any fire missed a subscriber
+bool RunEventFireBenchmark(int maxThreads, int firesPerThread, EventFireBenchmarkResults& out_results);
+//the cpu side of a debug text heavy frame, a background quad and three lines of text per box, built into std::vectors and
+//then into FrameVectors. runs on a thread of its own so the frames it ends don't reset anyone else's frame data
+bool RunFrameArenaBenchmark(BitmapFont& font, int numTextBoxes, int numFrames, FrameArenaBenchmarkResults& out_results);
+//numThreads threads log linesPerThread formatted lines each into a ring of their own. one line in 16 spans several records
+//and one in 256 is too long for any line. this thread drains the ring every drainIntervalMilliseconds, the way the console
+//drains it once a frame, so lines logged faster than that overflow. fails if the counters don't match what was logged
+bool RunLogRingBenchmark(int numThreads, int linesPerThread, int ringCapacity, int drainIntervalMilliseconds, LogRingBenchmarkResults& out_results);
+//builds EventArgs with three properties (two short strings and an int) and reads all three back, once per iteration
+bool RunEventArgsBenchmark(int iterations, EventArgsBenchmarkResults& out_results);
+//std::map lookups over numKeys 27 character keys, keyed by copied strings and by interned HashedCaseInsensitiveStrings.
+//the keys stay in the global intern table afterwards
+bool RunStringInternBenchmark(int numKeys, int numLookups, StringInternBenchmarkResults& out_results);
+//the same mesh imported from its OBJ (on the job system when given), loaded from its cooked file into a MeshBuilder and
+//opened in place by a MeshFileView with and without the checksum. the cooked file is written from the OBJ if it doesn't
+//exist yet, and the benchmark fails if it holds a different mesh
+bool RunMeshLoadBenchmark(const std::string& objFilePath, const std::string& meshFilePath, JobSystem* jobSystem, int repeats, MeshLoadBenchmarkResults& out_results);
+//ImportFromOBJFile on this thread and split into chunks on the job system. the file is first written as a gridSize x gridSize
+//grid if it doesn't exist, with mostly relative (negative) face indices so every chunk has to resolve them. fails if the
+//two imports don't produce identical vertices and indices, or a written grid comes back with the wrong triangle count
+bool RunObjImportBenchmark(const std::string& objFilePath, int gridSize, JobSystem* jobSystem, int repeats, ObjImportBenchmarkResults& out_results);
+//GenerateLods on the mesh in the OBJ, written first as a rippled torus of torusSegments x torusSegments / 2 quads if it
+//doesn't exist. every lod's reported error is then checked against its measured one: points sampled on the lod's surface
+//are measured to the full mesh's surface and points on the full mesh to the lod's, and the furthest of either kept
+bool RunMeshLodBenchmark(const std::string& objFilePath, int torusSegments, const mesh_lod_options& lodOptions, int repeats, MeshLodBenchmarkResults& out_results);
@@ -1,16 +1,118 @@
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 
 EventSystem* g_theEventSystem = nullptr;
 
+constexpr int EVENT_TABLE_MIN_SLOTS = 64;
+
+EventEntry* EventTable::Find(EventID eventID, const char* eventName) const
+{
+	if (m_slots.empty())
+		return nullptr;
+
+	EventEntry* foundEntry = nullptr;
+	size_t mask = m_slots.size() - 1;
+	for (size_t slot = eventID & mask; ; slot = (slot + 1) & mask)
+	{
+		EventEntry* entry = m_slots[slot];
+		if (entry == nullptr)
+			return foundEntry;
+		if (entry->m_id != eventID)
+			continue;
+
+		if (eventName)
+		{
+			if (_stricmp(entry->m_name.c_str(), eventName) == 0)
+				return entry;
+			continue;
+		}
+
+		//by id alone, two names sharing the id can't be told apart
+		if (foundEntry)
+		{
+			DebuggerPrintf(Stringf("Event id 0x%08x is shared by %s and %s, fire it by name", eventID, foundEntry->m_name.c_str(), entry->m_name.c_str()).c_str());
+			return nullptr;
+		}
+		foundEntry = entry;
+	}
+}
+
+void EventTable::Insert(EventEntry* entry)
+{
+	size_t mask = m_slots.size() - 1;
+	size_t slot = entry->m_id & mask;
+	while (m_slots[slot] != nullptr)
+	{
+		slot = (slot + 1) & mask;
+	}
+	m_slots[slot] = entry;
+	m_numEntries++;
+}
+
+void QueuedEventList::Push(QueuedEvent* queuedEvent)
+{
+	QueuedEvent* head = m_head.load();
+	do
+	{
+		queuedEvent->m_next = head;
+	} while (!m_head.compare_exchange_weak(head, queuedEvent));
+}
+
+QueuedEvent* QueuedEventList::PopAll()
+{
+	return m_head.exchange(nullptr);
+}
+
+EventSubscriptionJob::EventSubscriptionJob(EventSubscriptionBase* subscription, EventArgs& args)
+	:m_subscription(subscription), m_args(args)
+{
+}
+
+void EventSubscriptionJob::Execute()
+{
+	m_subscription->Execute(m_args);
+}
+
+void EventSubscriptionJob::OnFinished()
+{
+}
+
+EventRecepient::EventRecepient(const EventRecepient& copyFrom)
+{
+	//subscriptions belong to the object that made them, a copy starts with none
+	UNUSED(copyFrom);
+}
+
+EventRecepient& EventRecepient::operator=(const EventRecepient& copyFrom)
+{
+	UNUSED(copyFrom);
+	return *this;
+}
+
+EventRecepient::~EventRecepient()
+{
+	if (g_theEventSystem && m_firstSubscription)
+	{
+		g_theEventSystem->UnsubscribeRecepient(*this);
+	}
+}
+
 EventSystem::EventSystem(const EventSystemConfig& config)
 {
 	m_config = config;
+	m_numReadersInEpoch[0].store(0);
+	m_numReadersInEpoch[1].store(0);
+
+	EventTable* table = new EventTable();
+	table->m_slots.resize(EVENT_TABLE_MIN_SLOTS, nullptr);
+	m_eventTable.store(table);
 }
 
 EventSystem::~EventSystem()
 {
-
+	Shutdown();
 }
 
 void EventSystem::Startup()
@@ -20,59 +122,111 @@ void EventSystem::Startup()
 
 void EventSystem::Shutdown()
 {
+	QueuedEvent* undeliveredEvent = m_queuedEvents.PopAll();
+	while (undeliveredEvent)
+	{
+		QueuedEvent* nextEvent = undeliveredEvent->m_next;
+		delete undeliveredEvent;
+		undeliveredEvent = nextEvent;
+	}
+
+	m_subscriptionListMutex.lock();
+	FreeRetiredSnapshots(0);
+	FreeRetiredSnapshots(1);
+
+	EventTable* table = m_eventTable.exchange(nullptr);
+	if (table)
+	{
+		for (int slot = 0; slot < table->m_slots.size(); slot++)
+		{
+			EventEntry* entry = table->m_slots[slot];
+			if (entry == nullptr)
+				continue;
 
+			SubscriptionList* subList = entry->m_subscriptions.load();
+			if (subList)
+			{
+				for (int i = 0; i < subList->size(); i++)
+				{
+					EventSubscriptionBase* subscription = (*subList)[i];
+					if (subscription->m_recepient)
+					{
+						subscription->m_recepient->m_firstSubscription = nullptr;
+					}
+					delete subscription;
+				}
+				delete subList;
+			}
+			delete entry;
+		}
+		delete table;
+	}
+
+	m_handleSlots.clear();
+	m_handleGenerations.clear();
+	m_freeHandleSlots.clear();
+	m_entriesWithTombstones.clear();
+	m_subscriptionListMutex.unlock();
 }
 
 void EventSystem::BeginFrame()
 {
-
+	DeliverQueuedEvents();
 }
 
 void EventSystem::EndFrame()
 {
+	DeliverQueuedEvents();
 
+	m_subscriptionListMutex.lock();
+	CompactTombstonedSubscriptions();
+	ReclaimRetiredSnapshots();
+	m_subscriptionListMutex.unlock();
 }
 
-void EventSystem::SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr)
+EventSubscriptionHandle EventSystem::SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr, bool isThreadSafe)
 {
-	std::map<HashedCaseInsensitiveString, SubscriptionList>::const_iterator iter;
+	EventSubscriptionBase* subscription = new Function_EventSubscription(functionPtr);
+	subscription->m_isThreadSafe = isThreadSafe;
+	return AddSubscription(eventName.c_str(), subscription, nullptr);
+}
+
+void EventSystem::Unsubscribe(EventSubscriptionHandle& handle)
+{
+	if (!handle.IsValid())
+		return;
+
 	m_subscriptionListMutex.lock();
-	iter = m_subscriptionListByEventName.find(eventName);
-	if (iter == m_subscriptionListByEventName.end())
+	if (handle.m_slotIndex < m_handleSlots.size() && m_handleGenerations[handle.m_slotIndex] == handle.m_generation)
 	{
-		SubscriptionList subList;
-		EventSubscriptionBase* eventSub = new Function_EventSubscription(functionPtr);
-		subList.push_back(eventSub);
-		m_subscriptionListByEventName[eventName] = subList;
+		RemoveSubscription(m_handleSlots[handle.m_slotIndex]);
 	}
-	else
+	m_subscriptionListMutex.unlock();
+	handle = EventSubscriptionHandle();
+}
+
+void EventSystem::UnsubscribeRecepient(EventRecepient& recepient)
+{
+	m_subscriptionListMutex.lock();
+	while (recepient.m_firstSubscription)
 	{
-		SubscriptionList subList = iter->second;
-		EventSubscriptionBase* eventSub = new Function_EventSubscription(functionPtr);
-		subList.push_back(eventSub);
+		RemoveSubscription(recepient.m_firstSubscription);
 	}
 	m_subscriptionListMutex.unlock();
 }
 
 void EventSystem::UnsubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr)
 {
-	std::map<HashedCaseInsensitiveString, SubscriptionList>::iterator iter;
 	bool unsubscribeSuccess = false;
 	m_subscriptionListMutex.lock();
-	iter = m_subscriptionListByEventName.find(eventName);
-	if (iter != m_subscriptionListByEventName.end())
+	EventEntry* entry = FindEventEntry(eventName.c_str());
+	if (entry != nullptr)
 	{
-		SubscriptionList& subList = iter->second;
-		for (int i = 0; i < subList.size(); i++)
-		{
-			EventSubscriptionBase* callbackBase = subList[i];
-			if (callbackBase->IsForFunction(functionPtr))
+		RemoveSubscriptions(entry, [functionPtr](EventSubscriptionBase* subscription)
 			{
-				delete callbackBase;
-				std::swap(callbackBase, subList[subList.size() - 1]);
-				subList.pop_back();
+				return subscription->IsForFunction(functionPtr);
 			}
-		}
+		);
 		unsubscribeSuccess = true;
 	}
 	m_subscriptionListMutex.unlock();
@@ -85,47 +239,169 @@ void EventSystem::UnsubscribeEventCallbackFunction(const std::string& eventName,
 
 void EventSystem::FireEvent(const std::string& eventName, EventArgs& args)
 {
-	std::map<HashedCaseInsensitiveString, SubscriptionList>::const_iterator iter;
+	FireEvent(MakeEventID(eventName.c_str()), eventName.c_str(), args);
+}
+
+void EventSystem::FireEvent(const std::string& eventName)
+{
+	EventArgs args;
+	FireEvent(eventName, args);
+}
+
+void EventSystem::FireEvent(EventID eventID, EventArgs& args)
+{
+	FireEvent(eventID, nullptr, args);
+}
+
+void EventSystem::FireEvent(EventID eventID, const char* eventNameToVerify, EventArgs& args, bool dispatchThreadSafeOnJobs)
+{
 	bool fireEventSuccess = false;
-	SubscriptionList subList;
-	m_subscriptionListMutex.lock();
-	iter = m_subscriptionListByEventName.find(eventName);
-	if (iter != m_subscriptionListByEventName.end())
-	{
-		subList = iter->second;
-	}
-	m_subscriptionListMutex.unlock();
+	unsigned int epoch = EnterReadEpoch();
+	EventTable* table = m_eventTable.load();
+	EventEntry* entry = table ? table->Find(eventID, eventNameToVerify) : nullptr;
 
-	for (int i = 0; i < subList.size(); i++)
+	SubscriptionList* subList = entry ? entry->m_subscriptions.load() : nullptr;
+	if (subList)
 	{
-		fireEventSuccess = true;
-		EventSubscriptionBase* callback = subList[i];
-		bool consumed = callback->Execute(args);
-		if (consumed)
-			break;
+		//with job dispatch, main thread subscribers run first in order and can still consume the event,
+		//then the thread safe ones all run in parallel with the final args. they can't consume the event
+		bool consumed = false;
+		for (int i = 0; i < subList->size() && !consumed; i++)
+		{
+			fireEventSuccess = true;
+			EventSubscriptionBase* callback = (*subList)[i];
+			if (callback->m_isRemoved.load() || (dispatchThreadSafeOnJobs && callback->m_isThreadSafe))
+				continue;
+
+			consumed = callback->Execute(args);
+		}
+
+		if (dispatchThreadSafeOnJobs && !consumed)
+		{
+			FrameVector<Job*> subscriptionJobs;
+			for (int i = 0; i < subList->size(); i++)
+			{
+				EventSubscriptionBase* callback = (*subList)[i];
+				if (callback->m_isThreadSafe && !callback->m_isRemoved.load())
+				{
+					EventSubscriptionJob* subscriptionJob = new EventSubscriptionJob(callback, args);
+					m_config.m_jobSystem->QueueJobs(subscriptionJob);
+					subscriptionJobs.push_back(subscriptionJob);
+				}
+			}
+
+			if (!subscriptionJobs.empty())
+			{
+				m_config.m_jobSystem->WaitForJobs(subscriptionJobs.data(), (int)subscriptionJobs.size());
+				for (int i = 0; i < subscriptionJobs.size(); i++)
+				{
+					delete subscriptionJobs[i];
+				}
+			}
+		}
 	}
+	ExitReadEpoch(epoch);
 
 	if(!fireEventSuccess)
 	{
-		DebuggerPrintf(Stringf("Trying to fire event %s which doesn't exist", eventName.c_str()).c_str());
+		if (eventNameToVerify)
+			DebuggerPrintf(Stringf("Trying to fire event %s which doesn't exist", eventNameToVerify).c_str());
+		else
+			DebuggerPrintf(Stringf("Trying to fire event id 0x%08x which doesn't exist", eventID).c_str());
 	}
 }
 
-void EventSystem::FireEvent(const std::string& eventName)
+void EventSystem::QueueEvent(const std::string& eventName, EventArgs& args, bool coalesceDuplicates)
 {
-	EventArgs args;
-	FireEvent(eventName, args);
+	QueuedEvent* queuedEvent = new QueuedEvent();
+	queuedEvent->m_id = MakeEventID(eventName.c_str());
+	queuedEvent->m_name = eventName;
+	queuedEvent->m_args = std::move(args);
+	queuedEvent->m_coalesceDuplicates = coalesceDuplicates;
+	m_queuedEvents.Push(queuedEvent);
+}
+
+void EventSystem::QueueEvent(EventID eventID, EventArgs& args, bool coalesceDuplicates)
+{
+	QueuedEvent* queuedEvent = new QueuedEvent();
+	queuedEvent->m_id = eventID;
+	queuedEvent->m_args = std::move(args);
+	queuedEvent->m_coalesceDuplicates = coalesceDuplicates;
+	m_queuedEvents.Push(queuedEvent);
+}
+
+void EventSystem::DeliverQueuedEvents()
+{
+	//events queued by subscribers during delivery land in the next batch
+	QueuedEvent* newestEvent = m_queuedEvents.PopAll();
+	if (newestEvent == nullptr)
+		return;
+
+	m_deliveryBatch.clear();
+	for (QueuedEvent* queuedEvent = newestEvent; queuedEvent != nullptr; queuedEvent = queuedEvent->m_next)
+	{
+		m_deliveryBatch.push_back(queuedEvent);
+	}
+
+	//batch is newest first, so the first coalescing copy seen for an id is the one that survives
+	m_coalescedEvents.clear();
+	for (int i = 0; i < m_deliveryBatch.size(); i++)
+	{
+		QueuedEvent* queuedEvent = m_deliveryBatch[i];
+		if (!queuedEvent->m_coalesceDuplicates)
+			continue;
+
+		bool alreadySeen = false;
+		for (int seenIndex = 0; seenIndex < m_coalescedEvents.size(); seenIndex++)
+		{
+			//an event queued by id matches any name with that id, two different names never do
+			const QueuedEvent* seenEvent = m_coalescedEvents[seenIndex];
+			if (seenEvent->m_id == queuedEvent->m_id && (seenEvent->m_name.empty() || queuedEvent->m_name.empty() || _stricmp(seenEvent->m_name.c_str(), queuedEvent->m_name.c_str()) == 0))
+			{
+				alreadySeen = true;
+				break;
+			}
+		}
+
+		if (alreadySeen)
+		{
+			delete queuedEvent;
+			m_deliveryBatch[i] = nullptr;
+		}
+		else
+		{
+			m_coalescedEvents.push_back(queuedEvent);
+		}
+	}
+
+	bool dispatchThreadSafeOnJobs = m_config.m_jobSystem != nullptr;
+	for (int i = (int)m_deliveryBatch.size() - 1; i >= 0; i--)
+	{
+		QueuedEvent* queuedEvent = m_deliveryBatch[i];
+		if (queuedEvent == nullptr)
+			continue;
+
+		const char* eventNameToVerify = queuedEvent->m_name.empty() ? nullptr : queuedEvent->m_name.c_str();
+		FireEvent(queuedEvent->m_id, eventNameToVerify, queuedEvent->m_args, dispatchThreadSafeOnJobs);
+		delete queuedEvent;
+	}
+	m_deliveryBatch.clear();
 }
 
 void EventSystem::GetRegisteredEventNames(std::vector<std::string>& outNames) const
 {
 	m_subscriptionListMutex.lock();
-	for (auto itr = m_subscriptionListByEventName.begin(); itr != m_subscriptionListByEventName.end(); ++itr)
+	EventTable* table = m_eventTable.load();
+	for (int slot = 0; table && slot < table->m_slots.size(); slot++)
 	{
-		SubscriptionList subList = itr->second;
-		if (subList.size() > 0)
+		EventEntry* entry = table->m_slots[slot];
+		if (entry == nullptr)
+			continue;
+
+		SubscriptionList* subList = entry->m_subscriptions.load();
+		if (subList && subList->size() > 0)
 		{
-			outNames.push_back(itr->first.m_originalString);
+			outNames.push_back(entry->m_name.GetOriginalString());
 		}
 	}
 	m_subscriptionListMutex.unlock();
@@ -133,28 +409,253 @@ void EventSystem::GetRegisteredEventNames(std::vector<std::string>& outNames) co
 
 void EventSystem::UnsubcribeObjectFromAllEvents(const void* object)
 {
-	for (auto iter = m_subscriptionListByEventName.begin(); iter != m_subscriptionListByEventName.end(); ++iter)
+	m_subscriptionListMutex.lock();
+	EventTable* table = m_eventTable.load();
+	for (int slot = 0; table && slot < table->m_slots.size(); slot++)
+	{
+		if (table->m_slots[slot] == nullptr)
+			continue;
+
+		RemoveSubscriptions(table->m_slots[slot], [object](EventSubscriptionBase* subscription)
+			{
+				return subscription->IsForObject(object);
+			}
+		);
+	}
+	m_subscriptionListMutex.unlock();
+}
+
+EventSubscriptionHandle EventSystem::AddSubscription(const char* eventName, EventSubscriptionBase* subscription, EventRecepient* recepient)
+{
+	m_subscriptionListMutex.lock();
+	EventEntry* entry = FindOrAddEventEntry(eventName);
+	SubscriptionList* oldList = entry->m_subscriptions.load();
+	SubscriptionList* newList = oldList ? new SubscriptionList(*oldList) : new SubscriptionList();
+	newList->push_back(subscription);
+	entry->m_subscriptions.store(newList);
+	if (oldList)
+	{
+		RetireSubscriptionList(oldList);
+	}
+	subscription->m_entry = entry;
+
+	EventSubscriptionHandle handle;
+	if (m_freeHandleSlots.empty())
+	{
+		handle.m_slotIndex = (unsigned int)m_handleSlots.size();
+		m_handleSlots.push_back(subscription);
+		m_handleGenerations.push_back(0);
+	}
+	else
 	{
-		SubscriptionList& subList = iter->second;
-		for (int i = 0; i < subList.size(); i++)
+		handle.m_slotIndex = m_freeHandleSlots.back();
+		m_freeHandleSlots.pop_back();
+		m_handleSlots[handle.m_slotIndex] = subscription;
+	}
+	handle.m_generation = m_handleGenerations[handle.m_slotIndex];
+	subscription->m_handleSlot = handle.m_slotIndex;
+
+	if (recepient)
+	{
+		subscription->m_recepient = recepient;
+		subscription->m_nextForRecepient = recepient->m_firstSubscription;
+		if (recepient->m_firstSubscription)
 		{
-			m_subscriptionListMutex.lock();
-			if (subList[i]->IsForObject(object))
+			recepient->m_firstSubscription->m_prevForRecepient = subscription;
+		}
+		recepient->m_firstSubscription = subscription;
+	}
+	m_subscriptionListMutex.unlock();
+	return handle;
+}
+
+void EventSystem::RemoveSubscription(EventSubscriptionBase* subscription)
+{
+	//caller holds m_subscriptionListMutex. O(1), the subscription stays in its event's list as a tombstone until EndFrame
+	subscription->m_isRemoved.store(true);
+
+	m_handleGenerations[subscription->m_handleSlot]++;
+	m_handleSlots[subscription->m_handleSlot] = nullptr;
+	m_freeHandleSlots.push_back(subscription->m_handleSlot);
+
+	EventRecepient* recepient = subscription->m_recepient;
+	if (recepient)
+	{
+		if (subscription->m_prevForRecepient)
+		{
+			subscription->m_prevForRecepient->m_nextForRecepient = subscription->m_nextForRecepient;
+		}
+		else
+		{
+			recepient->m_firstSubscription = subscription->m_nextForRecepient;
+		}
+
+		if (subscription->m_nextForRecepient)
+		{
+			subscription->m_nextForRecepient->m_prevForRecepient = subscription->m_prevForRecepient;
+		}
+		subscription->m_recepient = nullptr;
+		subscription->m_prevForRecepient = nullptr;
+		subscription->m_nextForRecepient = nullptr;
+	}
+
+	EventEntry* entry = subscription->m_entry;
+	if (!entry->m_hasTombstones)
+	{
+		entry->m_hasTombstones = true;
+		m_entriesWithTombstones.push_back(entry);
+	}
+}
+
+void EventSystem::CompactTombstonedSubscriptions()
+{
+	//caller holds m_subscriptionListMutex. one rebuilt list per event that lost subscribers this frame
+	for (int entryIndex = 0; entryIndex < m_entriesWithTombstones.size(); entryIndex++)
+	{
+		EventEntry* entry = m_entriesWithTombstones[entryIndex];
+		entry->m_hasTombstones = false;
+
+		SubscriptionList* oldList = entry->m_subscriptions.load();
+		SubscriptionList* newList = new SubscriptionList();
+		newList->reserve(oldList->size());
+		for (int i = 0; i < oldList->size(); i++)
+		{
+			EventSubscriptionBase* subscription = (*oldList)[i];
+			if (subscription->m_isRemoved.load())
+			{
+				RetireSubscription(subscription);
+			}
+			else
 			{
-				delete subList[i];
-				std::swap(subList[i], subList[subList.size() - 1]);
-				subList.pop_back();
+				newList->push_back(subscription);
 			}
-			m_subscriptionListMutex.unlock();
 		}
+
+		entry->m_subscriptions.store(newList);
+		RetireSubscriptionList(oldList);
 	}
+	m_entriesWithTombstones.clear();
 }
 
-void SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr)
+EventEntry* EventSystem::FindOrAddEventEntry(const char* eventName)
+{
+	//caller holds m_subscriptionListMutex
+	EventEntry* existingEntry = FindEventEntry(eventName);
+	if (existingEntry)
+		return existingEntry;
+
+	//another name may already own this id, both entries live in the table and lookups by name tell them apart
+	EventEntry* newEntry = new EventEntry();
+	newEntry->m_name = HashedCaseInsensitiveString(eventName);
+	newEntry->m_id = newEntry->m_name.GetID();
+	EventTable* oldTable = m_eventTable.load();
+
+	//publish a copy with the new entry, growing to keep the load factor under a half
+	size_t numSlots = oldTable->m_slots.size();
+	while ((size_t)(oldTable->m_numEntries + 1) * 2 > numSlots)
+	{
+		numSlots *= 2;
+	}
+
+	EventTable* newTable = new EventTable();
+	newTable->m_slots.resize(numSlots, nullptr);
+	for (int slot = 0; slot < oldTable->m_slots.size(); slot++)
+	{
+		if (oldTable->m_slots[slot])
+		{
+			newTable->Insert(oldTable->m_slots[slot]);
+		}
+	}
+	newTable->Insert(newEntry);
+	m_eventTable.store(newTable);
+	m_retiredEventTables[m_readEpoch.load() & 1].push_back(oldTable);
+	return newEntry;
+}
+
+EventEntry* EventSystem::FindEventEntry(const char* eventName) const
+{
+	EventTable* table = m_eventTable.load();
+	return table ? table->Find(MakeEventID(eventName), eventName) : nullptr;
+}
+
+unsigned int EventSystem::EnterReadEpoch()
+{
+	//re-check after registering, so a reader is never counted in an epoch that already ended
+	while (true)
+	{
+		unsigned int epoch = m_readEpoch.load();
+		m_numReadersInEpoch[epoch & 1].fetch_add(1);
+		if (m_readEpoch.load() == epoch)
+			return epoch;
+
+		m_numReadersInEpoch[epoch & 1].fetch_sub(1);
+	}
+}
+
+void EventSystem::ExitReadEpoch(unsigned int epoch)
+{
+	m_numReadersInEpoch[epoch & 1].fetch_sub(1);
+}
+
+void EventSystem::RetireSubscriptionList(SubscriptionList* list)
+{
+	m_retiredSubscriptionLists[m_readEpoch.load() & 1].push_back(list);
+}
+
+void EventSystem::RetireSubscription(EventSubscriptionBase* subscription)
+{
+	m_retiredSubscriptions[m_readEpoch.load() & 1].push_back(subscription);
+}
+
+void EventSystem::ReclaimRetiredSnapshots()
+{
+	//caller holds m_subscriptionListMutex. anything retired in the previous epoch was unpublished before the current
+	//epoch began, so once that epoch's readers are gone nobody can still be looking at it. never waits on readers,
+	//a callback that is still running just pushes the reclaim to a later frame
+	unsigned int epoch = m_readEpoch.load();
+	int previousEpochIndex = (epoch + 1) & 1;
+	if (m_numReadersInEpoch[previousEpochIndex].load() != 0)
+		return;
+
+	FreeRetiredSnapshots(previousEpochIndex);
+	m_readEpoch.store(epoch + 1);
+}
+
+void EventSystem::FreeRetiredSnapshots(int retireListIndex)
+{
+	for (int i = 0; i < m_retiredSubscriptions[retireListIndex].size(); i++)
+	{
+		delete m_retiredSubscriptions[retireListIndex][i];
+	}
+	m_retiredSubscriptions[retireListIndex].clear();
+
+	for (int i = 0; i < m_retiredSubscriptionLists[retireListIndex].size(); i++)
+	{
+		delete m_retiredSubscriptionLists[retireListIndex][i];
+	}
+	m_retiredSubscriptionLists[retireListIndex].clear();
+
+	for (int i = 0; i < m_retiredEventTables[retireListIndex].size(); i++)
+	{
+		delete m_retiredEventTables[retireListIndex][i];
+	}
+	m_retiredEventTables[retireListIndex].clear();
+}
+
+EventSubscriptionHandle SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr, bool isThreadSafe)
+{
+	if (g_theEventSystem)
+	{
+		return g_theEventSystem->SubscribeEventCallbackFunction(eventName, functionPtr, isThreadSafe);
+	}
+	return EventSubscriptionHandle();
+}
+
+void UnsubscribeEvent(EventSubscriptionHandle& handle)
 {
 	if (g_theEventSystem)
 	{
-		g_theEventSystem->SubscribeEventCallbackFunction(eventName, functionPtr);
+		g_theEventSystem->Unsubscribe(handle);
 	}
 }
 
@@ -182,6 +683,30 @@ void FireEvent(const std::string& eventName)
 	}
 }
 
+void FireEvent(EventID eventID, EventArgs& args)
+{
+	if (g_theEventSystem)
+	{
+		g_theEventSystem->FireEvent(eventID, args);
+	}
+}
+
+void QueueEvent(const std::string& eventName, EventArgs& args, bool coalesceDuplicates)
+{
+	if (g_theEventSystem)
+	{
+		g_theEventSystem->QueueEvent(eventName, args, coalesceDuplicates);
+	}
+}
+
+void QueueEvent(EventID eventID, EventArgs& args, bool coalesceDuplicates)
+{
+	if (g_theEventSystem)
+	{
+		g_theEventSystem->QueueEvent(eventID, args, coalesceDuplicates);
+	}
+}
+
 void UnsubscribeObjectFromAllEvents(const void* object)
 {
 	if (g_theEventSystem)
@@ -2,23 +2,52 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <type_traits>
 #include "Engine/Core/NamedProperties.hpp"
 #include "Engine/Core/NamedStrings.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/HashedCaseInsensitiveString.hpp"
+#include "Engine/Core/Job.hpp"
+
+class JobSystem;
 
 typedef NamedProperties EventArgs;
 typedef bool (*EventCallbackFunction) (EventArgs& args);
 
+//events are keyed by the case insensitive hash of their name, build ids for hot events once (or at compile time) and fire by id.
+//names that share a hash are kept apart by name, firing one of those by id alone finds nothing
+typedef unsigned int EventID;
+constexpr EventID MakeEventID(const char* eventName)
+{
+	return HashCaseInsensitive(eventName);
+}
+
 extern EventSystem* g_theEventSystem;
 
-void SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr);
+struct EventSubscriptionBase;
+struct EventEntry;
+
+//returned by every subscribe call, unsubscribing through it is O(1). a stale handle is ignored
+struct EventSubscriptionHandle
+{
+	unsigned int m_slotIndex = 0xFFFFFFFF;
+	unsigned int m_generation = 0;
+
+	bool IsValid() const { return m_slotIndex != 0xFFFFFFFF; }
+};
+
+EventSubscriptionHandle SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr, bool isThreadSafe = false);
+void UnsubscribeEvent(EventSubscriptionHandle& handle);
 void UnsubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr);
 void FireEvent(const std::string& eventName, EventArgs& args);
 void FireEvent(const std::string& eventName);
+void FireEvent(EventID eventID, EventArgs& args);
+void QueueEvent(const std::string& eventName, EventArgs& args, bool coalesceDuplicates = false);
+void QueueEvent(EventID eventID, EventArgs& args, bool coalesceDuplicates = false);
 
 template <typename T_ObjectType, typename T_MethodType>
-void SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr);
+EventSubscriptionHandle SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr, bool isThreadSafe = false);
 
 template <typename T_ObjectType, typename T_MethodType>
 void UnsubscribeMethodEventCallbackFunctionForObject(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtrToUnsub);
@@ -28,13 +57,18 @@ void UnsubscribeMethodEventCallbackFunctionForObject(T_ObjectType& object, T_Met
 
 void UnsubscribeObjectFromAllEvents(const void* object);
 
+//objects deriving from this keep an intrusive list of their own subscriptions, so destroying one only touches those
 class EventRecepient
 {
+	friend class EventSystem;
 public:
-	virtual ~EventRecepient()
-	{
-		UnsubscribeObjectFromAllEvents(reinterpret_cast<const void*>(this));
-	}
+	EventRecepient() = default;
+	EventRecepient(const EventRecepient& copyFrom);
+	EventRecepient& operator=(const EventRecepient& copyFrom);
+	virtual ~EventRecepient();
+
+private:
+	EventSubscriptionBase* m_firstSubscription = nullptr;
 };
 
 struct EventSubscriptionBase
@@ -45,6 +79,16 @@ public:
 	virtual bool Execute(EventArgs& args) = 0;
 	virtual bool IsForObject(const void* objectToCompare) const { UNUSED(objectToCompare); return false; }
 	virtual bool IsForFunction(const void* functionPtr) const { UNUSED(functionPtr); return false; }
+	virtual const void* GetTypeTag() const { return nullptr; }
+
+public:
+	bool m_isThreadSafe = false;			//may run on a job worker alongside other subscribers, args must be treated as read only
+	std::atomic<bool> m_isRemoved{ false };	//tombstone, skipped by FireEvent and dropped from the list at EndFrame
+	EventEntry* m_entry = nullptr;
+	unsigned int m_handleSlot = 0xFFFFFFFF;
+	EventRecepient* m_recepient = nullptr;
+	EventSubscriptionBase* m_prevForRecepient = nullptr;
+	EventSubscriptionBase* m_nextForRecepient = nullptr;
 };
 
 template <typename T_ObjectType>
@@ -69,6 +113,15 @@ public:
 
 		return false;
 	}
+	virtual const void* GetTypeTag() const override
+	{
+		return GetStaticTypeTag();
+	}
+	static const void* GetStaticTypeTag()
+	{
+		static char s_typeTag = 0;
+		return &s_typeTag;
+	}
 	bool IsForMethod(MethodPtr methodPtr) const 
 	{
 		if (m_methodcallback == methodPtr)
@@ -110,11 +163,66 @@ public:
 
 struct EventSystemConfig
 {
-
+	JobSystem* m_jobSystem = nullptr;		//when set, queued events run their thread safe subscribers on job workers in parallel
 };
 
 typedef std::vector<EventSubscriptionBase*> SubscriptionList;
 
+//subscriber lists and the event table are never changed once published, writers build a new copy and swap it in.
+//firing only reads published snapshots, so it takes no lock and doesn't allocate
+struct EventEntry
+{
+	EventID m_id = 0;
+	HashedCaseInsensitiveString m_name;
+	std::atomic<SubscriptionList*> m_subscriptions{ nullptr };
+	bool m_hasTombstones = false;
+};
+
+//events queued from any thread, delivered on the main thread when the queue is drained in BeginFrame/EndFrame
+struct QueuedEvent
+{
+	EventID m_id = 0;
+	std::string m_name;						//empty when queued by id
+	EventArgs m_args;
+	bool m_coalesceDuplicates = false;		//only the newest queued copy of this event gets delivered
+	QueuedEvent* m_next = nullptr;
+};
+
+//multiple producer single consumer, producers push onto the head with a cas and the consumer takes the whole list at once
+class QueuedEventList
+{
+public:
+	void Push(QueuedEvent* queuedEvent);
+	QueuedEvent* PopAll();					//returns the newest event first
+
+private:
+	std::atomic<QueuedEvent*> m_head{ nullptr };
+};
+
+class EventSubscriptionJob : public Job
+{
+	friend class EventSystem;
+public:
+	EventSubscriptionJob(EventSubscriptionBase* subscription, EventArgs& args);
+
+private:
+	EventSubscriptionBase* m_subscription = nullptr;
+	EventArgs& m_args;
+
+private:
+	void Execute() override;
+	void OnFinished() override;
+};
+
+struct EventTable
+{
+	std::vector<EventEntry*> m_slots;				//open addressing, power of two size
+	int m_numEntries = 0;
+
+	EventEntry* Find(EventID eventID, const char* eventName) const;		//eventName compared when given, names can share an id
+	void Insert(EventEntry* entry);
+};
+
 class EventSystem
 {
 public:
@@ -125,14 +233,22 @@ public:
 	void BeginFrame();
 	void EndFrame();
 
-	void SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr);
+	EventSubscriptionHandle SubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr, bool isThreadSafe = false);
+	void Unsubscribe(EventSubscriptionHandle& handle);
+	void UnsubscribeRecepient(EventRecepient& recepient);
 	void UnsubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFunction functionPtr);
 	void FireEvent(const std::string& eventName, EventArgs& args);
 	void FireEvent(const std::string& eventName);
+	void FireEvent(EventID eventID, EventArgs& args);
 	void GetRegisteredEventNames(std::vector<std::string>& outNames) const;
 
+	//safe to call from any thread, args are moved into the queue and delivered at the next BeginFrame/EndFrame
+	void QueueEvent(const std::string& eventName, EventArgs& args, bool coalesceDuplicates = false);
+	void QueueEvent(EventID eventID, EventArgs& args, bool coalesceDuplicates = false);
+	void DeliverQueuedEvents();
+
 	template <typename T_ObjectType, typename T_MethodType>
-	void SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr);
+	EventSubscriptionHandle SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr, bool isThreadSafe = false);
 
 	template <typename T_ObjectType, typename T_MethodType>
 	void UnsubscribeMethodEventCallbackFunctionForObject(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtrToUnsub);
@@ -142,57 +258,123 @@ public:
 
 	void UnsubcribeObjectFromAllEvents(const void* object);
 
+protected:
+	void FireEvent(EventID eventID, const char* eventNameToVerify, EventArgs& args, bool dispatchThreadSafeOnJobs = false);
+	EventSubscriptionHandle AddSubscription(const char* eventName, EventSubscriptionBase* subscription, EventRecepient* recepient);
+	EventEntry* FindOrAddEventEntry(const char* eventName);
+	EventEntry* FindEventEntry(const char* eventName) const;
+	template <typename T_Predicate>
+	void RemoveSubscriptions(EventEntry* entry, T_Predicate shouldRemove);
+	template <typename T_Predicate>
+	void RemoveRecepientSubscriptions(EventRecepient& recepient, T_Predicate shouldRemove);
+	void RemoveSubscription(EventSubscriptionBase* subscription);
+	void CompactTombstonedSubscriptions();
+
+	//readers register in the current epoch, retired snapshots are freed once every reader of their epoch has left
+	unsigned int EnterReadEpoch();
+	void ExitReadEpoch(unsigned int epoch);
+	void RetireSubscriptionList(SubscriptionList* list);
+	void RetireSubscription(EventSubscriptionBase* subscription);
+	void ReclaimRetiredSnapshots();
+	void FreeRetiredSnapshots(int retireListIndex);
+
 protected:
 	EventSystemConfig m_config;
-	std::map<HashedCaseInsensitiveString, SubscriptionList> m_subscriptionListByEventName;
-	mutable std::mutex m_subscriptionListMutex;
+	std::atomic<EventTable*> m_eventTable{ nullptr };
+	mutable std::mutex m_subscriptionListMutex;		//serializes writers only
+
+	std::atomic<unsigned int> m_readEpoch{ 0 };
+	std::atomic<int> m_numReadersInEpoch[2];
+	std::vector<SubscriptionList*> m_retiredSubscriptionLists[2];
+	std::vector<EventSubscriptionBase*> m_retiredSubscriptions[2];
+	std::vector<EventTable*> m_retiredEventTables[2];
+
+	std::vector<EventSubscriptionBase*> m_handleSlots;			//handle slot -> live subscription, guarded by the writer mutex
+	std::vector<unsigned int> m_handleGenerations;
+	std::vector<unsigned int> m_freeHandleSlots;
+	std::vector<EventEntry*> m_entriesWithTombstones;
+
+	QueuedEventList m_queuedEvents;
+	std::vector<QueuedEvent*> m_deliveryBatch;
+	std::vector<const QueuedEvent*> m_coalescedEvents;
 };
 
-template <typename T_ObjectType, typename T_MethodType>
-void EventSystem::SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr)
+template <typename T_Predicate>
+void EventSystem::RemoveSubscriptions(EventEntry* entry, T_Predicate shouldRemove)
 {
-	std::map<HashedCaseInsensitiveString, SubscriptionList>::iterator iter;
-	m_subscriptionListMutex.lock();
-	iter = m_subscriptionListByEventName.find(eventName);
-	if (iter == m_subscriptionListByEventName.end())
+	//caller holds m_subscriptionListMutex
+	SubscriptionList* subList = entry->m_subscriptions.load();
+	for (int i = 0; subList && i < subList->size(); i++)
 	{
-		SubscriptionList subList;
-		EventSubscriptionBase* eventSub = new Methods_EventSubscription<T_ObjectType>(object, methodPtr);
-		subList.push_back(eventSub);
-		m_subscriptionListByEventName[eventName] = subList;
+		EventSubscriptionBase* subscription = (*subList)[i];
+		if (!subscription->m_isRemoved.load() && shouldRemove(subscription))
+		{
+			RemoveSubscription(subscription);
+		}
 	}
-	else
+}
+
+template <typename T_Predicate>
+void EventSystem::RemoveRecepientSubscriptions(EventRecepient& recepient, T_Predicate shouldRemove)
+{
+	//caller holds m_subscriptionListMutex
+	EventSubscriptionBase* subscription = recepient.m_firstSubscription;
+	while (subscription)
 	{
-		SubscriptionList& subList = iter->second;
-		EventSubscriptionBase* eventSub = new Methods_EventSubscription<T_ObjectType>(object, methodPtr);
-		subList.push_back(eventSub);
+		EventSubscriptionBase* nextSubscription = subscription->m_nextForRecepient;
+		if (shouldRemove(subscription))
+		{
+			RemoveSubscription(subscription);
+		}
+		subscription = nextSubscription;
 	}
-	m_subscriptionListMutex.unlock();
+}
+
+//subscriptions from objects deriving from EventRecepient get linked into the object's own list
+template <typename T_ObjectType>
+EventRecepient* GetEventRecepient(T_ObjectType& object, std::true_type)
+{
+	return &static_cast<EventRecepient&>(object);
+}
+
+template <typename T_ObjectType>
+EventRecepient* GetEventRecepient(T_ObjectType& object, std::false_type)
+{
+	UNUSED(object);
+	return nullptr;
+}
+
+template <typename T_ObjectType>
+EventRecepient* GetEventRecepient(T_ObjectType& object)
+{
+	return GetEventRecepient(object, std::is_base_of<EventRecepient, T_ObjectType>());
+}
+
+template <typename T_ObjectType, typename T_MethodType>
+EventSubscriptionHandle EventSystem::SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr, bool isThreadSafe)
+{
+	EventSubscriptionBase* subscription = new Methods_EventSubscription<T_ObjectType>(object, methodPtr);
+	subscription->m_isThreadSafe = isThreadSafe;
+	return AddSubscription(eventName.c_str(), subscription, GetEventRecepient(object));
 }
 
 template <typename T_ObjectType, typename T_MethodType>
 void EventSystem::UnsubscribeMethodEventCallbackFunctionForObject(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtrToUnsub)
 {
-	std::map<HashedCaseInsensitiveString, SubscriptionList>::iterator iter;
 	bool unsubscribeSuccess = false;
 	m_subscriptionListMutex.lock();
-	iter = m_subscriptionListByEventName.find(eventName);
-	if (iter != m_subscriptionListByEventName.end())
+	EventEntry* entry = FindEventEntry(eventName.c_str());
+	if (entry != nullptr)
 	{
-		SubscriptionList& subList = iter->second;
-		for (int i = 0; i < subList.size(); i++)
-		{
-			if (subList[i]->IsForObject(reinterpret_cast<void*>(&object)))
+		RemoveSubscriptions(entry, [&object, methodPtrToUnsub](EventSubscriptionBase* subscription)
 			{
-				Methods_EventSubscription<T_ObjectType>* methodSub = dynamic_cast<Methods_EventSubscription<T_ObjectType>*>(subList[i]);
-				if (methodSub && methodSub->IsForMethod(methodPtrToUnsub))
-				{
-					delete subList[i];
-					std::swap(subList[i], subList[subList.size() - 1]);
-					subList.pop_back();
-				}
+				if (subscription->GetTypeTag() != Methods_EventSubscription<T_ObjectType>::GetStaticTypeTag())
+					return false;
+
+				Methods_EventSubscription<T_ObjectType>* methodSub = static_cast<Methods_EventSubscription<T_ObjectType>*>(subscription);
+				return methodSub->IsForObject(reinterpret_cast<void*>(&object)) && methodSub->IsForMethod(methodPtrToUnsub);
 			}
-		}
+		);
 		unsubscribeSuccess = true;
 	}
 	m_subscriptionListMutex.unlock();
@@ -206,21 +388,29 @@ void EventSystem::UnsubscribeMethodEventCallbackFunctionForObject(const std::str
 template <typename T_ObjectType, typename T_MethodType>
 void EventSystem::UnsubscribeMethodEventCallbackFunctionForObject(T_ObjectType& object, T_MethodType methodPtrToUnsub)
 {
+	auto isForMethod = [&object, methodPtrToUnsub](EventSubscriptionBase* subscription)
+	{
+		if (subscription->GetTypeTag() != Methods_EventSubscription<T_ObjectType>::GetStaticTypeTag())
+			return false;
+
+		Methods_EventSubscription<T_ObjectType>* methodSub = static_cast<Methods_EventSubscription<T_ObjectType>*>(subscription);
+		return methodSub->IsForObject(reinterpret_cast<void*>(&object)) && methodSub->IsForMethod(methodPtrToUnsub);
+	};
+
 	m_subscriptionListMutex.lock();
-	for (auto iter = m_subscriptionListByEventName.begin(); iter != m_subscriptionListByEventName.end(); ++iter)
+	EventRecepient* recepient = GetEventRecepient(object);
+	if (recepient)
+	{
+		RemoveRecepientSubscriptions(*recepient, isForMethod);
+	}
+	else
 	{
-		SubscriptionList& subList = iter->second;
-		for (int i = 0; i < subList.size(); i++)
+		EventTable* table = m_eventTable.load();
+		for (int slot = 0; table && slot < table->m_slots.size(); slot++)
 		{
-			if (subList[i]->IsForObject(reinterpret_cast<void*>(&object)))
+			if (table->m_slots[slot])
 			{
-				Methods_EventSubscription<T_ObjectType>* methodSub = dynamic_cast<Methods_EventSubscription<T_ObjectType>*>(subList[i]);
-				if (methodSub && methodSub->IsForMethod(methodPtrToUnsub))
-				{
-					delete subList[i];
-					std::swap(subList[i], subList[subList.size() - 1]);
-					subList.pop_back();
-				}
+				RemoveSubscriptions(table->m_slots[slot], isForMethod);
 			}
 		}
 	}
@@ -228,12 +418,13 @@ void EventSystem::UnsubscribeMethodEventCallbackFunctionForObject(T_ObjectType&
 }
 
 template <typename T_ObjectType, typename T_MethodType>
-void SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr)
+EventSubscriptionHandle SubscribeEventCallbackFunctionObjectMethod(const std::string& eventName, T_ObjectType& object, T_MethodType methodPtr, bool isThreadSafe)
 {
 	if (g_theEventSystem)
 	{
-		g_theEventSystem->SubscribeEventCallbackFunctionObjectMethod(eventName, object, methodPtr);
+		return g_theEventSystem->SubscribeEventCallbackFunctionObjectMethod(eventName, object, methodPtr, isThreadSafe);
 	}
+	return EventSubscriptionHandle();
 }
 
 template <typename T_ObjectType, typename T_MethodType>
@@ -1,48 +1,84 @@
+#ifdef _WIN32
+#define PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <sys/stat.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <fstream>
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/PackFile.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
 bool DoesFileExist(const std::string& fileName)
 {
+	const PackFile* packFile = nullptr;
+	if (FindMountedPackEntry(fileName.c_str(), &packFile))
+		return true;
+
 	std::ifstream fileStream(fileName.c_str());
 	return fileStream.good();
 }
 
 int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename)
 {
-	std::ifstream readfileStream;
-	readfileStream.open(filename, std::ifstream::binary);
-	if (readfileStream.is_open())
-	{
-		readfileStream.seekg(0, readfileStream.end);
-		int length = static_cast<int>(readfileStream.tellg());
-		readfileStream.seekg(0, readfileStream.beg);
-
-		char* readBuffer = new char[length];
-		readfileStream.read(readBuffer, length);
-		outBuffer.resize(length);
-		memcpy(outBuffer.data(), readBuffer, sizeof(char) * length);
-		delete[] readBuffer;
-		readfileStream.close();
+	if (TryFileReadToBuffer(outBuffer, filename))
 		return 0;
-	}
-	else
-	{
-		std::string errorString = "Failed to open ";
-		errorString.append(filename);
-		ERROR_AND_DIE(errorString);
-		return -1;
-	}
+
+	std::string errorString = "Failed to open ";
+	errorString.append(filename);
+	ERROR_AND_DIE(errorString);
+	return -1;
 }
 
 int FileReadToString(std::string& outString, const std::string& filename)
 {
-	std::vector<uint8_t> buffer;
-	int result= FileReadToBuffer(buffer, filename);
-	buffer.push_back('\0');
-	outString.assign(buffer.begin(), buffer.end());
-	return result;
+	if (TryFileReadToString(outString, filename))
+		return 0;
+
+	std::string errorString = "Failed to open ";
+	errorString.append(filename);
+	ERROR_AND_DIE(errorString);
+	return -1;
+}
+
+bool TryFileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename)
+{
+	//one read straight into the output. callers that only parse the bytes should map the file instead
+	int64_t fileSize = GetFileSizeInBytes(filename);
+	if (fileSize < 0)
+		return false;
+
+	outBuffer.resize((size_t)fileSize);
+	int64_t bytesRead = FileReadIntoMemory(outBuffer.data(), outBuffer.size(), filename);
+	if (bytesRead < 0)
+		return false;
+
+	outBuffer.resize((size_t)bytesRead);
+	return true;
+}
+
+bool TryFileReadToString(std::string& outString, const std::string& filename)
+{
+	int64_t fileSize = GetFileSizeInBytes(filename);
+	if (fileSize < 0)
+		return false;
+
+	//keeps the trailing '\0' the text parsers have always been handed
+	outString.resize((size_t)fileSize + 1);
+	int64_t bytesRead = FileReadIntoMemory(&outString[0], (size_t)fileSize, filename);
+	if (bytesRead < 0)
+		return false;
+
+	outString.resize((size_t)bytesRead + 1);
+	outString[(size_t)bytesRead] = '\0';
+	return true;
 }
 
 int BufferWriteToFile(const std::vector<uint8_t>& buffer, const std::string& filename, bool createFileIfItDoesNotExist)
@@ -104,3 +140,243 @@ void FileStream::Close()
 {
 	fclose(filePtr);
 }
+
+ByteSpan ByteSpan::SubSpan(size_t offset, size_t size) const
+{
+	if (offset > m_size)
+		return ByteSpan();
+	if (size > m_size - offset)
+		size = m_size - offset;
+	return ByteSpan(m_data + offset, size);
+}
+
+MappedFile::MappedFile(const std::string& filename, FileAccessPattern accessPattern)
+{
+	Open(filename, accessPattern);
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& moveFrom) noexcept
+	:m_data(moveFrom.m_data), m_size(moveFrom.m_size), m_isOpen(moveFrom.m_isOpen), m_isInPackFile(moveFrom.m_isInPackFile), m_unpackedData(std::move(moveFrom.m_unpackedData))
+{
+	moveFrom.m_data = nullptr;
+	moveFrom.m_size = 0;
+	moveFrom.m_isOpen = false;
+	moveFrom.m_isInPackFile = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& moveFrom) noexcept
+{
+	if (this != &moveFrom)
+	{
+		Close();
+		m_data = moveFrom.m_data;
+		m_size = moveFrom.m_size;
+		m_isOpen = moveFrom.m_isOpen;
+		m_isInPackFile = moveFrom.m_isInPackFile;
+		m_unpackedData = std::move(moveFrom.m_unpackedData);
+		moveFrom.m_data = nullptr;
+		moveFrom.m_size = 0;
+		moveFrom.m_isOpen = false;
+		moveFrom.m_isInPackFile = false;
+	}
+	return *this;
+}
+
+bool MappedFile::Open(const std::string& filename, FileAccessPattern accessPattern)
+{
+	Close();
+
+	//a stored entry is used in place from the pack's own mapping, a compressed one is decoded into memory we own
+	const PackFile* packFile = nullptr;
+	const PackFileEntry* packEntry = FindMountedPackEntry(filename.c_str(), &packFile);
+	if (packEntry)
+	{
+		if (packEntry->m_compression == (uint16_t)ePackCompression::NONE)
+		{
+			m_data = packFile->GetStoredBytes(*packEntry).m_data;
+		}
+		else
+		{
+			m_unpackedData.resize(packEntry->m_originalSize);
+			if (packFile->ReadEntry(*packEntry, 0, m_unpackedData.data(), m_unpackedData.size()) != (int64_t)m_unpackedData.size())
+			{
+				std::vector<uint8_t>().swap(m_unpackedData);
+				return false;
+			}
+			m_data = m_unpackedData.data();
+		}
+		m_size = packEntry->m_originalSize;
+		m_isInPackFile = true;
+		m_isOpen = true;
+		if (accessPattern == FileAccessPattern::SEQUENTIAL)
+		{
+			PrefetchRange(0, m_size);
+		}
+		return true;
+	}
+
+	//the file and mapping handles can be closed as soon as the view exists, the view keeps the file alive on its own
+#if defined( PLATFORM_WINDOWS )
+	DWORD accessFlags = accessPattern == FileAccessPattern::SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+	HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | accessFlags, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	//windows refuses to map an empty file, but an empty file is still a perfectly good open file
+	if (fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		m_isOpen = true;
+		return true;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(fileHandle);
+	if (mappingHandle == nullptr)
+		return false;
+
+	void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mappingHandle);
+	if (view == nullptr)
+		return false;
+
+	m_data = (const uint8_t*)view;
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	int fileDescriptor = open(filename.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStats;
+	if (fstat(fileDescriptor, &fileStats) != 0 || !S_ISREG(fileStats.st_mode))
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	if (fileStats.st_size == 0)
+	{
+		close(fileDescriptor);
+		m_isOpen = true;
+		return true;
+	}
+
+	void* view = mmap(nullptr, (size_t)fileStats.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (view == MAP_FAILED)
+		return false;
+
+	madvise(view, (size_t)fileStats.st_size, accessPattern == FileAccessPattern::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+	m_data = (const uint8_t*)view;
+	m_size = (size_t)fileStats.st_size;
+#endif
+
+	m_isOpen = true;
+	if (accessPattern == FileAccessPattern::SEQUENTIAL)
+	{
+		PrefetchRange(0, m_size);
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data != nullptr && !m_isInPackFile)
+	{
+#if defined( PLATFORM_WINDOWS )
+		UnmapViewOfFile(m_data);
+#else
+		munmap((void*)m_data, m_size);
+#endif
+	}
+
+	std::vector<uint8_t>().swap(m_unpackedData);
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+	m_isInPackFile = false;
+}
+
+void MappedFile::PrefetchRange(size_t offset, size_t size) const
+{
+	ByteSpan range = GetBytes().SubSpan(offset, size);
+	if (range.IsEmpty())
+		return;
+
+#if defined( PLATFORM_WINDOWS )
+	WIN32_MEMORY_RANGE_ENTRY rangeEntry;
+	rangeEntry.VirtualAddress = (PVOID)range.m_data;
+	rangeEntry.NumberOfBytes = range.m_size;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &rangeEntry, 0);
+#else
+	//madvise wants a page aligned start
+	uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t rangeStart = (uintptr_t)range.m_data & ~(pageSize - 1);
+	madvise((void*)rangeStart, (uintptr_t)range.m_data + range.m_size - rangeStart, MADV_WILLNEED);
+#endif
+}
+
+int64_t GetFileSizeInBytes(const std::string& filename)
+{
+	const PackFile* packFile = nullptr;
+	const PackFileEntry* packEntry = FindMountedPackEntry(filename.c_str(), &packFile);
+	if (packEntry)
+		return (int64_t)packEntry->m_originalSize;
+
+#if defined( PLATFORM_WINDOWS )
+	struct _stat64 fileStats;
+	if (_stat64(filename.c_str(), &fileStats) != 0)
+		return -1;
+#else
+	struct stat fileStats;
+	if (stat(filename.c_str(), &fileStats) != 0)
+		return -1;
+#endif
+	return (int64_t)fileStats.st_size;
+}
+
+int64_t FileReadIntoMemory(void* outMemory, size_t maxBytes, const std::string& filename)
+{
+	const PackFile* packFile = nullptr;
+	const PackFileEntry* packEntry = FindMountedPackEntry(filename.c_str(), &packFile);
+	if (packEntry)
+		return packFile->ReadEntry(*packEntry, 0, outMemory, maxBytes);
+
+	FILE* filePtr = nullptr;
+	fopen_s(&filePtr, filename.c_str(), "rb");
+	if (filePtr == nullptr)
+		return -1;
+
+	//no stdio buffer, the reads go straight into the caller's memory
+	setvbuf(filePtr, nullptr, _IONBF, 0);
+	size_t totalBytesRead = 0;
+	while (totalBytesRead < maxBytes)
+	{
+		size_t bytesRead = fread((char*)outMemory + totalBytesRead, 1, maxBytes - totalBytesRead, filePtr);
+		if (bytesRead == 0)
+			break;
+		totalBytesRead += bytesRead;
+	}
+
+	//a short read is only fine if it stopped at the end of the file, not on an error part way through
+	bool hadReadError = ferror(filePtr) != 0;
+	fclose(filePtr);
+	if (hadReadError)
+	{
+		DebuggerPrintf("Read error in \"%s\" after %zu bytes\n", filename.c_str(), totalBytesRead);
+		return -1;
+	}
+	return (int64_t)totalBytesRead;
+}
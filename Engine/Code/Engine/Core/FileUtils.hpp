@@ -1,10 +1,36 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <stdint.h>
+
+//non owning view of some bytes, what BufferParser and the file loaders pass around instead of copying into a vector
+struct ByteSpan
+{
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+
+	ByteSpan() = default;
+	ByteSpan(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+	ByteSpan(const std::vector<uint8_t>& buffer) : m_data(buffer.data()), m_size(buffer.size()) {}
+
+	bool IsEmpty() const { return m_size == 0; }
+	const uint8_t* begin() const { return m_data; }
+	const uint8_t* end() const { return m_data + m_size; }
+	ByteSpan SubSpan(size_t offset, size_t size) const;
+};
+
+enum class FileAccessPattern
+{
+	SEQUENTIAL,		//read front to back once, os reads ahead aggressively and drops pages behind the reader
+	RANDOM			//jumping around, no read ahead
+};
 
 bool DoesFileExist(const std::string& fileName);
 int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename);
 int FileReadToString(std::string& outString, const std::string& filename);
+//same reads for files that may legitimately be missing or mid-write, false instead of dying
+bool TryFileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename);
+bool TryFileReadToString(std::string& outString, const std::string& filename);
 int BufferWriteToFile(const std::vector<uint8_t>& buffer, const std::string& filename, bool createFileIfItDoesNotExist = true);
 
 class FileStream
@@ -20,3 +46,41 @@ public:
 private:
 	FILE* filePtr = nullptr;
 };
+
+//read only memory mapping of a whole file. the bytes are paged in by the os on first touch, so nothing is copied
+//into our memory until someone actually reads it. the view stays valid until Close or destruction, or for a file
+//in a mounted pack until the pack is unmounted
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& filename, FileAccessPattern accessPattern = FileAccessPattern::SEQUENTIAL);
+	~MappedFile();
+	MappedFile(const MappedFile& copyFrom) = delete;
+	MappedFile& operator=(const MappedFile& copyFrom) = delete;
+	MappedFile(MappedFile&& moveFrom) noexcept;
+	MappedFile& operator=(MappedFile&& moveFrom) noexcept;
+
+	bool Open(const std::string& filename, FileAccessPattern accessPattern = FileAccessPattern::SEQUENTIAL);
+	void Close();
+	bool IsOpen() const { return m_isOpen; }
+
+	const uint8_t* GetData() const { return m_data; }
+	size_t GetSize() const { return m_size; }
+	ByteSpan GetBytes() const { return ByteSpan(m_data, m_size); }
+
+	//asks the os to start paging in a range we are about to read
+	void PrefetchRange(size_t offset, size_t size) const;
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_isOpen = false;
+	bool m_isInPackFile = false;
+	std::vector<uint8_t> m_unpackedData;		//compressed pack entries only
+};
+
+//single copy read straight into the output, for callers that need to own or modify the bytes. returns bytes read, or -1
+//if the file can't be opened or a read fails
+int64_t FileReadIntoMemory(void* outMemory, size_t maxBytes, const std::string& filename);
+int64_t GetFileSizeInBytes(const std::string& filename);
@@ -0,0 +1,323 @@
+#ifdef _WIN32
+#define PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "Engine/Core/FileWatcher.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <chrono>
+#include <ctype.h>
+
+constexpr size_t FILE_WATCHER_BUFFER_SIZE = 16 * 1024;
+
+struct FileWatcher::WatchedDirectory
+{
+	std::string m_path;
+#if defined(PLATFORM_WINDOWS)
+	HANDLE m_handle = INVALID_HANDLE_VALUE;
+	OVERLAPPED m_overlapped = {};
+	bool m_isReadPending = false;
+	alignas(DWORD) uint8_t m_buffer[FILE_WATCHER_BUFFER_SIZE];
+#else
+	int m_watchDescriptor = -1;
+#endif
+};
+
+//one spelling per file so a change reported for a directory can be matched against the watched paths
+static std::string NormalizeWatchPath(const std::string& path)
+{
+	std::string normalizedPath = path;
+	std::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
+	while (normalizedPath.compare(0, 2, "./") == 0)
+	{
+		normalizedPath.erase(0, 2);
+	}
+#if defined(PLATFORM_WINDOWS)
+	std::transform(normalizedPath.begin(), normalizedPath.end(), normalizedPath.begin(), [](char c) { return (char)tolower((unsigned char)c); });
+#endif
+	return normalizedPath;
+}
+
+static std::string GetWatchDirectory(const std::string& normalizedPath)
+{
+	size_t lastSlash = normalizedPath.find_last_of('/');
+	if (lastSlash == std::string::npos)
+		return ".";
+
+	return lastSlash == 0 ? "/" : normalizedPath.substr(0, lastSlash);
+}
+
+#if defined(PLATFORM_WINDOWS)
+static std::string ConvertWideFileName(const WCHAR* fileName, DWORD fileNameBytes)
+{
+	int numWideChars = (int)(fileNameBytes / sizeof(WCHAR));
+	int numChars = WideCharToMultiByte(CP_UTF8, 0, fileName, numWideChars, nullptr, 0, nullptr, nullptr);
+	std::string convertedName((size_t)numChars, '\0');
+	WideCharToMultiByte(CP_UTF8, 0, fileName, numWideChars, &convertedName[0], numChars, nullptr, nullptr);
+	return convertedName;
+}
+#endif
+
+FileWatcher::FileWatcher(const FileWatcherConfig& config)
+	:m_config(config)
+{
+}
+
+void FileWatcher::Startup()
+{
+	m_isQuitting = false;
+#if !defined(PLATFORM_WINDOWS)
+	m_platformHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	GUARANTEE_OR_DIE(m_platformHandle >= 0, "Couldn't create the inotify instance for the file watcher");
+
+	//files watched before startup only recorded their directories
+	std::lock_guard<std::mutex> lock(m_directoriesMutex);
+	for (int i = 0; i < m_directories.size(); i++)
+	{
+		m_directories[i]->m_watchDescriptor = inotify_add_watch(m_platformHandle, m_directories[i]->m_path.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+	}
+#endif
+	m_watchThread = new std::thread(&FileWatcher::WatchThreadMain, this);
+}
+
+void FileWatcher::Shutdown()
+{
+	m_isQuitting = true;
+	if (m_watchThread)
+	{
+		m_watchThread->join();
+		delete m_watchThread;
+		m_watchThread = nullptr;
+	}
+
+	for (int i = 0; i < m_directories.size(); i++)
+	{
+#if defined(PLATFORM_WINDOWS)
+		if (m_directories[i]->m_handle != INVALID_HANDLE_VALUE)
+		{
+			//the read has to be finished with the buffer before the buffer goes away
+			if (m_directories[i]->m_isReadPending)
+			{
+				DWORD numBytes = 0;
+				CancelIoEx(m_directories[i]->m_handle, &m_directories[i]->m_overlapped);
+				GetOverlappedResult(m_directories[i]->m_handle, &m_directories[i]->m_overlapped, &numBytes, TRUE);
+			}
+			CloseHandle(m_directories[i]->m_handle);
+		}
+#endif
+		delete m_directories[i];
+	}
+	m_directories.clear();
+#if !defined(PLATFORM_WINDOWS)
+	if (m_platformHandle >= 0)
+	{
+		close(m_platformHandle);
+		m_platformHandle = -1;
+	}
+#endif
+
+	m_watches.clear();
+	m_pendingChanges.clear();
+}
+
+void FileWatcher::BeginFrame()
+{
+	std::vector<std::string> settledPaths;
+	uint64_t currentRawTime = GetCurrentTimeRaw();
+	m_pendingChangesMutex.lock();
+	for (auto changeIter = m_pendingChanges.begin(); changeIter != m_pendingChanges.end();)
+	{
+		if (ConvertRawTimeToSeconds(currentRawTime - changeIter->second) >= m_config.m_settleSeconds)
+		{
+			settledPaths.push_back(changeIter->first);
+			changeIter = m_pendingChanges.erase(changeIter);
+		}
+		else
+		{
+			++changeIter;
+		}
+	}
+	m_pendingChangesMutex.unlock();
+
+	//callbacks can watch and unwatch files, so each one is looked up again right before it runs
+	std::vector<FileWatchID> watchesToNotify;
+	for (int pathIndex = 0; pathIndex < settledPaths.size(); pathIndex++)
+	{
+		watchesToNotify.clear();
+		for (int i = 0; i < m_watches.size(); i++)
+		{
+			if (m_watches[i].m_normalizedPath == settledPaths[pathIndex])
+			{
+				watchesToNotify.push_back(m_watches[i].m_id);
+				//a mounted pack would otherwise keep handing the reload the bytes from before the change
+				OverridePackedFileWithLooseFile(m_watches[i].m_filePath.c_str());
+			}
+		}
+
+		for (int notifyIndex = 0; notifyIndex < watchesToNotify.size(); notifyIndex++)
+		{
+			auto watchIter = std::find_if(m_watches.begin(), m_watches.end(), [&](const FileWatch& watch) { return watch.m_id == watchesToNotify[notifyIndex]; });
+			if (watchIter == m_watches.end())
+				continue;
+
+			std::string filePath = watchIter->m_filePath;
+			FileChangedCallback callback = watchIter->m_callback;
+			void* userData = watchIter->m_userData;
+			callback(filePath, userData);
+		}
+	}
+}
+
+FileWatchID FileWatcher::WatchFile(const std::string& filePath, FileChangedCallback callback, void* userData)
+{
+	FileWatch watch;
+	watch.m_id = m_nextWatchID++;
+	watch.m_filePath = filePath;
+	watch.m_normalizedPath = NormalizeWatchPath(filePath);
+	watch.m_callback = callback;
+	watch.m_userData = userData;
+	WatchDirectory(GetWatchDirectory(watch.m_normalizedPath));
+	m_watches.push_back(watch);
+	return watch.m_id;
+}
+
+void FileWatcher::UnwatchFile(FileWatchID watchID)
+{
+	auto watchIter = std::find_if(m_watches.begin(), m_watches.end(), [&](const FileWatch& watch) { return watch.m_id == watchID; });
+	if (watchIter != m_watches.end())
+	{
+		m_watches.erase(watchIter);
+	}
+}
+
+void FileWatcher::WatchDirectory(const std::string& normalizedDirectory)
+{
+	std::lock_guard<std::mutex> lock(m_directoriesMutex);
+	for (int i = 0; i < m_directories.size(); i++)
+	{
+		if (m_directories[i]->m_path == normalizedDirectory)
+			return;
+	}
+
+	WatchedDirectory* directory = new WatchedDirectory();
+	directory->m_path = normalizedDirectory;
+#if defined(PLATFORM_WINDOWS)
+	//the watch thread issues the reads, overlapped io belongs to the thread that started it
+	directory->m_handle = CreateFileA(normalizedDirectory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+		OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (directory->m_handle == INVALID_HANDLE_VALUE)
+	{
+		DebuggerPrintf("FileWatcher couldn't watch directory \"%s\"\n", normalizedDirectory.c_str());
+	}
+#else
+	if (m_platformHandle >= 0)
+	{
+		directory->m_watchDescriptor = inotify_add_watch(m_platformHandle, normalizedDirectory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+		if (directory->m_watchDescriptor < 0)
+		{
+			DebuggerPrintf("FileWatcher couldn't watch directory \"%s\"\n", normalizedDirectory.c_str());
+		}
+	}
+#endif
+	m_directories.push_back(directory);
+}
+
+void FileWatcher::ReportChange(const std::string& normalizedDirectory, const std::string& fileName)
+{
+	std::string changedPath = NormalizeWatchPath(normalizedDirectory == "." ? fileName : normalizedDirectory + "/" + fileName);
+	uint64_t changeRawTime = GetCurrentTimeRaw();
+	std::lock_guard<std::mutex> lock(m_pendingChangesMutex);
+	m_pendingChanges[changedPath] = changeRawTime;
+}
+
+void FileWatcher::WatchThreadMain()
+{
+#if defined(PLATFORM_WINDOWS)
+	std::vector<WatchedDirectory*> directories;
+	while (!m_isQuitting)
+	{
+		m_directoriesMutex.lock();
+		directories = m_directories;
+		m_directoriesMutex.unlock();
+
+		for (int i = 0; i < directories.size(); i++)
+		{
+			WatchedDirectory* directory = directories[i];
+			if (directory->m_handle == INVALID_HANDLE_VALUE)
+				continue;
+
+			if (directory->m_isReadPending)
+			{
+				if (!HasOverlappedIoCompleted(&directory->m_overlapped))
+					continue;
+
+				DWORD numBytes = 0;
+				directory->m_isReadPending = false;
+				if (GetOverlappedResult(directory->m_handle, &directory->m_overlapped, &numBytes, FALSE) && numBytes > 0)
+				{
+					const uint8_t* notifyData = directory->m_buffer;
+					for (;;)
+					{
+						const FILE_NOTIFY_INFORMATION* notification = (const FILE_NOTIFY_INFORMATION*)notifyData;
+						if (notification->Action == FILE_ACTION_ADDED || notification->Action == FILE_ACTION_MODIFIED || notification->Action == FILE_ACTION_RENAMED_NEW_NAME)
+						{
+							ReportChange(directory->m_path, ConvertWideFileName(notification->FileName, notification->FileNameLength));
+						}
+						if (notification->NextEntryOffset == 0)
+							break;
+
+						notifyData += notification->NextEntryOffset;
+					}
+				}
+			}
+
+			directory->m_overlapped = {};
+			directory->m_isReadPending = ReadDirectoryChangesW(directory->m_handle, directory->m_buffer, (DWORD)FILE_WATCHER_BUFFER_SIZE, FALSE,
+				FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE, nullptr, &directory->m_overlapped, nullptr) != FALSE;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(m_config.m_pollMilliseconds));
+	}
+#else
+	alignas(inotify_event) char eventBuffer[FILE_WATCHER_BUFFER_SIZE];
+	while (!m_isQuitting)
+	{
+		pollfd pollRequest = { m_platformHandle, POLLIN, 0 };
+		if (poll(&pollRequest, 1, m_config.m_pollMilliseconds) <= 0)
+			continue;
+
+		ssize_t numBytes = read(m_platformHandle, eventBuffer, sizeof(eventBuffer));
+		for (ssize_t offset = 0; offset < numBytes;)
+		{
+			const inotify_event* event = (const inotify_event*)(eventBuffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+			if (event->len == 0)
+				continue;
+
+			std::string directoryPath;
+			m_directoriesMutex.lock();
+			for (int i = 0; i < m_directories.size(); i++)
+			{
+				if (m_directories[i]->m_watchDescriptor == event->wd)
+				{
+					directoryPath = m_directories[i]->m_path;
+					break;
+				}
+			}
+			m_directoriesMutex.unlock();
+			if (!directoryPath.empty())
+			{
+				ReportChange(directoryPath, event->name);
+			}
+		}
+	}
+#endif
+}
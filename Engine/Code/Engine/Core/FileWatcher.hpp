@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+typedef unsigned int FileWatchID;
+constexpr FileWatchID INVALID_FILE_WATCH_ID = 0;
+
+//runs on the thread that calls FileWatcher::BeginFrame, with the path exactly as it was passed to WatchFile
+typedef void (*FileChangedCallback)(const std::string& filePath, void* userData);
+
+struct FileWatcherConfig
+{
+	float m_settleSeconds = 0.15f;		//editors save in several writes, a change is only reported once the file has been quiet this long
+	int m_pollMilliseconds = 50;		//how often the watch thread checks for shutdown when nothing is changing
+};
+
+//watches the directories of the files it is asked about, on one background thread (ReadDirectoryChangesW on windows,
+//inotify elsewhere). changes are handed out at frame boundaries so whatever reloads the file can swap it in without
+//racing the frame that is using it. a changed file is read from disk from then on, even if a mounted pack has it
+class FileWatcher
+{
+public:
+	FileWatcher(const FileWatcherConfig& config);
+	void Startup();
+	void Shutdown();
+	void BeginFrame();
+
+	FileWatchID WatchFile(const std::string& filePath, FileChangedCallback callback, void* userData);
+	void UnwatchFile(FileWatchID watchID);		//safe to call from inside a callback
+	int GetNumWatchedFiles() const { return (int)m_watches.size(); }
+
+private:
+	struct FileWatch
+	{
+		FileWatchID m_id = INVALID_FILE_WATCH_ID;
+		std::string m_filePath;
+		std::string m_normalizedPath;
+		FileChangedCallback m_callback = nullptr;
+		void* m_userData = nullptr;
+	};
+
+	struct WatchedDirectory;
+
+	void WatchThreadMain();
+	void WatchDirectory(const std::string& normalizedDirectory);
+	void ReportChange(const std::string& normalizedDirectory, const std::string& fileName);
+
+private:
+	FileWatcherConfig m_config;
+	std::thread* m_watchThread = nullptr;
+	std::atomic<bool> m_isQuitting = false;
+	FileWatchID m_nextWatchID = 1;
+	std::vector<FileWatch> m_watches;
+
+	//directories stay watched until shutdown, there are only ever a handful of them
+	std::vector<WatchedDirectory*> m_directories;
+	std::mutex m_directoriesMutex;
+	int m_platformHandle = -1;			//the inotify instance, unused on windows
+
+	std::unordered_map<std::string, uint64_t> m_pendingChanges;		//normalized path to the raw time of its latest change
+	std::mutex m_pendingChangesMutex;
+};
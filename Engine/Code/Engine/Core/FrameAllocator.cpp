@@ -0,0 +1,140 @@
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+std::atomic<unsigned int> FrameArena::s_frameNumber{ 0 };
+
+FrameArena::FrameArena()
+	:m_frameNumber(s_frameNumber.load(std::memory_order_acquire))
+{
+	for (int i = 0; i < 2; i++)
+	{
+		m_buffers[i].m_blocks.reserve(8);
+		AddBlock(m_buffers[i], FRAME_ARENA_INITIAL_BYTES);
+	}
+}
+
+FrameArena::~FrameArena()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		for (int blockIndex = 0; blockIndex < m_buffers[i].m_blocks.size(); blockIndex++)
+		{
+			delete[] m_buffers[i].m_blocks[blockIndex].m_memory;
+		}
+	}
+}
+
+FrameArena& FrameArena::GetThreadArena()
+{
+	static thread_local FrameArena t_frameArena;
+	return t_frameArena;
+}
+
+void FrameArena::EndFrame()
+{
+	s_frameNumber.fetch_add(1, std::memory_order_acq_rel);
+}
+
+unsigned int FrameArena::GetFrameNumber()
+{
+	return s_frameNumber.load(std::memory_order_acquire);
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	SyncToFrame();
+	FrameArenaBuffer& buffer = m_buffers[m_currentBufferIndex];
+	FrameArenaBlock* block = &buffer.m_blocks.back();
+	uintptr_t blockStart = (uintptr_t)block->m_memory;
+	uintptr_t alignedStart = (blockStart + block->m_used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	if (alignedStart + size > blockStart + block->m_capacity)
+	{
+		//spill into another block for the rest of this frame, the reset folds it into one bigger block
+		size_t blockCapacity = buffer.m_blocks[0].m_capacity;
+		block = &AddBlock(buffer, size + alignment > blockCapacity ? size + alignment : blockCapacity);
+		blockStart = (uintptr_t)block->m_memory;
+		alignedStart = (blockStart + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+
+	block->m_used = (size_t)(alignedStart + size - blockStart);
+	return (void*)alignedStart;
+}
+
+void FrameArena::Deallocate(void* memory, size_t size)
+{
+	//only the newest allocation on this thread's current block can be given back, which covers a container freeing
+	//the temporary it just grew out of. anything else is reclaimed when the buffer resets
+	FrameArenaBlock& block = m_buffers[m_currentBufferIndex].m_blocks.back();
+	uintptr_t blockStart = (uintptr_t)block.m_memory;
+	uintptr_t allocationStart = (uintptr_t)memory;
+	if (allocationStart >= blockStart && allocationStart + size == blockStart + block.m_used)
+	{
+		block.m_used = (size_t)(allocationStart - blockStart);
+	}
+}
+
+void FrameArena::EndThreadFrame()
+{
+	SyncToFrame();
+	m_currentBufferIndex = 1 - m_currentBufferIndex;
+	ResetBuffer(m_buffers[m_currentBufferIndex]);
+}
+
+size_t FrameArena::GetBytesUsedThisFrame() const
+{
+	const FrameArenaBuffer& buffer = m_buffers[m_currentBufferIndex];
+	size_t bytesUsed = 0;
+	for (int blockIndex = 0; blockIndex < buffer.m_blocks.size(); blockIndex++)
+	{
+		bytesUsed += buffer.m_blocks[blockIndex].m_used;
+	}
+	return bytesUsed;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+	return m_buffers[0].m_totalCapacity + m_buffers[1].m_totalCapacity;
+}
+
+void FrameArena::SyncToFrame()
+{
+	unsigned int frameNumber = s_frameNumber.load(std::memory_order_acquire);
+	if (frameNumber == m_frameNumber)
+		return;
+
+	//the buffer being switched to was last written at least two frames ago
+	m_frameNumber = frameNumber;
+	m_currentBufferIndex = 1 - m_currentBufferIndex;
+	ResetBuffer(m_buffers[m_currentBufferIndex]);
+}
+
+void FrameArena::ResetBuffer(FrameArenaBuffer& buffer)
+{
+	for (int blockIndex = 0; blockIndex < buffer.m_blocks.size(); blockIndex++)
+	{
+		buffer.m_blocks[blockIndex].m_used = 0;
+	}
+
+	if (buffer.m_blocks.size() > 1)
+	{
+		size_t totalCapacity = buffer.m_totalCapacity;
+		for (int blockIndex = 0; blockIndex < buffer.m_blocks.size(); blockIndex++)
+		{
+			delete[] buffer.m_blocks[blockIndex].m_memory;
+		}
+		buffer.m_blocks.clear();
+		buffer.m_totalCapacity = 0;
+		AddBlock(buffer, totalCapacity);
+	}
+}
+
+FrameArenaBlock& FrameArena::AddBlock(FrameArenaBuffer& buffer, size_t capacity)
+{
+	FrameArenaBlock block;
+	block.m_memory = new unsigned char[capacity];
+	GUARANTEE_OR_DIE(block.m_memory != nullptr, "Frame arena is out of memory");
+	block.m_capacity = capacity;
+	buffer.m_blocks.push_back(block);
+	buffer.m_totalCapacity += capacity;
+	return buffer.m_blocks.back();
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr size_t FRAME_ARENA_INITIAL_BYTES = 256 * 1024;		//per buffer, per thread. grows to fit the busiest frame
+
+struct FrameArenaBlock
+{
+	unsigned char* m_memory = nullptr;
+	size_t m_capacity = 0;
+	size_t m_used = 0;
+};
+
+struct FrameArenaBuffer
+{
+	std::vector<FrameArenaBlock> m_blocks;		//normally one, more only on a frame that outgrew it
+	size_t m_totalCapacity = 0;
+};
+
+//bump allocator for data that only lives until the end of the next frame. every thread gets its own arena with two
+//buffers: allocations go into the current one, and the first allocation after EndFrame swaps to the other buffer and
+//resets it, so what was allocated last frame is still valid this frame. freeing is a no-op unless it is the last
+//allocation, so nothing here should own anything with a destructor that matters
+class FrameArena
+{
+public:
+	FrameArena();
+	~FrameArena();
+	FrameArena(const FrameArena& copyFrom) = delete;
+	FrameArena& operator=(const FrameArena& copyFrom) = delete;
+
+	static FrameArena& GetThreadArena();
+	static void EndFrame();
+	static unsigned int GetFrameNumber();
+
+	void* Allocate(size_t size, size_t alignment);
+	void Deallocate(void* memory, size_t size);
+	//swaps this arena alone as if a frame had ended, for running many frames of work inside one real frame. only safe on
+	//a thread holding nothing from the arena, like a benchmark's own thread
+	void EndThreadFrame();
+	size_t GetBytesUsedThisFrame() const;
+	size_t GetCapacity() const;
+
+private:
+	void SyncToFrame();
+	void ResetBuffer(FrameArenaBuffer& buffer);
+	FrameArenaBlock& AddBlock(FrameArenaBuffer& buffer, size_t capacity);
+
+private:
+	FrameArenaBuffer m_buffers[2];
+	int m_currentBufferIndex = 0;
+	unsigned int m_frameNumber = 0;
+
+	static std::atomic<unsigned int> s_frameNumber;
+};
+
+//stl allocator on top of the calling thread's frame arena. containers using it must not outlive the next frame
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameAllocator() = default;
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& copyFrom) { (void)copyFrom; }
+
+	T* allocate(size_t count)
+	{
+		return (T*)FrameArena::GetThreadArena().Allocate(count * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T* memory, size_t count)
+	{
+		FrameArena::GetThreadArena().Deallocate(memory, count * sizeof(T));
+	}
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { (void)a; (void)b; return true; }
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { (void)a; (void)b; return false; }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
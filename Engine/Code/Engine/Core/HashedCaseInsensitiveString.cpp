@@ -1,44 +1,62 @@
 #include "Engine/Core/HashedCaseInsensitiveString.hpp"
+#include "Engine/Core/StringInternTable.hpp"
 
 HashedCaseInsensitiveString::HashedCaseInsensitiveString(const std::string& fromStdString)
-	:m_originalString(fromStdString)
+	:m_internedString(InternString(fromStdString.c_str()))
 {
-	CalculateStringHashValue();
+	m_toLowerHash = m_internedString->m_id;
 }
 
 HashedCaseInsensitiveString::HashedCaseInsensitiveString(const char* fromCString)
-	:m_originalString(fromCString)
+	:m_internedString(InternString(fromCString))
 {
-	CalculateStringHashValue();
+	m_toLowerHash = m_internedString->m_id;
 }
 
 bool HashedCaseInsensitiveString::operator<(const HashedCaseInsensitiveString& compare) const
 {
-	if (m_toLowerHash < compare.m_toLowerHash)
-		return true;
-	else if (m_toLowerHash == compare.m_toLowerHash)
-	{
-		int compareValue = _stricmp(m_originalString.c_str(), compare.m_originalString.c_str());
-		return compareValue < 0;
-	}
+	//orders by id rather than alphabetically, the strings only settle ties between colliding ids
+	if (m_toLowerHash != compare.m_toLowerHash)
+		return m_toLowerHash < compare.m_toLowerHash;
+	if (m_internedString == compare.m_internedString)
+		return false;
 
-	return false;
+	return _stricmp(c_str(), compare.c_str()) < 0;
 }
 
 bool HashedCaseInsensitiveString::operator==(const HashedCaseInsensitiveString& compare) const
 {
+	//the same string is always the same interned copy, so the compare only runs for colliding ids
 	if (m_toLowerHash != compare.m_toLowerHash)
 		return false;
+	if (m_internedString == compare.m_internedString)
+		return true;
+
+	return !_stricmp(c_str(), compare.c_str());
+}
+
+bool HashedCaseInsensitiveString::operator!=(const HashedCaseInsensitiveString& compare) const
+{
+	return !(*this == compare);
+}
+
+bool HashedCaseInsensitiveString::operator==(unsigned int compareID) const
+{
+	return m_toLowerHash == compareID;
+}
 
-	return !_stricmp(m_originalString.c_str(), compare.m_originalString.c_str());
+unsigned int HashedCaseInsensitiveString::GetID() const
+{
+	return m_toLowerHash;
+}
+
+const std::string& HashedCaseInsensitiveString::GetOriginalString() const
+{
+	static const std::string s_emptyString;
+	return m_internedString ? m_internedString->m_string : s_emptyString;
 }
 
-void HashedCaseInsensitiveString::CalculateStringHashValue()
+const char* HashedCaseInsensitiveString::c_str() const
 {
-	m_toLowerHash = 0;
-	for (int i = 0; i < m_originalString.size(); i++)
-	{
-		m_toLowerHash *= 31;
-		m_toLowerHash += static_cast<unsigned int>(tolower(m_originalString[i]));
-	}
+	return GetOriginalString().c_str();
 }
@@ -1,19 +1,44 @@
 #pragma once
 #include <string>
 
+//ascii only lower casing so the hash can be evaluated at compile time for literal keys
+constexpr char ToLowerAscii(char character)
+{
+	return (character >= 'A' && character <= 'Z') ? static_cast<char>(character - 'A' + 'a') : character;
+}
+
+constexpr unsigned int HashCaseInsensitive(const char* text)
+{
+	unsigned int hash = 0;
+	for (const char* character = text; *character != '\0'; character++)
+	{
+		hash *= 31;
+		hash += static_cast<unsigned int>(static_cast<unsigned char>(ToLowerAscii(*character)));
+	}
+	return hash;
+}
+
+struct InternedString;
+
+//handle to an interned string, copies are two words. comparisons look at the 32 bit id and only compare the strings
+//when two different strings share it
 class HashedCaseInsensitiveString
 {
 public:
+	HashedCaseInsensitiveString() = default;
 	HashedCaseInsensitiveString(const std::string& fromStdString);
 	HashedCaseInsensitiveString(const char* fromCString);
 
 	bool operator<(const HashedCaseInsensitiveString& compare) const;
 	bool operator==(const HashedCaseInsensitiveString& compare) const;
+	bool operator!=(const HashedCaseInsensitiveString& compare) const;
+	bool operator==(unsigned int compareID) const;		//id only, a different string with the same hash matches too
 
-private:
-	void CalculateStringHashValue();
+	unsigned int GetID() const;
+	const std::string& GetOriginalString() const;
+	const char* c_str() const;
 
 public:
-	std::string m_originalString;
+	const InternedString* m_internedString = nullptr;
 	unsigned int m_toLowerHash = 0;
-};
\ No newline at end of file
+};
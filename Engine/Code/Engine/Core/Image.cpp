@@ -3,18 +3,119 @@
 #include "Engine/Core/Image.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Job.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include <string.h>
+
+#if defined(_M_X64) || defined(__SSSE3__)
+#define IMAGE_USE_SSSE3
+#include <tmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(IMAGE_USE_SSSE3)
+static bool IsSSSE3Supported()
+{
+#if defined(__SSSE3__)
+	return true;
+#else
+	//every x64 cpu has sse2 but some early ones (amd k8/k10) don't have ssse3's byte shuffle
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 1);
+	return (cpuInfo[2] & (1 << 9)) != 0;
+#endif
+}
+
+static const bool s_isSSSE3Supported = IsSSSE3Supported();
+#endif
+
+//writes rows bottom up, which is the flip the renderer wants, so stb's global (and not thread safe) flip isn't needed
+static void ConvertTexelsToRgba8(const unsigned char* texelData, int bytesPerTexel, const IntVec2& dimensions, Rgba8* out_texels)
+{
+	size_t sourceRowSize = (size_t)dimensions.x * bytesPerTexel;
+	for (int y = 0; y < dimensions.y; y++)
+	{
+		const unsigned char* source = texelData + (size_t)(dimensions.y - 1 - y) * sourceRowSize;
+		Rgba8* destination = out_texels + (size_t)y * dimensions.x;
+		int x = 0;
+		switch (bytesPerTexel)
+		{
+		case 4:
+			memcpy(destination, source, sourceRowSize);
+			x = dimensions.x;
+			break;
+		case 3:
+#if defined(IMAGE_USE_SSSE3)
+			if (s_isSSSE3Supported)
+			{
+				//4 texels per step, each 16 byte load only uses 12 bytes so the loop stops 2 texels early to stay in the row
+				const __m128i expandRgbToRgba = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+				const __m128i opaqueAlpha = _mm_set1_epi32((int)0xFF000000);
+				for (; x + 6 <= dimensions.x; x += 4)
+				{
+					__m128i rgb = _mm_loadu_si128((const __m128i*)(source + x * 3));
+					__m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, expandRgbToRgba), opaqueAlpha);
+					_mm_storeu_si128((__m128i*)(destination + x), rgba);
+				}
+			}
+#endif
+			for (; x < dimensions.x; x++)
+			{
+				destination[x] = Rgba8(source[x * 3], source[x * 3 + 1], source[x * 3 + 2], 255);
+			}
+			break;
+		case 2:
+			for (; x < dimensions.x; x++)
+			{
+				destination[x] = Rgba8(source[x * 2], source[x * 2], source[x * 2], source[x * 2 + 1]);
+			}
+			break;
+		default:
+			for (; x < dimensions.x; x++)
+			{
+				destination[x] = Rgba8(source[x], source[x], source[x], 255);
+			}
+			break;
+		}
+	}
+}
+
+class ImageLoadJob : public Job
+{
+public:
+	explicit ImageLoadJob(const std::string& imageFilePath)
+		:m_imageFilePath(imageFilePath)
+	{
+	}
+
+	std::string m_imageFilePath;
+	Image* m_image = nullptr;
+
+private:
+	virtual void Execute() override
+	{
+		m_image = new Image(m_imageFilePath.c_str());
+	}
+	virtual void OnFinished() override {}
+};
 
 Image::Image(const char* imageFilePath)
 {
 	m_imageFilePath = imageFilePath;
 
-	int bytesPerTexel = 0;
-	int numComponentsRequested = 0;
-	stbi_set_flip_vertically_on_load(1);
-	unsigned char* texelData = stbi_load(imageFilePath, &m_dimension.x, &m_dimension.y, &bytesPerTexel, numComponentsRequested);
-	GUARANTEE_OR_DIE(texelData, Stringf("Failed to load image \"%s\"", imageFilePath));
-	StoreTexelData(texelData, bytesPerTexel);
-	stbi_image_free(texelData);
+	//one read of the whole file instead of stb's small stdio reads
+	std::vector<uint8_t> encodedBytes;
+	GUARANTEE_OR_DIE(FileReadToBuffer(encodedBytes, m_imageFilePath) >= 0, Stringf("Failed to load image \"%s\"", imageFilePath));
+	GUARANTEE_OR_DIE(Decode(ByteSpan(encodedBytes)), Stringf("Failed to decode image \"%s\": %s", imageFilePath, stbi_failure_reason()));
+}
+
+Image::Image(const char* name, const ByteSpan& encodedBytes)
+{
+	m_imageFilePath = name;
+	GUARANTEE_OR_DIE(Decode(encodedBytes), Stringf("Failed to decode image \"%s\": %s", name, stbi_failure_reason()));
 }
 
 Image::Image(IntVec2 size, Rgba8 color)
@@ -23,6 +124,12 @@ Image::Image(IntVec2 size, Rgba8 color)
 	m_rgbaTexels.assign(size.x * size.y, color);
 }
 
+Image::Image(const char* name, IntVec2 size, const std::vector<Rgba8>& texels)
+	:m_imageFilePath(name), m_dimension(size), m_rgbaTexels(texels)
+{
+	GUARANTEE_OR_DIE(texels.size() == (size_t)size.x * (size_t)size.y, Stringf("Texel count doesn't match dimensions for image \"%s\"", name));
+}
+
 const std::string& Image::GetImageFilePath() const
 {
 	return m_imageFilePath;
@@ -50,23 +157,57 @@ void Image::SetTexelColor(const IntVec2& texelCoords, const Rgba8& newColor)
 	m_rgbaTexels[texelIndex] = newColor;
 }
 
-void Image::StoreTexelData(unsigned char* texelData, int bytesPerTexel)
+bool Image::LoadFromFile(const char* imageFilePath)
 {
-	m_rgbaTexels.reserve(m_dimension.x * m_dimension.y);
-	int incrementSize = bytesPerTexel == 3 ? 3 : 4;
-	int imageSize = m_dimension.x * m_dimension.y;
+	std::vector<uint8_t> encodedBytes;
+	if (!TryFileReadToBuffer(encodedBytes, imageFilePath) || !Decode(ByteSpan(encodedBytes)))
+		return false;
 
-	for (int i = 0; i < imageSize; i++)
-	{
-		int pointerIndex = (i * incrementSize);
-		unsigned char r = *(texelData + pointerIndex);
-		unsigned char g = *(texelData + pointerIndex + 1);
-		unsigned char b = *(texelData + pointerIndex + 2);
+	m_imageFilePath = imageFilePath;
+	return true;
+}
 
-		unsigned char a = 255;
-		if (bytesPerTexel == 4)
-			a = *(texelData + pointerIndex + 3);
+bool Image::Decode(const ByteSpan& encodedBytes)
+{
+	//the conversion does the flip. the thread local setting wins over the global one, whoever else sets that
+	stbi_set_flip_vertically_on_load_thread(0);
+	int bytesPerTexel = 0;
+	int numComponentsRequested = 0;
+	IntVec2 dimensions;
+	unsigned char* texelData = stbi_load_from_memory(encodedBytes.m_data, (int)encodedBytes.m_size, &dimensions.x, &dimensions.y, &bytesPerTexel, numComponentsRequested);
+	if (!texelData)
+		return false;
 
-		m_rgbaTexels.push_back(Rgba8(r, g, b, a));
+	m_dimension = dimensions;
+	m_rgbaTexels.resize((size_t)m_dimension.x * m_dimension.y);
+	ConvertTexelsToRgba8(texelData, bytesPerTexel, m_dimension, m_rgbaTexels.data());
+	stbi_image_free(texelData);
+	return true;
+}
+
+void LoadImages(const std::vector<std::string>& imageFilePaths, std::vector<Image*>& out_images, JobSystem* jobSystem)
+{
+	out_images.clear();
+	if (!jobSystem)
+	{
+		for (int i = 0; i < imageFilePaths.size(); i++)
+		{
+			out_images.push_back(new Image(imageFilePaths[i].c_str()));
+		}
+		return;
+	}
+
+	std::vector<Job*> loadJobs;
+	for (int i = 0; i < imageFilePaths.size(); i++)
+	{
+		ImageLoadJob* loadJob = new ImageLoadJob(imageFilePaths[i]);
+		loadJobs.push_back(loadJob);
+		jobSystem->QueueJobs(loadJob);
+	}
+	jobSystem->WaitForJobs(loadJobs);
+	for (int i = 0; i < loadJobs.size(); i++)
+	{
+		out_images.push_back(((ImageLoadJob*)loadJobs[i])->m_image);
+		delete loadJobs[i];
 	}
 }
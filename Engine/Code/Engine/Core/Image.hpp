@@ -4,17 +4,23 @@
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Core/Rgba8.hpp"
 
+struct ByteSpan;
+class JobSystem;
+
 class Image
 {
 	friend class Renderer;
 public:
 	Image(const char* imageFilePath);
+	Image(const char* name, const ByteSpan& encodedBytes);		//decodes a file that has already been read, e.g. by AsyncFileIO
 	Image(IntVec2 size, Rgba8 color);
+	Image(const char* name, IntVec2 size, const std::vector<Rgba8>& texels);
 	const std::string& GetImageFilePath() const;
 	IntVec2 GetDimensions() const;
 	const void* GetRawData() const;
 	Rgba8 GetTexelColor(const IntVec2& texelCoords) const;
 	void SetTexelColor(const IntVec2& texelCoords, const Rgba8& newColor);
+	bool LoadFromFile(const char* imageFilePath);		//unlike the constructor a bad file isn't fatal, the image keeps its texels
 
 private:
 	std::string m_imageFilePath;
@@ -22,5 +28,9 @@ private:
 	std::vector<Rgba8> m_rgbaTexels;
 
 private:
-	void StoreTexelData(unsigned char* texelData, int bytesPerTexel);
-};
\ No newline at end of file
+	bool Decode(const ByteSpan& encodedBytes);
+};
+
+//decodes every file on the job system's workers, or on the calling thread without one. images come back in the same
+//order as the paths and belong to the caller
+void LoadImages(const std::vector<std::string>& imageFilePaths, std::vector<Image*>& out_images, JobSystem* jobSystem);
\ No newline at end of file
@@ -1,13 +1,18 @@
 #pragma once
 #include "Engine/Core/JobWorkerThread.hpp"
+#include <stdint.h>
 
 class Job
 {
 	friend class JobWorkerThread;
+	friend class JobSystem;
 public:
 	virtual ~Job() = default;
 
 private:
 	virtual void Execute() = 0;
 	virtual void OnFinished() = 0;
+
+private:
+	uint64_t m_queuedRawTime = 0;
 };
\ No newline at end of file
@@ -1,10 +1,18 @@
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/JobWorkerThread.hpp"
 #include "Job.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
+#include "Engine/Core/Time.hpp"
+#include <thread>
+#include <typeinfo>
 
 JobSystem::JobSystem(const JobSystemConfig& config)
 	:m_config(config)
 {
+	m_jobLatencyStat = RegisterHistogramStat("jobs.latency_ms");
+	m_jobsCompletedStat = RegisterCounterStat("jobs.completed");
+	m_jobsQueuedStat = RegisterGaugeStat("jobs.queued");
 }
 
 void JobSystem::Startup()
@@ -34,9 +42,12 @@ void JobSystem::EndFrame()
 
 void JobSystem::QueueJobs(Job* jobToExecute)
 {
+	jobToExecute->m_queuedRawTime = GetCurrentTimeRaw();
 	m_queuedJobsMutex.lock();
 	m_queuedJobs.push_back(jobToExecute);
+	int numQueuedJobs = (int)m_queuedJobs.size();
 	m_queuedJobsMutex.unlock();
+	SetStatGauge(m_jobsQueuedStat, numQueuedJobs);
 }
 
 Job* JobSystem::ClaimJobToExecute()
@@ -51,12 +62,20 @@ Job* JobSystem::ClaimJobToExecute()
 		m_executingJobs.push_back(jobToExecute);
 		m_executingJobsMutex.unlock();
 	}
+	int numQueuedJobs = (int)m_queuedJobs.size();
 	m_queuedJobsMutex.unlock();
+
+	if (jobToExecute)
+	{
+		SetStatGauge(m_jobsQueuedStat, numQueuedJobs);
+		RecordStatSample(m_jobLatencyStat, ConvertRawTimeToSeconds(GetCurrentTimeRaw() - jobToExecute->m_queuedRawTime) * 1000.0);
+	}
 	return jobToExecute;
 }
 
 void JobSystem::MoveJobToFinishedQueue(Job* job)
 {
+	AddToStatCounter(m_jobsCompletedStat);
 	m_finishedJobsMutex.lock();
 	m_finishedJobs.push_back(job);
 	m_finishedJobsMutex.unlock();
@@ -86,6 +105,67 @@ Job* JobSystem::RetrieveFinishedJob()
 	return finishedJob;
 }
 
+bool JobSystem::RetrieveFinishedJob(Job* job)
+{
+	bool wasFound = false;
+	m_finishedJobsMutex.lock();
+	for (auto iter = m_finishedJobs.begin(); iter != m_finishedJobs.end(); ++iter)
+	{
+		if (*iter == job)
+		{
+			m_finishedJobs.erase(iter);
+			wasFound = true;
+			break;
+		}
+	}
+	m_finishedJobsMutex.unlock();
+	return wasFound;
+}
+
+void JobSystem::WaitForJobs(const std::vector<Job*>& jobsToWaitFor)
+{
+	WaitForJobs(jobsToWaitFor.data(), (int)jobsToWaitFor.size());
+}
+
+void JobSystem::WaitForJobs(Job* const* jobsToWaitFor, int numJobs)
+{
+	//only retrieve the given jobs, other finished jobs stay in the queue for their owners
+	//help execute queued jobs while waiting so a job waiting on its own child jobs can't stall the workers
+	FrameVector<Job*> pendingJobs(jobsToWaitFor, jobsToWaitFor + numJobs);
+	while (!pendingJobs.empty())
+	{
+		for (auto iter = pendingJobs.begin(); iter != pendingJobs.end();)
+		{
+			if (RetrieveFinishedJob(*iter))
+			{
+				iter = pendingJobs.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		if (pendingJobs.empty())
+			break;
+
+		Job* jobToExecute = ClaimJobToExecute();
+		if (jobToExecute)
+		{
+			{
+				PROFILE_JOB_SCOPE(typeid(*jobToExecute).name());
+				jobToExecute->Execute();
+			}
+			jobToExecute->OnFinished();
+			MoveJobToFinishedQueue(jobToExecute);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
 int JobSystem::GetNumQueuedJobs() const
 {
 	m_queuedJobsMutex.lock();
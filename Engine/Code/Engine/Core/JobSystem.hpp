@@ -2,6 +2,7 @@
 #include <deque>
 #include <mutex>
 #include <vector>
+#include "Engine/Core/StatsRegistry.hpp"
 
 class Job;
 class JobWorkerThread;
@@ -24,6 +25,9 @@ public:
 	Job* ClaimJobToExecute();
 	void MoveJobToFinishedQueue(Job* job);
 	Job* RetrieveFinishedJob();
+	bool RetrieveFinishedJob(Job* job);
+	void WaitForJobs(const std::vector<Job*>& jobsToWaitFor);
+	void WaitForJobs(Job* const* jobsToWaitFor, int numJobs);
 	int GetNumQueuedJobs() const;
 	int GetNumExecutingJobs() const;
 	int GetNumWorkerThreads() const;
@@ -43,6 +47,10 @@ private:
 
 	std::vector<JobWorkerThread*> m_workerThreads;
 
+	StatID m_jobLatencyStat = INVALID_STAT_ID;		//queued to claimed, in ms
+	StatID m_jobsCompletedStat = INVALID_STAT_ID;
+	StatID m_jobsQueuedStat = INVALID_STAT_ID;
+
 private:
 	void DestroyAllThreads();
 };
\ No newline at end of file
@@ -2,7 +2,10 @@
 #include "Engine/Core/Job.hpp"
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include <chrono>
+#include <typeinfo>
 
 JobWorkerThread::JobWorkerThread(JobSystem* jobSystem, int workerThreadID)
 	:m_jobSystem(jobSystem), m_workerThreadID(workerThreadID)
@@ -19,13 +22,17 @@ JobWorkerThread::~JobWorkerThread()
 
 void JobWorkerThread::JobWorkerMain(int workerID)
 {
-	UNUSED(workerID);
+	Profiler::GetGlobalProfiler().SetThreadName(Stringf("JobWorker %d", workerID));
 	while (!m_isQuitting)
 	{
 		Job* jobToExecute = m_jobSystem->ClaimJobToExecute();
 		if (jobToExecute)
 		{
-			jobToExecute->Execute();
+			{
+				//the job's class name marks the job in the profile
+				PROFILE_JOB_SCOPE(typeid(*jobToExecute).name());
+				jobToExecute->Execute();
+			}
 			jobToExecute->OnFinished();
 			m_jobSystem->MoveJobToFinishedQueue(jobToExecute);
 		}
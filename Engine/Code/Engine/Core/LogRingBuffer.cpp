@@ -0,0 +1,160 @@
+#include "Engine/Core/LogRingBuffer.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <stdio.h>
+#include <string.h>
+
+constexpr int LOG_RECORD_TEXT_LENGTH = LOG_RECORD_TEXT_BYTES - 1;
+
+LogRingBuffer::LogRingBuffer(int capacity)
+{
+	GUARANTEE_OR_DIE(capacity > 0 && (capacity & (capacity - 1)) == 0, "Log ring capacity must be a power of two");
+	m_records = new LogRecord[capacity];
+	m_mask = (unsigned int)capacity - 1;
+
+	//a record is free for the push at position p when its sequence is p, and ready to pop when it is p + 1
+	for (int i = 0; i < capacity; i++)
+	{
+		m_records[i].m_sequence.store((unsigned int)i);
+	}
+}
+
+LogRingBuffer::~LogRingBuffer()
+{
+	delete[] m_records;
+	m_records = nullptr;
+}
+
+bool LogRingBuffer::Push(const Rgba8& color, int frameNumber, const char* text, int textLength)
+{
+	//a small ring can't hold the longest lines, those are cut at whatever fits
+	int maxRecords = LOG_MAX_RECORDS_PER_LINE < GetCapacity() ? LOG_MAX_RECORDS_PER_LINE : GetCapacity();
+	bool isTruncated = textLength > maxRecords * LOG_RECORD_TEXT_LENGTH;
+	if (isTruncated)
+	{
+		textLength = maxRecords * LOG_RECORD_TEXT_LENGTH;
+		m_numTruncated.fetch_add(1);
+	}
+
+	int numRecords = textLength > 0 ? (textLength + LOG_RECORD_TEXT_LENGTH - 1) / LOG_RECORD_TEXT_LENGTH : 1;
+	unsigned int firstPosition = 0;
+	if (!ClaimRecords(numRecords, firstPosition))
+		return false;
+
+	for (int recordIndex = 0; recordIndex < numRecords; recordIndex++)
+	{
+		LogRecord& record = m_records[(firstPosition + recordIndex) & m_mask];
+		int textOffset = recordIndex * LOG_RECORD_TEXT_LENGTH;
+		int recordTextLength = textLength - textOffset < LOG_RECORD_TEXT_LENGTH ? textLength - textOffset : LOG_RECORD_TEXT_LENGTH;
+		memcpy(record.m_text, text + textOffset, recordTextLength);
+		record.m_text[recordTextLength] = '\0';
+		record.m_textLength = recordTextLength;
+		record.m_color = color;
+		record.m_frameNumber = frameNumber;
+		record.m_continuesInNextRecord = recordIndex + 1 < numRecords;
+	}
+
+	if (isTruncated)
+	{
+		LogRecord& lastRecord = m_records[(firstPosition + numRecords - 1) & m_mask];
+		memcpy(lastRecord.m_text + lastRecord.m_textLength - 3, "...", 3);
+	}
+
+	//the first record goes out last, so by the time the consumer can pop the start of a line the rest is there too
+	for (int recordIndex = numRecords - 1; recordIndex >= 0; recordIndex--)
+	{
+		PublishRecord(&m_records[(firstPosition + recordIndex) & m_mask]);
+	}
+	return true;
+}
+
+bool LogRingBuffer::PushFormatted(const Rgba8& color, int frameNumber, const char* format, va_list args)
+{
+	//formatted on the stack, the ring only learns how many records the line needs once it is formatted
+	char text[LOG_MAX_LINE_LENGTH + 1];
+	int textLength = vsnprintf(text, sizeof(text), format, args);
+	if (textLength < 0)
+	{
+		textLength = 0;
+		text[0] = '\0';
+	}
+	else if (textLength > LOG_MAX_LINE_LENGTH)
+	{
+		//one more than fits, so Push marks it as cut
+		textLength = LOG_MAX_LINE_LENGTH + 1;
+	}
+	return Push(color, frameNumber, text, textLength);
+}
+
+const LogRecord* LogRingBuffer::BeginPop()
+{
+	//a producer that claimed this record but hasn't published yet holds up everything behind it until the next pop
+	LogRecord& record = m_records[m_popPosition & m_mask];
+	if (record.m_sequence.load(std::memory_order_acquire) != m_popPosition + 1)
+		return nullptr;
+
+	return &record;
+}
+
+void LogRingBuffer::EndPop()
+{
+	LogRecord& record = m_records[m_popPosition & m_mask];
+	record.m_sequence.store(m_popPosition + m_mask + 1, std::memory_order_release);
+	m_popPosition++;
+}
+
+int LogRingBuffer::GetCapacity() const
+{
+	return (int)m_mask + 1;
+}
+
+unsigned int LogRingBuffer::GetNumPushed() const
+{
+	return m_pushPosition.load();
+}
+
+unsigned int LogRingBuffer::GetNumDropped() const
+{
+	return m_numDropped.load();
+}
+
+unsigned int LogRingBuffer::GetNumTruncated() const
+{
+	return m_numTruncated.load();
+}
+
+bool LogRingBuffer::ClaimRecords(int numRecords, unsigned int& out_firstPosition)
+{
+	unsigned int position = m_pushPosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		//the consumer frees records in order, so the whole range is free once its last record is
+		unsigned int lastPosition = position + (unsigned int)numRecords - 1;
+		LogRecord& lastRecord = m_records[lastPosition & m_mask];
+		unsigned int sequence = lastRecord.m_sequence.load(std::memory_order_acquire);
+		int difference = (int)(sequence - lastPosition);
+		if (difference == 0)
+		{
+			if (m_pushPosition.compare_exchange_weak(position, position + (unsigned int)numRecords, std::memory_order_relaxed))
+			{
+				out_firstPosition = position;
+				return true;
+			}
+		}
+		else if (difference < 0)
+		{
+			//the consumer hasn't freed this record yet, the ring is full
+			m_numDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			position = m_pushPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void LogRingBuffer::PublishRecord(LogRecord* record)
+{
+	unsigned int position = record->m_sequence.load(std::memory_order_relaxed);
+	record->m_sequence.store(position + 1, std::memory_order_release);
+}
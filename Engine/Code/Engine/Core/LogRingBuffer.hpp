@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <stdarg.h>
+#include "Engine/Core/Rgba8.hpp"
+
+constexpr int LOG_RECORD_TEXT_BYTES = 240;
+constexpr int LOG_MAX_RECORDS_PER_LINE = 16;		//longer lines keep their start and end in "..."
+constexpr int LOG_MAX_LINE_LENGTH = (LOG_RECORD_TEXT_BYTES - 1) * LOG_MAX_RECORDS_PER_LINE;
+
+struct LogRecord
+{
+	std::atomic<unsigned int> m_sequence{ 0 };
+	Rgba8 m_color;
+	int m_frameNumber = 0;
+	int m_textLength = 0;
+	bool m_continuesInNextRecord = false;
+	char m_text[LOG_RECORD_TEXT_BYTES];		//null terminated
+};
+
+//fixed capacity ring of preformatted log lines. any number of threads push without locking or allocating,
+//one thread pops. when full, new lines are dropped and counted rather than blocking the logging thread.
+//a line longer than one record goes into consecutive records, and the consumer sees them all once it sees the first
+class LogRingBuffer
+{
+public:
+	LogRingBuffer(int capacity);
+	~LogRingBuffer();
+
+	bool Push(const Rgba8& color, int frameNumber, const char* text, int textLength);
+	bool PushFormatted(const Rgba8& color, int frameNumber, const char* format, va_list args);
+
+	//consumer only. the record stays valid until EndPop
+	const LogRecord* BeginPop();
+	void EndPop();
+
+	int GetCapacity() const;
+	unsigned int GetNumPushed() const;
+	unsigned int GetNumDropped() const;
+	unsigned int GetNumTruncated() const;
+
+private:
+	bool ClaimRecords(int numRecords, unsigned int& out_firstPosition);
+	void PublishRecord(LogRecord* record);
+
+private:
+	LogRecord* m_records = nullptr;
+	unsigned int m_mask = 0;
+	alignas(64) std::atomic<unsigned int> m_pushPosition{ 0 };
+	alignas(64) unsigned int m_popPosition = 0;
+	alignas(64) std::atomic<unsigned int> m_numDropped{ 0 };
+	std::atomic<unsigned int> m_numTruncated{ 0 };
+};
@@ -0,0 +1,332 @@
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <new>
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+
+extern DevConsole* g_theConsole;
+
+//running totals, touched by every tracked new/delete. zero initialized before any constructor runs, so allocations
+//made during static initialization are counted too
+struct alignas(64) MemoryTagCounters
+{
+	std::atomic<int64_t> m_liveBytes;
+	std::atomic<int64_t> m_peakBytes;
+	std::atomic<int64_t> m_liveAllocations;
+	std::atomic<int64_t> m_totalAllocations;
+	std::atomic<int64_t> m_totalBytesAllocated;
+};
+
+static MemoryTagCounters s_memoryTagCounters[NUM_MEMORY_TAGS];
+static thread_local MemoryTag t_currentMemoryTag = MemoryTag::UNTAGGED;
+
+static const char* s_memoryTagNames[NUM_MEMORY_TAGS] =
+{
+	"untagged",
+	"particles",
+	"renderer",
+	"debug_render",
+	"audio",
+	"console",
+};
+
+#if defined( ENGINE_TRACK_MEMORY )
+//sits right in front of every tracked block. 16 bytes so the block keeps malloc's alignment
+struct TrackedAllocationHeader
+{
+	uint64_t m_size = 0;
+	uint32_t m_offset = 0;			//from the start of the raw block to the user pointer
+	MemoryTag m_tag = MemoryTag::UNTAGGED;
+	unsigned char m_padding[3] = {};
+};
+static_assert(sizeof(TrackedAllocationHeader) == 16, "tracked allocation header must keep 16 byte alignment");
+
+constexpr size_t TRACKED_MALLOC_ALIGNMENT = 16;
+
+static void RecordAllocation(MemoryTag tag, int64_t size)
+{
+	MemoryTagCounters& counters = s_memoryTagCounters[(int)tag];
+	int64_t liveBytes = counters.m_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	counters.m_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_totalBytesAllocated.fetch_add(size, std::memory_order_relaxed);
+
+	int64_t peakBytes = counters.m_peakBytes.load(std::memory_order_relaxed);
+	while (liveBytes > peakBytes && !counters.m_peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+	{
+	}
+}
+
+static void RecordFree(MemoryTag tag, int64_t size)
+{
+	MemoryTagCounters& counters = s_memoryTagCounters[(int)tag];
+	counters.m_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+	counters.m_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void* TrackedAllocate(size_t size, size_t alignment, MemoryTag tag)
+{
+	bool isOverAligned = alignment > TRACKED_MALLOC_ALIGNMENT;
+	size_t headerSpace = isOverAligned ? alignment : TRACKED_MALLOC_ALIGNMENT;
+	unsigned char* rawBlock = isOverAligned ? (unsigned char*)_aligned_malloc(size + headerSpace, alignment) : (unsigned char*)malloc(size + headerSpace);
+	if (rawBlock == nullptr)
+		return nullptr;
+
+	unsigned char* userBlock = rawBlock + headerSpace;
+	TrackedAllocationHeader* header = new (userBlock - sizeof(TrackedAllocationHeader)) TrackedAllocationHeader();
+	header->m_size = size;
+	header->m_offset = (uint32_t)headerSpace;
+	header->m_tag = tag;
+	RecordAllocation(header->m_tag, (int64_t)size);
+	return userBlock;
+}
+
+static void TrackedFree(void* userBlock)
+{
+	if (userBlock == nullptr)
+		return;
+
+	//freed against the tag it was allocated with, whatever scope the delete happens in
+	TrackedAllocationHeader* header = (TrackedAllocationHeader*)((unsigned char*)userBlock - sizeof(TrackedAllocationHeader));
+	RecordFree(header->m_tag, (int64_t)header->m_size);
+	unsigned char* rawBlock = (unsigned char*)userBlock - header->m_offset;
+	if (header->m_offset > TRACKED_MALLOC_ALIGNMENT)
+	{
+		_aligned_free(rawBlock);
+	}
+	else
+	{
+		free(rawBlock);
+	}
+}
+
+static void* TrackedAllocateOrThrow(size_t size, size_t alignment)
+{
+	void* userBlock = TrackedAllocate(size, alignment, t_currentMemoryTag);
+	if (userBlock == nullptr)
+		throw std::bad_alloc();
+
+	return userBlock;
+}
+
+void* operator new(size_t size) { return TrackedAllocateOrThrow(size, TRACKED_MALLOC_ALIGNMENT); }
+void* operator new[](size_t size) { return TrackedAllocateOrThrow(size, TRACKED_MALLOC_ALIGNMENT); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, TRACKED_MALLOC_ALIGNMENT, t_currentMemoryTag); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, TRACKED_MALLOC_ALIGNMENT, t_currentMemoryTag); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, (size_t)alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, (size_t)alignment, t_currentMemoryTag); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, (size_t)alignment, t_currentMemoryTag); }
+
+void operator delete(void* block) noexcept { TrackedFree(block); }
+void operator delete[](void* block) noexcept { TrackedFree(block); }
+void operator delete(void* block, size_t) noexcept { TrackedFree(block); }
+void operator delete[](void* block, size_t) noexcept { TrackedFree(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { TrackedFree(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { TrackedFree(block); }
+void operator delete(void* block, std::align_val_t) noexcept { TrackedFree(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { TrackedFree(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { TrackedFree(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { TrackedFree(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(block); }
+
+void* AllocateTaggedMemory(size_t size, MemoryTag tag)
+{
+	return TrackedAllocate(size, TRACKED_MALLOC_ALIGNMENT, tag);
+}
+
+void* ReallocateTaggedMemory(void* block, size_t newSize, MemoryTag tag)
+{
+	if (block == nullptr)
+		return TrackedAllocate(newSize, TRACKED_MALLOC_ALIGNMENT, tag);
+
+	TrackedAllocationHeader* header = (TrackedAllocationHeader*)((unsigned char*)block - sizeof(TrackedAllocationHeader));
+	void* newBlock = TrackedAllocate(newSize, TRACKED_MALLOC_ALIGNMENT, tag);
+	if (newBlock == nullptr)
+		return nullptr;
+
+	memcpy(newBlock, block, header->m_size < newSize ? header->m_size : newSize);
+	TrackedFree(block);
+	return newBlock;
+}
+
+void FreeTaggedMemory(void* block)
+{
+	TrackedFree(block);
+}
+#endif
+
+MemoryTracker::MemoryTracker()
+{
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		m_liveKBStats[tagIndex] = RegisterGaugeStat(Stringf("memory.%s.live_kb", s_memoryTagNames[tagIndex]));
+		m_allocationStats[tagIndex] = RegisterCounterStat(Stringf("memory.%s.allocations", s_memoryTagNames[tagIndex]));
+	}
+}
+
+MemoryTracker& MemoryTracker::GetGlobalTracker()
+{
+	static MemoryTracker s_globalTracker;
+	return s_globalTracker;
+}
+
+bool MemoryTracker::IsEnabled()
+{
+#if defined( ENGINE_TRACK_MEMORY )
+	return true;
+#else
+	return false;
+#endif
+}
+
+MemoryTagStats MemoryTracker::GetTagStats(MemoryTag tag) const
+{
+	int tagIndex = (int)tag;
+	const MemoryTagCounters& counters = s_memoryTagCounters[tagIndex];
+	MemoryTagStats stats = m_lastFrameStats[tagIndex];
+	stats.m_liveBytes = counters.m_liveBytes.load(std::memory_order_relaxed);
+	stats.m_peakBytes = counters.m_peakBytes.load(std::memory_order_relaxed);
+	stats.m_liveAllocations = counters.m_liveAllocations.load(std::memory_order_relaxed);
+	stats.m_totalAllocations = counters.m_totalAllocations.load(std::memory_order_relaxed);
+	stats.m_totalBytesAllocated = counters.m_totalBytesAllocated.load(std::memory_order_relaxed);
+	stats.m_budgetBytes = m_budgetBytes[tagIndex];
+	return stats;
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, int64_t budgetBytes)
+{
+	m_budgetBytes[(int)tag] = budgetBytes;
+	m_isOverBudget[(int)tag] = false;
+}
+
+void MemoryTracker::EndFrame(float deltaSeconds)
+{
+	if (!IsEnabled())
+		return;
+
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		MemoryTag tag = (MemoryTag)tagIndex;
+		MemoryTagStats& lastFrame = m_lastFrameStats[tagIndex];
+		MemoryTagStats stats = GetTagStats(tag);
+		stats.m_allocationsLastFrame = stats.m_totalAllocations - lastFrame.m_totalAllocations;
+		stats.m_bytesAllocatedLastFrame = stats.m_totalBytesAllocated - lastFrame.m_totalBytesAllocated;
+		stats.m_bytesPerSecond = deltaSeconds > 0.f ? (double)stats.m_bytesAllocatedLastFrame / (double)deltaSeconds : 0.0;
+		lastFrame = stats;
+
+		SetStatGauge(m_liveKBStats[tagIndex], (double)stats.m_liveBytes / 1024.0);
+		AddToStatCounter(m_allocationStats[tagIndex], stats.m_allocationsLastFrame);
+
+		bool isOverBudget = stats.m_budgetBytes > 0 && stats.m_liveBytes > stats.m_budgetBytes;
+		if (isOverBudget && !m_isOverBudget[tagIndex] && g_theConsole)
+		{
+			g_theConsole->AddLine(g_theConsole->WARNING, Stringf("Memory tag %s is over budget: %.1f KB live, %.1f KB budget", s_memoryTagNames[tagIndex],
+				(double)stats.m_liveBytes / 1024.0, (double)stats.m_budgetBytes / 1024.0));
+		}
+		m_isOverBudget[tagIndex] = isOverBudget;
+
+		if (!m_isSteadyStateArmed[tagIndex])
+			continue;
+
+		if (m_steadyStateWarmupFramesLeft[tagIndex] > 0)
+		{
+			m_steadyStateWarmupFramesLeft[tagIndex]--;
+			continue;
+		}
+
+		if (stats.m_allocationsLastFrame > 0)
+		{
+			m_numSteadyStateFailures[tagIndex]++;
+			m_isSteadyStateArmed[tagIndex] = false;
+			ERROR_RECOVERABLE(Stringf("Memory tag %s allocated in steady state: %lld allocations, %lld bytes last frame", s_memoryTagNames[tagIndex],
+				(long long)stats.m_allocationsLastFrame, (long long)stats.m_bytesAllocatedLastFrame));
+		}
+	}
+}
+
+void MemoryTracker::PrintBudgetTable(DevConsole& console) const
+{
+	if (!IsEnabled())
+	{
+		console.AddLine(console.WARNING, "Memory tracking is off, build with ENGINE_TRACK_MEMORY to turn it on");
+		return;
+	}
+
+	console.AddLine(console.INFO_MAJOR, "---- Memory by tag (KB) ----");
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		MemoryTagStats stats = GetTagStats((MemoryTag)tagIndex);
+		std::string line = Stringf("%-13s live %10.1f  peak %10.1f  blocks %7lld  allocs/frame %5lld  KB/s %9.1f", s_memoryTagNames[tagIndex],
+			(double)stats.m_liveBytes / 1024.0, (double)stats.m_peakBytes / 1024.0, (long long)stats.m_liveAllocations,
+			(long long)stats.m_allocationsLastFrame, stats.m_bytesPerSecond / 1024.0);
+		if (stats.m_budgetBytes > 0)
+		{
+			line += Stringf("  budget %10.1f (%.0f%%)", (double)stats.m_budgetBytes / 1024.0, 100.0 * (double)stats.m_liveBytes / (double)stats.m_budgetBytes);
+		}
+		if (m_isSteadyStateArmed[tagIndex])
+		{
+			line += "  [steady]";
+		}
+		console.AddLine(m_isOverBudget[tagIndex] ? console.WARNING : console.INFO_MINOR, line);
+	}
+}
+
+void MemoryTracker::ArmSteadyStateCheck(MemoryTag tag, int warmupFrames)
+{
+	m_isSteadyStateArmed[(int)tag] = true;
+	m_steadyStateWarmupFramesLeft[(int)tag] = warmupFrames;
+}
+
+void MemoryTracker::DisarmSteadyStateCheck(MemoryTag tag)
+{
+	m_isSteadyStateArmed[(int)tag] = false;
+}
+
+bool MemoryTracker::IsSteadyStateCheckArmed(MemoryTag tag) const
+{
+	return m_isSteadyStateArmed[(int)tag];
+}
+
+int MemoryTracker::GetNumSteadyStateFailures(MemoryTag tag) const
+{
+	return m_numSteadyStateFailures[(int)tag];
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag)
+	:m_previousTag(t_currentMemoryTag)
+{
+	t_currentMemoryTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+	t_currentMemoryTag = m_previousTag;
+}
+
+const char* GetMemoryTagName(MemoryTag tag)
+{
+	return s_memoryTagNames[(int)tag];
+}
+
+bool GetMemoryTagFromName(const std::string& name, MemoryTag& out_tag)
+{
+	for (int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; tagIndex++)
+	{
+		if (_stricmp(name.c_str(), s_memoryTagNames[tagIndex]) == 0)
+		{
+			out_tag = (MemoryTag)tagIndex;
+			return true;
+		}
+	}
+	return false;
+}
+
+MemoryTag GetCurrentMemoryTag()
+{
+	return t_currentMemoryTag;
+}
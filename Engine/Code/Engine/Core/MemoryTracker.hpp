@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <stdint.h>
+#include "Engine/Core/StatsRegistry.hpp"
+
+class DevConsole;
+
+//define ENGINE_TRACK_MEMORY to replace the global new/delete with tracked versions. without it the tag scopes compile
+//to nothing and the tracker only reports that it is off
+#if defined( ENGINE_TRACK_MEMORY )
+#define MEMORY_TAG_SCOPE_JOIN_INNER(a, b) a##b
+#define MEMORY_TAG_SCOPE_JOIN(a, b) MEMORY_TAG_SCOPE_JOIN_INNER(a, b)
+#define MEMORY_TAG_SCOPE(tag) MemoryTagScope MEMORY_TAG_SCOPE_JOIN(_memory_tag_scope_, __LINE__)(tag);
+#else
+#define MEMORY_TAG_SCOPE(tag)
+#endif
+
+enum class MemoryTag : unsigned char
+{
+	UNTAGGED,
+	PARTICLES,
+	RENDERER,
+	DEBUG_RENDER,
+	AUDIO,
+	CONSOLE,
+	NUM_TAGS
+};
+
+constexpr int NUM_MEMORY_TAGS = (int)MemoryTag::NUM_TAGS;
+
+struct MemoryTagStats
+{
+	int64_t m_liveBytes = 0;
+	int64_t m_peakBytes = 0;
+	int64_t m_liveAllocations = 0;
+	int64_t m_totalAllocations = 0;
+	int64_t m_totalBytesAllocated = 0;
+	int64_t m_allocationsLastFrame = 0;
+	int64_t m_bytesAllocatedLastFrame = 0;
+	double m_bytesPerSecond = 0.0;			//allocated, over the last frame
+	int64_t m_budgetBytes = 0;				//0 is no budget
+};
+
+//counts every tracked allocation against the tag of the scope it was made in (and every free against the tag it was
+//allocated with). EndFrame, called from Clock::SystemBeginFrame, turns the running totals into per frame counts, feeds the
+//stats registry, warns about blown budgets and fails any armed steady state check
+class MemoryTracker
+{
+public:
+	static MemoryTracker& GetGlobalTracker();
+	static bool IsEnabled();
+
+	MemoryTagStats GetTagStats(MemoryTag tag) const;
+	void SetBudget(MemoryTag tag, int64_t budgetBytes);
+
+	void EndFrame(float deltaSeconds);
+	void PrintBudgetTable(DevConsole& console) const;
+
+	//once armed, any frame in which the tag allocates is a recoverable error. warmupFrames are let through first so
+	//pools and caches can fill
+	void ArmSteadyStateCheck(MemoryTag tag, int warmupFrames = 0);
+	void DisarmSteadyStateCheck(MemoryTag tag);
+	bool IsSteadyStateCheckArmed(MemoryTag tag) const;
+	int GetNumSteadyStateFailures(MemoryTag tag) const;
+
+private:
+	MemoryTracker();
+
+private:
+	//everything here belongs to the thread calling EndFrame
+	MemoryTagStats m_lastFrameStats[NUM_MEMORY_TAGS];
+	int64_t m_budgetBytes[NUM_MEMORY_TAGS] = {};
+	bool m_isOverBudget[NUM_MEMORY_TAGS] = {};
+	bool m_isSteadyStateArmed[NUM_MEMORY_TAGS] = {};
+	int m_steadyStateWarmupFramesLeft[NUM_MEMORY_TAGS] = {};
+	int m_numSteadyStateFailures[NUM_MEMORY_TAGS] = {};
+	StatID m_liveKBStats[NUM_MEMORY_TAGS] = {};
+	StatID m_allocationStats[NUM_MEMORY_TAGS] = {};
+};
+
+class MemoryTagScope
+{
+public:
+	MemoryTagScope(MemoryTag tag);
+	~MemoryTagScope();
+
+	MemoryTagScope(const MemoryTagScope& copyFrom) = delete;
+	MemoryTagScope& operator=(const MemoryTagScope& copyFrom) = delete;
+
+private:
+	MemoryTag m_previousTag = MemoryTag::UNTAGGED;
+};
+
+const char* GetMemoryTagName(MemoryTag tag);
+bool GetMemoryTagFromName(const std::string& name, MemoryTag& out_tag);
+MemoryTag GetCurrentMemoryTag();
+
+#if defined( ENGINE_TRACK_MEMORY )
+//for third party libraries that take allocation callbacks instead of going through new/delete
+void* AllocateTaggedMemory(size_t size, MemoryTag tag);
+void* ReallocateTaggedMemory(void* block, size_t newSize, MemoryTag tag);
+void FreeTaggedMemory(void* block);
+#endif
@@ -1,29 +1,153 @@
 #include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringInternTable.hpp"
 
-NamedProperties::~NamedProperties()
+NamedProperties::NamedProperties(NamedProperties&& moveFrom)
+{
+	MoveAllProperties(moveFrom);
+}
+
+NamedProperties& NamedProperties::operator=(NamedProperties&& moveFrom)
 {
-	for (auto iter = m_namedProperties.begin(); iter != m_namedProperties.end(); ++iter)
+	if (this != &moveFrom)
 	{
-		NamedPropertyBase*& propertyBase = iter->second;
-		if (propertyBase)
-		{
-			delete propertyBase;
-			propertyBase = nullptr;
-		}
+		DeleteAllProperties();
+		MoveAllProperties(moveFrom);
 	}
+	return *this;
+}
 
-	m_namedProperties.clear();
+NamedProperties::~NamedProperties()
+{
+	DeleteAllProperties();
 }
 
-void NamedProperties::SetValue(const std::string& keyName, const char* keyValue)
+void NamedProperties::SetValue(const NamedPropertyKey& key, const char* keyValue)
 {
 	std::string keyValueAsString = keyValue;
-	SetValue(keyName, keyValueAsString);
+	SetValue(key, keyValueAsString);
+}
+
+std::string NamedProperties::GetValue(const NamedPropertyKey& key, const char* defaultValue) const
+{
+	const NamedProperty* property = FindProperty(key);
+	if (property != nullptr && property->m_type == GetNamedPropertyTypeInfo<std::string>())
+	{
+		return *NamedPropertyStorage<std::string>::Get(property->m_value);
+	}
+
+	return std::string(defaultValue);
+}
+
+int NamedProperties::GetNumProperties() const
+{
+	return m_numProperties;
+}
+
+static bool IsPropertyKey(const NamedProperty& property, const NamedPropertyKey& key)
+{
+	if (property.m_keyHash != key.m_hash)
+		return false;
+	if (key.m_internedString)
+		return property.m_key == key.m_internedString;
+
+	return _stricmp(property.m_key->m_string.c_str(), key.m_name) == 0;
+}
+
+NamedProperty* NamedProperties::FindProperty(const NamedPropertyKey& key)
+{
+	for (int i = 0; i < m_numProperties; i++)
+	{
+		NamedProperty& property = GetProperty(i);
+		if (IsPropertyKey(property, key))
+			return &property;
+	}
+
+	return nullptr;
+}
+
+const NamedProperty* NamedProperties::FindProperty(const NamedPropertyKey& key) const
+{
+	for (int i = 0; i < m_numProperties; i++)
+	{
+		const NamedProperty& property = GetProperty(i);
+		if (IsPropertyKey(property, key))
+			return &property;
+	}
+
+	return nullptr;
+}
+
+NamedProperty* NamedProperties::AddProperty(const NamedPropertyKey& key)
+{
+	const InternedString* internedKey = key.m_internedString ? key.m_internedString : InternString(key.m_name);
+
+	if (m_numProperties >= NAMED_PROPERTIES_INLINE_COUNT)
+	{
+		m_overflowProperties.push_back(new NamedProperty());
+	}
+
+	NamedProperty& newProperty = GetProperty(m_numProperties);
+	newProperty.m_keyHash = key.m_hash;
+	newProperty.m_key = internedKey;
+	newProperty.m_type = nullptr;
+	m_numProperties++;
+	return &newProperty;
+}
+
+NamedProperty& NamedProperties::GetProperty(int propertyIndex)
+{
+	if (propertyIndex < NAMED_PROPERTIES_INLINE_COUNT)
+		return m_inlineProperties[propertyIndex];
+
+	return *m_overflowProperties[propertyIndex - NAMED_PROPERTIES_INLINE_COUNT];
 }
 
-std::string NamedProperties::GetValue(const std::string& keyName, const char* defaultValue) const
+const NamedProperty& NamedProperties::GetProperty(int propertyIndex) const
 {
-	std::string defaultValueAsString = defaultValue;
-	return GetValue(keyName, defaultValueAsString);
+	if (propertyIndex < NAMED_PROPERTIES_INLINE_COUNT)
+		return m_inlineProperties[propertyIndex];
+
+	return *m_overflowProperties[propertyIndex - NAMED_PROPERTIES_INLINE_COUNT];
 }
 
+void NamedProperties::MoveAllProperties(NamedProperties& moveFrom)
+{
+	//inline values are moved one by one, the overflow nodes are handed over as they are
+	int numInlineProperties = moveFrom.m_numProperties < NAMED_PROPERTIES_INLINE_COUNT ? moveFrom.m_numProperties : NAMED_PROPERTIES_INLINE_COUNT;
+	for (int i = 0; i < numInlineProperties; i++)
+	{
+		NamedProperty& source = moveFrom.m_inlineProperties[i];
+		NamedProperty& destination = m_inlineProperties[i];
+		destination.m_keyHash = source.m_keyHash;
+		destination.m_key = source.m_key;
+		destination.m_type = source.m_type;
+		source.m_type->m_move(destination.m_value, source.m_value);
+		source.m_type = nullptr;
+	}
+
+	m_overflowProperties = std::move(moveFrom.m_overflowProperties);
+	moveFrom.m_overflowProperties.clear();
+	m_numProperties = moveFrom.m_numProperties;
+	moveFrom.m_numProperties = 0;
+}
+
+void NamedProperties::DeleteAllProperties()
+{
+	for (int i = 0; i < m_numProperties; i++)
+	{
+		NamedProperty& property = GetProperty(i);
+		if (property.m_type)
+		{
+			property.m_type->m_destroy(property.m_value);
+			property.m_type = nullptr;
+		}
+	}
+
+	for (int i = 0; i < m_overflowProperties.size(); i++)
+	{
+		delete m_overflowProperties[i];
+	}
+
+	m_overflowProperties.clear();
+	m_numProperties = 0;
+}
@@ -1,81 +1,149 @@
 #pragma once
-#include <map>
+#include <new>
 #include <string>
+#include <utility>
+#include <vector>
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/HashedCaseInsensitiveString.hpp"
 
-class NamedPropertyBase
+constexpr int NAMED_PROPERTY_INLINE_VALUE_BYTES = 40;		//fits every math type and a std::string in place
+constexpr int NAMED_PROPERTIES_INLINE_COUNT = 8;
+
+//keys are looked up by their case insensitive hash, so string literal keys never build a std::string. a property keeps
+//its interned key name and a matching hash is confirmed against it, two names sharing a hash never alias
+struct NamedPropertyKey
 {
-public:
-	NamedPropertyBase() = default;
-	virtual ~NamedPropertyBase() = default;
+	constexpr NamedPropertyKey(const char* keyName)
+		:m_hash(HashCaseInsensitive(keyName)), m_name(keyName)
+	{
+	}
+	NamedPropertyKey(const std::string& keyName)
+		:m_hash(HashCaseInsensitive(keyName.c_str())), m_name(keyName.c_str())
+	{
+	}
+	NamedPropertyKey(const HashedCaseInsensitiveString& keyName)
+		:m_hash(keyName.GetID()), m_name(keyName.c_str()), m_internedString(keyName.m_internedString)
+	{
+	}
+
+	unsigned int m_hash = 0;
+	const char* m_name = nullptr;							//only valid for the call the key was built for
+	const InternedString* m_internedString = nullptr;		//when already interned, compared by pointer
 };
 
-template <typename T>
-class TypedNameProperty : public NamedPropertyBase
+//one instance per stored type, its address is the type tag
+struct NamedPropertyTypeInfo
 {
-public:
-	TypedNameProperty(const T& value)
-		:m_value(value)
+	void (*m_destroy)(void* storage);
+	void (*m_move)(void* destination, void* source);		//leaves source destroyed
+};
+
+template <typename T, bool T_IsInline = (sizeof(T) <= NAMED_PROPERTY_INLINE_VALUE_BYTES && alignof(T) <= alignof(double))>
+struct NamedPropertyStorage
+{
+	static T* Get(void* storage) { return reinterpret_cast<T*>(storage); }
+	static const T* Get(const void* storage) { return reinterpret_cast<const T*>(storage); }
+	static void Construct(void* storage, const T& value) { new (storage) T(value); }
+	static void Destroy(void* storage) { Get(storage)->~T(); }
+	static void Move(void* destination, void* source)
 	{
+		new (destination) T(std::move(*Get(source)));
+		Get(source)->~T();
 	}
+};
 
-	virtual ~TypedNameProperty() = default;
-
-public:
-	T m_value;
+//types too big for the inline buffer keep a pointer to a heap copy there instead
+template <typename T>
+struct NamedPropertyStorage<T, false>
+{
+	static T* Get(void* storage) { return *reinterpret_cast<T**>(storage); }
+	static const T* Get(const void* storage) { return *reinterpret_cast<T* const*>(storage); }
+	static void Construct(void* storage, const T& value) { *reinterpret_cast<T**>(storage) = new T(value); }
+	static void Destroy(void* storage) { delete Get(storage); }
+	static void Move(void* destination, void* source) { *reinterpret_cast<T**>(destination) = Get(source); }
 };
 
+template <typename T>
+const NamedPropertyTypeInfo* GetNamedPropertyTypeInfo()
+{
+	//not const on purpose, the linker may merge identical read only data and two types would share a tag
+	static NamedPropertyTypeInfo s_typeInfo = { &NamedPropertyStorage<T>::Destroy, &NamedPropertyStorage<T>::Move };
+	return &s_typeInfo;
+}
+
+//left uninitialized on purpose, slots are only filled in by AddProperty so empty args cost nothing to construct
+struct NamedProperty
+{
+	unsigned int m_keyHash;
+	const InternedString* m_key;
+	const NamedPropertyTypeInfo* m_type;
+	alignas(double) unsigned char m_value[NAMED_PROPERTY_INLINE_VALUE_BYTES];
+};
 
+//flat property bag, the first few properties live inside the object so building and reading small event args doesn't allocate
 class NamedProperties
 {
 public:
+	NamedProperties() = default;
+	NamedProperties(NamedProperties&& moveFrom);
+	NamedProperties& operator=(NamedProperties&& moveFrom);
+	NamedProperties(const NamedProperties& copyFrom) = delete;
+	NamedProperties& operator=(const NamedProperties& copyFrom) = delete;
 	~NamedProperties();
 
 	template <typename T_PropertyType>
-	void SetValue(const std::string& keyName, const T_PropertyType& keyValue);
-	void SetValue(const std::string& keyName, const char* keyValue);
+	void SetValue(const NamedPropertyKey& key, const T_PropertyType& keyValue);
+	void SetValue(const NamedPropertyKey& key, const char* keyValue);
 
 	template <typename T_PropertyType>
-	T_PropertyType GetValue(const std::string& keyName, const T_PropertyType& defaultValue) const;
-	std::string GetValue(const std::string& keyName, const char* defaultValue) const;
+	T_PropertyType GetValue(const NamedPropertyKey& key, const T_PropertyType& defaultValue) const;
+	std::string GetValue(const NamedPropertyKey& key, const char* defaultValue) const;
+
+	int GetNumProperties() const;
+
+private:
+	NamedProperty* FindProperty(const NamedPropertyKey& key);
+	const NamedProperty* FindProperty(const NamedPropertyKey& key) const;
+	NamedProperty* AddProperty(const NamedPropertyKey& key);
+	NamedProperty& GetProperty(int propertyIndex);
+	const NamedProperty& GetProperty(int propertyIndex) const;
+	void MoveAllProperties(NamedProperties& moveFrom);
+	void DeleteAllProperties();
 
 private:
-	std::map<HashedCaseInsensitiveString, NamedPropertyBase*> m_namedProperties;
+	NamedProperty m_inlineProperties[NAMED_PROPERTIES_INLINE_COUNT];
+	std::vector<NamedProperty*> m_overflowProperties;
+	int m_numProperties = 0;
 };
 
 template <typename T_PropertyType>
-void NamedProperties::SetValue(const std::string& keyName, const T_PropertyType& keyValue)
+void NamedProperties::SetValue(const NamedPropertyKey& key, const T_PropertyType& keyValue)
 {
-	NamedPropertyBase* baseProperty = m_namedProperties[keyName];
-	if (baseProperty != nullptr)
+	const NamedPropertyTypeInfo* typeInfo = GetNamedPropertyTypeInfo<T_PropertyType>();
+	NamedProperty* existingProperty = FindProperty(key);
+	if (existingProperty != nullptr)
 	{
-		TypedNameProperty<T_PropertyType>* typedProperty = dynamic_cast<TypedNameProperty<T_PropertyType>*>(baseProperty);
-		if (typedProperty != nullptr)
-		{
-			delete baseProperty;
-		}
-		else
+		if (existingProperty->m_type != typeInfo)
 		{
 			ERROR_AND_DIE("Trying to set value of a key which is associated to a different type");
 		}
+
+		*NamedPropertyStorage<T_PropertyType>::Get(existingProperty->m_value) = keyValue;
+		return;
 	}
 
-	NamedPropertyBase* propertyValue = new TypedNameProperty<T_PropertyType>(keyValue);
-	m_namedProperties[keyName] = propertyValue;
+	NamedProperty* newProperty = AddProperty(key);
+	NamedPropertyStorage<T_PropertyType>::Construct(newProperty->m_value, keyValue);
+	newProperty->m_type = typeInfo;
 }
 
 template <typename T_PropertyType>
-T_PropertyType NamedProperties::GetValue(const std::string& keyName, const T_PropertyType& defaultValue) const
+T_PropertyType NamedProperties::GetValue(const NamedPropertyKey& key, const T_PropertyType& defaultValue) const
 {
-	std::map<HashedCaseInsensitiveString, NamedPropertyBase*>::const_iterator valueFound = m_namedProperties.find(keyName);
-	if (valueFound != m_namedProperties.end())
+	const NamedProperty* property = FindProperty(key);
+	if (property != nullptr && property->m_type == GetNamedPropertyTypeInfo<T_PropertyType>())
 	{
-		TypedNameProperty<T_PropertyType>* typedProperty = dynamic_cast<TypedNameProperty<T_PropertyType>*>(valueFound->second);
-		if (typedProperty != nullptr)
-		{
-			return typedProperty->m_value;
-		}
+		return *NamedPropertyStorage<T_PropertyType>::Get(property->m_value);
 	}
 
 	return defaultValue;
@@ -0,0 +1,388 @@
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/BinaryFileUtils.hpp"
+#include "Engine/Core/Compression.hpp"
+#include "Engine/Core/HashedCaseInsensitiveString.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string.h>
+
+constexpr uint64_t PACK_FILE_HASH_SEED = 0xcbf29ce484222325ull;
+constexpr uint64_t PACK_FILE_HASH_PRIME = 0x100000001b3ull;
+
+static std::vector<PackFile*> s_mountedPackFiles;
+//changed on disk after mounting. looked up from loading threads, so behind a lock that is only taken once there are any
+static std::vector<std::string> s_overriddenFilePaths;
+static std::atomic<int> s_numOverriddenFilePaths = 0;
+static std::mutex s_overriddenFilePathsMutex;
+
+static uint64_t AlignPackFileOffset(uint64_t offset)
+{
+	return (offset + PACK_FILE_ENTRY_ALIGNMENT - 1) & ~(uint64_t)(PACK_FILE_ENTRY_ALIGNMENT - 1);
+}
+
+static const char* SkipCurrentDirectoryPrefix(const char* filePath)
+{
+	while (filePath[0] == '.' && (filePath[1] == '/' || filePath[1] == '\\'))
+	{
+		filePath += 2;
+	}
+	return filePath;
+}
+
+static char NormalizePackPathCharacter(char character)
+{
+	return character == '\\' ? '/' : ToLowerAscii(character);
+}
+
+static bool ArePackFilePathsEqual(const char* storedPath, const char* filePath)
+{
+	filePath = SkipCurrentDirectoryPrefix(filePath);
+	for (; *storedPath != '\0' && *filePath != '\0'; storedPath++, filePath++)
+	{
+		if (NormalizePackPathCharacter(*storedPath) != NormalizePackPathCharacter(*filePath))
+			return false;
+	}
+	return *storedPath == *filePath;
+}
+
+uint64_t HashPackFilePath(const char* filePath)
+{
+	uint64_t hash = PACK_FILE_HASH_SEED;
+	for (const char* character = SkipCurrentDirectoryPrefix(filePath); *character != '\0'; character++)
+	{
+		hash = (hash ^ (uint8_t)NormalizePackPathCharacter(*character)) * PACK_FILE_HASH_PRIME;
+	}
+	return hash;
+}
+
+bool PackFile::Open(const std::string& packFilePath)
+{
+	Close();
+	//random access, a pack is far bigger than what any one load touches
+	if (!m_mappedFile.Open(packFilePath, FileAccessPattern::RANDOM))
+		return false;
+
+	const uint8_t* fileData = m_mappedFile.GetData();
+	size_t fileSize = m_mappedFile.GetSize();
+	const PackFileHeader* header = (const PackFileHeader*)fileData;
+	if (fileSize < sizeof(PackFileHeader) || header->m_fourCC != PACK_FILE_FOURCC || header->m_version != PACK_FILE_VERSION || header->m_headerSize != sizeof(PackFileHeader))
+	{
+		ERROR_RECOVERABLE(Stringf("\"%s\" is not a pack file of the current version", packFilePath.c_str()));
+		Close();
+		return false;
+	}
+
+	uint64_t entriesSize = (uint64_t)header->m_numEntries * sizeof(PackFileEntry);
+	bool isValid = header->m_fileSize == fileSize && header->m_entriesOffset % PACK_FILE_ENTRY_ALIGNMENT == 0 && header->m_entriesOffset + entriesSize <= fileSize &&
+		header->m_pathTableOffset + header->m_pathTableSize <= fileSize;
+	if (isValid)
+	{
+		uint64_t checksum = ComputeFileChecksum(fileData + header->m_entriesOffset, (size_t)entriesSize, PACK_FILE_HASH_SEED);
+		checksum = ComputeFileChecksum(fileData + header->m_pathTableOffset, header->m_pathTableSize, checksum);
+		isValid = checksum == header->m_checksum;
+	}
+
+	const PackFileEntry* entries = (const PackFileEntry*)(fileData + header->m_entriesOffset);
+	const char* pathTable = (const char*)(fileData + header->m_pathTableOffset);
+	for (uint32_t entryIndex = 0; isValid && entryIndex < header->m_numEntries; entryIndex++)
+	{
+		const PackFileEntry& entry = entries[entryIndex];
+		isValid = entry.m_dataOffset + entry.m_storedSize <= fileSize && (uint64_t)entry.m_pathOffset + entry.m_pathLength < header->m_pathTableSize &&
+			pathTable[entry.m_pathOffset + entry.m_pathLength] == '\0' && (entryIndex == 0 || entries[entryIndex - 1].m_pathHash <= entry.m_pathHash) &&
+			(entry.m_compression == (uint16_t)ePackCompression::LZ4 || (entry.m_compression == (uint16_t)ePackCompression::NONE && entry.m_storedSize == entry.m_originalSize));
+	}
+	if (!isValid)
+	{
+		ERROR_RECOVERABLE(Stringf("Pack file \"%s\" is malformed", packFilePath.c_str()));
+		Close();
+		return false;
+	}
+
+	m_packFilePath = packFilePath;
+	m_header = header;
+	m_entries = entries;
+	m_pathTable = pathTable;
+	return true;
+}
+
+void PackFile::Close()
+{
+	m_mappedFile.Close();
+	m_packFilePath.clear();
+	m_header = nullptr;
+	m_entries = nullptr;
+	m_pathTable = nullptr;
+}
+
+const PackFileEntry* PackFile::FindEntry(const char* filePath) const
+{
+	if (m_header == nullptr)
+		return nullptr;
+
+	uint64_t pathHash = HashPackFilePath(filePath);
+	const PackFileEntry* entriesEnd = m_entries + m_header->m_numEntries;
+	const PackFileEntry* entry = std::lower_bound(m_entries, entriesEnd, pathHash, [](const PackFileEntry& a, uint64_t hash) { return a.m_pathHash < hash; });
+	for (; entry != entriesEnd && entry->m_pathHash == pathHash; entry++)
+	{
+		if (ArePackFilePathsEqual(GetEntryPath(*entry), filePath))
+			return entry;
+	}
+	return nullptr;
+}
+
+ByteSpan PackFile::GetStoredBytes(const PackFileEntry& entry) const
+{
+	return ByteSpan(m_mappedFile.GetData() + entry.m_dataOffset, entry.m_storedSize);
+}
+
+int64_t PackFile::ReadEntry(const PackFileEntry& entry, uint64_t offset, void* outMemory, size_t numBytes) const
+{
+	if (offset >= entry.m_originalSize)
+		return 0;
+	if (numBytes > entry.m_originalSize - offset)
+	{
+		numBytes = (size_t)(entry.m_originalSize - offset);
+	}
+
+	//the pack is mapped for random access, so without this every page of the entry would be its own read from disk
+	m_mappedFile.PrefetchRange((size_t)entry.m_dataOffset, entry.m_storedSize);
+	ByteSpan storedBytes = GetStoredBytes(entry);
+	if (entry.m_compression == (uint16_t)ePackCompression::NONE)
+	{
+		memcpy(outMemory, storedBytes.m_data + offset, numBytes);
+		return (int64_t)numBytes;
+	}
+
+	//lz4 only decodes front to back, a read from the middle decodes everything before it too
+	if (offset == 0)
+	{
+		return DecompressLZ4(storedBytes.m_data, storedBytes.m_size, (uint8_t*)outMemory, numBytes) == (int64_t)numBytes ? (int64_t)numBytes : -1;
+	}
+
+	std::vector<uint8_t> decodedBytes((size_t)offset + numBytes);
+	if (DecompressLZ4(storedBytes.m_data, storedBytes.m_size, decodedBytes.data(), decodedBytes.size()) != (int64_t)decodedBytes.size())
+		return -1;
+	memcpy(outMemory, decodedBytes.data() + offset, numBytes);
+	return (int64_t)numBytes;
+}
+
+//straight from the disk, whatever is mounted. the packer must never read its inputs back out of a pack
+static bool ReadLooseFile(const std::string& filePath, std::vector<uint8_t>& out_bytes)
+{
+	std::ifstream fileStream(filePath, std::ios::binary | std::ios::ate);
+	if (!fileStream.good())
+		return false;
+
+	out_bytes.resize((size_t)fileStream.tellg());
+	fileStream.seekg(0);
+	fileStream.read((char*)out_bytes.data(), (std::streamsize)out_bytes.size());
+	return fileStream.good() || out_bytes.empty();
+}
+
+bool WritePackFile(const char* packFilePath, const std::vector<std::string>& filePaths, const pack_file_options& options)
+{
+	for (int i = 0; i < s_mountedPackFiles.size(); i++)
+	{
+		if (ArePackFilePathsEqual(s_mountedPackFiles[i]->GetFilePath().c_str(), packFilePath))
+		{
+			ERROR_RECOVERABLE(Stringf("Can't write pack file \"%s\" while it is mounted", packFilePath));
+			return false;
+		}
+	}
+
+	struct PackedFile
+	{
+		std::string m_path;
+		PackFileEntry m_entry;
+		std::vector<uint8_t> m_storedBytes;
+	};
+	std::vector<PackedFile> packedFiles(filePaths.size());
+	std::vector<uint8_t> fileBytes;
+	uint32_t pathTableSize = 0;
+	for (int fileIndex = 0; fileIndex < filePaths.size(); fileIndex++)
+	{
+		if (!ReadLooseFile(filePaths[fileIndex], fileBytes))
+		{
+			ERROR_RECOVERABLE(Stringf("Couldn't read \"%s\" while writing pack file \"%s\"", filePaths[fileIndex].c_str(), packFilePath));
+			return false;
+		}
+		GUARANTEE_OR_DIE(fileBytes.size() <= UINT32_MAX, Stringf("\"%s\" is too big for a pack file entry", filePaths[fileIndex].c_str()));
+
+		PackedFile& packedFile = packedFiles[fileIndex];
+		packedFile.m_path = SkipCurrentDirectoryPrefix(filePaths[fileIndex].c_str());
+		std::replace(packedFile.m_path.begin(), packedFile.m_path.end(), '\\', '/');
+		GUARANTEE_OR_DIE(packedFile.m_path.size() <= UINT16_MAX, Stringf("Path \"%s\" is too long for a pack file", packedFile.m_path.c_str()));
+		packedFile.m_entry.m_pathHash = HashPackFilePath(packedFile.m_path.c_str());
+		packedFile.m_entry.m_originalSize = (uint32_t)fileBytes.size();
+		packedFile.m_entry.m_pathOffset = pathTableSize;
+		packedFile.m_entry.m_pathLength = (uint16_t)packedFile.m_path.size();
+		pathTableSize += (uint32_t)packedFile.m_path.size() + 1;
+
+		bool isCompressible = options.m_compress && std::none_of(options.m_uncompressedExtensions.begin(), options.m_uncompressedExtensions.end(),
+			[&](const std::string& extension)
+			{
+				return packedFile.m_path.size() >= extension.size() && ArePackFilePathsEqual(extension.c_str(), packedFile.m_path.c_str() + packedFile.m_path.size() - extension.size());
+			});
+		if (isCompressible && !fileBytes.empty())
+		{
+			packedFile.m_storedBytes.resize(GetLZ4CompressBound(fileBytes.size()));
+			size_t compressedSize = CompressLZ4(fileBytes.data(), fileBytes.size(), packedFile.m_storedBytes.data(), packedFile.m_storedBytes.size());
+			if (compressedSize > 0 && (float)compressedSize <= (float)fileBytes.size() * options.m_maxCompressedRatio)
+			{
+				packedFile.m_storedBytes.resize(compressedSize);
+				packedFile.m_entry.m_compression = (uint16_t)ePackCompression::LZ4;
+			}
+		}
+		if (packedFile.m_entry.m_compression == (uint16_t)ePackCompression::NONE)
+		{
+			packedFile.m_storedBytes.swap(fileBytes);
+		}
+		packedFile.m_entry.m_storedSize = (uint32_t)packedFile.m_storedBytes.size();
+	}
+
+	PackFileHeader header;
+	header.m_numEntries = (uint32_t)packedFiles.size();
+	header.m_pathTableSize = pathTableSize;
+	header.m_entriesOffset = AlignPackFileOffset(sizeof(PackFileHeader));
+	header.m_pathTableOffset = header.m_entriesOffset + packedFiles.size() * sizeof(PackFileEntry);
+
+	//the data stays in the order it was given, so files that load together sit together in the pack
+	uint64_t dataOffset = header.m_pathTableOffset + pathTableSize;
+	for (int fileIndex = 0; fileIndex < packedFiles.size(); fileIndex++)
+	{
+		packedFiles[fileIndex].m_entry.m_dataOffset = AlignPackFileOffset(dataOffset);
+		dataOffset = packedFiles[fileIndex].m_entry.m_dataOffset + packedFiles[fileIndex].m_entry.m_storedSize;
+	}
+	header.m_fileSize = dataOffset;
+
+	std::vector<PackFileEntry> entries(packedFiles.size());
+	std::vector<char> pathTable(pathTableSize);
+	for (int fileIndex = 0; fileIndex < packedFiles.size(); fileIndex++)
+	{
+		entries[fileIndex] = packedFiles[fileIndex].m_entry;
+		memcpy(pathTable.data() + packedFiles[fileIndex].m_entry.m_pathOffset, packedFiles[fileIndex].m_path.c_str(), packedFiles[fileIndex].m_path.size() + 1);
+	}
+	std::sort(entries.begin(), entries.end(), [](const PackFileEntry& a, const PackFileEntry& b) { return a.m_pathHash < b.m_pathHash; });
+	for (int entryIndex = 1; entryIndex < entries.size(); entryIndex++)
+	{
+		if (entries[entryIndex].m_pathHash == entries[entryIndex - 1].m_pathHash)
+		{
+			const char* path = pathTable.data() + entries[entryIndex].m_pathOffset;
+			GUARANTEE_OR_DIE(!ArePackFilePathsEqual(pathTable.data() + entries[entryIndex - 1].m_pathOffset, path), Stringf("\"%s\" is in pack file \"%s\" twice", path, packFilePath));
+		}
+	}
+	header.m_checksum = ComputeFileChecksum(entries.data(), entries.size() * sizeof(PackFileEntry), PACK_FILE_HASH_SEED);
+	header.m_checksum = ComputeFileChecksum(pathTable.data(), pathTable.size(), header.m_checksum);
+
+	SectionedFileWriter fileWriter;
+	fileWriter.Open(packFilePath);
+	fileWriter.WriteSection(0, &header, sizeof(header));
+	fileWriter.WriteSection(header.m_entriesOffset, entries.data(), entries.size() * sizeof(PackFileEntry));
+	fileWriter.WriteSection(header.m_pathTableOffset, pathTable.data(), pathTable.size());
+	for (int fileIndex = 0; fileIndex < packedFiles.size(); fileIndex++)
+	{
+		fileWriter.WriteSection(packedFiles[fileIndex].m_entry.m_dataOffset, packedFiles[fileIndex].m_storedBytes.data(), packedFiles[fileIndex].m_storedBytes.size());
+	}
+	return fileWriter.Close();
+}
+
+bool WritePackFileFromDirectory(const char* packFilePath, const char* directoryPath, const pack_file_options& options)
+{
+	std::error_code errorCode;
+	std::vector<std::string> filePaths;
+	for (std::filesystem::recursive_directory_iterator fileIter(directoryPath, errorCode), endIter; !errorCode && fileIter != endIter; fileIter.increment(errorCode))
+	{
+		//an earlier pack written into the directory doesn't go into the new one
+		if (fileIter->is_regular_file() && !std::filesystem::equivalent(fileIter->path(), packFilePath, errorCode))
+		{
+			filePaths.push_back(fileIter->path().generic_string());
+		}
+		errorCode.clear();
+	}
+	if (errorCode)
+	{
+		ERROR_RECOVERABLE(Stringf("Couldn't list directory \"%s\" for pack file \"%s\"", directoryPath, packFilePath));
+		return false;
+	}
+
+	std::sort(filePaths.begin(), filePaths.end());
+	return WritePackFile(packFilePath, filePaths, options);
+}
+
+bool MountPackFile(const std::string& packFilePath)
+{
+	PackFile* packFile = new PackFile();
+	if (!packFile->Open(packFilePath))
+	{
+		delete packFile;
+		return false;
+	}
+
+	s_mountedPackFiles.push_back(packFile);
+	return true;
+}
+
+void UnmountAllPackFiles()
+{
+	for (int i = 0; i < s_mountedPackFiles.size(); i++)
+	{
+		delete s_mountedPackFiles[i];
+	}
+	s_mountedPackFiles.clear();
+
+	s_overriddenFilePathsMutex.lock();
+	s_overriddenFilePaths.clear();
+	s_numOverriddenFilePaths = 0;
+	s_overriddenFilePathsMutex.unlock();
+}
+
+int GetNumMountedPackFiles()
+{
+	return (int)s_mountedPackFiles.size();
+}
+
+static bool IsPackedFileOverridden(const char* filePath)
+{
+	if (s_numOverriddenFilePaths == 0)
+		return false;
+
+	std::lock_guard<std::mutex> lock(s_overriddenFilePathsMutex);
+	for (int i = 0; i < s_overriddenFilePaths.size(); i++)
+	{
+		if (ArePackFilePathsEqual(s_overriddenFilePaths[i].c_str(), filePath))
+			return true;
+	}
+	return false;
+}
+
+void OverridePackedFileWithLooseFile(const char* filePath)
+{
+	if (s_mountedPackFiles.empty() || IsPackedFileOverridden(filePath))
+		return;
+
+	std::lock_guard<std::mutex> lock(s_overriddenFilePathsMutex);
+	s_overriddenFilePaths.push_back(SkipCurrentDirectoryPrefix(filePath));
+	s_numOverriddenFilePaths = (int)s_overriddenFilePaths.size();
+}
+
+const PackFileEntry* FindMountedPackEntry(const char* filePath, const PackFile** out_packFile)
+{
+	if (IsPackedFileOverridden(filePath))
+		return nullptr;
+
+	for (int i = (int)s_mountedPackFiles.size() - 1; i >= 0; i--)
+	{
+		const PackFileEntry* entry = s_mountedPackFiles[i]->FindEntry(filePath);
+		if (entry)
+		{
+			*out_packFile = s_mountedPackFiles[i];
+			return entry;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Engine/Core/FileUtils.hpp"
+
+constexpr uint32_t PACK_FILE_FOURCC = 0x4b434150;		//"PACK"
+constexpr uint16_t PACK_FILE_VERSION = 2;
+constexpr size_t PACK_FILE_ENTRY_ALIGNMENT = 16;		//entries are used in place from the mapping, cooked formats want their sections aligned
+
+enum class ePackCompression : uint16_t
+{
+	NONE,
+	LZ4,
+};
+
+//sorted by path hash so a lookup is a binary search. the stored path settles the rare hash collision
+struct PackFileEntry
+{
+	uint64_t m_pathHash = 0;
+	uint64_t m_dataOffset = 0;
+	uint32_t m_storedSize = 0;
+	uint32_t m_originalSize = 0;
+	uint32_t m_pathOffset = 0;			//into the path table, '\0' terminated
+	uint16_t m_compression = (uint16_t)ePackCompression::NONE;
+	uint16_t m_pathLength = 0;
+};
+static_assert(sizeof(PackFileEntry) == 32, "PackFileEntry layout changed, bump PACK_FILE_VERSION");
+
+//little endian, the entry table follows the header, then the path table, then the entry data in the order it was packed
+struct PackFileHeader
+{
+	uint32_t m_fourCC = PACK_FILE_FOURCC;
+	uint16_t m_version = PACK_FILE_VERSION;
+	uint16_t m_headerSize = (uint16_t)sizeof(PackFileHeader);
+	uint32_t m_numEntries = 0;
+	uint32_t m_pathTableSize = 0;
+	uint64_t m_entriesOffset = 0;
+	uint64_t m_pathTableOffset = 0;
+	uint64_t m_fileSize = 0;
+	uint64_t m_checksum = 0;			//over the entry and path tables, the data is left to the formats inside
+};
+static_assert(sizeof(PackFileHeader) == 48, "PackFileHeader layout changed, bump PACK_FILE_VERSION");
+
+//paths are looked up the way windows opens files: case insensitive, either slash, with or without a leading "./"
+uint64_t HashPackFilePath(const char* filePath);
+
+//a pack used straight out of a memory mapping. stored entries are handed out without a copy, compressed ones are
+//decoded into the caller's memory
+class PackFile
+{
+public:
+	PackFile() = default;
+	PackFile(const PackFile& copyFrom) = delete;
+
+	bool Open(const std::string& packFilePath);
+	void Close();
+	bool IsOpen() const { return m_header != nullptr; }
+	const std::string& GetFilePath() const { return m_packFilePath; }
+
+	int GetNumEntries() const { return m_header ? (int)m_header->m_numEntries : 0; }
+	const PackFileEntry& GetEntry(int entryIndex) const { return m_entries[entryIndex]; }
+	const PackFileEntry* FindEntry(const char* filePath) const;
+	const char* GetEntryPath(const PackFileEntry& entry) const { return m_pathTable + entry.m_pathOffset; }
+	ByteSpan GetStoredBytes(const PackFileEntry& entry) const;
+
+	//numBytes of the original file starting at offset, clamped to the end of it. returns the bytes read or -1
+	int64_t ReadEntry(const PackFileEntry& entry, uint64_t offset, void* outMemory, size_t numBytes) const;
+
+private:
+	MappedFile m_mappedFile;
+	std::string m_packFilePath;
+	const PackFileHeader* m_header = nullptr;
+	const PackFileEntry* m_entries = nullptr;
+	const char* m_pathTable = nullptr;
+};
+
+struct pack_file_options
+{
+	bool m_compress = true;
+	float m_maxCompressedRatio = 0.9f;		//entries that don't shrink below this are stored, they're cheaper to use in place
+	std::vector<std::string> m_uncompressedExtensions;		//always stored, for cooked formats the loaders map and use in place
+};
+
+//the packer. files are stored under the paths given, so pass them the way the game asks for them ("Data/...")
+bool WritePackFile(const char* packFilePath, const std::vector<std::string>& filePaths, const pack_file_options& options = pack_file_options());
+//every file under the directory, in path order so the same tree always packs to the same bytes
+bool WritePackFileFromDirectory(const char* packFilePath, const char* directoryPath, const pack_file_options& options = pack_file_options());
+
+//the virtual file system. FileReadToBuffer, FileReadToString, MappedFile, DoesFileExist and AsyncFileIO reads all look
+//in the mounted packs before the disk, later mounts win. mount and unmount while nothing is loading
+bool MountPackFile(const std::string& packFilePath);
+void UnmountAllPackFiles();
+int GetNumMountedPackFiles();
+const PackFileEntry* FindMountedPackEntry(const char* filePath, const PackFile** out_packFile);
+//the loose file has changed since the packs were built, so reads of this path skip the packs from now on (until
+//UnmountAllPackFiles). the file watcher does this for every change it reports, so hot reloads never see stale pack data
+void OverridePackedFileWithLooseFile(const char* filePath);
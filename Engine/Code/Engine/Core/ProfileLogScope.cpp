@@ -1,22 +1,31 @@
 #include "Engine/Core/ProfileLogScope.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/DevConsole.hpp"
-#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/BinaryLog.hpp"
+#include "Engine/Core/Profiler.hpp"
 
 extern DevConsole* g_theConsole;
 
 ProfileLogScope::ProfileLogScope(const char* tag)
 	:m_tag(tag), m_startRawTime(GetCurrentTimeRaw())
 {
-
+#if !defined( ENGINE_DISABLE_PROFILER )
+	m_isProfiled = Profiler::GetGlobalProfiler().BeginScope(tag, PROFILER_EVENT_BEGIN);
+#endif
 }
 
 ProfileLogScope::~ProfileLogScope()
 {
 	uint64_t duration = GetCurrentTimeRaw() - m_startRawTime;
+	if (m_isProfiled)
+	{
+		Profiler::GetGlobalProfiler().EndScope();
+	}
+
 	if (g_theConsole)
 	{
-		g_theConsole->AddLine(g_theConsole->INFO_MINOR, Stringf("%s = %f ms", m_tag, ConvertRawTimeToSeconds(duration) * 1000.f));
+		//recorded raw, the console formats it when it drains the binary log
+		BINARY_LOG("%s = %f ms", m_tag, ConvertRawTimeToSeconds(duration) * 1000.0);
 	}
 }
 
@@ -12,4 +12,5 @@ public:
 private:
 	uint64_t m_startRawTime = 0;
 	char const* m_tag;
+	bool m_isProfiled = false;
 };
\ No newline at end of file
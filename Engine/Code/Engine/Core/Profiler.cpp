@@ -0,0 +1,425 @@
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <string.h>
+
+//set the first time a thread opens a scope, the buffer itself is owned by the global profiler
+static thread_local ProfilerThreadBuffer* t_profilerThreadBuffer = nullptr;
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(int threadIndex)
+	:m_threadIndex(threadIndex)
+{
+	static_assert((PROFILER_THREAD_BUFFER_EVENTS & (PROFILER_THREAD_BUFFER_EVENTS - 1)) == 0, "Profiler thread buffer size must be a power of two");
+	m_events = new ProfilerEvent[PROFILER_THREAD_BUFFER_EVENTS];
+	m_mask = PROFILER_THREAD_BUFFER_EVENTS - 1;
+	m_threadName = Stringf("Thread %d", threadIndex);
+}
+
+ProfilerThreadBuffer::~ProfilerThreadBuffer()
+{
+	delete[] m_events;
+	m_events = nullptr;
+}
+
+bool ProfilerThreadBuffer::PushBegin(const char* name, ProfilerEventType type)
+{
+	//a begin needs room for itself and for the end of every recorded scope still open, its own included,
+	//so an end is never dropped once its begin made it in
+	unsigned int writePosition = m_writePosition.load(std::memory_order_relaxed);
+	unsigned int readPosition = m_readPosition.load(std::memory_order_acquire);
+	unsigned int freeEvents = (m_mask + 1) - (writePosition - readPosition);
+	if (freeEvents < (unsigned int)m_numReservedEnds + 2)
+	{
+		m_numDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	ProfilerEvent& event = m_events[writePosition & m_mask];
+	event.m_rawTime = GetCurrentTimeRaw();
+	event.m_name = name;
+	event.m_type = type;
+	m_numReservedEnds++;
+	m_writePosition.store(writePosition + 1, std::memory_order_release);
+	return true;
+}
+
+void ProfilerThreadBuffer::PushEnd()
+{
+	unsigned int writePosition = m_writePosition.load(std::memory_order_relaxed);
+	ProfilerEvent& event = m_events[writePosition & m_mask];
+	event.m_rawTime = GetCurrentTimeRaw();
+	event.m_name = nullptr;
+	event.m_type = PROFILER_EVENT_END;
+	m_numReservedEnds--;
+	m_writePosition.store(writePosition + 1, std::memory_order_release);
+}
+
+Profiler::~Profiler()
+{
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		delete m_threadBuffers[i];
+	}
+	m_threadBuffers.clear();
+}
+
+Profiler& Profiler::GetGlobalProfiler()
+{
+	//function static so scopes hit during static initialization still find the profiler
+	static Profiler s_globalProfiler;
+	return s_globalProfiler;
+}
+
+bool Profiler::BeginScope(const char* name, ProfilerEventType type)
+{
+	return GetThreadBuffer().PushBegin(name, type);
+}
+
+void Profiler::EndScope()
+{
+	t_profilerThreadBuffer->PushEnd();
+}
+
+void Profiler::SetThreadName(const std::string& threadName)
+{
+	ProfilerThreadBuffer& threadBuffer = GetThreadBuffer();
+	m_mutex.lock();
+	threadBuffer.m_threadName = threadName;
+	threadBuffer.m_isNamed = true;
+	m_mutex.unlock();
+}
+
+void Profiler::BeginFrame()
+{
+	ProfilerThreadBuffer& frameThreadBuffer = GetThreadBuffer();
+	m_mutex.lock();
+	if (!frameThreadBuffer.m_isNamed)
+	{
+		frameThreadBuffer.m_threadName = "Main";
+		frameThreadBuffer.m_isNamed = true;
+	}
+
+	m_frameNumber++;
+	m_frameThreadIndex = frameThreadBuffer.m_threadIndex;
+	m_frameStartRawTime = GetCurrentTimeRaw();
+	for (int i = 0; i < m_nodes.size(); i++)
+	{
+		ProfilerNode& node = m_nodes[i];
+		node.m_numCalls = 0;
+		node.m_totalRawTime = 0;
+		node.m_minRawTime = 0;
+		node.m_maxRawTime = 0;
+	}
+
+	if (!m_isCaptureActive && m_numCaptureFramesRequested > 0)
+	{
+		m_isCaptureActive = true;
+		m_numCaptureFramesLeft = m_numCaptureFramesRequested;
+		m_numCaptureFramesRequested = 0;
+		m_captureEvents.clear();
+		m_captureFrameStarts.clear();
+		for (int i = 0; i < m_threadBuffers.size(); i++)
+		{
+			m_threadBuffers[i]->m_captureBaseDepth = (int)m_threadBuffers[i]->m_openScopes.size();
+		}
+	}
+
+	if (m_isCaptureActive)
+	{
+		m_captureFrameStarts.push_back(std::pair<int, uint64_t>(m_frameNumber, m_frameStartRawTime));
+	}
+	m_mutex.unlock();
+}
+
+void Profiler::EndFrame()
+{
+	m_mutex.lock();
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		DrainThreadBuffer(*m_threadBuffers[i]);
+	}
+
+	//the copy reuses its storage once the tree stops growing
+	m_lastFrameNodes = m_nodes;
+	m_lastFrameNumber = m_frameNumber;
+
+	if (m_isCaptureActive)
+	{
+		m_numCaptureFramesLeft--;
+		if (m_numCaptureFramesLeft <= 0)
+		{
+			WriteCapture();
+			m_isCaptureActive = false;
+		}
+	}
+	m_mutex.unlock();
+}
+
+void Profiler::StartCapture(int numFrames, const std::string& outputPath)
+{
+	m_mutex.lock();
+	if (numFrames > PROFILER_MAX_CAPTURE_FRAMES)
+	{
+		numFrames = PROFILER_MAX_CAPTURE_FRAMES;
+	}
+	m_numCaptureFramesRequested = numFrames > 0 ? numFrames : 1;
+	m_captureOutputPath = outputPath;
+	m_mutex.unlock();
+}
+
+bool Profiler::IsCapturing() const
+{
+	return m_isCaptureActive || m_numCaptureFramesRequested > 0;
+}
+
+const std::vector<ProfilerNode>& Profiler::GetLastFrameNodes() const
+{
+	return m_lastFrameNodes;
+}
+
+int Profiler::GetLastFrameNumber() const
+{
+	return m_lastFrameNumber;
+}
+
+unsigned int Profiler::GetNumDropped()
+{
+	m_mutex.lock();
+	unsigned int numDropped = 0;
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		numDropped += m_threadBuffers[i]->m_numDropped.load();
+	}
+	m_mutex.unlock();
+	return numDropped;
+}
+
+static void PrintNodeReport(DevConsole& console, const std::vector<ProfilerNode>& nodes, int nodeIndex, uint64_t minTotalRawTime)
+{
+	for (int childIndex = nodes[nodeIndex].m_firstChildIndex; childIndex != -1; childIndex = nodes[childIndex].m_nextSiblingIndex)
+	{
+		const ProfilerNode& child = nodes[childIndex];
+		if (child.m_numCalls == 0 || child.m_totalRawTime < minTotalRawTime)
+			continue;
+
+		double totalMs = ConvertRawTimeToSeconds(child.m_totalRawTime) * 1000.0;
+		console.AddLineFormatted(console.INFO_MINOR, "%*s%s%s  calls %d  total %.3f ms  avg %.3f  min %.3f  max %.3f",
+			child.m_depth * 2, "", child.m_name, child.m_isJob ? " (job)" : "", child.m_numCalls, totalMs, totalMs / (double)child.m_numCalls,
+			ConvertRawTimeToSeconds(child.m_minRawTime) * 1000.0, ConvertRawTimeToSeconds(child.m_maxRawTime) * 1000.0);
+		PrintNodeReport(console, nodes, childIndex, minTotalRawTime);
+	}
+}
+
+void Profiler::PrintLastFrameReport(DevConsole& console, float minTotalMs)
+{
+	uint64_t minTotalRawTime = (uint64_t)((double)minTotalMs * 0.001 / ConvertRawTimeToSeconds(1));
+	console.AddLineFormatted(console.INFO_MAJOR, "---- Profile of frame %d ----", m_lastFrameNumber);
+	m_mutex.lock();
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		const ProfilerThreadBuffer& threadBuffer = *m_threadBuffers[i];
+		if (threadBuffer.m_rootNodeIndex == -1 || threadBuffer.m_rootNodeIndex >= m_lastFrameNodes.size())
+			continue;
+
+		console.AddLine(console.INFO_MAJOR, threadBuffer.m_threadName);
+		PrintNodeReport(console, m_lastFrameNodes, threadBuffer.m_rootNodeIndex, minTotalRawTime);
+	}
+	m_mutex.unlock();
+}
+
+ProfilerThreadBuffer& Profiler::GetThreadBuffer()
+{
+	if (t_profilerThreadBuffer == nullptr)
+	{
+		m_mutex.lock();
+		t_profilerThreadBuffer = new ProfilerThreadBuffer((int)m_threadBuffers.size());
+		m_threadBuffers.push_back(t_profilerThreadBuffer);
+		m_mutex.unlock();
+	}
+
+	return *t_profilerThreadBuffer;
+}
+
+void Profiler::DrainThreadBuffer(ProfilerThreadBuffer& threadBuffer)
+{
+	if (threadBuffer.m_rootNodeIndex == -1)
+	{
+		ProfilerNode root;
+		root.m_threadIndex = threadBuffer.m_threadIndex;
+		threadBuffer.m_rootNodeIndex = (int)m_nodes.size();
+		m_nodes.push_back(root);
+	}
+
+	unsigned int readPosition = threadBuffer.m_readPosition.load(std::memory_order_relaxed);
+	unsigned int writePosition = threadBuffer.m_writePosition.load(std::memory_order_acquire);
+	for (; readPosition != writePosition; readPosition++)
+	{
+		const ProfilerEvent& event = threadBuffer.m_events[readPosition & threadBuffer.m_mask];
+		if (event.m_type == PROFILER_EVENT_END)
+		{
+			//can't be empty, a scope's end is only recorded if its begin was
+			ProfilerOpenScope openScope = threadBuffer.m_openScopes.back();
+			threadBuffer.m_openScopes.pop_back();
+			ProfilerNode& node = m_nodes[openScope.m_nodeIndex];
+			uint64_t duration = event.m_rawTime - openScope.m_startRawTime;
+			node.m_minRawTime = (node.m_numCalls == 0 || duration < node.m_minRawTime) ? duration : node.m_minRawTime;
+			node.m_maxRawTime = duration > node.m_maxRawTime ? duration : node.m_maxRawTime;
+			node.m_totalRawTime += duration;
+			node.m_numCalls++;
+
+			if (m_isCaptureActive)
+			{
+				if ((int)threadBuffer.m_openScopes.size() < threadBuffer.m_captureBaseDepth)
+				{
+					threadBuffer.m_captureBaseDepth = (int)threadBuffer.m_openScopes.size();
+				}
+				else
+				{
+					ProfilerCaptureEvent captureEvent;
+					captureEvent.m_rawTime = event.m_rawTime;
+					captureEvent.m_threadIndex = threadBuffer.m_threadIndex;
+					captureEvent.m_type = PROFILER_EVENT_END;
+					m_captureEvents.push_back(captureEvent);
+				}
+			}
+		}
+		else
+		{
+			int parentIndex = threadBuffer.m_openScopes.empty() ? threadBuffer.m_rootNodeIndex : threadBuffer.m_openScopes.back().m_nodeIndex;
+			ProfilerOpenScope openScope;
+			openScope.m_nodeIndex = FindOrAddChildNode(parentIndex, event.m_name, event.m_type == PROFILER_EVENT_JOB_BEGIN);
+			openScope.m_startRawTime = event.m_rawTime;
+			threadBuffer.m_openScopes.push_back(openScope);
+
+			if (m_isCaptureActive)
+			{
+				ProfilerCaptureEvent captureEvent;
+				captureEvent.m_rawTime = event.m_rawTime;
+				captureEvent.m_name = event.m_name;
+				captureEvent.m_threadIndex = threadBuffer.m_threadIndex;
+				captureEvent.m_type = event.m_type;
+				m_captureEvents.push_back(captureEvent);
+			}
+		}
+	}
+
+	threadBuffer.m_readPosition.store(writePosition, std::memory_order_release);
+}
+
+int Profiler::FindOrAddChildNode(int parentIndex, const char* name, bool isJob)
+{
+	//names are compared by text since the same literal can have a different address in every translation unit
+	int lastChildIndex = -1;
+	for (int childIndex = m_nodes[parentIndex].m_firstChildIndex; childIndex != -1; childIndex = m_nodes[childIndex].m_nextSiblingIndex)
+	{
+		const ProfilerNode& child = m_nodes[childIndex];
+		if (child.m_isJob == isJob && (child.m_name == name || strcmp(child.m_name, name) == 0))
+			return childIndex;
+		lastChildIndex = childIndex;
+	}
+
+	ProfilerNode newNode;
+	newNode.m_name = name;
+	newNode.m_parentIndex = parentIndex;
+	newNode.m_threadIndex = m_nodes[parentIndex].m_threadIndex;
+	newNode.m_depth = m_nodes[parentIndex].m_depth + 1;
+	newNode.m_isJob = isJob;
+	int newNodeIndex = (int)m_nodes.size();
+	m_nodes.push_back(newNode);
+	if (lastChildIndex == -1)
+	{
+		m_nodes[parentIndex].m_firstChildIndex = newNodeIndex;
+	}
+	else
+	{
+		m_nodes[lastChildIndex].m_nextSiblingIndex = newNodeIndex;
+	}
+	return newNodeIndex;
+}
+
+static void AppendJsonEscaped(std::string& json, const char* text)
+{
+	for (const char* character = text; *character != '\0'; character++)
+	{
+		if (*character == '"' || *character == '\\')
+		{
+			json += '\\';
+		}
+		json += *character;
+	}
+}
+
+void Profiler::WriteCapture()
+{
+	//Chrome trace_event format, timestamps in microseconds from the first captured frame
+	uint64_t captureStartRawTime = m_captureFrameStarts.empty() ? 0 : m_captureFrameStarts[0].second;
+	uint64_t captureEndRawTime = GetCurrentTimeRaw();
+	double microsecondsPerRawTick = ConvertRawTimeToSeconds(1) * 1000000.0;
+	std::string json;
+	json.reserve(m_captureEvents.size() * 80 + 1024);
+	json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		json += Stringf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"", i);
+		AppendJsonEscaped(json, m_threadBuffers[i]->m_threadName.c_str());
+		json += "\"}},\n";
+	}
+
+	char eventText[128];
+	for (int i = 0; i < m_captureFrameStarts.size(); i++)
+	{
+		double timestamp = (double)(m_captureFrameStarts[i].second - captureStartRawTime) * microsecondsPerRawTick;
+		snprintf(eventText, sizeof(eventText), "{\"name\":\"Frame %d\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":%d,\"ts\":%.3f},\n", m_captureFrameStarts[i].first, m_frameThreadIndex, timestamp);
+		json += eventText;
+	}
+
+	for (int i = 0; i < m_captureEvents.size(); i++)
+	{
+		const ProfilerCaptureEvent& captureEvent = m_captureEvents[i];
+		double timestamp = (double)(captureEvent.m_rawTime - captureStartRawTime) * microsecondsPerRawTick;
+		if (captureEvent.m_type == PROFILER_EVENT_END)
+		{
+			snprintf(eventText, sizeof(eventText), "{\"ph\":\"E\",\"pid\":0,\"tid\":%d,\"ts\":%.3f},\n", captureEvent.m_threadIndex, timestamp);
+			json += eventText;
+		}
+		else
+		{
+			json += "{\"name\":\"";
+			AppendJsonEscaped(json, captureEvent.m_name);
+			snprintf(eventText, sizeof(eventText), "\",\"cat\":\"%s\",\"ph\":\"B\",\"pid\":0,\"tid\":%d,\"ts\":%.3f},\n",
+				captureEvent.m_type == PROFILER_EVENT_JOB_BEGIN ? "job" : "scope", captureEvent.m_threadIndex, timestamp);
+			json += eventText;
+		}
+	}
+
+	//close whatever was still open so every begin in the file has its end
+	double endTimestamp = (double)(captureEndRawTime - captureStartRawTime) * microsecondsPerRawTick;
+	for (int i = 0; i < m_threadBuffers.size(); i++)
+	{
+		const ProfilerThreadBuffer& threadBuffer = *m_threadBuffers[i];
+		for (int depth = (int)threadBuffer.m_openScopes.size(); depth > threadBuffer.m_captureBaseDepth; depth--)
+		{
+			snprintf(eventText, sizeof(eventText), "{\"ph\":\"E\",\"pid\":0,\"tid\":%d,\"ts\":%.3f},\n", threadBuffer.m_threadIndex, endTimestamp);
+			json += eventText;
+		}
+	}
+
+	//the trailing comma is replaced with the closing brackets
+	if (json.size() >= 2 && json[json.size() - 2] == ',')
+	{
+		json.erase(json.size() - 2);
+		json += '\n';
+	}
+	json += "]}\n";
+
+	FileStream captureFile;
+	captureFile.OpenForWrite(m_captureOutputPath.c_str());
+	captureFile.WriteBytes(json.c_str(), json.size());
+	captureFile.Close();
+	m_captureEvents.clear();
+	m_captureFrameStarts.clear();
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+class DevConsole;
+
+//define ENGINE_DISABLE_PROFILER to compile every scope out
+#if defined( ENGINE_DISABLE_PROFILER )
+#define PROFILE_SCOPE(name)
+#define PROFILE_JOB_SCOPE(name)
+#else
+#define PROFILE_SCOPE_JOIN_INNER(a, b) a##b
+#define PROFILE_SCOPE_JOIN(a, b) PROFILE_SCOPE_JOIN_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_JOIN(_profile_scope_, __LINE__)(name, PROFILER_EVENT_BEGIN);
+#define PROFILE_JOB_SCOPE(name) ProfileScope PROFILE_SCOPE_JOIN(_profile_scope_, __LINE__)(name, PROFILER_EVENT_JOB_BEGIN);
+#endif
+
+constexpr int PROFILER_THREAD_BUFFER_EVENTS = 32 * 1024;		//per profiled thread, power of two
+constexpr int PROFILER_MAX_CAPTURE_FRAMES = 600;
+
+enum ProfilerEventType : unsigned char
+{
+	PROFILER_EVENT_BEGIN,
+	PROFILER_EVENT_JOB_BEGIN,
+	PROFILER_EVENT_END,
+};
+
+struct ProfilerEvent
+{
+	uint64_t m_rawTime = 0;
+	const char* m_name = nullptr;		//must outlive the profiler, normally a literal
+	ProfilerEventType m_type = PROFILER_EVENT_BEGIN;
+};
+
+struct ProfilerOpenScope
+{
+	int m_nodeIndex = -1;
+	uint64_t m_startRawTime = 0;
+};
+
+//single producer (the owning thread), single consumer (the thread running Profiler::EndFrame)
+class ProfilerThreadBuffer
+{
+	friend class Profiler;
+public:
+	ProfilerThreadBuffer(int threadIndex);
+	~ProfilerThreadBuffer();
+
+	bool PushBegin(const char* name, ProfilerEventType type);
+	void PushEnd();
+
+private:
+	ProfilerEvent* m_events = nullptr;
+	unsigned int m_mask = 0;
+	int m_threadIndex = 0;
+	int m_numReservedEnds = 0;				//producer only. every recorded begin keeps a slot free for its end
+	alignas(64) std::atomic<unsigned int> m_writePosition{ 0 };
+	alignas(64) std::atomic<unsigned int> m_readPosition{ 0 };
+	std::atomic<unsigned int> m_numDropped{ 0 };
+
+	//consumer only
+	std::string m_threadName;
+	bool m_isNamed = false;
+	int m_rootNodeIndex = -1;
+	std::vector<ProfilerOpenScope> m_openScopes;
+	int m_captureBaseDepth = 0;				//scopes already open when the capture started have no begin in it
+};
+
+//one node per distinct call path, per thread. times are raw and summed over a frame
+struct ProfilerNode
+{
+	const char* m_name = nullptr;
+	int m_parentIndex = -1;
+	int m_firstChildIndex = -1;
+	int m_nextSiblingIndex = -1;
+	int m_threadIndex = 0;
+	int m_depth = 0;						//roots, one per thread, are depth 0 and have no name
+	bool m_isJob = false;
+	int m_numCalls = 0;
+	uint64_t m_totalRawTime = 0;
+	uint64_t m_minRawTime = 0;
+	uint64_t m_maxRawTime = 0;
+};
+
+struct ProfilerCaptureEvent
+{
+	uint64_t m_rawTime = 0;
+	const char* m_name = nullptr;
+	int m_threadIndex = 0;
+	ProfilerEventType m_type = PROFILER_EVENT_BEGIN;
+};
+
+//scopes record begin/end events into their thread's buffer without locking. BeginFrame/EndFrame drain them on one
+//thread, building a per frame call tree (calls, total, min, avg, max) and optionally a Chrome trace_event capture
+//that opens in Perfetto or chrome://tracing. Clock::SystemBeginFrame drives the frames, the dev console has the profile_* commands
+class Profiler
+{
+public:
+	~Profiler();
+	static Profiler& GetGlobalProfiler();
+
+	bool BeginScope(const char* name, ProfilerEventType type);
+	void EndScope();
+	void SetThreadName(const std::string& threadName);
+
+	void BeginFrame();
+	void EndFrame();
+
+	void StartCapture(int numFrames, const std::string& outputPath);
+	bool IsCapturing() const;
+	const std::vector<ProfilerNode>& GetLastFrameNodes() const;
+	int GetLastFrameNumber() const;
+	unsigned int GetNumDropped();
+	void PrintLastFrameReport(DevConsole& console, float minTotalMs = 0.f);
+
+private:
+	Profiler() = default;
+	ProfilerThreadBuffer& GetThreadBuffer();
+	void DrainThreadBuffer(ProfilerThreadBuffer& threadBuffer);
+	int FindOrAddChildNode(int parentIndex, const char* name, bool isJob);
+	void WriteCapture();
+
+private:
+	std::mutex m_mutex;
+	std::vector<ProfilerThreadBuffer*> m_threadBuffers;
+
+	//everything below belongs to the thread calling BeginFrame/EndFrame
+	int m_frameNumber = 0;
+	int m_frameThreadIndex = 0;
+	uint64_t m_frameStartRawTime = 0;
+	std::vector<ProfilerNode> m_nodes;
+	std::vector<ProfilerNode> m_lastFrameNodes;
+	int m_lastFrameNumber = -1;
+	int m_numCaptureFramesRequested = 0;
+	int m_numCaptureFramesLeft = 0;
+	bool m_isCaptureActive = false;
+	std::string m_captureOutputPath;
+	std::vector<ProfilerCaptureEvent> m_captureEvents;
+	std::vector<std::pair<int, uint64_t>> m_captureFrameStarts;		//frame number, raw time
+};
+
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name, ProfilerEventType type = PROFILER_EVENT_BEGIN)
+	{
+		m_isRecorded = Profiler::GetGlobalProfiler().BeginScope(name, type);
+	}
+
+	~ProfileScope()
+	{
+		if (m_isRecorded)
+		{
+			Profiler::GetGlobalProfiler().EndScope();
+		}
+	}
+
+	ProfileScope(const ProfileScope& copyFrom) = delete;
+	ProfileScope& operator=(const ProfileScope& copyFrom) = delete;
+
+private:
+	bool m_isRecorded = false;
+};
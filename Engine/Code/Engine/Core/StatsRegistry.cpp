@@ -0,0 +1,508 @@
+#include "Engine/Core/StatsRegistry.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Clock.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <math.h>
+
+static std::atomic<int> s_numShardedThreads{ 0 };
+static thread_local int t_statShardIndex = -1;
+
+static int GetThreadShardIndex()
+{
+	if (t_statShardIndex < 0)
+	{
+		t_statShardIndex = s_numShardedThreads.fetch_add(1) % STATS_NUM_SHARDS;
+	}
+	return t_statShardIndex;
+}
+
+static void AtomicAddDouble(std::atomic<double>& target, double value)
+{
+	double current = target.load(std::memory_order_relaxed);
+	while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+}
+
+static void AtomicMinDouble(std::atomic<double>& target, double value)
+{
+	double current = target.load(std::memory_order_relaxed);
+	while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+static void AtomicMaxDouble(std::atomic<double>& target, double value)
+{
+	double current = target.load(std::memory_order_relaxed);
+	while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+static int GetHistogramBucketIndex(double value)
+{
+	//bucket 0 takes zero, negatives and anything under the range
+	int exponent = 0;
+	double mantissa = frexp(value, &exponent);
+	if (!(value > 0.0) || exponent < STATS_HISTOGRAM_MIN_EXPONENT)
+		return 0;
+
+	int octave = exponent - STATS_HISTOGRAM_MIN_EXPONENT;
+	if (octave >= STATS_HISTOGRAM_NUM_OCTAVES)
+		return STATS_HISTOGRAM_NUM_BUCKETS - 1;
+
+	int subBucket = (int)((mantissa - 0.5) * 2.0 * STATS_HISTOGRAM_SUB_BUCKETS);
+	return 1 + octave * STATS_HISTOGRAM_SUB_BUCKETS + subBucket;
+}
+
+static double GetHistogramBucketLowerBound(int bucketIndex)
+{
+	if (bucketIndex <= 0)
+		return 0.0;
+
+	int octave = (bucketIndex - 1) / STATS_HISTOGRAM_SUB_BUCKETS;
+	int subBucket = (bucketIndex - 1) % STATS_HISTOGRAM_SUB_BUCKETS;
+	return ldexp(0.5 + 0.5 * (double)subBucket / (double)STATS_HISTOGRAM_SUB_BUCKETS, octave + STATS_HISTOGRAM_MIN_EXPONENT);
+}
+
+Stat::Stat(const std::string& name, StatType type, int windowFrames)
+	:m_name(name), m_type(type)
+{
+	m_frameValues.resize(windowFrames, 0.0);
+	for (int i = 0; i < STATS_NUM_SHARDS; i++)
+	{
+		m_shards[i].m_min.store(DBL_MAX);
+		m_shards[i].m_max.store(-DBL_MAX);
+	}
+
+	if (m_type == StatType::HISTOGRAM)
+	{
+		for (int i = 0; i < STATS_NUM_SHARDS; i++)
+		{
+			m_shards[i].m_buckets = new std::atomic<unsigned int>[STATS_HISTOGRAM_NUM_BUCKETS];
+			for (int bucketIndex = 0; bucketIndex < STATS_HISTOGRAM_NUM_BUCKETS; bucketIndex++)
+			{
+				m_shards[i].m_buckets[bucketIndex].store(0);
+			}
+		}
+		m_frameMins.resize(windowFrames, 0.0);
+		m_frameMaxs.resize(windowFrames, 0.0);
+		m_frameBuckets.resize(windowFrames * STATS_HISTOGRAM_NUM_BUCKETS, 0);
+		m_frameSampleCounts.resize(windowFrames, 0);
+		m_windowBucketTotals.resize(STATS_HISTOGRAM_NUM_BUCKETS, 0);
+	}
+}
+
+Stat::~Stat()
+{
+	for (int i = 0; i < STATS_NUM_SHARDS; i++)
+	{
+		delete[] m_shards[i].m_buckets;
+		m_shards[i].m_buckets = nullptr;
+	}
+}
+
+void Stat::Add(int64_t amount, int shardIndex)
+{
+	m_shards[shardIndex].m_count.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Stat::Set(double value)
+{
+	m_gaugeValue.store(value, std::memory_order_relaxed);
+}
+
+void Stat::Record(double value, int shardIndex)
+{
+	//the bucket goes in before the count, a shard with a count of zero is skipped when the frame rolls
+	StatShard& shard = m_shards[shardIndex];
+	shard.m_buckets[GetHistogramBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	AtomicAddDouble(shard.m_sum, value);
+	AtomicMinDouble(shard.m_min, value);
+	AtomicMaxDouble(shard.m_max, value);
+	shard.m_count.fetch_add(1, std::memory_order_release);
+}
+
+void Stat::RollFrame(int windowSlot)
+{
+	m_numFramesRolled++;
+	if (m_type == StatType::COUNTER)
+	{
+		//shards are never reset, so a racing Add lands in this frame or the next but is never lost
+		int64_t total = 0;
+		for (int i = 0; i < STATS_NUM_SHARDS; i++)
+		{
+			total += m_shards[i].m_count.load(std::memory_order_relaxed);
+		}
+		m_frameValues[windowSlot] = (double)(total - m_lastCounterTotal);
+		m_lastCounterTotal = total;
+		return;
+	}
+
+	if (m_type == StatType::GAUGE)
+	{
+		m_frameValues[windowSlot] = m_gaugeValue.load(std::memory_order_relaxed);
+		return;
+	}
+
+	//the frame falling out of the window leaves the running totals first
+	unsigned int* frameBuckets = &m_frameBuckets[windowSlot * STATS_HISTOGRAM_NUM_BUCKETS];
+	for (int bucketIndex = 0; bucketIndex < STATS_HISTOGRAM_NUM_BUCKETS; bucketIndex++)
+	{
+		m_windowBucketTotals[bucketIndex] -= frameBuckets[bucketIndex];
+		frameBuckets[bucketIndex] = 0;
+	}
+
+	unsigned int numSamples = 0;
+	double sum = 0.0;
+	double minValue = DBL_MAX;
+	double maxValue = -DBL_MAX;
+	for (int i = 0; i < STATS_NUM_SHARDS; i++)
+	{
+		StatShard& shard = m_shards[i];
+		if (shard.m_count.exchange(0, std::memory_order_acquire) == 0)
+			continue;
+
+		sum += shard.m_sum.exchange(0.0, std::memory_order_relaxed);
+		minValue = std::min(minValue, shard.m_min.exchange(DBL_MAX, std::memory_order_relaxed));
+		maxValue = std::max(maxValue, shard.m_max.exchange(-DBL_MAX, std::memory_order_relaxed));
+		for (int bucketIndex = 0; bucketIndex < STATS_HISTOGRAM_NUM_BUCKETS; bucketIndex++)
+		{
+			unsigned int bucketCount = shard.m_buckets[bucketIndex].exchange(0, std::memory_order_relaxed);
+			frameBuckets[bucketIndex] += bucketCount;
+			numSamples += bucketCount;
+		}
+	}
+
+	for (int bucketIndex = 0; bucketIndex < STATS_HISTOGRAM_NUM_BUCKETS; bucketIndex++)
+	{
+		m_windowBucketTotals[bucketIndex] += frameBuckets[bucketIndex];
+	}
+
+	m_frameSampleCounts[windowSlot] = numSamples;
+	m_frameValues[windowSlot] = numSamples > 0 ? sum / (double)numSamples : 0.0;
+	m_frameMins[windowSlot] = numSamples > 0 ? minValue : 0.0;
+	m_frameMaxs[windowSlot] = numSamples > 0 ? maxValue : 0.0;
+}
+
+StatsRegistry::StatsRegistry()
+{
+	m_frameClock = &Clock::GetSystemClock();
+	m_windowClockFrames.resize(m_windowFrames, 0);
+	m_frameTimeStat = RegisterStat("frame.time_ms", StatType::HISTOGRAM);
+}
+
+StatsRegistry::~StatsRegistry()
+{
+	for (int i = 0; i < m_numStats.load(); i++)
+	{
+		delete m_stats[i];
+		m_stats[i] = nullptr;
+	}
+}
+
+StatsRegistry& StatsRegistry::GetGlobalRegistry()
+{
+	//function static so stats registered during static initialization still find the registry
+	static StatsRegistry s_globalRegistry;
+	return s_globalRegistry;
+}
+
+StatID StatsRegistry::RegisterStat(const std::string& name, StatType type)
+{
+	//registering a name twice hands back the same stat, so systems can register from their constructors
+	m_registerMutex.lock();
+	int numStats = m_numStats.load();
+	for (int i = 0; i < numStats; i++)
+	{
+		if (m_stats[i]->m_name == name)
+		{
+			m_registerMutex.unlock();
+			GUARANTEE_OR_DIE(m_stats[i]->m_type == type, Stringf("Stat %s registered again as a different type", name.c_str()));
+			return i;
+		}
+	}
+
+	GUARANTEE_OR_DIE(numStats < STATS_MAX_STATS, "Too many stats registered");
+	m_stats[numStats] = new Stat(name, type, m_windowFrames);
+	m_numStats.store(numStats + 1, std::memory_order_release);
+	m_registerMutex.unlock();
+	return numStats;
+}
+
+StatID StatsRegistry::FindStat(const std::string& name) const
+{
+	int numStats = m_numStats.load(std::memory_order_acquire);
+	for (int i = 0; i < numStats; i++)
+	{
+		if (m_stats[i]->m_name == name)
+			return i;
+	}
+	return INVALID_STAT_ID;
+}
+
+Stat* StatsRegistry::GetStat(StatID statID) const
+{
+	if (statID < 0 || statID >= m_numStats.load(std::memory_order_acquire))
+		return nullptr;
+
+	return m_stats[statID];
+}
+
+int StatsRegistry::GetNumStats() const
+{
+	return m_numStats.load(std::memory_order_acquire);
+}
+
+void StatsRegistry::SetFrameClock(const Clock* frameClock)
+{
+	m_frameClock = frameClock ? frameClock : &Clock::GetSystemClock();
+	m_hasRolledFrame = false;
+}
+
+void StatsRegistry::EndFrame()
+{
+	//rolls at most once per tick of the frame clock, however many systems end the frame
+	size_t clockFrame = m_frameClock->GetFrameCount();
+	if (m_hasRolledFrame && clockFrame == m_lastRolledClockFrame)
+		return;
+
+	m_hasRolledFrame = true;
+	m_lastRolledClockFrame = clockFrame;
+	RecordStatSample(m_frameTimeStat, m_frameClock->GetDeltaTime() * 1000.0);
+
+	int windowSlot = m_nextWindowSlot;
+	int numStats = m_numStats.load(std::memory_order_acquire);
+	for (int i = 0; i < numStats; i++)
+	{
+		m_stats[i]->RollFrame(windowSlot);
+	}
+
+	m_windowClockFrames[windowSlot] = clockFrame;
+	m_nextWindowSlot = (m_nextWindowSlot + 1) % m_windowFrames;
+	m_numFramesInWindow = std::min(m_numFramesInWindow + 1, m_windowFrames);
+}
+
+void StatsRegistry::GetWindowFrameValues(const Stat& stat, std::vector<double>& outValues) const
+{
+	//oldest first
+	outValues.clear();
+	int numFrames = std::min(stat.m_numFramesRolled, m_windowFrames);
+	for (int i = numFrames; i > 0; i--)
+	{
+		int windowSlot = (m_nextWindowSlot - i + m_windowFrames) % m_windowFrames;
+		outValues.push_back(stat.m_frameValues[windowSlot]);
+	}
+}
+
+StatSummary StatsRegistry::GetSummary(StatID statID) const
+{
+	StatSummary summary;
+	const Stat* stat = GetStat(statID);
+	if (stat == nullptr || stat->m_numFramesRolled == 0)
+		return summary;
+
+	std::vector<double> frameValues;
+	GetWindowFrameValues(*stat, frameValues);
+	summary.m_numFrames = (int)frameValues.size();
+	summary.m_lastFrameValue = frameValues.back();
+
+	if (stat->m_type == StatType::HISTOGRAM)
+	{
+		//averaged over samples rather than frames, min and max are the extreme samples
+		double sum = 0.0;
+		summary.m_min = DBL_MAX;
+		summary.m_max = -DBL_MAX;
+		for (int i = summary.m_numFrames; i > 0; i--)
+		{
+			int windowSlot = (m_nextWindowSlot - i + m_windowFrames) % m_windowFrames;
+			unsigned int numSamples = stat->m_frameSampleCounts[windowSlot];
+			if (numSamples == 0)
+				continue;
+
+			summary.m_numSamples += numSamples;
+			sum += stat->m_frameValues[windowSlot] * (double)numSamples;
+			summary.m_min = std::min(summary.m_min, stat->m_frameMins[windowSlot]);
+			summary.m_max = std::max(summary.m_max, stat->m_frameMaxs[windowSlot]);
+		}
+
+		if (summary.m_numSamples == 0)
+		{
+			summary.m_min = 0.0;
+			summary.m_max = 0.0;
+			return summary;
+		}
+		summary.m_average = sum / (double)summary.m_numSamples;
+	}
+	else
+	{
+		double sum = 0.0;
+		summary.m_min = frameValues[0];
+		summary.m_max = frameValues[0];
+		for (int i = 0; i < frameValues.size(); i++)
+		{
+			sum += frameValues[i];
+			summary.m_min = std::min(summary.m_min, frameValues[i]);
+			summary.m_max = std::max(summary.m_max, frameValues[i]);
+		}
+		summary.m_average = sum / (double)frameValues.size();
+	}
+
+	summary.m_p50 = GetPercentile(statID, 50.f);
+	summary.m_p95 = GetPercentile(statID, 95.f);
+	summary.m_p99 = GetPercentile(statID, 99.f);
+	return summary;
+}
+
+double StatsRegistry::GetPercentile(StatID statID, float percentile) const
+{
+	const Stat* stat = GetStat(statID);
+	if (stat == nullptr || stat->m_numFramesRolled == 0)
+		return 0.0;
+
+	double fraction = std::min(std::max((double)percentile * 0.01, 0.0), 1.0);
+	if (stat->m_type == StatType::HISTOGRAM)
+	{
+		//percentile over every sample in the window, interpolated inside the bucket it falls in
+		uint64_t numSamples = 0;
+		for (int bucketIndex = 0; bucketIndex < STATS_HISTOGRAM_NUM_BUCKETS; bucketIndex++)
+		{
+			numSamples += stat->m_windowBucketTotals[bucketIndex];
+		}
+		if (numSamples == 0)
+			return 0.0;
+
+		double targetRank = fraction * (double)numSamples;
+		uint64_t samplesBelow = 0;
+		for (int bucketIndex = 0; bucketIndex < STATS_HISTOGRAM_NUM_BUCKETS; bucketIndex++)
+		{
+			uint64_t bucketCount = stat->m_windowBucketTotals[bucketIndex];
+			if (bucketCount == 0 || (double)(samplesBelow + bucketCount) < targetRank)
+			{
+				samplesBelow += bucketCount;
+				continue;
+			}
+
+			double lowerBound = GetHistogramBucketLowerBound(bucketIndex);
+			if (bucketIndex == STATS_HISTOGRAM_NUM_BUCKETS - 1)
+				return lowerBound;
+
+			double upperBound = GetHistogramBucketLowerBound(bucketIndex + 1);
+			double fractionInBucket = (targetRank - (double)samplesBelow) / (double)bucketCount;
+			return lowerBound + (upperBound - lowerBound) * fractionInBucket;
+		}
+		return GetHistogramBucketLowerBound(STATS_HISTOGRAM_NUM_BUCKETS - 1);
+	}
+
+	std::vector<double> frameValues;
+	GetWindowFrameValues(*stat, frameValues);
+	std::sort(frameValues.begin(), frameValues.end());
+	double rank = fraction * (double)(frameValues.size() - 1);
+	int lowerIndex = (int)rank;
+	int upperIndex = std::min(lowerIndex + 1, (int)frameValues.size() - 1);
+	double t = rank - (double)lowerIndex;
+	return frameValues[lowerIndex] + (frameValues[upperIndex] - frameValues[lowerIndex]) * t;
+}
+
+void StatsRegistry::PrintToConsole(DevConsole& console, const std::string& nameFilter) const
+{
+	console.AddLineFormatted(console.INFO_MAJOR, "---- Stats over the last %d frames ----", m_numFramesInWindow);
+	int numStats = m_numStats.load(std::memory_order_acquire);
+	for (int i = 0; i < numStats; i++)
+	{
+		const Stat& stat = *m_stats[i];
+		if (!nameFilter.empty() && stat.m_name.find(nameFilter) == std::string::npos)
+			continue;
+
+		StatSummary summary = GetSummary(i);
+		std::string line = Stringf("%s  last %.3f  avg %.3f  min %.3f  max %.3f  p50 %.3f  p95 %.3f  p99 %.3f", stat.m_name.c_str(),
+			summary.m_lastFrameValue, summary.m_average, summary.m_min, summary.m_max, summary.m_p50, summary.m_p95, summary.m_p99);
+		if (stat.m_type == StatType::HISTOGRAM)
+		{
+			line += Stringf("  samples %lld", (long long)summary.m_numSamples);
+		}
+		console.AddLine(console.INFO_MINOR, line);
+	}
+}
+
+bool StatsRegistry::ExportCSV(const std::string& filePath) const
+{
+	//one row per frame in the window, oldest first. histograms get their frame mean and sample count
+	int numStats = m_numStats.load(std::memory_order_acquire);
+	std::string csv = "frame";
+	for (int i = 0; i < numStats; i++)
+	{
+		const Stat& stat = *m_stats[i];
+		csv += "," + stat.m_name;
+		if (stat.m_type == StatType::HISTOGRAM)
+		{
+			csv += "," + stat.m_name + ".count";
+		}
+	}
+	csv += "\n";
+
+	for (int frameAge = m_numFramesInWindow; frameAge > 0; frameAge--)
+	{
+		int windowSlot = (m_nextWindowSlot - frameAge + m_windowFrames) % m_windowFrames;
+		csv += Stringf("%llu", (unsigned long long)m_windowClockFrames[windowSlot]);
+		for (int i = 0; i < numStats; i++)
+		{
+			//stats registered partway through the window leave the frames before them empty
+			const Stat& stat = *m_stats[i];
+			bool hasFrame = frameAge <= stat.m_numFramesRolled;
+			csv += hasFrame ? Stringf(",%.6g", stat.m_frameValues[windowSlot]) : ",";
+			if (stat.m_type == StatType::HISTOGRAM)
+			{
+				csv += hasFrame ? Stringf(",%u", stat.m_frameSampleCounts[windowSlot]) : ",";
+			}
+		}
+		csv += "\n";
+	}
+
+	FileStream csvFile;
+	csvFile.OpenForWrite(filePath.c_str());
+	csvFile.WriteBytes(csv.c_str(), csv.size());
+	csvFile.Close();
+	return true;
+}
+
+StatID RegisterCounterStat(const std::string& name)
+{
+	return StatsRegistry::GetGlobalRegistry().RegisterStat(name, StatType::COUNTER);
+}
+
+StatID RegisterGaugeStat(const std::string& name)
+{
+	return StatsRegistry::GetGlobalRegistry().RegisterStat(name, StatType::GAUGE);
+}
+
+StatID RegisterHistogramStat(const std::string& name)
+{
+	return StatsRegistry::GetGlobalRegistry().RegisterStat(name, StatType::HISTOGRAM);
+}
+
+void AddToStatCounter(StatID statID, int64_t amount)
+{
+	Stat* stat = StatsRegistry::GetGlobalRegistry().GetStat(statID);
+	if (stat && stat->GetType() == StatType::COUNTER)
+	{
+		stat->Add(amount, GetThreadShardIndex());
+	}
+}
+
+void SetStatGauge(StatID statID, double value)
+{
+	Stat* stat = StatsRegistry::GetGlobalRegistry().GetStat(statID);
+	if (stat && stat->GetType() == StatType::GAUGE)
+	{
+		stat->Set(value);
+	}
+}
+
+void RecordStatSample(StatID statID, double value)
+{
+	Stat* stat = StatsRegistry::GetGlobalRegistry().GetStat(statID);
+	if (stat && stat->GetType() == StatType::HISTOGRAM)
+	{
+		stat->Record(value, GetThreadShardIndex());
+	}
+}
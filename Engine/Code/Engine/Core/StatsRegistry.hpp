@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+class Clock;
+class DevConsole;
+
+typedef int StatID;
+constexpr StatID INVALID_STAT_ID = -1;
+
+constexpr int STATS_MAX_STATS = 512;
+constexpr int STATS_NUM_SHARDS = 16;					//threads are spread over the shards so they rarely share a cache line
+constexpr int STATS_DEFAULT_WINDOW_FRAMES = 300;
+
+//histogram buckets are log-linear: 8 per power of two from 2^-10 to 2^21, so a percentile is within ~6% of the value
+constexpr int STATS_HISTOGRAM_SUB_BUCKETS = 8;
+constexpr int STATS_HISTOGRAM_MIN_EXPONENT = -9;
+constexpr int STATS_HISTOGRAM_NUM_OCTAVES = 31;
+constexpr int STATS_HISTOGRAM_NUM_BUCKETS = 1 + STATS_HISTOGRAM_NUM_OCTAVES * STATS_HISTOGRAM_SUB_BUCKETS + 1;		//under and over range buckets
+
+enum class StatType
+{
+	COUNTER,		//summed, the frame value is how much it went up that frame
+	GAUGE,			//set, the frame value is what it was at the end of the frame
+	HISTOGRAM,		//sampled, the frame value is the mean of that frame's samples
+};
+
+struct alignas(64) StatShard
+{
+	std::atomic<int64_t> m_count{ 0 };
+	std::atomic<double> m_sum{ 0.0 };
+	std::atomic<double> m_min{ 0.0 };
+	std::atomic<double> m_max{ 0.0 };
+	std::atomic<unsigned int>* m_buckets = nullptr;		//histograms only
+};
+
+struct StatSummary
+{
+	int m_numFrames = 0;
+	double m_lastFrameValue = 0.0;
+	double m_average = 0.0;
+	double m_min = 0.0;
+	double m_max = 0.0;
+	double m_p50 = 0.0;
+	double m_p95 = 0.0;
+	double m_p99 = 0.0;
+	int64_t m_numSamples = 0;			//histograms only, samples over the window
+};
+
+class Stat
+{
+	friend class StatsRegistry;
+public:
+	Stat(const std::string& name, StatType type, int windowFrames);
+	~Stat();
+
+	void Add(int64_t amount, int shardIndex);
+	void Set(double value);
+	void Record(double value, int shardIndex);
+
+	const std::string& GetName() const { return m_name; }
+	StatType GetType() const { return m_type; }
+
+private:
+	void RollFrame(int windowSlot);
+
+private:
+	std::string m_name;
+	StatType m_type = StatType::COUNTER;
+	StatShard m_shards[STATS_NUM_SHARDS];
+	std::atomic<double> m_gaugeValue{ 0.0 };
+
+	//everything below belongs to the thread rolling the frames
+	int64_t m_lastCounterTotal = 0;
+	int m_numFramesRolled = 0;
+	std::vector<double> m_frameValues;					//ring, one slot per window frame
+	std::vector<double> m_frameMins;					//histograms only
+	std::vector<double> m_frameMaxs;
+	std::vector<unsigned int> m_frameBuckets;			//histograms only, STATS_HISTOGRAM_NUM_BUCKETS per window frame
+	std::vector<unsigned int> m_frameSampleCounts;
+	std::vector<uint64_t> m_windowBucketTotals;			//the frame buckets summed over the window
+};
+
+//counters, gauges and histograms that any thread can update without locking. once per frame of the frame clock
+//(the system clock unless told otherwise) the registry rolls every stat into a window of recent frames that
+//summaries, percentiles, the "stats" console command and the csv export read from
+class StatsRegistry
+{
+public:
+	~StatsRegistry();
+	static StatsRegistry& GetGlobalRegistry();
+
+	StatID RegisterStat(const std::string& name, StatType type);
+	StatID FindStat(const std::string& name) const;
+	Stat* GetStat(StatID statID) const;
+	int GetNumStats() const;
+
+	void SetFrameClock(const Clock* frameClock);
+	void EndFrame();
+
+	StatSummary GetSummary(StatID statID) const;
+	double GetPercentile(StatID statID, float percentile) const;
+	void PrintToConsole(DevConsole& console, const std::string& nameFilter) const;
+	bool ExportCSV(const std::string& filePath) const;
+
+private:
+	StatsRegistry();
+	void GetWindowFrameValues(const Stat& stat, std::vector<double>& outValues) const;
+
+private:
+	mutable std::mutex m_registerMutex;
+	Stat* m_stats[STATS_MAX_STATS] = {};
+	std::atomic<int> m_numStats{ 0 };
+	int m_windowFrames = STATS_DEFAULT_WINDOW_FRAMES;
+
+	//belongs to the thread rolling the frames
+	const Clock* m_frameClock = nullptr;
+	size_t m_lastRolledClockFrame = 0;
+	bool m_hasRolledFrame = false;
+	int m_nextWindowSlot = 0;
+	int m_numFramesInWindow = 0;
+	std::vector<size_t> m_windowClockFrames;
+	StatID m_frameTimeStat = INVALID_STAT_ID;
+};
+
+StatID RegisterCounterStat(const std::string& name);
+StatID RegisterGaugeStat(const std::string& name);
+StatID RegisterHistogramStat(const std::string& name);
+void AddToStatCounter(StatID statID, int64_t amount = 1);
+void SetStatGauge(StatID statID, double value);
+void RecordStatSample(StatID statID, double value);
@@ -0,0 +1,141 @@
+#include "Engine/Core/StringInternTable.hpp"
+#include "Engine/Core/HashedCaseInsensitiveString.hpp"
+#include <string.h>
+
+constexpr unsigned int INTERN_TABLE_MIN_SLOTS = 1024;
+
+InternedStringSlots::InternedStringSlots(unsigned int numSlots)
+	:m_mask(numSlots - 1)
+{
+	m_slots = new std::atomic<InternedString*>[numSlots];
+	for (unsigned int i = 0; i < numSlots; i++)
+	{
+		m_slots[i].store(nullptr);
+	}
+}
+
+InternedStringSlots::~InternedStringSlots()
+{
+	delete[] m_slots;
+	m_slots = nullptr;
+}
+
+StringInternTable::StringInternTable()
+{
+	m_slots.store(new InternedStringSlots(INTERN_TABLE_MIN_SLOTS));
+}
+
+StringInternTable::~StringInternTable()
+{
+	delete m_slots.load();
+	for (int i = 0; i < m_retiredSlots.size(); i++)
+	{
+		delete m_retiredSlots[i];
+	}
+	for (int i = 0; i < m_strings.size(); i++)
+	{
+		delete m_strings[i];
+	}
+}
+
+StringInternTable& StringInternTable::GetGlobalTable()
+{
+	//function static so keys built during static initialization still find the table
+	static StringInternTable s_globalTable;
+	return s_globalTable;
+}
+
+const InternedString* StringInternTable::Intern(const char* text)
+{
+	return Intern(text, HashCaseInsensitive(text));
+}
+
+const InternedString* StringInternTable::Intern(const char* text, unsigned int hash)
+{
+	const InternedString* existingString = FindInSlots(*m_slots.load(), hash, text);
+	if (existingString)
+		return existingString;
+
+	m_insertMutex.lock();
+	InternedStringSlots* slots = m_slots.load();
+	existingString = FindInSlots(*slots, hash, text);
+	if (existingString)
+	{
+		m_insertMutex.unlock();
+		return existingString;
+	}
+
+	InternedString* newString = new InternedString();
+	newString->m_id = hash;
+	newString->m_string = text;
+	m_strings.push_back(newString);
+
+	//keep the load factor under a half. the old slots stay alive since readers don't lock
+	unsigned int numSlots = slots->m_mask + 1;
+	if ((unsigned int)(m_strings.size()) * 2 > numSlots)
+	{
+		InternedStringSlots* grownSlots = new InternedStringSlots(numSlots * 2);
+		for (int i = 0; i < m_strings.size(); i++)
+		{
+			InsertIntoSlots(*grownSlots, m_strings[i]);
+		}
+		m_slots.store(grownSlots);
+		m_retiredSlots.push_back(slots);
+	}
+	else
+	{
+		InsertIntoSlots(*slots, newString);
+	}
+
+	m_numStrings.fetch_add(1);
+	m_insertMutex.unlock();
+	return newString;
+}
+
+const InternedString* StringInternTable::Find(const char* text) const
+{
+	return FindInSlots(*m_slots.load(), HashCaseInsensitive(text), text);
+}
+
+const InternedString* StringInternTable::FindByID(unsigned int id) const
+{
+	return FindInSlots(*m_slots.load(), id, nullptr);
+}
+
+int StringInternTable::GetNumStrings() const
+{
+	return m_numStrings.load();
+}
+
+const InternedString* StringInternTable::FindInSlots(const InternedStringSlots& slots, unsigned int id, const char* text) const
+{
+	for (unsigned int slot = id & slots.m_mask; ; slot = (slot + 1) & slots.m_mask)
+	{
+		InternedString* internedString = slots.m_slots[slot].load();
+		if (internedString == nullptr)
+			return nullptr;
+		if (internedString->m_id == id && (text == nullptr || _stricmp(internedString->m_string.c_str(), text) == 0))
+			return internedString;
+	}
+}
+
+void StringInternTable::InsertIntoSlots(InternedStringSlots& slots, InternedString* internedString)
+{
+	unsigned int slot = internedString->m_id & slots.m_mask;
+	while (slots.m_slots[slot].load() != nullptr)
+	{
+		slot = (slot + 1) & slots.m_mask;
+	}
+	slots.m_slots[slot].store(internedString);
+}
+
+const InternedString* InternString(const char* text)
+{
+	return StringInternTable::GetGlobalTable().Intern(text);
+}
+
+const char* GetInternedString(unsigned int id)
+{
+	const InternedString* internedString = StringInternTable::GetGlobalTable().FindByID(id);
+	return internedString ? internedString->m_string.c_str() : nullptr;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//one copy of each distinct (case insensitive) string for the life of the program. the id is the case insensitive
+//hash, so a literal's id can be computed at compile time with HashCaseInsensitive. two strings can share an id, the
+//InternedString pointer is what is unique
+struct InternedString
+{
+	unsigned int m_id = 0;
+	std::string m_string;
+};
+
+struct InternedStringSlots
+{
+	InternedStringSlots(unsigned int numSlots);
+	~InternedStringSlots();
+
+	std::atomic<InternedString*>* m_slots = nullptr;		//open addressing, power of two size
+	unsigned int m_mask = 0;
+};
+
+//lookups of strings already in the table don't lock or allocate. adding a string locks. strings with the same hash
+//sit next to each other in the probe sequence and are told apart by a case insensitive compare
+class StringInternTable
+{
+public:
+	StringInternTable();
+	~StringInternTable();
+
+	static StringInternTable& GetGlobalTable();
+
+	const InternedString* Intern(const char* text);
+	const InternedString* Intern(const char* text, unsigned int hash);
+	const InternedString* Find(const char* text) const;
+	const InternedString* FindByID(unsigned int id) const;		//the first string with that id if several share it
+	int GetNumStrings() const;
+
+private:
+	const InternedString* FindInSlots(const InternedStringSlots& slots, unsigned int id, const char* text) const;		//any string with the id when text is null
+	void InsertIntoSlots(InternedStringSlots& slots, InternedString* internedString);
+
+private:
+	std::atomic<InternedStringSlots*> m_slots{ nullptr };
+	std::vector<InternedStringSlots*> m_retiredSlots;		//readers may still be probing these, freed with the table
+	std::vector<InternedString*> m_strings;
+	mutable std::mutex m_insertMutex;
+	std::atomic<int> m_numStrings{ 0 };
+};
+
+const InternedString* InternString(const char* text);
+const char* GetInternedString(unsigned int id);
@@ -32,7 +32,8 @@ void TransformVertexArray3D(int numVerts, Vertex_PNCU* verts, const Mat44& trans
 	}
 }
 
-void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color)
+template <typename VertexArray>
+static void AddVertsForAABB2DTo(VertexArray& verts, const AABB2& localBounds, Rgba8 color)
 {
 	Vertex_PCU vertices[6];
 	vertices[0].m_position = Vec3(localBounds.m_mins.x, localBounds.m_mins.y, 0.f);
@@ -62,7 +63,8 @@ void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds,
 	}
 }
 
-void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color, const Vec2& uvAtMins, const Vec2& uvAtMaxs)
+template <typename VertexArray>
+static void AddVertsForAABB2DTo(VertexArray& verts, const AABB2& localBounds, Rgba8 color, const Vec2& uvAtMins, const Vec2& uvAtMaxs)
 {
 	Vertex_PCU vertices[6];
 	vertices[0].m_position = Vec3(localBounds.m_mins.x, localBounds.m_mins.y, 0.f);
@@ -228,7 +230,8 @@ void AddVertsForOBB2D(std::vector<Vertex_PCU>& verts, const OBB2& box, const Rgb
 	}
 }
 
-void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, const Vec2& start, const Vec2& end, float thickness, const Rgba8& color)
+template <typename VertexArray>
+static void AddVertsForLineSegment2DTo(VertexArray& verts, const Vec2& start, const Vec2& end, float thickness, const Rgba8& color)
 {
 	float halfWidth = thickness * 0.5f;
 	Vec2 unitForwardVector = (end - start) / (end - start).GetLength();
@@ -257,9 +260,45 @@ void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, const Vec2& start,
 		verts.push_back(drawVerticesForLine[i]);
 }
 
+//the frame vector overloads share these bodies, see AddVertsFor*To
+void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color)
+{
+	AddVertsForAABB2DTo(verts, localBounds, color);
+}
+
+void AddVertsForAABB2D(FrameVector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color)
+{
+	AddVertsForAABB2DTo(verts, localBounds, color);
+}
+
+void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color, const Vec2& uvAtMins, const Vec2& uvAtMaxs)
+{
+	AddVertsForAABB2DTo(verts, localBounds, color, uvAtMins, uvAtMaxs);
+}
+
+void AddVertsForAABB2D(FrameVector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color, const Vec2& uvAtMins, const Vec2& uvAtMaxs)
+{
+	AddVertsForAABB2DTo(verts, localBounds, color, uvAtMins, uvAtMaxs);
+}
+
+void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, const Vec2& start, const Vec2& end, float thickness, const Rgba8& color)
+{
+	AddVertsForLineSegment2DTo(verts, start, end, thickness, color);
+}
+
+void AddVertsForLineSegment2D(FrameVector<Vertex_PCU>& verts, const Vec2& start, const Vec2& end, float thickness, const Rgba8& color)
+{
+	AddVertsForLineSegment2DTo(verts, start, end, thickness, color);
+}
+
 void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, const LineSegment2& lineSegment, float thickness, const Rgba8& color)
 {
-	AddVertsForLineSegment2D(verts, lineSegment.m_start, lineSegment.m_end, thickness, color);
+	AddVertsForLineSegment2DTo(verts, lineSegment.m_start, lineSegment.m_end, thickness, color);
+}
+
+void AddVertsForLineSegment2D(FrameVector<Vertex_PCU>& verts, const LineSegment2& lineSegment, float thickness, const Rgba8& color)
+{
+	AddVertsForLineSegment2DTo(verts, lineSegment.m_start, lineSegment.m_end, thickness, color);
 }
 
 void AddVertsForRing2D(std::vector<Vertex_PCU>& verts, const Vec2& ringCenter, float ringRadius, Rgba8 color, float ringThickness)
@@ -6,6 +6,7 @@
 #include "Engine/Math/LineSegment2.hpp"
 #include "Engine/Math/OBB2.hpp"
 #include "Engine/Math/AABB3.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include <vector>
 
 struct Mat44;
@@ -17,6 +18,8 @@ void TransformVertexArray3D(int numVerts, Vertex_PNCU* verts, const Mat44& trans
 
 void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color);
 void AddVertsForAABB2D(std::vector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color, const Vec2& uvAtMins, const Vec2& uvAtMaxs);
+void AddVertsForAABB2D(FrameVector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color);
+void AddVertsForAABB2D(FrameVector<Vertex_PCU>& verts, const AABB2& localBounds, Rgba8 color, const Vec2& uvAtMins, const Vec2& uvAtMaxs);
 
 void AddVertsForCapsule2D(std::vector<Vertex_PCU>& verts, const Capsule2& capsule, const Rgba8& color);
 void AddVertsForCapsule2D(std::vector<Vertex_PCU>& verts, const Vec2& boneStart, const Vec2& boneEnd, float radius, const Rgba8& color);
@@ -28,6 +31,8 @@ void AddVertsForOBB2D(std::vector<Vertex_PCU>& verts, const OBB2& box, const Rgb
 
 void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, const Vec2& start, const Vec2& end, float thickness, const Rgba8& color);
 void AddVertsForLineSegment2D(std::vector<Vertex_PCU>& verts, const LineSegment2& lineSegment, float thickness, const Rgba8& color);
+void AddVertsForLineSegment2D(FrameVector<Vertex_PCU>& verts, const Vec2& start, const Vec2& end, float thickness, const Rgba8& color);
+void AddVertsForLineSegment2D(FrameVector<Vertex_PCU>& verts, const LineSegment2& lineSegment, float thickness, const Rgba8& color);
 void AddVertsForArrow2D(std::vector<Vertex_PCU>& verts, const Vec2& tailPos, const Vec2& tipPos, float lineThickness, const Rgba8& color);
 
 void AddVertsForQuad3D(std::vector<Vertex_PCU>& verts, const Vec3& topLeft, const Vec3& bottomLeft, const Vec3& bottomRight, const Vec3& topRight,
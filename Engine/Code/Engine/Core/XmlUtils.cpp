@@ -1,5 +1,14 @@
 #include <string>
 #include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+
+tinyxml2::XMLError LoadXmlDocument(XmlDocument& out_document, const std::string& filePath)
+{
+	std::string fileText;
+	if (!TryFileReadToString(fileText, filePath))
+		return tinyxml2::XML_ERROR_FILE_NOT_FOUND;
+	return out_document.Parse(fileText.c_str(), fileText.size());
+}
 
 int ParseXmlAttribute(const XmlElement& element, const char* attributeName, int defaultValue)
 {
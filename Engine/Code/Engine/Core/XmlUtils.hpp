@@ -10,6 +10,10 @@
 #include "Engine/Math/IntVec3.hpp"
 
 typedef tinyxml2::XMLElement XmlElement;
+typedef tinyxml2::XMLDocument XmlDocument;
+
+//reads through FileReadToString so the document can come from a mounted pack. XML_ERROR_FILE_NOT_FOUND if it can't be read
+tinyxml2::XMLError LoadXmlDocument(XmlDocument& out_document, const std::string& filePath);
 
 int ParseXmlAttribute(const XmlElement& element, const char* attributeName, int defaultValue);
 char ParseXmlAttribute(const XmlElement& element, const char* attributeName, char defaultValue);
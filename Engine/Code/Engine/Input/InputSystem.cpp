@@ -32,6 +32,9 @@ const unsigned char KEYCODE_DELETE = VK_DELETE;
 const unsigned char KEYCODE_BACKSPACE = VK_BACK;
 const unsigned char KEYCODE_SHIFT = VK_SHIFT;
 
+constexpr EventID KEY_PRESSED_EVENT_ID = MakeEventID("KeyPressed");
+constexpr EventID CHAR_INPUT_EVENT_ID = MakeEventID("CharInput");
+
 
 InputSystem::InputSystem(const InputSystemConfig& config)
 	:m_config(config)
@@ -77,7 +80,7 @@ void InputSystem::HandleKeyPressed(unsigned char keyCode)
 	m_keyStates[keyCode].m_currentState = true;
 	EventArgs args;
 	args.SetValue("keyCode", keyCode);
-	FireEvent("KeyPressed", args);
+	FireEvent(KEY_PRESSED_EVENT_ID, args);
 }
 
 void InputSystem::HandleKeyReleased(unsigned char keyCode)
@@ -90,7 +93,7 @@ void InputSystem::HandleCharInput(int charCode)
 	EventArgs args;
 	//args.SetValue("charCode", Stringf("%d", charCode));
 	args.SetValue("charCode", charCode);
-	FireEvent("CharInput", args);
+	FireEvent(CHAR_INPUT_EVENT_ID, args);
 }
 
 bool InputSystem::IsKeyDown(unsigned char keyCode)
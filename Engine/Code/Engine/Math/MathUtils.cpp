@@ -881,6 +881,48 @@ Vec3 GetNearestPointOnZCylinder3D(const Vec3& referencePoint, const Vec2& cylind
 	return Vec3(nearestPointOnCylinderDiscXY.x, nearestPointOnCylinderDiscXY.y, nearestPointOnZ);
 }
 
+Vec3 GetNearestPointOnTriangle3D(const Vec3& referencePoint, const Vec3& cornerA, const Vec3& cornerB, const Vec3& cornerC)
+{
+	//finds which corner, edge or the face itself the point projects onto, from the barycentric coordinates
+	Vec3 edgeAB = cornerB - cornerA;
+	Vec3 edgeAC = cornerC - cornerA;
+	Vec3 aToPoint = referencePoint - cornerA;
+	float d1 = DotProduct3D(edgeAB, aToPoint);
+	float d2 = DotProduct3D(edgeAC, aToPoint);
+	if (d1 <= 0.f && d2 <= 0.f)
+		return cornerA;
+
+	Vec3 bToPoint = referencePoint - cornerB;
+	float d3 = DotProduct3D(edgeAB, bToPoint);
+	float d4 = DotProduct3D(edgeAC, bToPoint);
+	if (d3 >= 0.f && d4 <= d3)
+		return cornerB;
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		return cornerA + edgeAB * (d1 / (d1 - d3));
+
+	Vec3 cToPoint = referencePoint - cornerC;
+	float d5 = DotProduct3D(edgeAB, cToPoint);
+	float d6 = DotProduct3D(edgeAC, cToPoint);
+	if (d6 >= 0.f && d5 <= d6)
+		return cornerC;
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		return cornerA + edgeAC * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+		return cornerB + (cornerC - cornerB) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	//degenerate triangles fall back to their first corner
+	float denominator = va + vb + vc;
+	if (denominator == 0.f)
+		return cornerA;
+	return cornerA + edgeAB * (vb / denominator) + edgeAC * (vc / denominator);
+}
+
 bool IsPointInsideOrientedSector2D(const Vec2& point, const Vec2& sectorTip, float sectorForwardDegrees, float sectorApertureDegrees, float sectorRadius)
 {
 	if (GetDistanceSquared2D(point, sectorTip) > sectorRadius * sectorRadius)
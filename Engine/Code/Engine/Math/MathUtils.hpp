@@ -96,6 +96,7 @@ const Vec2 GetNearestPointOnOBB2D(const Vec2& referencePoint, const OBB2& orient
 Vec3 GetNearestPointOnAABB3(const Vec3& referencePoint, const AABB3& box);
 Vec3 GetNearestPointOnSphere3D(const Vec3& referencePoint, const Vec3& sphereCenter, float sphereRadius);
 Vec3 GetNearestPointOnZCylinder3D(const Vec3& referencePoint, const Vec2& cylinderCenterXY, float cylinderRadius, const FloatRange& cylinderHeightZRange);
+Vec3 GetNearestPointOnTriangle3D(const Vec3& referencePoint, const Vec3& cornerA, const Vec3& cornerB, const Vec3& cornerC);
 
 void TransformPosition2D(Vec2& positionToTransform, float uniformScaleXY, float rotationDegreeAboutZ, const Vec2& translationXY);
 void TransformPosition2D(Vec2& positionToTransform, const Vec2& iBasis, const Vec2& jBasis, const Vec2& translationXY);
@@ -77,12 +77,12 @@ void RemoteConsole::Render(Renderer& renderer, const AABB2& bounds, BitmapFont&
 	Vec2 boxMins = Vec2(boxDimensions.x / 2.f, bounds.m_maxs.y - boxDimensions.y);
 	AABB2 boxBounds = AABB2(boxMins, boxMins + boxDimensions);
 
-	std::vector<Vertex_PCU> bgBox;
+	FrameVector<Vertex_PCU> bgBox;
 	AddVertsForAABB2D(bgBox, boxBounds, Rgba8(0, 0, 255, 127));
 	renderer.BindTexture(nullptr);
 	renderer.DrawVertexArray((int)bgBox.size(), bgBox.data());
 
-	std::vector<Vertex_PCU> textVerts;
+	FrameVector<Vertex_PCU> textVerts;
 	std::string consoleData;
 	consoleData.append(GetCurrentStateString() + ": ");
 	if (m_connectionState == ConnectionState::HOSTING)
@@ -17,7 +17,28 @@ Texture& BitmapFont::GetTexture()
 
 void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, const Vec2& textMins, float cellHeight, const std::string& text, const Rgba8& tint, float cellAspect, int maxGlyphsToDraw)
 {
-	for (int i = 0; i < text.size() && maxGlyphsToDraw > 0; i++)
+	AddVertsForText2DTo(vertexArray, textMins, cellHeight, text.c_str(), (int)text.size(), tint, cellAspect, maxGlyphsToDraw);
+}
+
+void BitmapFont::AddVertsForText2D(FrameVector<Vertex_PCU>& vertexArray, const Vec2& textMins, float cellHeight, const std::string& text, const Rgba8& tint, float cellAspect, int maxGlyphsToDraw)
+{
+	AddVertsForText2DTo(vertexArray, textMins, cellHeight, text.c_str(), (int)text.size(), tint, cellAspect, maxGlyphsToDraw);
+}
+
+void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, const AABB2& box, float cellHeight, const std::string& text, const Rgba8& tint, float cellAspect, const Vec2& alignment, TextBoxMode mode, int maxGlyphsToDraw)
+{
+	AddVertsForTextInBox2DTo(vertexArray, box, cellHeight, text, tint, cellAspect, alignment, mode, maxGlyphsToDraw);
+}
+
+void BitmapFont::AddVertsForTextInBox2D(FrameVector<Vertex_PCU>& vertexArray, const AABB2& box, float cellHeight, const std::string& text, const Rgba8& tint, float cellAspect, const Vec2& alignment, TextBoxMode mode, int maxGlyphsToDraw)
+{
+	AddVertsForTextInBox2DTo(vertexArray, box, cellHeight, text, tint, cellAspect, alignment, mode, maxGlyphsToDraw);
+}
+
+template <typename VertexArray>
+void BitmapFont::AddVertsForText2DTo(VertexArray& vertexArray, const Vec2& textMins, float cellHeight, const char* text, int textLength, const Rgba8& tint, float cellAspect, int maxGlyphsToDraw)
+{
+	for (int i = 0; i < textLength && maxGlyphsToDraw > 0; i++)
 	{
 		Vec2 characterAABBLowerBound = Vec2(textMins.x + (i * cellAspect * cellHeight), textMins.y);
 		Vec2 characterAABBUpperBound = Vec2(textMins.x + ((i + 1) * cellAspect * cellHeight), textMins.y + cellHeight);
@@ -27,14 +48,28 @@ void BitmapFont::AddVertsForText2D(std::vector<Vertex_PCU>& vertexArray, const V
 	}
 }
 
-void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, const AABB2& box, float cellHeight, const std::string& text, const Rgba8& tint , float cellAspect , const Vec2& alignment , TextBoxMode mode , int maxGlyphsToDraw)
+template <typename VertexArray>
+void BitmapFont::AddVertsForTextInBox2DTo(VertexArray& vertexArray, const AABB2& box, float cellHeight, const std::string& text, const Rgba8& tint, float cellAspect, const Vec2& alignment, TextBoxMode mode, int maxGlyphsToDraw)
 {
-	Strings textStrings = SplitStringOnDelimiter(text, '\n');
+	//walk the lines in place rather than splitting them into strings, this runs for every console and debug text box every frame
+	int numLines = 1;
+	int longestLineLength = 0;
+	int lineStart = 0;
+	for (int i = 0; i <= (int)text.size(); i++)
+	{
+		if (i == (int)text.size() || text[i] == '\n')
+		{
+			if (i - lineStart > longestLineLength)
+				longestLineLength = i - lineStart;
+			if (i < (int)text.size())
+				numLines++;
+			lineStart = i + 1;
+		}
+	}
+
 	Vec2 boxDimensions = box.GetDimensions();
-	
-	std::string longestStringInTextGroup = GetLongestStringAmongstStrings(textStrings);
-	float textGroupLongestStringWidth = GetTextWidth(cellHeight, longestStringInTextGroup, cellAspect);
-	float textGroupHeight = textStrings.size() * cellHeight;
+	float textGroupLongestStringWidth = longestLineLength * cellHeight * cellAspect;
+	float textGroupHeight = numLines * cellHeight;
 	float shrinkFactor = 1.f;
 	if (mode == TextBoxMode::SHRINK_TO_FIT)
 	{
@@ -49,18 +84,27 @@ void BitmapFont::AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, co
 	float textGroupMinY = (boxDimensions.y - (textGroupHeight * shrinkFactor)) * alignment.y;
 
 	int glyphsToDraw = maxGlyphsToDraw;
-	for (int i = 0; i < textStrings.size() && glyphsToDraw > 0; i++)
+	lineStart = 0;
+	for (int lineIndex = 0; lineIndex < numLines && glyphsToDraw > 0; lineIndex++)
 	{
+		int lineEnd = lineStart;
+		while (lineEnd < (int)text.size() && text[lineEnd] != '\n')
+		{
+			lineEnd++;
+		}
+		int lineLength = lineEnd - lineStart;
+
 		float textLineHeight = cellHeight * shrinkFactor;
-		float textLineWidth = GetTextWidth(textLineHeight, textStrings[i], cellAspect);
+		float textLineWidth = lineLength * textLineHeight * cellAspect;
 
 		float leftPadding = (boxDimensions.x - textLineWidth) * alignment.x;
-		float botPadding = textGroupMinY + (textLineHeight * (float(textStrings.size() - 1 - i)));
+		float botPadding = textGroupMinY + (textLineHeight * (float(numLines - 1 - lineIndex)));
 
 		float textLineMinX = box.m_mins.x + leftPadding;
 		float textLineMinY = box.m_mins.y + botPadding;
-		AddVertsForText2D(vertexArray, Vec2(textLineMinX, textLineMinY), textLineHeight, textStrings[i], tint, cellAspect, glyphsToDraw);
-		glyphsToDraw -= (int)textStrings[i].length();
+		AddVertsForText2DTo(vertexArray, Vec2(textLineMinX, textLineMinY), textLineHeight, text.c_str() + lineStart, lineLength, tint, cellAspect, glyphsToDraw);
+		glyphsToDraw -= lineLength;
+		lineStart = lineEnd + 1;
 	}
 }
 
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 
 class Texture;
@@ -28,11 +29,21 @@ public:
 	void AddVertsForTextInBox2D(std::vector<Vertex_PCU>& vertexArray, const AABB2& box, float cellHeight, const std::string& text,
 		const Rgba8& tint = Rgba8::WHITE, float cellAspect = 1.f, const Vec2& alignment = Vec2(0.5f, 0.5f),
 		TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, int maxGlyphsToDraw = INT_MAX);
+	void AddVertsForText2D(FrameVector<Vertex_PCU>& vertexArray, const Vec2& textMins, float cellHeight, const std::string& text,
+		const Rgba8& tint = Rgba8::WHITE, float cellAspect = 1.f, int maxGlyphsToDraw = INT_MAX);
+	void AddVertsForTextInBox2D(FrameVector<Vertex_PCU>& vertexArray, const AABB2& box, float cellHeight, const std::string& text,
+		const Rgba8& tint = Rgba8::WHITE, float cellAspect = 1.f, const Vec2& alignment = Vec2(0.5f, 0.5f),
+		TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, int maxGlyphsToDraw = INT_MAX);
 	float GetTextWidth(float cellHeight, const std::string& text, float cellAspect = 1.f);
 	const std::string& GetFontFilePath() const;
 
 protected:
 	float GetGlyphAspect(int glyphUnicode) const;
+	template <typename VertexArray>
+	void AddVertsForText2DTo(VertexArray& vertexArray, const Vec2& textMins, float cellHeight, const char* text, int textLength, const Rgba8& tint, float cellAspect, int maxGlyphsToDraw);
+	template <typename VertexArray>
+	void AddVertsForTextInBox2DTo(VertexArray& vertexArray, const AABB2& box, float cellHeight, const std::string& text, const Rgba8& tint, float cellAspect,
+		const Vec2& alignment, TextBoxMode mode, int maxGlyphsToDraw);
 
 protected:
 	std::string m_fontFilePathWithNoExtension;
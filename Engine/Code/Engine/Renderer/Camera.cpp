@@ -138,6 +138,11 @@ float Camera::GetFOV() const
 	return m_perspectiveCameraFov;
 }
 
+CameraMode Camera::GetMode() const
+{
+	return m_mode;
+}
+
 Texture* Camera::GetColorTarget() const
 {
 	return m_colorTarget;
@@ -27,6 +27,7 @@ public:
 	void GetTransform(Vec3& out_Positon, EulerAngles& out_orientation) const;
 	AABB2 GetCameraViewport() const;
 	float GetFOV() const;
+	CameraMode GetMode() const;
 	Texture* GetColorTarget() const;
 	Texture* GetDepthTarget() const;
 
@@ -6,6 +6,7 @@
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include <mutex>
 
@@ -41,6 +42,7 @@ public:
 	BitmapFont* m_font = nullptr;
 	IntVec2 m_uiScreenSize = IntVec2::ZERO;
 	Camera m_worldCamera;
+	std::string m_debugMessageText;			//rebuilt every frame, kept around for its capacity
 };
 
 DebugRenderSystem* g_debugRenderSystem = nullptr;
@@ -100,6 +102,7 @@ void DebugRenderSystem::RemoveFromList(std::vector<DebugRenderObject*>& list, De
 
 void DebugAddWorldWireSphere(const Vec3& center, float radius, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
@@ -107,7 +110,7 @@ void DebugAddWorldWireSphere(const Vec3& center, float radius, float duration, c
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_transform = Mat44::CreateTranslation3D(center);
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -120,6 +123,7 @@ void DebugAddWorldWireSphere(const Vec3& center, float radius, float duration, c
 
 void DebugAddWorldSphere(const Vec3& center, float radius, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
@@ -127,7 +131,7 @@ void DebugAddWorldSphere(const Vec3& center, float radius, float duration, const
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_transform = Mat44::CreateTranslation3D(center);
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -140,6 +144,7 @@ void DebugAddWorldSphere(const Vec3& center, float radius, float duration, const
 
 void DebugAddWorldArrow(const Vec3& start, const Vec3& end, float radius, float duration, const Rgba8& baseColor, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	UNUSED(baseColor);
 	if (g_debugRenderSystem)
 	{
@@ -147,7 +152,7 @@ void DebugAddWorldArrow(const Vec3& start, const Vec3& end, float radius, float
 		AddVertsForArrow3D(verts, start, end, radius, Rgba8::WHITE);
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -160,13 +165,14 @@ void DebugAddWorldArrow(const Vec3& start, const Vec3& end, float radius, float
 
 void DebugAddWorldBox(const AABB3& bounds, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
 		AddVertsForAABB3D(verts, bounds, Rgba8::WHITE, AABB2(Vec2::ZERO, Vec2::ONE));
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -179,6 +185,7 @@ void DebugAddWorldBox(const AABB3& bounds, float duration, const Rgba8& startCol
 
 void DebugAddWorldBasis(const Mat44& basis, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	UNUSED(startColor);
 	UNUSED(endColor);
 	if (g_debugRenderSystem)
@@ -192,6 +199,7 @@ void DebugAddWorldBasis(const Mat44& basis, float duration, const Rgba8& startCo
 
 void DebugAddWorldText(const std::string& text, const Mat44& transform, float textHeight, const Vec2& alignment, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU>verts;
@@ -200,7 +208,7 @@ void DebugAddWorldText(const std::string& text, const Mat44& transform, float te
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_transform = transform;
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -215,6 +223,7 @@ void DebugAddWorldText(const std::string& text, const Mat44& transform, float te
 
 void DebugAddWorldBillboardText(const std::string& text, const Vec3& origin, float textHeight, const Vec2& alignment, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
@@ -224,7 +233,7 @@ void DebugAddWorldBillboardText(const std::string& text, const Vec3& origin, flo
 		renderObj->m_transform = Mat44::CreateTranslation3D(origin);
 		//renderObj->m_transform.Append(Mat44::CreateTranslation2D(Vec2(-alignment.x * textWidth, -alignment.y * textWidth)));
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -243,13 +252,14 @@ void DebugAddWorldBillboardText(const std::string& text, const Vec3& origin, flo
 
 void DebugAddScreenText(const std::string& text, const Vec2& position, float duration, const Vec2& alignment, float size, const Rgba8& startColor, const Rgba8& endColor)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
 		g_debugRenderSystem->m_font->AddVertsForText2D(verts, position, size, text);
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_fillMode = FillMode::SOLID;
@@ -263,6 +273,7 @@ void DebugAddScreenText(const std::string& text, const Vec2& position, float dur
 
 void DebugAddMessage(const std::string& text, float duration, const Rgba8& startColor, const Rgba8& endColor)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		DebugRenderObject* renderObj = new DebugRenderObject();
@@ -281,13 +292,14 @@ void DebugAddMessage(const std::string& text, float duration, const Rgba8& start
 
 void DebugAddWorldWireCylinder(const Vec3& base, const Vec3& top, float radius, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
 		AddVertsForCylinder3D(verts, base, top, radius, Rgba8::WHITE);
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -300,6 +312,7 @@ void DebugAddWorldWireCylinder(const Vec3& base, const Vec3& top, float radius,
 
 void DebugAddWorldPoint(const Vec3& pos, float radius, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
@@ -307,7 +320,7 @@ void DebugAddWorldPoint(const Vec3& pos, float radius, float duration, const Rgb
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_transform = Mat44::CreateTranslation3D(pos);
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -320,13 +333,14 @@ void DebugAddWorldPoint(const Vec3& pos, float radius, float duration, const Rgb
 
 void DebugAddWorldLine(const Vec3& start, const Vec3& end, float radius, float duration, const Rgba8& startColor, const Rgba8& endColor, DebugRenderMode mode)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		std::vector<Vertex_PCU> verts;
 		AddVertsForCylinder3D(verts, start, end, radius, Rgba8::WHITE);
 		DebugRenderObject* renderObj = new DebugRenderObject();
 		renderObj->m_totalLifeDuration = duration;
-		renderObj->m_localVerts = verts;
+		renderObj->m_localVerts = std::move(verts);
 		renderObj->m_startColor = startColor;
 		renderObj->m_endColor = endColor;
 		renderObj->m_debugRenderMode = mode;
@@ -366,6 +380,7 @@ void DebugRenderToggleVisibility()
 
 void DebugRenderClear()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	g_debugRenderSystem->m_allObjectListMutex.lock();
 	for (int i = 0; i < g_debugRenderSystem->m_allDebugObject.size(); i++)
 	{
@@ -399,6 +414,7 @@ void DebugRenderChangeTimeDilation(float deltaValue)
 
 void DebugRenderBeginFrame()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	g_debugRenderSystem->m_allObjectListMutex.lock();
 	for (int i = 0; i < g_debugRenderSystem->m_allDebugObject.size(); i++)
 	{
@@ -414,6 +430,7 @@ void DebugRenderBeginFrame()
 
 void DebugRenderWorld(const Camera& camera)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		g_debugRenderSystem->m_worldCamera = camera;
@@ -510,6 +527,7 @@ void DebugRenderWorld(const Camera& camera)
 
 void DebugRenderScreen(const Camera& camera)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	if (g_debugRenderSystem)
 	{
 		UNUSED(camera);
@@ -534,8 +552,9 @@ void DebugRenderScreen(const Camera& camera)
 		}
 		g_debugRenderSystem->m_textObjectMutex.unlock();
 
-		std::vector<Vertex_PCU> debugMessageVerts;
-		std::string debugMessages;
+		FrameVector<Vertex_PCU> debugMessageVerts;
+		std::string& debugMessages = g_debugRenderSystem->m_debugMessageText;
+		debugMessages.clear();
 		g_debugRenderSystem->m_debugMessagesMutex.lock();
 		for (int i = 0; i < g_debugRenderSystem->m_debugMessages.size(); i++)
 		{
@@ -544,6 +563,7 @@ void DebugRenderScreen(const Camera& camera)
 			debugMessages.append(g_debugRenderSystem->m_debugMessages[i]->m_debugMessage);
 		}
 		g_debugRenderSystem->m_debugMessagesMutex.unlock();
+		debugMessageVerts.reserve(debugMessages.size() * 6);
 		AABB2 bounds(Vec2(0.f, g_debugRenderSystem->m_uiScreenSize.y - 25.f), Vec2(25.f, g_debugRenderSystem->m_uiScreenSize.y - 15.f));
 		g_debugRenderSystem->m_font->AddVertsForTextInBox2D(debugMessageVerts, bounds, 15.f, debugMessages, Rgba8::WHITE, 1.f, Vec2(0.f, 1.f), TextBoxMode::OVERRUN);
 		renderer->SetBlendMode(BlendMode::ALPHA);
@@ -557,6 +577,7 @@ void DebugRenderScreen(const Camera& camera)
 
 void DebugRenderEndFrame()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::DEBUG_RENDER)
 	g_debugRenderSystem->m_allObjectListMutex.lock();
 	for (int i = 0; i < g_debugRenderSystem->m_allDebugObject.size(); i++)
 	{
@@ -0,0 +1,183 @@
+#include <d3d11.h>
+#include "Engine/Renderer/GPUReadbackRing.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+RendererReadbackBackend::RendererReadbackBackend(Renderer* renderer)
+	:m_renderer(renderer)
+{
+}
+
+void* RendererReadbackBackend::CreateStagingBuffer(size_t size)
+{
+	ID3D11Buffer* stagingBuffer = nullptr;
+	m_renderer->CreateD3DStagingBuffer(&stagingBuffer, size, size);
+	return stagingBuffer;
+}
+
+void RendererReadbackBackend::ReleaseStagingBuffer(void* stagingBuffer)
+{
+	ID3D11Buffer* buffer = static_cast<ID3D11Buffer*>(stagingBuffer);
+	DX_SAFE_RELEASE(buffer);
+}
+
+void RendererReadbackBackend::CopyToStagingBuffer(void* stagingBuffer, void* sourceBuffer)
+{
+	m_renderer->CopyOverResourcesInGPU(static_cast<ID3D11Buffer*>(stagingBuffer), static_cast<ID3D11Buffer*>(sourceBuffer));
+}
+
+bool RendererReadbackBackend::TryReadStagingBuffer(void* stagingBuffer, void* out_data, size_t size)
+{
+	return m_renderer->TryCopyGPUToCPU(out_data, size, static_cast<ID3D11Buffer*>(stagingBuffer));
+}
+
+MockReadbackBackend::MockReadbackBackend(int failedReadsBeforeReady)
+	:m_failedReadsBeforeReady(failedReadsBeforeReady)
+{
+}
+
+MockReadbackBackend::~MockReadbackBackend()
+{
+	GUARANTEE_RECOVERABLE(m_stagingBuffers.empty(), "Mock readback backend destroyed with staging buffers still alive");
+	for (int i = 0; i < m_stagingBuffers.size(); i++)
+	{
+		delete m_stagingBuffers[i];
+	}
+	m_stagingBuffers.clear();
+}
+
+void* MockReadbackBackend::CreateStagingBuffer(size_t size)
+{
+	MockStagingBuffer* stagingBuffer = new MockStagingBuffer();
+	stagingBuffer->m_data.resize(size);
+	m_stagingBuffers.push_back(stagingBuffer);
+	return stagingBuffer;
+}
+
+void MockReadbackBackend::ReleaseStagingBuffer(void* stagingBuffer)
+{
+	for (auto iter = m_stagingBuffers.begin(); iter != m_stagingBuffers.end(); ++iter)
+	{
+		if (*iter == stagingBuffer)
+		{
+			delete *iter;
+			m_stagingBuffers.erase(iter);
+			return;
+		}
+	}
+	ERROR_RECOVERABLE("Releasing a staging buffer the mock backend doesn't own");
+}
+
+void MockReadbackBackend::CopyToStagingBuffer(void* stagingBuffer, void* sourceBuffer)
+{
+	MockStagingBuffer* mockBuffer = static_cast<MockStagingBuffer*>(stagingBuffer);
+	memcpy(mockBuffer->m_data.data(), sourceBuffer, mockBuffer->m_data.size());
+	mockBuffer->m_failedReadsLeft = m_failedReadsBeforeReady;
+	m_numCopiesIssued++;
+}
+
+bool MockReadbackBackend::TryReadStagingBuffer(void* stagingBuffer, void* out_data, size_t size)
+{
+	MockStagingBuffer* mockBuffer = static_cast<MockStagingBuffer*>(stagingBuffer);
+	if (mockBuffer->m_failedReadsLeft > 0)
+	{
+		mockBuffer->m_failedReadsLeft--;
+		return false;
+	}
+
+	GUARANTEE_OR_DIE(size <= mockBuffer->m_data.size(), "Reading more data than the staging buffer holds");
+	memcpy(out_data, mockBuffer->m_data.data(), size);
+	return true;
+}
+
+int MockReadbackBackend::GetNumLiveStagingBuffers() const
+{
+	return (int)m_stagingBuffers.size();
+}
+
+int MockReadbackBackend::GetNumCopiesIssued() const
+{
+	return m_numCopiesIssued;
+}
+
+GPUReadbackRing::GPUReadbackRing(GPUReadbackBackend* backend, size_t dataSize, int numStagingBuffers)
+	:m_backend(backend), m_dataSize(dataSize)
+{
+	GUARANTEE_OR_DIE(m_backend != nullptr, "Readback ring needs a backend");
+	GUARANTEE_OR_DIE(numStagingBuffers > 0, "Readback ring needs at least one staging buffer");
+
+	m_slots.resize(numStagingBuffers);
+	for (int i = 0; i < numStagingBuffers; i++)
+	{
+		m_slots[i].m_stagingBuffer = m_backend->CreateStagingBuffer(m_dataSize);
+	}
+	m_latestData.resize(m_dataSize);
+}
+
+GPUReadbackRing::~GPUReadbackRing()
+{
+	for (int i = 0; i < m_slots.size(); i++)
+	{
+		m_backend->ReleaseStagingBuffer(m_slots[i].m_stagingBuffer);
+		m_slots[i].m_stagingBuffer = nullptr;
+	}
+	m_slots.clear();
+}
+
+bool GPUReadbackRing::QueueReadback(void* sourceBuffer, unsigned int tag)
+{
+	ReadbackSlot& slot = m_slots[m_nextSlotToWrite];
+	if (slot.m_isPending)
+	{
+		//the gpu is more than a ring behind, dropping this readback is better than waiting on it
+		m_numSkippedReadbacks++;
+		return false;
+	}
+
+	m_backend->CopyToStagingBuffer(slot.m_stagingBuffer, sourceBuffer);
+	slot.m_tag = tag;
+	slot.m_isPending = true;
+	m_numPendingReadbacks++;
+	m_nextSlotToWrite = (m_nextSlotToWrite + 1) % (int)m_slots.size();
+	return true;
+}
+
+bool GPUReadbackRing::PollReadbacks()
+{
+	//copies complete in submission order, so stop at the first one that isn't ready
+	bool receivedNewData = false;
+	while (m_numPendingReadbacks > 0)
+	{
+		ReadbackSlot& slot = m_slots[m_oldestPendingSlot];
+		if (!m_backend->TryReadStagingBuffer(slot.m_stagingBuffer, m_latestData.data(), m_dataSize))
+			break;
+
+		m_latestTag = slot.m_tag;
+		m_hasData = true;
+		receivedNewData = true;
+		slot.m_isPending = false;
+		m_numPendingReadbacks--;
+		m_oldestPendingSlot = (m_oldestPendingSlot + 1) % (int)m_slots.size();
+	}
+	return receivedNewData;
+}
+
+bool GPUReadbackRing::HasData() const
+{
+	return m_hasData;
+}
+
+unsigned int GPUReadbackRing::GetLatestTag() const
+{
+	return m_latestTag;
+}
+
+int GPUReadbackRing::GetNumPendingReadbacks() const
+{
+	return m_numPendingReadbacks;
+}
+
+int GPUReadbackRing::GetNumSkippedReadbacks() const
+{
+	return m_numSkippedReadbacks;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+class Renderer;
+
+//interface over the gpu calls the readback ring needs, buffers are passed around as opaque handles
+//so the ring logic doesn't depend on d3d and can run against MockReadbackBackend
+class GPUReadbackBackend
+{
+public:
+	virtual ~GPUReadbackBackend() = default;
+	virtual void* CreateStagingBuffer(size_t size) = 0;
+	virtual void ReleaseStagingBuffer(void* stagingBuffer) = 0;
+	virtual void CopyToStagingBuffer(void* stagingBuffer, void* sourceBuffer) = 0;
+	//must not block, returns false if the gpu hasn't finished the copy yet
+	virtual bool TryReadStagingBuffer(void* stagingBuffer, void* out_data, size_t size) = 0;
+};
+
+//backend for the d3d11 renderer, handles are ID3D11Buffer pointers
+class RendererReadbackBackend : public GPUReadbackBackend
+{
+public:
+	RendererReadbackBackend(Renderer* renderer);
+	void* CreateStagingBuffer(size_t size) override;
+	void ReleaseStagingBuffer(void* stagingBuffer) override;
+	void CopyToStagingBuffer(void* stagingBuffer, void* sourceBuffer) override;
+	bool TryReadStagingBuffer(void* stagingBuffer, void* out_data, size_t size) override;
+
+private:
+	Renderer* m_renderer = nullptr;
+};
+
+//cpu only backend, source handles point to plain memory and copies become readable after a set number of read attempts
+class MockReadbackBackend : public GPUReadbackBackend
+{
+public:
+	MockReadbackBackend(int failedReadsBeforeReady = 2);
+	~MockReadbackBackend();
+	void* CreateStagingBuffer(size_t size) override;
+	void ReleaseStagingBuffer(void* stagingBuffer) override;
+	void CopyToStagingBuffer(void* stagingBuffer, void* sourceBuffer) override;
+	bool TryReadStagingBuffer(void* stagingBuffer, void* out_data, size_t size) override;
+
+	int GetNumLiveStagingBuffers() const;
+	int GetNumCopiesIssued() const;
+
+private:
+	struct MockStagingBuffer
+	{
+		std::vector<uint8_t> m_data;
+		int m_failedReadsLeft = 0;
+	};
+
+	std::vector<MockStagingBuffer*> m_stagingBuffers;
+	int m_failedReadsBeforeReady = 0;
+	int m_numCopiesIssued = 0;
+};
+
+//ring of staging buffers so a gpu buffer can be read back a few frames later without stalling the pipeline.
+//each readback carries a caller supplied tag (frame number, running counter...) that comes back with the data
+class GPUReadbackRing
+{
+public:
+	GPUReadbackRing(GPUReadbackBackend* backend, size_t dataSize, int numStagingBuffers);
+	~GPUReadbackRing();
+
+	//returns false and skips the copy if every staging buffer is still waiting on the gpu
+	bool QueueReadback(void* sourceBuffer, unsigned int tag);
+	//reads back every copy the gpu has finished, oldest first, never blocks. returns true if newer data arrived
+	bool PollReadbacks();
+
+	bool HasData() const;
+	unsigned int GetLatestTag() const;
+	int GetNumPendingReadbacks() const;
+	int GetNumSkippedReadbacks() const;
+	template <typename T>
+	bool GetLatestData(T& out_data) const;
+
+private:
+	struct ReadbackSlot
+	{
+		void* m_stagingBuffer = nullptr;
+		unsigned int m_tag = 0;
+		bool m_isPending = false;
+	};
+
+	GPUReadbackBackend* m_backend = nullptr;
+	size_t m_dataSize = 0;
+	std::vector<ReadbackSlot> m_slots;
+	int m_nextSlotToWrite = 0;
+	int m_oldestPendingSlot = 0;
+	int m_numPendingReadbacks = 0;
+	int m_numSkippedReadbacks = 0;
+	std::vector<uint8_t> m_latestData;
+	unsigned int m_latestTag = 0;
+	bool m_hasData = false;
+};
+
+template <typename T>
+bool GPUReadbackRing::GetLatestData(T& out_data) const
+{
+	if (!m_hasData || sizeof(T) != m_dataSize)
+		return false;
+
+	memcpy(&out_data, m_latestData.data(), sizeof(T));
+	return true;
+}
@@ -3,8 +3,8 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 
-IndexBuffer::IndexBuffer(size_t size)
-	:m_size(size)
+IndexBuffer::IndexBuffer(size_t size, unsigned int stride)
+	:m_size(size), m_stride(stride)
 {
 
 }
@@ -14,3 +14,7 @@ IndexBuffer::~IndexBuffer()
 	DX_SAFE_RELEASE(m_buffer);
 }
 
+unsigned int IndexBuffer::GetStride() const
+{
+	return m_stride;
+}
@@ -7,10 +7,13 @@ class IndexBuffer
 	friend class Renderer;
 
 public:
-	IndexBuffer(size_t size);
+	IndexBuffer(size_t size, unsigned int stride = sizeof(unsigned int));
 	IndexBuffer(const IndexBuffer& copy) = delete;
 	virtual ~IndexBuffer();
 
+	unsigned int GetStride() const;
+
 	ID3D11Buffer* m_buffer = nullptr;
 	size_t m_size = 0;
+	unsigned int m_stride = sizeof(unsigned int);		//2 or 4 bytes per index
 };
\ No newline at end of file
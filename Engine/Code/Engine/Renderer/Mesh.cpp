@@ -1,5 +1,6 @@
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
 #include "Engine/Renderer/VertexBuffer.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/Renderer.hpp"
@@ -17,10 +18,15 @@ Mesh::~Mesh()
 
 bool Mesh::UpdateFromBuilder(const MeshBuilder& builder)
 {
+	m_lods.clear();
 	if (builder.GetNumIndices() > 0)
 	{
 		m_usesIndices = true;
-		m_elementCount = builder.GetNumIndices();
+		for (unsigned int lodIndex = 0; lodIndex < builder.GetNumLods(); lodIndex++)
+		{
+			m_lods.push_back(builder.GetLod(lodIndex));
+		}
+		m_elementCount = m_lods[0].m_numIndices;
 	}
 	else
 	{
@@ -30,19 +36,48 @@ bool Mesh::UpdateFromBuilder(const MeshBuilder& builder)
 
 	size_t vertexBufferSize = builder.GetSizeOfVertex() * builder.GetNumVertices();
 	size_t indexBufferSize = builder.GetSizeOfIndex() * builder.GetNumIndices();
+	UploadBuffers(builder.GetVerticesData().data(), vertexBufferSize, (unsigned int)builder.GetSizeOfVertex(), builder.GetIndicesData().data(), indexBufferSize, (unsigned int)builder.GetSizeOfIndex());
+	return true;
+}
+
+bool Mesh::UpdateFromMeshFile(const MeshFileView& meshFile)
+{
+	if (!meshFile.IsOpen())
+		return false;
+
+	m_usesIndices = meshFile.GetNumIndices() > 0;
+	m_lods.clear();
+	if (m_usesIndices)
+	{
+		m_lods.assign(&meshFile.GetLod(0), &meshFile.GetLod(0) + meshFile.GetNumLods());
+	}
+	m_elementCount = m_usesIndices ? m_lods[0].m_numIndices : meshFile.GetNumVertices();
+
+	//uploaded straight out of the mapped file, 16 bit indices stay 16 bit on the gpu
+	size_t vertexBufferSize = sizeof(Vertex_PNCU) * meshFile.GetNumVertices();
+	size_t indexBufferSize = (size_t)meshFile.GetIndexStride() * meshFile.GetNumIndices();
+	UploadBuffers(meshFile.GetVertices(), vertexBufferSize, (unsigned int)sizeof(Vertex_PNCU), meshFile.GetIndexData(), indexBufferSize, meshFile.GetIndexStride());
+	return true;
+}
+
+void Mesh::UploadBuffers(const void* vertexData, size_t vertexBufferSize, unsigned int vertexStride, const void* indexData, size_t indexBufferSize, unsigned int indexStride)
+{
+	if (m_indexBuffer && m_indexBuffer->GetStride() != indexStride)
+	{
+		delete m_indexBuffer;
+		m_indexBuffer = nullptr;
+	}
 	if (!m_vertexBuffer)
 	{
-		m_vertexBuffer = m_renderer->CreateVertexBuffer(vertexBufferSize, (unsigned int)builder.GetSizeOfVertex());
+		m_vertexBuffer = m_renderer->CreateVertexBuffer(vertexBufferSize, vertexStride);
 	}
 	if (!m_indexBuffer)
 	{
-		m_indexBuffer = m_renderer->CreateIndexBuffer(indexBufferSize);
+		m_indexBuffer = m_renderer->CreateIndexBuffer(indexBufferSize, indexStride);
 	}
 
-	m_renderer->CopyCPUToGPU(builder.GetVerticesData().data(), vertexBufferSize, m_vertexBuffer);
-	m_renderer->CopyCPUToGPU(builder.GetIndicesData().data(), indexBufferSize, m_indexBuffer);
-
-	return true;
+	m_renderer->CopyCPUToGPU(vertexData, vertexBufferSize, m_vertexBuffer);
+	m_renderer->CopyCPUToGPU(indexData, indexBufferSize, m_indexBuffer);
 }
 
 VertexBuffer* Mesh::GetVertexBuffer() const
@@ -60,3 +95,12 @@ unsigned int Mesh::GetElementCount() const
 	return m_elementCount;
 }
 
+unsigned int Mesh::GetNumLods() const
+{
+	return (unsigned int)m_lods.size();
+}
+
+const MeshLod& Mesh::GetLod(unsigned int lodIndex) const
+{
+	return m_lods[lodIndex];
+}
@@ -1,8 +1,11 @@
 #pragma once
+#include <vector>
+#include "Engine/Renderer/MeshFile.hpp"
 
 class VertexBuffer;
 class IndexBuffer;
 class MeshBuilder;
+class MeshFileView;
 class Renderer;
 
 class Mesh
@@ -11,10 +14,13 @@ public:
 	explicit Mesh(Renderer* renderer);
 	~Mesh();
 	bool UpdateFromBuilder(const MeshBuilder& builder);
+	bool UpdateFromMeshFile(const MeshFileView& meshFile);
 
 	VertexBuffer* GetVertexBuffer() const;
 	IndexBuffer* GetIndexBuffer() const;
-	unsigned int GetElementCount() const;
+	unsigned int GetElementCount() const;		//of the full mesh, lod 0
+	unsigned int GetNumLods() const;
+	const MeshLod& GetLod(unsigned int lodIndex) const;	//index range to draw with DrawIndexed, see SelectMeshLod
 
 private:
 	Renderer* m_renderer = nullptr;
@@ -22,4 +28,8 @@ private:
 	IndexBuffer* m_indexBuffer = nullptr;
 	bool m_usesIndices = false;
 	unsigned int m_elementCount = 0;
+	std::vector<MeshLod> m_lods;
+
+private:
+	void UploadBuffers(const void* vertexData, size_t vertexBufferSize, unsigned int vertexStride, const void* indexData, size_t indexBufferSize, unsigned int indexStride);
 };
\ No newline at end of file
@@ -1,87 +1,389 @@
 #include "Engine/Renderer/MeshBuilder.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Renderer/MeshSimplifier.hpp"
+#include "Engine/Core/Job.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <charconv>
+#include <string.h>
+
+//one slice of an obj file, parsed on its own. a relative (negative) index can reach back past the start of its chunk,
+//so it is stored as an index from the chunk's first element (negative if it points into an earlier chunk) and flagged,
+//then turned into a file wide index once every chunk's counts are known
+constexpr unsigned char OBJ_RELATIVE_POSITION = 1 << 0;
+constexpr unsigned char OBJ_RELATIVE_UV = 1 << 1;
+constexpr unsigned char OBJ_RELATIVE_NORMAL = 1 << 2;
+
+struct ObjFaceCorner
+{
+	int m_position = 0;
+	int m_uv = 0;
+	int m_normal = 0;
+	unsigned char m_relativeComponents = 0;
+
+	bool operator==(const ObjFaceCorner& compare) const { return m_position == compare.m_position && m_uv == compare.m_uv && m_normal == compare.m_normal; }
+};
+
+struct ObjFileChunk
+{
+	const char* m_begin = nullptr;
+	const char* m_end = nullptr;
+	std::vector<Vec3> m_positions;
+	std::vector<Vec2> m_uvs;
+	std::vector<Vec3> m_normals;
+	std::vector<ObjFaceCorner> m_faceCorners;		//1 based, 0 if missing, chunk local when flagged relative
+	std::vector<int> m_faceCornerCounts;
+	bool m_isMalformed = false;
+};
+
+class ObjParseChunkJob : public Job
+{
+public:
+	ObjParseChunkJob(ObjFileChunk& chunk) : m_chunk(chunk) {}
+
+private:
+	virtual void Execute() override;
+	virtual void OnFinished() override {}
+
+private:
+	ObjFileChunk& m_chunk;
+};
+
+static const char* SkipObjSpaces(const char* text, const char* end)
+{
+	while (text < end && (*text == ' ' || *text == '\t'))
+	{
+		text++;
+	}
+	return text;
+}
+
+static const char* ParseObjFloats(const char* text, const char* end, float* outValues, int numValues)
+{
+	for (int i = 0; i < numValues; i++)
+	{
+		text = SkipObjSpaces(text, end);
+		if (text < end && *text == '+')
+		{
+			text++;
+		}
+		std::from_chars_result result = std::from_chars(text, end, outValues[i]);
+		if (result.ec != std::errc())
+			return nullptr;
+		text = result.ptr;
+	}
+	return text;
+}
+
+//a non zero obj index, kept as is if absolute or made chunk local if relative
+static void StoreObjIndex(int objIndex, int numSoFarInChunk, unsigned char relativeFlag, int& outIndex, unsigned char& outRelativeComponents)
+{
+	if (objIndex > 0)
+	{
+		outIndex = objIndex;
+		return;
+	}
+	outIndex = numSoFarInChunk + objIndex;
+	outRelativeComponents |= relativeFlag;
+}
+
+//to a 0 based file wide index, -1 for missing. false if it points outside the file's elements
+static bool ResolveObjIndex(int chunkBase, int numInFile, bool isRelative, int& index)
+{
+	if (!isRelative && index == 0)
+	{
+		index = -1;
+		return true;
+	}
+	index = isRelative ? chunkBase + index : index - 1;
+	return index >= 0 && index < numInFile;
+}
+
+static void ParseObjChunk(ObjFileChunk& chunk)
+{
+	const char* text = chunk.m_begin;
+	const char* end = chunk.m_end;
+	while (text < end)
+	{
+		const char* lineEnd = (const char*)memchr(text, '\n', end - text);
+		if (lineEnd == nullptr)
+		{
+			lineEnd = end;
+		}
+
+		text = SkipObjSpaces(text, lineEnd);
+		if (lineEnd - text > 2 && text[0] == 'v' && (text[1] == ' ' || text[1] == '\t'))
+		{
+			float values[3] = {};
+			chunk.m_isMalformed |= ParseObjFloats(text + 2, lineEnd, values, 3) == nullptr;
+			chunk.m_positions.push_back(Vec3(values[0], values[1], values[2]));
+		}
+		else if (lineEnd - text > 3 && text[0] == 'v' && text[1] == 't' && (text[2] == ' ' || text[2] == '\t'))
+		{
+			float values[2] = {};
+			chunk.m_isMalformed |= ParseObjFloats(text + 3, lineEnd, values, 2) == nullptr;
+			chunk.m_uvs.push_back(Vec2(values[0], values[1]));
+		}
+		else if (lineEnd - text > 3 && text[0] == 'v' && text[1] == 'n' && (text[2] == ' ' || text[2] == '\t'))
+		{
+			float values[3] = {};
+			chunk.m_isMalformed |= ParseObjFloats(text + 3, lineEnd, values, 3) == nullptr;
+			chunk.m_normals.push_back(Vec3(values[0], values[1], values[2]));
+		}
+		else if (lineEnd - text > 2 && text[0] == 'f' && (text[1] == ' ' || text[1] == '\t'))
+		{
+			//corners are v, v/vt, v//vn or v/vt/vn
+			int numCorners = 0;
+			const char* cursor = text + 2;
+			while (true)
+			{
+				cursor = SkipObjSpaces(cursor, lineEnd);
+				if (cursor >= lineEnd || *cursor == '\r' || *cursor == '#')
+					break;
+
+				int objIndices[3] = { 0, 0, 0 };
+				for (int component = 0; component < 3; component++)
+				{
+					if (component > 0)
+					{
+						if (cursor >= lineEnd || *cursor != '/')
+							break;
+						cursor++;
+						if (cursor < lineEnd && *cursor == '/')
+							continue;
+					}
+					std::from_chars_result result = std::from_chars(cursor, lineEnd, objIndices[component]);
+					if (result.ec != std::errc())
+					{
+						chunk.m_isMalformed = true;
+						break;
+					}
+					cursor = result.ptr;
+				}
+				if (chunk.m_isMalformed)
+					break;
+
+				if (objIndices[0] == 0)
+				{
+					chunk.m_isMalformed = true;
+					break;
+				}
+
+				//whether a relative index really exists is only known once the earlier chunks are counted
+				ObjFaceCorner corner;
+				StoreObjIndex(objIndices[0], (int)chunk.m_positions.size(), OBJ_RELATIVE_POSITION, corner.m_position, corner.m_relativeComponents);
+				if (objIndices[1] != 0)
+				{
+					StoreObjIndex(objIndices[1], (int)chunk.m_uvs.size(), OBJ_RELATIVE_UV, corner.m_uv, corner.m_relativeComponents);
+				}
+				if (objIndices[2] != 0)
+				{
+					StoreObjIndex(objIndices[2], (int)chunk.m_normals.size(), OBJ_RELATIVE_NORMAL, corner.m_normal, corner.m_relativeComponents);
+				}
+				chunk.m_faceCorners.push_back(corner);
+				numCorners++;
+			}
+			chunk.m_faceCornerCounts.push_back(numCorners);
+		}
+
+		text = lineEnd + 1;
+	}
+}
+
+void ObjParseChunkJob::Execute()
+{
+	ParseObjChunk(m_chunk);
+}
+
+//maps an obj corner (position, uv, normal) to the vertex made for it. the position index is the hash: each position
+//keeps a short list of the vertices made from it, so lookups walk memory in about the same order the faces do
+class ObjVertexTable
+{
+public:
+	ObjVertexTable(size_t numPositions)
+		:m_firstVertexAtPosition(numPositions, INVALID_VERTEX)
+	{
+		m_vertexCorners.reserve(numPositions);
+	}
+
+	//returns the existing vertex for the corner, or records the corner as vertex newVertexIndex
+	unsigned int FindOrAdd(const ObjFaceCorner& corner, unsigned int newVertexIndex)
+	{
+		unsigned int vertexIndex = m_firstVertexAtPosition[corner.m_position];
+		while (vertexIndex != INVALID_VERTEX)
+		{
+			const VertexCorner& vertexCorner = m_vertexCorners[vertexIndex];
+			if (vertexCorner.m_uv == corner.m_uv && vertexCorner.m_normal == corner.m_normal)
+				return vertexIndex;
+			vertexIndex = vertexCorner.m_nextAtSamePosition;
+		}
+
+		VertexCorner newCorner;
+		newCorner.m_uv = corner.m_uv;
+		newCorner.m_normal = corner.m_normal;
+		newCorner.m_nextAtSamePosition = m_firstVertexAtPosition[corner.m_position];
+		m_firstVertexAtPosition[corner.m_position] = newVertexIndex;
+		m_vertexCorners.push_back(newCorner);
+		return newVertexIndex;
+	}
+
+private:
+	static constexpr unsigned int INVALID_VERTEX = 0xFFFFFFFF;
+	struct VertexCorner
+	{
+		int m_uv = 0;
+		int m_normal = 0;
+		unsigned int m_nextAtSamePosition = INVALID_VERTEX;
+	};
+
+	std::vector<unsigned int> m_firstVertexAtPosition;
+	std::vector<VertexCorner> m_vertexCorners;		//indexed by vertex, vertices are only ever added in order
+};
 
 bool MeshBuilder::ImportFromOBJFile(const char* filepath, const mesh_import_options& importOptions)
 {
-	std::string bufferString;
-	Strings entries;
-	std::vector<Vec3> positions;
-	std::vector<Vec3> normals;
-	std::vector<Vec2> uvs;
-	std::vector<std::string> faces;
+	MappedFile objFile;
+	if (!objFile.Open(filepath, FileAccessPattern::SEQUENTIAL))
+	{
+		ERROR_RECOVERABLE(Stringf("Failed to open obj file \"%s\"", filepath));
+		return false;
+	}
 
-	FileReadToString(bufferString, filepath);
-	entries = SplitStringOnDelimiter(bufferString, '\n');
+	//split on line boundaries into chunks that are parsed independently, as jobs if there is a job system to use
+	const char* fileBegin = (const char*)objFile.GetData();
+	const char* fileEnd = fileBegin + objFile.GetSize();
+	int numChunks = 1;
+	if (importOptions.m_jobSystem)
+	{
+		size_t maxChunks = objFile.GetSize() / OBJ_IMPORT_MIN_CHUNK_BYTES + 1;
+		numChunks = importOptions.m_jobSystem->GetNumWorkerThreads() * 2;
+		numChunks = (size_t)numChunks > maxChunks ? (int)maxChunks : numChunks;
+		numChunks = numChunks < 1 ? 1 : numChunks;
+	}
 
-	for (int i = 0; i < entries.size(); i++)
+	std::vector<ObjFileChunk> chunks(numChunks);
+	const char* chunkBegin = fileBegin;
+	for (int i = 0; i < numChunks; i++)
 	{
-		Strings tokens = SplitStringOnDelimiter(entries[i], ' ');
-		//found positions
-		if (tokens[0] == "v")
+		const char* chunkEnd = fileEnd;
+		if (i < numChunks - 1)
 		{
-			Vec3 pos;
-			pos.SetFromText(MakeValuesStringFromTokens(tokens).c_str());
-			positions.push_back(pos);
+			chunkEnd = fileBegin + objFile.GetSize() / numChunks * (i + 1);
+			chunkEnd = chunkEnd < chunkBegin ? chunkBegin : chunkEnd;
+			const char* newline = (const char*)memchr(chunkEnd, '\n', fileEnd - chunkEnd);
+			chunkEnd = newline ? newline + 1 : fileEnd;
 		}
-		//found normal
-		else if (tokens[0] == "vn")
+		chunks[i].m_begin = chunkBegin;
+		chunks[i].m_end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	if (numChunks > 1)
+	{
+		std::vector<ObjParseChunkJob> parseJobs;
+		std::vector<Job*> jobsToWaitFor;
+		parseJobs.reserve(numChunks);
+		for (int i = 0; i < numChunks; i++)
 		{
-			Vec3 normal;
-			normal.SetFromText(MakeValuesStringFromTokens(tokens).c_str());
-			normals.push_back(normal);
+			parseJobs.emplace_back(chunks[i]);
+			jobsToWaitFor.push_back(&parseJobs.back());
+			importOptions.m_jobSystem->QueueJobs(&parseJobs.back());
 		}
-		//found uv
-		else if (tokens[0] == "vt")
+		importOptions.m_jobSystem->WaitForJobs(jobsToWaitFor);
+	}
+	else
+	{
+		ParseObjChunk(chunks[0]);
+	}
+
+	size_t numPositions = 0;
+	size_t numUVs = 0;
+	size_t numNormals = 0;
+	size_t numCorners = 0;
+	for (int i = 0; i < numChunks; i++)
+	{
+		if (chunks[i].m_isMalformed)
 		{
-			Vec2 uv;
-			uv.SetFromText(MakeValuesStringFromTokens(tokens).c_str());
-			uvs.push_back(uv);
+			ERROR_RECOVERABLE(Stringf("Malformed obj file \"%s\"", filepath));
+			return false;
 		}
-		//found face
-		else if (tokens[0] == "f")
+		numPositions += chunks[i].m_positions.size();
+		numUVs += chunks[i].m_uvs.size();
+		numNormals += chunks[i].m_normals.size();
+		numCorners += chunks[i].m_faceCorners.size();
+	}
+
+	std::vector<Vec3> positions;
+	std::vector<Vec2> uvs;
+	std::vector<Vec3> normals;
+	positions.reserve(numPositions);
+	uvs.reserve(numUVs);
+	normals.reserve(numNormals);
+
+	//identical corners share a vertex, n-gons are fanned from their first corner
+	m_vertices.clear();
+	m_indices.clear();
+	m_lods.clear();
+	//most meshes end up with about one vertex per position, the table and vertex array grow from there if not
+	m_vertices.reserve(numPositions);
+	m_indices.reserve(numCorners * 3 / 2);
+	ObjVertexTable vertexTable(numPositions);
+	std::vector<unsigned int> faceVertexIndices;
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		ObjFileChunk& chunk = chunks[chunkIndex];
+		int positionBase = (int)positions.size();
+		int uvBase = (int)uvs.size();
+		int normalBase = (int)normals.size();
+		positions.insert(positions.end(), chunk.m_positions.begin(), chunk.m_positions.end());
+		uvs.insert(uvs.end(), chunk.m_uvs.begin(), chunk.m_uvs.end());
+		normals.insert(normals.end(), chunk.m_normals.begin(), chunk.m_normals.end());
+
+		size_t cornerIndex = 0;
+		for (int faceIndex = 0; faceIndex < chunk.m_faceCornerCounts.size(); faceIndex++)
 		{
-			int numberOfClusters = 0;
-			int baseIndex = (int)m_vertices.size();
-			for (int j = 0; j < tokens.size(); j++)
+			int numFaceCorners = chunk.m_faceCornerCounts[faceIndex];
+			faceVertexIndices.clear();
+			for (int i = 0; i < numFaceCorners; i++)
 			{
-				if (tokens[j].find('/') != std::string::npos)
+				ObjFaceCorner corner = chunk.m_faceCorners[cornerIndex++];
+				bool isValid = ResolveObjIndex(positionBase, (int)positions.size(), (corner.m_relativeComponents & OBJ_RELATIVE_POSITION) != 0, corner.m_position);
+				isValid &= ResolveObjIndex(uvBase, (int)uvs.size(), (corner.m_relativeComponents & OBJ_RELATIVE_UV) != 0, corner.m_uv);
+				isValid &= ResolveObjIndex(normalBase, (int)normals.size(), (corner.m_relativeComponents & OBJ_RELATIVE_NORMAL) != 0, corner.m_normal);
+				if (!isValid || corner.m_position < 0)
+				{
+					ERROR_RECOVERABLE(Stringf("Obj file \"%s\" has a face index out of range", filepath));
+					m_vertices.clear();
+					m_indices.clear();
+					return false;
+				}
+
+				unsigned int vertexIndex = vertexTable.FindOrAdd(corner, (unsigned int)m_vertices.size());
+				if (vertexIndex == m_vertices.size())
 				{
-					numberOfClusters++;
-					Strings listIndices = SplitStringOnDelimiter(tokens[j], '/');
 					Vertex_PNCU vert;
-					vert.m_position = positions[atoi(listIndices[0].c_str()) - 1];	//subtracting by 1 because the indices in the obj file start from 1 (and not 0)
+					vert.m_position = positions[corner.m_position];
 					vert.m_color = Rgba8::WHITE;
-					if (listIndices.size() > 1 && listIndices[1] != "")
+					if (corner.m_uv >= 0)
 					{
-						vert.m_uvTexCoords = uvs[atoi(listIndices[1].c_str()) - 1];
+						vert.m_uvTexCoords = uvs[corner.m_uv];
 					}
-					if (listIndices.size() > 2)
+					if (corner.m_normal >= 0)
 					{
-						vert.m_normal = normals[atoi(listIndices[2].c_str()) - 1];
+						vert.m_normal = normals[corner.m_normal];
 					}
-					
 					m_vertices.push_back(vert);
 				}
+				faceVertexIndices.push_back(vertexIndex);
 			}
 
-			//add indices for index buffer
-			if (numberOfClusters > 3)
-			{
-				//if there were 4 clusters, mean it was a quad
-				m_indices.push_back(baseIndex + 0);
-				m_indices.push_back(baseIndex + 1);
-				m_indices.push_back(baseIndex + 2);
-				m_indices.push_back(baseIndex + 0);
-				m_indices.push_back(baseIndex + 2);
-				m_indices.push_back(baseIndex + 3);
-			}
-			else
+			for (int i = 1; i + 1 < numFaceCorners; i++)
 			{
-				//only 3 clusters, means it was a triangle
-				m_indices.push_back(baseIndex + 0);
-				m_indices.push_back(baseIndex + 1);
-				m_indices.push_back(baseIndex + 2);
+				m_indices.push_back(faceVertexIndices[0]);
+				m_indices.push_back(faceVertexIndices[i]);
+				m_indices.push_back(faceVertexIndices[i + 1]);
 			}
 		}
 	}
@@ -109,7 +411,7 @@ unsigned int MeshBuilder::GetNumVertices() const
 	return (unsigned int)m_vertices.size();
 }
 
-const std::vector<Vertex_PNCU> MeshBuilder::GetVerticesData() const
+const std::vector<Vertex_PNCU>& MeshBuilder::GetVerticesData() const
 {
 	return m_vertices;
 }
@@ -124,7 +426,7 @@ unsigned int MeshBuilder::GetNumIndices() const
 	return (unsigned int)m_indices.size();
 }
 
-const std::vector<unsigned int> MeshBuilder::GetIndicesData() const
+const std::vector<unsigned int>& MeshBuilder::GetIndicesData() const
 {
 	return m_indices;
 }
@@ -179,78 +481,167 @@ void MeshBuilder::ApplyScale(float scale)
 	m_isCPUMeshDirty = true;
 }
 
-
-void MeshBuilder::Save(const char* filepath)
+void MeshBuilder::Optimize(const mesh_optimize_options& optimizeOptions, std::vector<MeshOptimizeStats>* outStats)
 {
-	FileStream fileStream;
-	fileStream.OpenForWrite(filepath);
-	std::string numVerts = std::to_string(GetNumVertices());
-	fileStream.WriteBytes(numVerts.c_str(), sizeof(unsigned int));
-
-	size_t vertexDataSize = sizeof(m_vertices[0]) * GetNumVertices();
-	char* vertexData = new char[vertexDataSize];
-	memcpy(vertexData, m_vertices.data(), vertexDataSize);
-	fileStream.WriteBytes(vertexData, vertexDataSize);
-	delete[] vertexData;
-
-	std::string numIndices = std::to_string(GetNumIndices());
-	fileStream.WriteBytes(numIndices.c_str(), sizeof(unsigned int));
-
-	size_t indexDataSize = sizeof(m_indices[0]) * GetNumIndices();
-	char* indexData = new char[indexDataSize];
-	memcpy(indexData, m_indices.data(), indexDataSize);
-	fileStream.WriteBytes(indexData, indexDataSize);
-	delete[] indexData;
-
-	fileStream.Close();
+	//stats are for the full mesh, later lods only ride along
+	auto recordStage = [&](const char* stageName)
+		{
+			if (!outStats)
+				return;
+
+			if (m_lods.empty())
+			{
+				outStats->push_back(AnalyzeMesh(stageName, m_vertices, m_indices));
+			}
+			else
+			{
+				std::vector<unsigned int> fullMeshIndices(m_indices.begin(), m_indices.begin() + m_lods[0].m_numIndices);
+				outStats->push_back(AnalyzeMesh(stageName, m_vertices, fullMeshIndices));
+			}
+		};
+	//the reordering passes work on one lod's triangles at a time so lods never mix
+	auto optimizeEachLod = [&](auto optimizeFunction)
+		{
+			if (m_lods.empty())
+			{
+				optimizeFunction(m_indices);
+				return;
+			}
+
+			std::vector<unsigned int> lodIndices;
+			for (int lodIndex = 0; lodIndex < m_lods.size(); lodIndex++)
+			{
+				auto lodBegin = m_indices.begin() + m_lods[lodIndex].m_firstIndex;
+				lodIndices.assign(lodBegin, lodBegin + m_lods[lodIndex].m_numIndices);
+				optimizeFunction(lodIndices);
+				std::copy(lodIndices.begin(), lodIndices.end(), lodBegin);
+			}
+		};
+
+	recordStage("input");
+	if (optimizeOptions.m_quantizeAttributes)
+	{
+		QuantizeVertexAttributes(m_vertices, optimizeOptions.m_normalBits, optimizeOptions.m_uvBits);
+		recordStage("quantize");
+	}
+	if (optimizeOptions.m_deduplicateVertices || m_indices.empty())
+	{
+		DeduplicateVertices(m_vertices, m_indices);
+		recordStage("deduplicate");
+	}
+	if (optimizeOptions.m_optimizeVertexCache)
+	{
+		optimizeEachLod([&](std::vector<unsigned int>& indices) { OptimizeVertexCache(indices, GetNumVertices()); });
+		recordStage("vertex cache");
+	}
+	if (optimizeOptions.m_optimizeOverdraw)
+	{
+		optimizeEachLod([&](std::vector<unsigned int>& indices) { OptimizeOverdraw(indices, m_vertices, optimizeOptions.m_overdrawCacheThreshold); });
+		recordStage("overdraw");
+	}
+	if (optimizeOptions.m_optimizeVertexFetch)
+	{
+		OptimizeVertexFetch(m_vertices, m_indices);
+		recordStage("vertex fetch");
+	}
+
+	m_isCPUMeshDirty = true;
 }
 
-void MeshBuilder::Load(const char* filepath)
+void MeshBuilder::GenerateLods(const mesh_lod_options& lodOptions)
 {
-	FileStream fileStream;
-	fileStream.OpenForRead(filepath);
-	char* vertexCount = new char[sizeof(unsigned int)];
-	fileStream.ReadBytes(vertexCount, sizeof(unsigned int));
-	unsigned int verts = strtoul(vertexCount, nullptr, 0);
-	delete[] vertexCount;
-
-	size_t vertexDataSize = sizeof(Vertex_PNCU) * verts;
-	m_vertices.resize(verts);
-	char* vertexData = new char[vertexDataSize];
-	fileStream.ReadBytes(vertexData, vertexDataSize);
-	memcpy(m_vertices.data(), vertexData, vertexDataSize);
-	delete[] vertexData;
-
-	char* indexCount = new char[sizeof(unsigned int)];
-	fileStream.ReadBytes(indexCount, sizeof(unsigned int));
-	unsigned int indices = strtoul(indexCount, nullptr, 0);
-	delete[] indexCount;
-
-	size_t indexDataSize = sizeof(unsigned int) * indices;
-	m_indices.resize(indices);
-	char* indexData = new char[indexDataSize];
-	fileStream.ReadBytes(indexData, indexDataSize);
-	memcpy(m_indices.data(), indexData, indexDataSize);
-	delete[] indexData;
-
-	fileStream.Close();
+	//lods are appended after the full mesh in m_indices, regenerating starts over from the full mesh
+	if (!m_lods.empty())
+	{
+		m_indices.resize(m_lods[0].m_numIndices);
+	}
+	m_lods.clear();
+	if (m_indices.empty())
+		return;
+
+	MeshLod fullMeshLod;
+	fullMeshLod.m_numIndices = GetNumIndices();
+	m_lods.push_back(fullMeshLod);
+
+	//each lod is simplified from the one before it, which is much cheaper than starting from the full mesh every time.
+	//the errors of the steps add up, which keeps every lod's error an upper bound against the full mesh
+	float meshExtent = GetMeshExtent(m_vertices);
+	float relativeError = 0.f;
+	std::vector<unsigned int> sourceIndices(m_indices);
+	std::vector<unsigned int> lodIndices;
+	int numLods = lodOptions.m_numLods < MESH_MAX_LODS ? lodOptions.m_numLods : MESH_MAX_LODS;
+	for (int lodIndex = 1; lodIndex < numLods; lodIndex++)
+	{
+		unsigned int targetNumIndices = (unsigned int)((float)(sourceIndices.size() / 3) * lodOptions.m_triangleRatio) * 3;
+		float stepError = 0.f;
+		SimplifyMesh(lodIndices, m_vertices, sourceIndices, targetNumIndices, lodOptions.m_maxError - relativeError, lodOptions.m_lockBorders, &stepError);
+
+		//a lod that barely lost anything isn't worth its memory, and the next one won't do better
+		if (lodIndices.empty() || lodIndices.size() * 20 > sourceIndices.size() * 19)
+			break;
+
+		relativeError += stepError;
+		OptimizeVertexCache(lodIndices, GetNumVertices());
+		MeshLod lod;
+		lod.m_firstIndex = GetNumIndices();
+		lod.m_numIndices = (unsigned int)lodIndices.size();
+		lod.m_error = relativeError * meshExtent;
+		m_lods.push_back(lod);
+		m_indices.insert(m_indices.end(), lodIndices.begin(), lodIndices.end());
+		sourceIndices.swap(lodIndices);
+	}
+
+	if (m_lods.size() == 1)
+	{
+		m_lods.clear();
+	}
 	m_isCPUMeshDirty = true;
 }
 
-std::string MeshBuilder::MakeValuesStringFromTokens(const Strings& tokens)
+unsigned int MeshBuilder::GetNumLods() const
 {
-	std::string valueString;
-	//always ignore the first token, since it's the value type identifier token
-	for (int i = 1; i < tokens.size(); i++)
+	return m_lods.empty() ? 1 : (unsigned int)m_lods.size();
+}
+
+MeshLod MeshBuilder::GetLod(unsigned int lodIndex) const
+{
+	if (m_lods.empty())
 	{
-		//if token is non empty
-		if (tokens[i].size() > 0)
-		{
-			valueString.append(tokens[i]);
-			if (i != tokens.size() - 1)
-				valueString.append(",");
-		}
+		MeshLod fullMeshLod;
+		fullMeshLod.m_numIndices = GetNumIndices();
+		return fullMeshLod;
+	}
+	return m_lods[lodIndex];
+}
+
+bool MeshBuilder::Save(const char* filepath) const
+{
+	return WriteMeshFile(filepath, m_vertices.data(), GetNumVertices(), m_indices.data(), GetNumIndices(), m_lods.data(), (unsigned int)m_lods.size());
+}
+
+bool MeshBuilder::Load(const char* filepath)
+{
+	MeshFileView meshFile;
+	if (!meshFile.Open(filepath))
+		return false;
+
+	m_vertices.assign(meshFile.GetVertices(), meshFile.GetVertices() + meshFile.GetNumVertices());
+	if (meshFile.GetIndexStride() == sizeof(unsigned int))
+	{
+		const unsigned int* indices = (const unsigned int*)meshFile.GetIndexData();
+		m_indices.assign(indices, indices + meshFile.GetNumIndices());
+	}
+	else
+	{
+		const uint16_t* indices = (const uint16_t*)meshFile.GetIndexData();
+		m_indices.assign(indices, indices + meshFile.GetNumIndices());
 	}
 
-	return valueString;
+	m_lods.clear();
+	if (meshFile.GetNumLods() > 1)
+	{
+		m_lods.assign(&meshFile.GetLod(0), &meshFile.GetLod(0) + meshFile.GetNumLods());
+	}
+	m_isCPUMeshDirty = true;
+	return true;
 }
@@ -3,6 +3,12 @@
 #include "Engine/Core/Vertex_PNCU.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include "Engine/Renderer/MeshSimplifier.hpp"
+
+class JobSystem;
+
+constexpr size_t OBJ_IMPORT_MIN_CHUNK_BYTES = 1024 * 1024;		//smaller files aren't worth splitting across jobs
 
 struct mesh_import_options
 {
@@ -10,6 +16,7 @@ struct mesh_import_options
 	float m_scale = 1.f;
 	bool m_reverseWindingOrder = false;
 	bool m_invertV = false;	//if uv (0, 0) starts from top left instead of bot left
+	JobSystem* m_jobSystem = nullptr;	//parses big files in parallel when set
 };
 
 //is the CPU representation of the verts and indices, aka, CPU Mesh
@@ -19,10 +26,10 @@ public:
 	bool ImportFromOBJFile(const char* filepath, const mesh_import_options& importOptions);
 
 	unsigned int GetNumVertices() const;
-	const std::vector<Vertex_PNCU> GetVerticesData() const;
+	const std::vector<Vertex_PNCU>& GetVerticesData() const;
 	size_t GetSizeOfVertex() const;
 	unsigned int GetNumIndices() const;
-	const std::vector<unsigned int> GetIndicesData() const;
+	const std::vector<unsigned int>& GetIndicesData() const;
 	size_t GetSizeOfIndex() const;
 
 	bool IsCPUMeshDirty() const;
@@ -33,14 +40,23 @@ public:
 	void InvertV();
 	void ApplyScale(float scale);
 
-	void Save(const char* filepath);
-	void Load(const char* filepath);
+	//runs the enabled MeshOptimizer passes in order: quantize, dedup, vertex cache, overdraw, vertex fetch.
+	//outStats gets the input's stats followed by one entry per pass that ran
+	void Optimize(const mesh_optimize_options& optimizeOptions, std::vector<MeshOptimizeStats>* outStats = nullptr);
 
-private:
-	std::string MakeValuesStringFromTokens(const Strings& tokens);
+	//appends simplified lods after the full mesh's indices, every lod uses the same verts. optimizing afterwards keeps
+	//the lods, each one is reordered on its own
+	void GenerateLods(const mesh_lod_options& lodOptions);
+	unsigned int GetNumLods() const;
+	MeshLod GetLod(unsigned int lodIndex) const;		//lod 0 is the full mesh
+
+	//cooked binary mesh, see MeshFile.hpp. a Mesh can also be filled straight from a MeshFileView without a builder
+	bool Save(const char* filepath) const;
+	bool Load(const char* filepath);
 
 private:
 	std::vector<Vertex_PNCU> m_vertices;
 	std::vector<unsigned int> m_indices;
+	std::vector<MeshLod> m_lods;		//empty when the mesh has no lods
 	bool m_isCPUMeshDirty = false;
 };
\ No newline at end of file
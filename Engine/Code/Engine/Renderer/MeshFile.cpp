@@ -0,0 +1,166 @@
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Core/Vertex_PNCU.hpp"
+#include "Engine/Core/BinaryFileUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+constexpr uint64_t MESH_FILE_CHECKSUM_SEED = 0xcbf29ce484222325ull;
+constexpr int NUM_PNCU_ATTRIBUTES = 4;
+
+static const MeshVertexAttribute PNCU_ATTRIBUTES[NUM_PNCU_ATTRIBUTES] =
+{
+	{ MeshVertexSemantic::POSITION, MeshVertexFormat::FLOAT3, (uint16_t)offsetof(Vertex_PNCU, m_position) },
+	{ MeshVertexSemantic::NORMAL, MeshVertexFormat::FLOAT3, (uint16_t)offsetof(Vertex_PNCU, m_normal) },
+	{ MeshVertexSemantic::COLOR, MeshVertexFormat::RGBA8, (uint16_t)offsetof(Vertex_PNCU, m_color) },
+	{ MeshVertexSemantic::UV, MeshVertexFormat::FLOAT2, (uint16_t)offsetof(Vertex_PNCU, m_uvTexCoords) },
+};
+
+static uint64_t AlignMeshFileOffset(uint64_t offset)
+{
+	return (offset + MESH_FILE_SECTION_ALIGNMENT - 1) & ~(uint64_t)(MESH_FILE_SECTION_ALIGNMENT - 1);
+}
+
+bool MeshFileView::Open(const char* filepath, bool verifyChecksum)
+{
+	Close();
+	if (!m_mappedFile.Open(filepath, FileAccessPattern::SEQUENTIAL))
+		return false;
+
+	const uint8_t* fileData = m_mappedFile.GetData();
+	size_t fileSize = m_mappedFile.GetSize();
+	const MeshFileHeader* header = (const MeshFileHeader*)fileData;
+	if (fileSize < sizeof(MeshFileHeader) || header->m_fourCC != MESH_FILE_FOURCC || header->m_version != MESH_FILE_VERSION || header->m_headerSize != sizeof(MeshFileHeader))
+	{
+		ERROR_RECOVERABLE(Stringf("\"%s\" is not a mesh file of the current version", filepath));
+		Close();
+		return false;
+	}
+
+	//the renderer only has an input layout for Vertex_PNCU, so that is the only layout a view can hand out
+	bool isLayoutValid = header->m_vertexStride == sizeof(Vertex_PNCU) && header->m_numAttributes == NUM_PNCU_ATTRIBUTES &&
+		header->m_attributesOffset + sizeof(PNCU_ATTRIBUTES) <= fileSize &&
+		memcmp(fileData + header->m_attributesOffset, PNCU_ATTRIBUTES, sizeof(PNCU_ATTRIBUTES)) == 0;
+	unsigned int expectedIndexStride = (header->m_flags & MESH_FILE_FLAG_16_BIT_INDICES) ? 2 : 4;
+	uint64_t lodsSize = (uint64_t)header->m_numLods * sizeof(MeshLod);
+	uint64_t vertexDataSize = (uint64_t)header->m_numVertices * header->m_vertexStride;
+	uint64_t indexDataSize = (uint64_t)header->m_numIndices * header->m_indexStride;
+	bool areSectionsValid = header->m_fileSize == fileSize && header->m_indexStride == expectedIndexStride &&
+		header->m_numLods > 0 && header->m_lodsOffset % MESH_FILE_SECTION_ALIGNMENT == 0 && header->m_lodsOffset + lodsSize <= header->m_vertexDataOffset &&
+		header->m_vertexDataOffset % MESH_FILE_SECTION_ALIGNMENT == 0 && header->m_indexDataOffset % MESH_FILE_SECTION_ALIGNMENT == 0 &&
+		header->m_vertexDataOffset + vertexDataSize <= header->m_indexDataOffset && header->m_indexDataOffset + indexDataSize <= fileSize;
+	for (unsigned int lodIndex = 0; areSectionsValid && lodIndex < header->m_numLods; lodIndex++)
+	{
+		const MeshLod& lod = ((const MeshLod*)(fileData + header->m_lodsOffset))[lodIndex];
+		areSectionsValid = (uint64_t)lod.m_firstIndex + lod.m_numIndices <= header->m_numIndices;
+	}
+	if (!isLayoutValid || !areSectionsValid)
+	{
+		ERROR_RECOVERABLE(Stringf("Mesh file \"%s\" is malformed or has an unsupported vertex layout", filepath));
+		Close();
+		return false;
+	}
+
+	if (verifyChecksum)
+	{
+		uint64_t checksum = MESH_FILE_CHECKSUM_SEED;
+		checksum = ComputeFileChecksum(fileData + header->m_attributesOffset, sizeof(PNCU_ATTRIBUTES), checksum);
+		checksum = ComputeFileChecksum(fileData + header->m_lodsOffset, (size_t)lodsSize, checksum);
+		checksum = ComputeFileChecksum(fileData + header->m_vertexDataOffset, (size_t)vertexDataSize, checksum);
+		checksum = ComputeFileChecksum(fileData + header->m_indexDataOffset, (size_t)indexDataSize, checksum);
+		if (checksum != header->m_checksum)
+		{
+			ERROR_RECOVERABLE(Stringf("Mesh file \"%s\" failed its checksum", filepath));
+			Close();
+			return false;
+		}
+	}
+
+	m_header = header;
+	m_lods = (const MeshLod*)(fileData + header->m_lodsOffset);
+	m_vertices = (const Vertex_PNCU*)(fileData + header->m_vertexDataOffset);
+	m_indexData = fileData + header->m_indexDataOffset;
+	return true;
+}
+
+void MeshFileView::Close()
+{
+	m_mappedFile.Close();
+	m_header = nullptr;
+	m_lods = nullptr;
+	m_vertices = nullptr;
+	m_indexData = nullptr;
+}
+
+unsigned int MeshFileView::GetIndex(unsigned int indexNumber) const
+{
+	if (m_header->m_indexStride == 2)
+		return ((const uint16_t*)m_indexData)[indexNumber];
+
+	return ((const uint32_t*)m_indexData)[indexNumber];
+}
+
+bool WriteMeshFile(const char* filepath, const Vertex_PNCU* vertices, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices,
+	const MeshLod* lods, unsigned int numLods)
+{
+	MeshLod fullMeshLod;
+	fullMeshLod.m_numIndices = numIndices;
+	if (numLods == 0)
+	{
+		lods = &fullMeshLod;
+		numLods = 1;
+	}
+
+	MeshFileHeader header;
+	header.m_numVertices = numVertices;
+	header.m_numIndices = numIndices;
+	header.m_vertexStride = (uint16_t)sizeof(Vertex_PNCU);
+	header.m_numAttributes = (uint16_t)NUM_PNCU_ATTRIBUTES;
+	header.m_numLods = numLods;
+
+	//16 bit indices whenever the mesh is small enough for every index to fit
+	std::vector<uint16_t> shortIndices;
+	const void* indexData = indices;
+	if (numVertices <= 0x10000)
+	{
+		header.m_flags |= MESH_FILE_FLAG_16_BIT_INDICES;
+		header.m_indexStride = 2;
+		shortIndices.resize(numIndices);
+		for (unsigned int i = 0; i < numIndices; i++)
+		{
+			GUARANTEE_OR_DIE(indices[i] < numVertices, Stringf("Mesh index %u is out of range while writing \"%s\"", indices[i], filepath));
+			shortIndices[i] = (uint16_t)indices[i];
+		}
+		indexData = shortIndices.data();
+	}
+	else
+	{
+		header.m_indexStride = 4;
+	}
+
+	size_t lodsSize = (size_t)numLods * sizeof(MeshLod);
+	size_t vertexDataSize = (size_t)numVertices * sizeof(Vertex_PNCU);
+	size_t indexDataSize = (size_t)numIndices * header.m_indexStride;
+	header.m_attributesOffset = AlignMeshFileOffset(sizeof(MeshFileHeader));
+	header.m_lodsOffset = AlignMeshFileOffset(header.m_attributesOffset + sizeof(PNCU_ATTRIBUTES));
+	header.m_vertexDataOffset = AlignMeshFileOffset(header.m_lodsOffset + lodsSize);
+	header.m_indexDataOffset = AlignMeshFileOffset(header.m_vertexDataOffset + vertexDataSize);
+	header.m_fileSize = header.m_indexDataOffset + indexDataSize;
+
+	header.m_checksum = MESH_FILE_CHECKSUM_SEED;
+	header.m_checksum = ComputeFileChecksum(PNCU_ATTRIBUTES, sizeof(PNCU_ATTRIBUTES), header.m_checksum);
+	header.m_checksum = ComputeFileChecksum(lods, lodsSize, header.m_checksum);
+	header.m_checksum = ComputeFileChecksum(vertices, vertexDataSize, header.m_checksum);
+	header.m_checksum = ComputeFileChecksum(indexData, indexDataSize, header.m_checksum);
+
+	SectionedFileWriter fileWriter;
+	fileWriter.Open(filepath);
+	fileWriter.WriteSection(0, &header, sizeof(header));
+	fileWriter.WriteSection(header.m_attributesOffset, PNCU_ATTRIBUTES, sizeof(PNCU_ATTRIBUTES));
+	fileWriter.WriteSection(header.m_lodsOffset, lods, lodsSize);
+	fileWriter.WriteSection(header.m_vertexDataOffset, vertices, vertexDataSize);
+	fileWriter.WriteSection(header.m_indexDataOffset, indexData, indexDataSize);
+	return fileWriter.Close();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include "Engine/Core/FileUtils.hpp"
+
+struct Vertex_PNCU;
+
+constexpr uint32_t MESH_FILE_FOURCC = 0x4853454d;		//"MESH"
+constexpr uint16_t MESH_FILE_VERSION = 2;
+constexpr size_t MESH_FILE_SECTION_ALIGNMENT = 16;		//every section starts aligned so it can be used in place from a mapping
+
+enum MeshFileFlags : uint16_t
+{
+	MESH_FILE_FLAG_NONE = 0,
+	MESH_FILE_FLAG_16_BIT_INDICES = 1 << 0,		//set when every index fits, halves the index data
+};
+
+enum class MeshVertexSemantic : uint8_t
+{
+	POSITION,
+	NORMAL,
+	COLOR,
+	UV
+};
+
+enum class MeshVertexFormat : uint8_t
+{
+	FLOAT2,
+	FLOAT3,
+	RGBA8
+};
+
+struct MeshVertexAttribute
+{
+	MeshVertexSemantic m_semantic = MeshVertexSemantic::POSITION;
+	MeshVertexFormat m_format = MeshVertexFormat::FLOAT3;
+	uint16_t m_offset = 0;
+};
+
+//one level of detail, a range of the shared index data that uses the shared vertices. error is how far the lod
+//strays from the full mesh, in mesh units
+struct MeshLod
+{
+	uint32_t m_firstIndex = 0;
+	uint32_t m_numIndices = 0;
+	float m_error = 0.f;
+	uint32_t m_reserved = 0;
+};
+static_assert(sizeof(MeshLod) == 16, "MeshLod layout changed, bump MESH_FILE_VERSION");
+
+//little endian, sections follow in this order: attributes, lods, vertices, indices
+struct MeshFileHeader
+{
+	uint32_t m_fourCC = MESH_FILE_FOURCC;
+	uint16_t m_version = MESH_FILE_VERSION;
+	uint16_t m_headerSize = (uint16_t)sizeof(MeshFileHeader);
+	uint32_t m_numVertices = 0;
+	uint32_t m_numIndices = 0;
+	uint16_t m_vertexStride = 0;
+	uint16_t m_indexStride = 0;
+	uint16_t m_numAttributes = 0;
+	uint16_t m_flags = MESH_FILE_FLAG_NONE;
+	uint64_t m_attributesOffset = 0;
+	uint64_t m_vertexDataOffset = 0;
+	uint64_t m_indexDataOffset = 0;
+	uint64_t m_fileSize = 0;
+	uint64_t m_checksum = 0;			//over the attribute, lod, vertex and index sections
+	uint32_t m_numLods = 0;
+	uint32_t m_reserved = 0;
+	uint64_t m_lodsOffset = 0;
+};
+static_assert(sizeof(MeshFileHeader) == 80, "MeshFileHeader layout changed, bump MESH_FILE_VERSION");
+
+//a cooked mesh used straight out of a memory mapping. nothing is parsed or copied, the vertex and index pointers
+//point into the mapped file and stay valid until the view is closed
+class MeshFileView
+{
+public:
+	bool Open(const char* filepath, bool verifyChecksum = true);
+	void Close();
+	bool IsOpen() const { return m_mappedFile.IsOpen(); }
+
+	const MeshFileHeader& GetHeader() const { return *m_header; }
+	unsigned int GetNumVertices() const { return m_header->m_numVertices; }
+	unsigned int GetNumIndices() const { return m_header->m_numIndices; }
+	const Vertex_PNCU* GetVertices() const { return m_vertices; }
+	const void* GetIndexData() const { return m_indexData; }
+	unsigned int GetIndexStride() const { return m_header->m_indexStride; }		//2 or 4 bytes
+	unsigned int GetIndex(unsigned int indexNumber) const;
+	unsigned int GetNumLods() const { return m_header->m_numLods; }		//at least 1, lod 0 is the full mesh
+	const MeshLod& GetLod(unsigned int lodIndex) const { return m_lods[lodIndex]; }
+
+private:
+	MappedFile m_mappedFile;
+	const MeshFileHeader* m_header = nullptr;
+	const MeshLod* m_lods = nullptr;
+	const Vertex_PNCU* m_vertices = nullptr;
+	const void* m_indexData = nullptr;
+};
+
+//without lods the whole index data is written as lod 0
+bool WriteMeshFile(const char* filepath, const Vertex_PNCU* vertices, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices,
+	const MeshLod* lods = nullptr, unsigned int numLods = 0);
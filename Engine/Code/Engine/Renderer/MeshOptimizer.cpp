@@ -0,0 +1,406 @@
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+constexpr unsigned int INVALID_MESH_INDEX = 0xFFFFFFFF;
+constexpr int FORSYTH_MAX_VALENCE_SCORES = 64;
+
+MeshOptimizeStats AnalyzeMesh(const char* stageName, const std::vector<Vertex_PNCU>& vertices, const std::vector<unsigned int>& indices)
+{
+	MeshOptimizeStats stats;
+	stats.m_stageName = stageName;
+	stats.m_numVertices = (unsigned int)vertices.size();
+	stats.m_numIndices = (unsigned int)indices.size();
+	if (indices.size() < 3)
+		return stats;
+
+	//fifo post transform cache: a vertex is a hit if it went into the cache less than a cache size of misses ago
+	std::vector<unsigned int> cacheTimestamps(vertices.size(), 0);
+	std::vector<unsigned int> isReferenced(vertices.size(), 0);
+	uint64_t fetchCacheTags[MESH_OPTIMIZER_FETCH_CACHE_LINES];
+	memset(fetchCacheTags, 0xFF, sizeof(fetchCacheTags));
+	unsigned int timestamp = MESH_OPTIMIZER_FIFO_CACHE_SIZE + 1;
+	unsigned int numTransformed = 0;
+	unsigned int numUnique = 0;
+	size_t numBytesFetched = 0;
+	for (int i = 0; i < indices.size(); i++)
+	{
+		unsigned int vertexIndex = indices[i];
+		if (!isReferenced[vertexIndex])
+		{
+			isReferenced[vertexIndex] = 1;
+			numUnique++;
+		}
+		if (timestamp - cacheTimestamps[vertexIndex] <= MESH_OPTIMIZER_FIFO_CACHE_SIZE)
+			continue;
+
+		cacheTimestamps[vertexIndex] = timestamp++;
+		numTransformed++;
+
+		//a transformed vertex is read from memory through a small direct mapped cache of lines
+		uint64_t firstByte = (uint64_t)vertexIndex * sizeof(Vertex_PNCU);
+		uint64_t lastByte = firstByte + sizeof(Vertex_PNCU) - 1;
+		for (uint64_t line = firstByte / MESH_OPTIMIZER_FETCH_LINE_BYTES; line <= lastByte / MESH_OPTIMIZER_FETCH_LINE_BYTES; line++)
+		{
+			uint64_t& tag = fetchCacheTags[line % MESH_OPTIMIZER_FETCH_CACHE_LINES];
+			if (tag != line)
+			{
+				tag = line;
+				numBytesFetched += MESH_OPTIMIZER_FETCH_LINE_BYTES;
+			}
+		}
+	}
+
+	stats.m_acmr = (float)numTransformed / (float)(indices.size() / 3);
+	stats.m_atvr = (float)numTransformed / (float)numUnique;
+	stats.m_overfetch = (float)numBytesFetched / (float)(numUnique * sizeof(Vertex_PNCU));
+	return stats;
+}
+
+void DeduplicateVertices(std::vector<Vertex_PNCU>& vertices, std::vector<unsigned int>& indices)
+{
+	//an unindexed stream becomes indexed here
+	if (indices.empty())
+	{
+		indices.resize(vertices.size());
+		for (unsigned int i = 0; i < (unsigned int)vertices.size(); i++)
+		{
+			indices[i] = i;
+		}
+	}
+
+	//open addressing on the raw vertex bytes, Vertex_PNCU has no padding so equal bytes means equal vertex
+	size_t capacity = 64;
+	while (capacity < vertices.size() * 2)
+	{
+		capacity *= 2;
+	}
+	std::vector<unsigned int> table(capacity, INVALID_MESH_INDEX);
+	std::vector<unsigned int> remap(vertices.size());
+	unsigned int numUniqueVertices = 0;
+	for (unsigned int i = 0; i < (unsigned int)vertices.size(); i++)
+	{
+		uint32_t words[sizeof(Vertex_PNCU) / 4];
+		memcpy(words, &vertices[i], sizeof(words));
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (int wordIndex = 0; wordIndex < sizeof(words) / 4; wordIndex++)
+		{
+			hash = (hash ^ words[wordIndex]) * 0x100000001b3ull;
+		}
+
+		size_t slot = (size_t)(hash ^ (hash >> 32)) & (capacity - 1);
+		while (table[slot] != INVALID_MESH_INDEX && memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex_PNCU)) != 0)
+		{
+			slot = (slot + 1) & (capacity - 1);
+		}
+		if (table[slot] == INVALID_MESH_INDEX)
+		{
+			//compacting in place is safe, a unique vertex only ever moves down over ones already looked at
+			table[slot] = numUniqueVertices;
+			vertices[numUniqueVertices] = vertices[i];
+			numUniqueVertices++;
+		}
+		remap[i] = table[slot];
+	}
+
+	vertices.resize(numUniqueVertices);
+	for (int i = 0; i < indices.size(); i++)
+	{
+		indices[i] = remap[indices[i]];
+	}
+}
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int numVertices)
+{
+	//tom forsyth's linear speed vertex cache optimization: greedily emit the triangle whose verts score highest, where
+	//a vert scores for being recently used and for having few triangles left (so it can leave the cache for good)
+	size_t numTriangles = indices.size() / 3;
+	if (numTriangles == 0)
+		return;
+
+	float cacheScores[MESH_OPTIMIZER_LRU_CACHE_SIZE];
+	for (int i = 0; i < MESH_OPTIMIZER_LRU_CACHE_SIZE; i++)
+	{
+		//the last triangle's verts get a fixed score so the next triangle doesn't just reuse the same edge
+		cacheScores[i] = i < 3 ? 0.75f : powf(1.f - (float)(i - 3) / (float)(MESH_OPTIMIZER_LRU_CACHE_SIZE - 3), 1.5f);
+	}
+	float valenceScores[FORSYTH_MAX_VALENCE_SCORES];
+	valenceScores[0] = 0.f;
+	for (int i = 1; i < FORSYTH_MAX_VALENCE_SCORES; i++)
+	{
+		valenceScores[i] = 2.f / sqrtf((float)i);
+	}
+	auto getVertexScore = [&](int cachePosition, unsigned int numTrianglesLeft) -> float
+		{
+			if (numTrianglesLeft == 0)
+				return -1.f;
+			float score = cachePosition >= 0 ? cacheScores[cachePosition] : 0.f;
+			return score + (numTrianglesLeft < FORSYTH_MAX_VALENCE_SCORES ? valenceScores[numTrianglesLeft] : 2.f / sqrtf((float)numTrianglesLeft));
+		};
+
+	//triangles per vertex, packed
+	std::vector<unsigned int> numTrianglesLeft(numVertices, 0);
+	for (int i = 0; i < indices.size(); i++)
+	{
+		numTrianglesLeft[indices[i]]++;
+	}
+	std::vector<unsigned int> adjacencyOffsets(numVertices + 1, 0);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		adjacencyOffsets[i + 1] = adjacencyOffsets[i] + numTrianglesLeft[i];
+	}
+	std::vector<unsigned int> adjacentTriangles(indices.size());
+	std::vector<unsigned int> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (unsigned int i = 0; i < (unsigned int)indices.size(); i++)
+	{
+		adjacentTriangles[adjacencyFill[indices[i]]++] = i / 3;
+	}
+
+	std::vector<int> cachePositions(numVertices, -1);
+	std::vector<float> vertexScores(numVertices);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		vertexScores[i] = getVertexScore(-1, numTrianglesLeft[i]);
+	}
+	std::vector<float> triangleScores(numTriangles);
+	std::vector<unsigned char> isEmitted(numTriangles, 0);
+	unsigned int bestTriangle = INVALID_MESH_INDEX;
+	float bestScore = -1.f;
+	for (size_t i = 0; i < numTriangles; i++)
+	{
+		triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+		if (triangleScores[i] > bestScore)
+		{
+			bestScore = triangleScores[i];
+			bestTriangle = (unsigned int)i;
+		}
+	}
+
+	std::vector<unsigned int> newIndices;
+	newIndices.reserve(indices.size());
+	unsigned int cache[MESH_OPTIMIZER_LRU_CACHE_SIZE + 3];
+	unsigned int newCache[MESH_OPTIMIZER_LRU_CACHE_SIZE + 3];
+	int cacheSize = 0;
+	size_t nextUnemittedTriangle = 0;
+	for (size_t numEmitted = 0; numEmitted < numTriangles; numEmitted++)
+	{
+		//nothing in the cache has triangles left, restart from the first triangle not emitted yet
+		if (bestTriangle == INVALID_MESH_INDEX)
+		{
+			while (isEmitted[nextUnemittedTriangle])
+			{
+				nextUnemittedTriangle++;
+			}
+			bestTriangle = (unsigned int)nextUnemittedTriangle;
+		}
+
+		const unsigned int* triangle = &indices[bestTriangle * 3];
+		isEmitted[bestTriangle] = 1;
+		newIndices.push_back(triangle[0]);
+		newIndices.push_back(triangle[1]);
+		newIndices.push_back(triangle[2]);
+
+		int newCacheSize = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int vertexIndex = triangle[corner];
+			unsigned int* adjacency = &adjacentTriangles[adjacencyOffsets[vertexIndex]];
+			unsigned int numAdjacent = numTrianglesLeft[vertexIndex];
+			for (unsigned int i = 0; i < numAdjacent; i++)
+			{
+				if (adjacency[i] == bestTriangle)
+				{
+					adjacency[i] = adjacency[numAdjacent - 1];
+					break;
+				}
+			}
+			numTrianglesLeft[vertexIndex]--;
+			newCache[newCacheSize++] = vertexIndex;
+		}
+		for (int i = 0; i < cacheSize; i++)
+		{
+			unsigned int vertexIndex = cache[i];
+			if (vertexIndex != triangle[0] && vertexIndex != triangle[1] && vertexIndex != triangle[2])
+			{
+				newCache[newCacheSize++] = vertexIndex;
+			}
+		}
+
+		//rescore every vert that is or just was in the cache, and pick the next triangle from their neighbours
+		bestTriangle = INVALID_MESH_INDEX;
+		bestScore = -1.f;
+		for (int i = 0; i < newCacheSize; i++)
+		{
+			unsigned int vertexIndex = newCache[i];
+			cachePositions[vertexIndex] = i < MESH_OPTIMIZER_LRU_CACHE_SIZE ? i : -1;
+			float newScore = getVertexScore(cachePositions[vertexIndex], numTrianglesLeft[vertexIndex]);
+			float scoreChange = newScore - vertexScores[vertexIndex];
+			vertexScores[vertexIndex] = newScore;
+
+			const unsigned int* adjacency = &adjacentTriangles[adjacencyOffsets[vertexIndex]];
+			for (unsigned int adjacentIndex = 0; adjacentIndex < numTrianglesLeft[vertexIndex]; adjacentIndex++)
+			{
+				unsigned int triangleIndex = adjacency[adjacentIndex];
+				triangleScores[triangleIndex] += scoreChange;
+				if (triangleScores[triangleIndex] > bestScore)
+				{
+					bestScore = triangleScores[triangleIndex];
+					bestTriangle = triangleIndex;
+				}
+			}
+		}
+
+		cacheSize = newCacheSize < MESH_OPTIMIZER_LRU_CACHE_SIZE ? newCacheSize : MESH_OPTIMIZER_LRU_CACHE_SIZE;
+		memcpy(cache, newCache, cacheSize * sizeof(unsigned int));
+	}
+
+	indices.swap(newIndices);
+}
+
+struct OverdrawCluster
+{
+	unsigned int m_firstTriangle = 0;
+	unsigned int m_numTriangles = 0;
+	float m_sortKey = 0.f;
+};
+
+void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex_PNCU>& vertices, float cacheThreshold)
+{
+	//cut the cache friendly order into clusters, then draw the clusters that face outwards from the middle of the mesh
+	//first since they are the ones most likely to occlude the rest. a cluster is closed as soon as drawing it from a
+	//cold cache stays within the allowed acmr, so any cluster order costs about threshold times the original acmr
+	size_t numTriangles = indices.size() / 3;
+	if (numTriangles < 2)
+		return;
+
+	float originalACMR = AnalyzeMesh("", vertices, indices).m_acmr;
+	float clusterACMRLimit = originalACMR * cacheThreshold;
+	std::vector<OverdrawCluster> clusters;
+	std::vector<unsigned int> cacheTimestamps(vertices.size(), 0);
+	unsigned int timestamp = MESH_OPTIMIZER_FIFO_CACHE_SIZE + 1;
+	unsigned int numClusterMisses = 0;
+	for (unsigned int triangleIndex = 0; triangleIndex < (unsigned int)numTriangles; triangleIndex++)
+	{
+		if (clusters.empty() || (clusters.back().m_numTriangles > 0 && (float)numClusterMisses <= clusterACMRLimit * (float)clusters.back().m_numTriangles))
+		{
+			OverdrawCluster cluster;
+			cluster.m_firstTriangle = triangleIndex;
+			clusters.push_back(cluster);
+			numClusterMisses = 0;
+			timestamp += MESH_OPTIMIZER_FIFO_CACHE_SIZE + 1;
+		}
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int vertexIndex = indices[triangleIndex * 3 + corner];
+			if (timestamp - cacheTimestamps[vertexIndex] > MESH_OPTIMIZER_FIFO_CACHE_SIZE)
+			{
+				cacheTimestamps[vertexIndex] = timestamp++;
+				numClusterMisses++;
+			}
+		}
+		clusters.back().m_numTriangles++;
+	}
+	if (clusters.size() < 2)
+		return;
+
+	Vec3 meshCentroid;
+	float meshArea = 0.f;
+	std::vector<Vec3> clusterCentroids(clusters.size());
+	std::vector<Vec3> clusterNormals(clusters.size());
+	for (int clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+	{
+		const OverdrawCluster& cluster = clusters[clusterIndex];
+		float clusterArea = 0.f;
+		for (unsigned int triangleIndex = cluster.m_firstTriangle; triangleIndex < cluster.m_firstTriangle + cluster.m_numTriangles; triangleIndex++)
+		{
+			const Vec3& a = vertices[indices[triangleIndex * 3]].m_position;
+			const Vec3& b = vertices[indices[triangleIndex * 3 + 1]].m_position;
+			const Vec3& c = vertices[indices[triangleIndex * 3 + 2]].m_position;
+			Vec3 areaNormal = CrossProduct3D(b - a, c - a);
+			float area = areaNormal.GetLength();
+			clusterNormals[clusterIndex] += areaNormal;
+			clusterCentroids[clusterIndex] += (a + b + c) * (area / 3.f);
+			clusterArea += area;
+		}
+		meshCentroid += clusterCentroids[clusterIndex];
+		meshArea += clusterArea;
+		if (clusterArea > 0.f)
+		{
+			clusterCentroids[clusterIndex] /= clusterArea;
+		}
+	}
+	if (meshArea <= 0.f)
+		return;
+	meshCentroid /= meshArea;
+
+	for (int clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+	{
+		float normalLength = clusterNormals[clusterIndex].GetLength();
+		Vec3 normal = normalLength > 0.f ? clusterNormals[clusterIndex] / normalLength : Vec3();
+		clusters[clusterIndex].m_sortKey = DotProduct3D(clusterCentroids[clusterIndex] - meshCentroid, normal);
+	}
+	std::sort(clusters.begin(), clusters.end(), [](const OverdrawCluster& a, const OverdrawCluster& b)
+		{
+			if (a.m_sortKey != b.m_sortKey)
+				return a.m_sortKey > b.m_sortKey;
+			return a.m_firstTriangle < b.m_firstTriangle;
+		});
+
+	std::vector<unsigned int> newIndices;
+	newIndices.reserve(indices.size());
+	for (int clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+	{
+		const OverdrawCluster& cluster = clusters[clusterIndex];
+		newIndices.insert(newIndices.end(), indices.begin() + cluster.m_firstTriangle * 3, indices.begin() + (cluster.m_firstTriangle + cluster.m_numTriangles) * 3);
+	}
+
+	//keep the old order if the reorder costs more vertex cache than allowed
+	if (AnalyzeMesh("", vertices, newIndices).m_acmr <= originalACMR * cacheThreshold)
+	{
+		indices.swap(newIndices);
+	}
+}
+
+void OptimizeVertexFetch(std::vector<Vertex_PNCU>& vertices, std::vector<unsigned int>& indices)
+{
+	//verts are renumbered in the order the index buffer first touches them, unreferenced verts are dropped
+	if (indices.empty())
+		return;
+
+	std::vector<unsigned int> remap(vertices.size(), INVALID_MESH_INDEX);
+	std::vector<Vertex_PNCU> newVertices;
+	newVertices.reserve(vertices.size());
+	for (int i = 0; i < indices.size(); i++)
+	{
+		unsigned int& newIndex = remap[indices[i]];
+		if (newIndex == INVALID_MESH_INDEX)
+		{
+			newIndex = (unsigned int)newVertices.size();
+			newVertices.push_back(vertices[indices[i]]);
+		}
+		indices[i] = newIndex;
+	}
+	vertices.swap(newVertices);
+}
+
+void QuantizeVertexAttributes(std::vector<Vertex_PNCU>& vertices, int normalBits, int uvBits)
+{
+	//the renderer only has a float Vertex_PNCU layout, so values are snapped to what a packed format would hold
+	//rather than stored packed. normals become snorm with normalBits, uvs a fixed point grid with uvBits of fraction
+	float normalScale = (float)((1 << (normalBits - 1)) - 1);
+	float uvScale = (float)(1 << uvBits);
+	for (int i = 0; i < vertices.size(); i++)
+	{
+		Vec3& normal = vertices[i].m_normal;
+		normal.x = roundf(Clamp(normal.x, -1.f, 1.f) * normalScale) / normalScale;
+		normal.y = roundf(Clamp(normal.y, -1.f, 1.f) * normalScale) / normalScale;
+		normal.z = roundf(Clamp(normal.z, -1.f, 1.f) * normalScale) / normalScale;
+		Vec2& uv = vertices[i].m_uvTexCoords;
+		uv.x = roundf(uv.x * uvScale) / uvScale;
+		uv.y = roundf(uv.y * uvScale) / uvScale;
+	}
+}
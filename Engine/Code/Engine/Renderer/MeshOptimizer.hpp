@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Core/Vertex_PNCU.hpp"
+
+constexpr int MESH_OPTIMIZER_FIFO_CACHE_SIZE = 16;		//post transform cache the stats are measured against
+constexpr int MESH_OPTIMIZER_LRU_CACHE_SIZE = 32;		//cache the reordering optimizes for
+constexpr int MESH_OPTIMIZER_FETCH_LINE_BYTES = 64;
+constexpr int MESH_OPTIMIZER_FETCH_CACHE_LINES = 256;
+
+struct mesh_optimize_options
+{
+	bool m_deduplicateVertices = true;
+	bool m_optimizeVertexCache = true;
+	bool m_optimizeOverdraw = true;
+	float m_overdrawCacheThreshold = 1.05f;		//how much acmr the overdraw pass may give back, 1.05 = 5% worse at most
+	bool m_optimizeVertexFetch = true;
+	bool m_quantizeAttributes = false;			//snaps normals and uvs to a grid so identical looking verts merge
+	int m_normalBits = 10;
+	int m_uvBits = 16;
+};
+
+//cpu side stand in for gpu counters. acmr is transformed verts per triangle (0.5 is ideal for a regular grid, 3 is
+//the worst), atvr is transformed verts per unique vert (1 is ideal), overfetch is bytes pulled from memory per
+//vertex byte (1 is ideal)
+struct MeshOptimizeStats
+{
+	std::string m_stageName;
+	unsigned int m_numVertices = 0;
+	unsigned int m_numIndices = 0;
+	float m_acmr = 0.f;
+	float m_atvr = 0.f;
+	float m_overfetch = 0.f;
+};
+
+MeshOptimizeStats AnalyzeMesh(const char* stageName, const std::vector<Vertex_PNCU>& vertices, const std::vector<unsigned int>& indices);
+
+void DeduplicateVertices(std::vector<Vertex_PNCU>& vertices, std::vector<unsigned int>& indices);
+void OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int numVertices);
+void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex_PNCU>& vertices, float cacheThreshold);
+void OptimizeVertexFetch(std::vector<Vertex_PNCU>& vertices, std::vector<unsigned int>& indices);
+void QuantizeVertexAttributes(std::vector<Vertex_PNCU>& vertices, int normalBits, int uvBits);
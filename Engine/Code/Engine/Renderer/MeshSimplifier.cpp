@@ -0,0 +1,569 @@
+#include "Engine/Renderer/MeshSimplifier.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+constexpr unsigned int INVALID_SIMPLIFY_INDEX = 0xFFFFFFFF;
+constexpr uint64_t EMPTY_SIMPLIFY_EDGE = 0xFFFFFFFFFFFFFFFFull;
+constexpr float BORDER_QUADRIC_WEIGHT = 10.f;		//how much harder it is to move an open edge sideways than a surface off its plane
+constexpr float PASS_ERROR_LIMIT_SCALE = 1.5f;
+
+//what a position class is allowed to collapse along. borders and seams may only slide along themselves so the
+//outline and the uv/normal splits stay where they are, anything more tangled than that never moves
+enum class SimplifyVertexKind : uint8_t
+{
+	MANIFOLD,
+	BORDER,
+	SEAM,
+	LOCKED
+};
+
+struct Quadric
+{
+	float m_a00 = 0.f;
+	float m_a11 = 0.f;
+	float m_a22 = 0.f;
+	float m_a01 = 0.f;
+	float m_a02 = 0.f;
+	float m_a12 = 0.f;
+	float m_b0 = 0.f;
+	float m_b1 = 0.f;
+	float m_b2 = 0.f;
+	float m_c = 0.f;
+	float m_weight = 0.f;
+
+	void AddPlane(const Vec3& normal, float distance, float weight)
+	{
+		m_a00 += normal.x * normal.x * weight;
+		m_a11 += normal.y * normal.y * weight;
+		m_a22 += normal.z * normal.z * weight;
+		m_a01 += normal.x * normal.y * weight;
+		m_a02 += normal.x * normal.z * weight;
+		m_a12 += normal.y * normal.z * weight;
+		m_b0 += normal.x * distance * weight;
+		m_b1 += normal.y * distance * weight;
+		m_b2 += normal.z * distance * weight;
+		m_c += distance * distance * weight;
+		m_weight += weight;
+	}
+
+	void Add(const Quadric& other)
+	{
+		m_a00 += other.m_a00;
+		m_a11 += other.m_a11;
+		m_a22 += other.m_a22;
+		m_a01 += other.m_a01;
+		m_a02 += other.m_a02;
+		m_a12 += other.m_a12;
+		m_b0 += other.m_b0;
+		m_b1 += other.m_b1;
+		m_b2 += other.m_b2;
+		m_c += other.m_c;
+		m_weight += other.m_weight;
+	}
+
+	//area weighted mean squared distance from the position to the quadric's planes
+	float GetError(const Vec3& p) const
+	{
+		if (m_weight <= 0.f)
+			return 0.f;
+
+		float error = m_a00 * p.x * p.x + m_a11 * p.y * p.y + m_a22 * p.z * p.z +
+			2.f * (m_a01 * p.x * p.y + m_a02 * p.x * p.z + m_a12 * p.y * p.z) +
+			2.f * (m_b0 * p.x + m_b1 * p.y + m_b2 * p.z) + m_c;
+		return fabsf(error) / m_weight;
+	}
+};
+
+struct SimplifyCollapse
+{
+	unsigned int m_source = 0;
+	unsigned int m_target = 0;
+	float m_error = 0.f;
+};
+
+//open addressing set of directed edges, used once to tell borders and seams apart
+class SimplifyEdgeSet
+{
+public:
+	explicit SimplifyEdgeSet(size_t numEdges)
+	{
+		size_t capacity = 64;
+		while (capacity < numEdges * 2)
+		{
+			capacity *= 2;
+		}
+		m_keys.assign(capacity, EMPTY_SIMPLIFY_EDGE);
+	}
+
+	void Insert(unsigned int from, unsigned int to)
+	{
+		uint64_t key = ((uint64_t)from << 32) | to;
+		m_keys[GetSlot(key)] = key;
+	}
+
+	bool Contains(unsigned int from, unsigned int to) const
+	{
+		uint64_t key = ((uint64_t)from << 32) | to;
+		return m_keys[GetSlot(key)] == key;
+	}
+
+private:
+	size_t GetSlot(uint64_t key) const
+	{
+		size_t mask = m_keys.size() - 1;
+		uint64_t hash = (key ^ (key >> 33)) * 0xff51afd7ed558ccdull;
+		hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ull;
+		size_t slot = (size_t)(hash ^ (hash >> 33)) & mask;
+		while (m_keys[slot] != EMPTY_SIMPLIFY_EDGE && m_keys[slot] != key)
+		{
+			slot = (slot + 1) & mask;
+		}
+		return slot;
+	}
+
+	std::vector<uint64_t> m_keys;
+};
+
+float GetMeshExtent(const std::vector<Vertex_PNCU>& vertices)
+{
+	if (vertices.empty())
+		return 0.f;
+
+	Vec3 mins = vertices[0].m_position;
+	Vec3 maxs = vertices[0].m_position;
+	for (int i = 1; i < vertices.size(); i++)
+	{
+		const Vec3& position = vertices[i].m_position;
+		mins = Vec3(position.x < mins.x ? position.x : mins.x, position.y < mins.y ? position.y : mins.y, position.z < mins.z ? position.z : mins.z);
+		maxs = Vec3(position.x > maxs.x ? position.x : maxs.x, position.y > maxs.y ? position.y : maxs.y, position.z > maxs.z ? position.z : maxs.z);
+	}
+	Vec3 size = maxs - mins;
+	float extent = size.x > size.y ? size.x : size.y;
+	return extent > size.z ? extent : size.z;
+}
+
+void SimplifyMesh(std::vector<unsigned int>& outIndices, const std::vector<Vertex_PNCU>& vertices, const std::vector<unsigned int>& indices,
+	unsigned int targetNumIndices, float targetError, bool lockBorders, float* outError)
+{
+	outIndices = indices;
+	if (outError)
+	{
+		*outError = 0.f;
+	}
+	unsigned int numVertices = (unsigned int)vertices.size();
+	if (indices.size() < 3 || targetNumIndices >= indices.size())
+		return;
+
+	//work in a unit box so errors come out as a fraction of the mesh's extents
+	float extent = GetMeshExtent(vertices);
+	float scale = extent > 0.f ? 1.f / extent : 0.f;
+	std::vector<Vec3> positions(numVertices);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		positions[i] = (vertices[i].m_position - vertices[0].m_position) * scale;
+	}
+
+	//verts at one position are wedges of a single position class, split apart by a uv or normal seam. collapses move
+	//whole classes, a class is named after its first vert and wedges are linked in a ring
+	std::vector<unsigned int> vertexClasses(numVertices);
+	std::vector<unsigned int> nextWedges(numVertices);
+	std::vector<unsigned int> numWedges(numVertices, 0);
+	{
+		size_t capacity = 64;
+		while (capacity < numVertices * 2)
+		{
+			capacity *= 2;
+		}
+		std::vector<unsigned int> table(capacity, INVALID_SIMPLIFY_INDEX);
+		for (unsigned int i = 0; i < numVertices; i++)
+		{
+			uint32_t words[3];
+			memcpy(words, &vertices[i].m_position, sizeof(words));
+			uint32_t hash = (words[0] * 73856093u) ^ (words[1] * 19349663u) ^ (words[2] * 83492791u);
+			hash = (hash ^ (hash >> 16)) * 0x7feb352du;		//round coordinates leave the low mantissa bits all zero
+			size_t slot = (size_t)(hash ^ (hash >> 15)) & (capacity - 1);
+			while (table[slot] != INVALID_SIMPLIFY_INDEX && memcmp(&vertices[table[slot]].m_position, &vertices[i].m_position, sizeof(Vec3)) != 0)
+			{
+				slot = (slot + 1) & (capacity - 1);
+			}
+			if (table[slot] == INVALID_SIMPLIFY_INDEX)
+			{
+				table[slot] = i;
+				nextWedges[i] = i;
+			}
+			else
+			{
+				unsigned int classIndex = table[slot];
+				nextWedges[i] = nextWedges[classIndex];
+				nextWedges[classIndex] = i;
+			}
+			vertexClasses[i] = table[slot];
+			numWedges[table[slot]]++;
+		}
+	}
+
+	//an edge is open when its reverse is missing at the class level, and a seam when the reverse exists between classes
+	//but not between the same verts. both kinds also get a quadric that holds the edge in place sideways
+	size_t numTriangles = indices.size() / 3;
+	SimplifyEdgeSet vertexEdges(indices.size());
+	SimplifyEdgeSet classEdges(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		unsigned int from = indices[i];
+		unsigned int to = indices[i % 3 == 2 ? i - 2 : i + 1];
+		vertexEdges.Insert(from, to);
+		classEdges.Insert(vertexClasses[from], vertexClasses[to]);
+	}
+
+	std::vector<Quadric> quadrics(numVertices);
+	std::vector<unsigned int> numBorderEdges(numVertices, 0);
+	std::vector<unsigned int> numSeamEdges(numVertices, 0);
+	std::vector<unsigned int> constrainedNeighbors(numVertices * 2, INVALID_SIMPLIFY_INDEX);
+	auto addConstrainedNeighbor = [&](unsigned int classIndex, unsigned int neighborClass)
+		{
+			unsigned int numConstrainedEdges = numBorderEdges[classIndex] + numSeamEdges[classIndex];
+			if (numConstrainedEdges <= 2)
+			{
+				constrainedNeighbors[classIndex * 2 + numConstrainedEdges - 1] = neighborClass;
+			}
+		};
+	for (size_t triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+	{
+		const unsigned int* triangle = &indices[triangleIndex * 3];
+		const Vec3& p0 = positions[triangle[0]];
+		Vec3 areaNormal = CrossProduct3D(positions[triangle[1]] - p0, positions[triangle[2]] - p0);
+		float normalLength = areaNormal.GetLength();
+		Vec3 normal = normalLength > 0.f ? areaNormal / normalLength : Vec3();
+		for (int corner = 0; corner < 3; corner++)
+		{
+			quadrics[vertexClasses[triangle[corner]]].AddPlane(normal, -DotProduct3D(normal, p0), normalLength * 0.5f);
+		}
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int from = triangle[corner];
+			unsigned int to = triangle[(corner + 1) % 3];
+			unsigned int fromClass = vertexClasses[from];
+			unsigned int toClass = vertexClasses[to];
+			if (fromClass == toClass)
+				continue;
+
+			if (!classEdges.Contains(toClass, fromClass))
+			{
+				numBorderEdges[fromClass]++;
+				addConstrainedNeighbor(fromClass, toClass);
+				numBorderEdges[toClass]++;
+				addConstrainedNeighbor(toClass, fromClass);
+
+				Vec3 edge = positions[to] - positions[from];
+				Vec3 borderNormal = CrossProduct3D(edge, normal);
+				float borderNormalLength = borderNormal.GetLength();
+				if (!lockBorders && borderNormalLength > 0.f)
+				{
+					borderNormal /= borderNormalLength;
+					float distance = -DotProduct3D(borderNormal, positions[from]);
+					float weight = edge.GetLengthSquared() * BORDER_QUADRIC_WEIGHT;
+					quadrics[fromClass].AddPlane(borderNormal, distance, weight);
+					quadrics[toClass].AddPlane(borderNormal, distance, weight);
+				}
+			}
+			else if (!vertexEdges.Contains(to, from))
+			{
+				numSeamEdges[fromClass]++;
+				addConstrainedNeighbor(fromClass, toClass);
+			}
+		}
+	}
+
+	//triangles that are already degenerate would only block the collapses around them
+	std::vector<unsigned int> newIndices;
+	for (size_t triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+	{
+		unsigned int c0 = vertexClasses[indices[triangleIndex * 3]];
+		unsigned int c1 = vertexClasses[indices[triangleIndex * 3 + 1]];
+		unsigned int c2 = vertexClasses[indices[triangleIndex * 3 + 2]];
+		if (c0 != c1 && c0 != c2 && c1 != c2)
+		{
+			newIndices.insert(newIndices.end(), indices.begin() + triangleIndex * 3, indices.begin() + triangleIndex * 3 + 3);
+		}
+	}
+	outIndices.swap(newIndices);
+
+	std::vector<SimplifyVertexKind> vertexKinds(numVertices, SimplifyVertexKind::LOCKED);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		if (vertexClasses[i] != i)
+			continue;
+
+		if (numWedges[i] == 1 && numBorderEdges[i] == 0 && numSeamEdges[i] == 0)
+		{
+			vertexKinds[i] = SimplifyVertexKind::MANIFOLD;
+		}
+		else if (numWedges[i] == 1 && numBorderEdges[i] == 2 && numSeamEdges[i] == 0 && !lockBorders)
+		{
+			vertexKinds[i] = SimplifyVertexKind::BORDER;
+		}
+		else if (numWedges[i] == 2 && numBorderEdges[i] == 0 && numSeamEdges[i] == 2)
+		{
+			vertexKinds[i] = SimplifyVertexKind::SEAM;
+		}
+	}
+
+	std::vector<unsigned int> classCollapses(numVertices);
+	for (unsigned int i = 0; i < numVertices; i++)
+	{
+		classCollapses[i] = i;
+	}
+	auto resolveClass = [&](unsigned int classIndex) -> unsigned int
+		{
+			while (classCollapses[classIndex] != classIndex)
+			{
+				classIndex = classCollapses[classIndex];
+			}
+			return classIndex;
+		};
+	auto isConstrainedNeighbor = [&](unsigned int classIndex, unsigned int neighborClass) -> bool
+		{
+			return resolveClass(constrainedNeighbors[classIndex * 2]) == neighborClass || resolveClass(constrainedNeighbors[classIndex * 2 + 1]) == neighborClass;
+		};
+	auto isCollapseAllowed = [&](unsigned int sourceClass, unsigned int targetClass) -> bool
+		{
+			switch (vertexKinds[sourceClass])
+			{
+			case SimplifyVertexKind::MANIFOLD:
+				return true;
+			case SimplifyVertexKind::BORDER:
+			case SimplifyVertexKind::SEAM:
+				return isConstrainedNeighbor(sourceClass, targetClass);
+			default:
+				return false;
+			}
+		};
+
+	//each pass collects every allowed collapse, sorts them by error and applies the cheapest ones that don't touch
+	//each other. quadrics merge into the surviving class so error keeps building up across passes
+	std::vector<unsigned int> triangleOffsets(numVertices + 1);
+	std::vector<unsigned int> classTriangles;
+	std::vector<unsigned int> vertexRemap(numVertices);
+	std::vector<unsigned char> isClassLocked(numVertices);
+	std::vector<SimplifyCollapse> collapses;
+	float maxErrorSquared = targetError * targetError;
+	float resultErrorSquared = 0.f;
+	while (outIndices.size() > targetNumIndices)
+	{
+		numTriangles = outIndices.size() / 3;
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (size_t i = 0; i < outIndices.size(); i++)
+		{
+			triangleOffsets[vertexClasses[outIndices[i]] + 1]++;
+		}
+		for (unsigned int i = 0; i < numVertices; i++)
+		{
+			triangleOffsets[i + 1] += triangleOffsets[i];
+		}
+		classTriangles.resize(outIndices.size());
+		std::vector<unsigned int> fillOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+		for (size_t i = 0; i < outIndices.size(); i++)
+		{
+			classTriangles[fillOffsets[vertexClasses[outIndices[i]]]++] = (unsigned int)(i / 3);
+		}
+
+		//every directed edge offers its own collapse. a border edge only exists one way round, so it also offers the reverse
+		collapses.clear();
+		for (size_t i = 0; i < outIndices.size(); i++)
+		{
+			unsigned int fromClass = vertexClasses[outIndices[i]];
+			unsigned int toClass = vertexClasses[outIndices[i % 3 == 2 ? i - 2 : i + 1]];
+			if (fromClass == toClass)
+				continue;
+
+			if (isCollapseAllowed(fromClass, toClass))
+			{
+				collapses.push_back({ fromClass, toClass, quadrics[fromClass].GetError(positions[toClass]) });
+			}
+			if (vertexKinds[toClass] == SimplifyVertexKind::BORDER && isConstrainedNeighbor(toClass, fromClass))
+			{
+				collapses.push_back({ toClass, fromClass, quadrics[toClass].GetError(positions[fromClass]) });
+			}
+		}
+		if (collapses.empty())
+			break;
+
+		//an interior collapse removes two triangles. only collapses up to a bit past the goal's error are sorted, which
+		//spreads the work over several passes instead of letting one pass take everything in a region
+		size_t numTrianglesToRemove = numTriangles - targetNumIndices / 3;
+		size_t collapseGoal = numTrianglesToRemove / 2 + 1;
+		float passErrorLimit = maxErrorSquared;
+		if (collapseGoal < collapses.size())
+		{
+			auto byError = [](const SimplifyCollapse& a, const SimplifyCollapse& b) { return a.m_error < b.m_error; };
+			std::nth_element(collapses.begin(), collapses.begin() + collapseGoal, collapses.end(), byError);
+			float goalError = collapses[collapseGoal].m_error * PASS_ERROR_LIMIT_SCALE;
+			passErrorLimit = goalError < passErrorLimit ? goalError : passErrorLimit;
+		}
+		auto sortEnd = std::partition(collapses.begin(), collapses.end(), [&](const SimplifyCollapse& collapse) { return collapse.m_error <= passErrorLimit; });
+		std::sort(collapses.begin(), sortEnd, [](const SimplifyCollapse& a, const SimplifyCollapse& b)
+			{
+				if (a.m_error != b.m_error)
+					return a.m_error < b.m_error;
+				return a.m_source < b.m_source;
+			});
+
+		for (unsigned int i = 0; i < numVertices; i++)
+		{
+			vertexRemap[i] = i;
+		}
+		std::fill(isClassLocked.begin(), isClassLocked.end(), (unsigned char)0);
+		size_t numTrianglesRemoved = 0;
+		size_t numCollapsesDone = 0;
+		for (auto collapseIter = collapses.begin(); collapseIter != sortEnd && numTrianglesRemoved < numTrianglesToRemove; ++collapseIter)
+		{
+			unsigned int sourceClass = collapseIter->m_source;
+			unsigned int targetClass = collapseIter->m_target;
+			if (isClassLocked[sourceClass] || isClassLocked[targetClass])
+				continue;
+
+			//moving the source must not turn any of its other triangles over
+			bool hasFlip = false;
+			size_t numRemovedByCollapse = 0;
+			for (unsigned int adjacencyIndex = triangleOffsets[sourceClass]; !hasFlip && adjacencyIndex < triangleOffsets[sourceClass + 1]; adjacencyIndex++)
+			{
+				const unsigned int* triangle = &outIndices[classTriangles[adjacencyIndex] * 3];
+				unsigned int classes[3] = { vertexClasses[triangle[0]], vertexClasses[triangle[1]], vertexClasses[triangle[2]] };
+				if (classes[0] == targetClass || classes[1] == targetClass || classes[2] == targetClass)
+				{
+					numRemovedByCollapse++;
+					continue;
+				}
+
+				Vec3 before[3] = { positions[classes[0]], positions[classes[1]], positions[classes[2]] };
+				Vec3 after[3] = { before[0], before[1], before[2] };
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (classes[corner] == sourceClass)
+					{
+						after[corner] = positions[targetClass];
+					}
+				}
+				Vec3 normalBefore = CrossProduct3D(before[1] - before[0], before[2] - before[0]);
+				Vec3 normalAfter = CrossProduct3D(after[1] - after[0], after[2] - after[0]);
+				hasFlip = DotProduct3D(normalBefore, normalAfter) <= 0.f;
+			}
+			if (hasFlip)
+				continue;
+
+			//each wedge of the source goes to the target wedge it shares a triangle with, so uvs and normals stay on
+			//their own side of a seam
+			unsigned int wedge = sourceClass;
+			do
+			{
+				unsigned int targetWedge = targetClass;
+				for (unsigned int adjacencyIndex = triangleOffsets[sourceClass]; numWedges[targetClass] > 1 && adjacencyIndex < triangleOffsets[sourceClass + 1]; adjacencyIndex++)
+				{
+					const unsigned int* triangle = &outIndices[classTriangles[adjacencyIndex] * 3];
+					if (triangle[0] != wedge && triangle[1] != wedge && triangle[2] != wedge)
+						continue;
+
+					for (int corner = 0; corner < 3; corner++)
+					{
+						if (vertexClasses[triangle[corner]] == targetClass)
+						{
+							targetWedge = triangle[corner];
+						}
+					}
+				}
+				vertexRemap[wedge] = targetWedge;
+				wedge = nextWedges[wedge];
+			} while (wedge != sourceClass);
+
+			//the target takes over the source's place along a border or seam
+			if (vertexKinds[sourceClass] == SimplifyVertexKind::BORDER || vertexKinds[sourceClass] == SimplifyVertexKind::SEAM)
+			{
+				unsigned int otherNeighbor = resolveClass(constrainedNeighbors[sourceClass * 2]);
+				if (otherNeighbor == targetClass)
+				{
+					otherNeighbor = resolveClass(constrainedNeighbors[sourceClass * 2 + 1]);
+				}
+				for (int slot = 0; slot < 2; slot++)
+				{
+					unsigned int& neighbor = constrainedNeighbors[targetClass * 2 + slot];
+					if (neighbor != INVALID_SIMPLIFY_INDEX && resolveClass(neighbor) == sourceClass)
+					{
+						neighbor = otherNeighbor;
+					}
+				}
+			}
+
+			quadrics[targetClass].Add(quadrics[sourceClass]);
+			classCollapses[sourceClass] = targetClass;
+			isClassLocked[sourceClass] = 1;
+			isClassLocked[targetClass] = 1;
+			numTrianglesRemoved += numRemovedByCollapse;
+			numCollapsesDone++;
+			if (collapseIter->m_error > resultErrorSquared)
+			{
+				resultErrorSquared = collapseIter->m_error;
+			}
+		}
+		if (numCollapsesDone == 0)
+			break;
+
+		newIndices.clear();
+		for (size_t triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+		{
+			unsigned int v0 = vertexRemap[outIndices[triangleIndex * 3]];
+			unsigned int v1 = vertexRemap[outIndices[triangleIndex * 3 + 1]];
+			unsigned int v2 = vertexRemap[outIndices[triangleIndex * 3 + 2]];
+			unsigned int c0 = vertexClasses[v0];
+			unsigned int c1 = vertexClasses[v1];
+			unsigned int c2 = vertexClasses[v2];
+			if (c0 != c1 && c0 != c2 && c1 != c2)
+			{
+				newIndices.push_back(v0);
+				newIndices.push_back(v1);
+				newIndices.push_back(v2);
+			}
+		}
+		outIndices.swap(newIndices);
+	}
+
+	if (outError)
+	{
+		*outError = sqrtf(resultErrorSquared);
+	}
+}
+
+int SelectMeshLod(const Camera& camera, const Vec3& boundsCenter, float boundsRadius, float objectScale, const MeshLod* lods, int numLods,
+	float screenHeightPixels, float maxErrorPixels)
+{
+	//world units to pixels at the distance of the mesh
+	float pixelsPerUnit = 0.f;
+	if (camera.GetMode() == CameraMode::PERSPECTIVE)
+	{
+		float distance = GetDistance3D(boundsCenter, camera.GetPosition()) - boundsRadius;
+		if (distance <= 0.f)
+			return 0;
+
+		float halfFov = camera.GetFOV() * 0.5f;
+		pixelsPerUnit = screenHeightPixels * CosDegrees(halfFov) / (2.f * distance * SinDegrees(halfFov));
+	}
+	else
+	{
+		float viewHeight = camera.GetOrthoTopRight().y - camera.GetOrthoBottomLeft().y;
+		pixelsPerUnit = viewHeight > 0.f ? screenHeightPixels / viewHeight : 0.f;
+	}
+
+	int selectedLod = 0;
+	for (int lodIndex = 1; lodIndex < numLods; lodIndex++)
+	{
+		if (lods[lodIndex].m_error * objectScale * pixelsPerUnit > maxErrorPixels)
+			break;
+
+		selectedLod = lodIndex;
+	}
+	return selectedLod;
+}
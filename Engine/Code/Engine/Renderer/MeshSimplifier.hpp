@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include "Engine/Core/Vertex_PNCU.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
+
+class Camera;
+struct Vec3;
+
+constexpr int MESH_MAX_LODS = 8;
+
+struct mesh_lod_options
+{
+	int m_numLods = 4;					//including the full mesh
+	float m_triangleRatio = 0.5f;		//each lod aims for this fraction of the previous lod's triangles
+	float m_maxError = 0.02f;			//no lod strays further than this from the full mesh, as a fraction of the mesh's extents
+	bool m_lockBorders = false;			//keeps open edges in place, for meshes that have to line up with their neighbours
+};
+
+//quadric error edge collapse. verts are only ever collapsed onto other existing verts, so the result indexes the same
+//vertex array and every lod of a mesh can share one vertex buffer. stops at targetNumIndices or once the next collapse
+//would move the surface further than targetError (a fraction of the mesh's extents), whichever comes first.
+//outError gets the error the result actually has, in the same units
+void SimplifyMesh(std::vector<unsigned int>& outIndices, const std::vector<Vertex_PNCU>& vertices, const std::vector<unsigned int>& indices,
+	unsigned int targetNumIndices, float targetError, bool lockBorders, float* outError = nullptr);
+
+float GetMeshExtent(const std::vector<Vertex_PNCU>& vertices);
+
+//picks the coarsest lod whose error covers at most maxErrorPixels on screen. lod errors are in mesh units and
+//objectScale takes them to world units, the distance used is to the nearest point of the bounding sphere
+int SelectMeshLod(const Camera& camera, const Vec3& boundsCenter, float boundsRadius, float objectScale, const MeshLod* lods, int numLods,
+	float screenHeightPixels, float maxErrorPixels = 1.f);
@@ -0,0 +1,133 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vec4.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/IntVec3.hpp"
+
+//data layouts shared between the cpu and the particle compute shaders, these must stay byte compatible with the hlsl side
+
+struct CountBuffer
+{
+	unsigned int maxParticles = 0u;
+	unsigned int listSize = 0u;
+	unsigned int deadListSize = 0u;
+	unsigned int lastAliveParticleIndex = 0u;
+};
+
+//the below constants values NEED to be the same as the constants defined in CommonCS.hlsl
+constexpr unsigned int SPAWN_THREAD_COUNT = 128;
+constexpr unsigned int SIMULATION_THREAD_COUNT = 128;
+constexpr unsigned int FINISH_SIM_THREAD_COUNT = 128;
+constexpr unsigned int SORT_THREAD_COUNT = 32;
+
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_X = 1;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_Y = 2;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_Z = 4;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_SIZE_OVERLIFE_X = 8;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_SIZE_OVERLIFE_Y = 16;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_DRAG_OVERLIFE = 32;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_ROT_OVERLIFE = 64;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_COLOR_OVERLIFE = 128;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_ORBIT_VEL_OVERLIFE = 256;
+constexpr unsigned int ANIM_CURVE_BIT_FLAG_ORBIT_RADIUS_OVERLIFE = 512;
+
+struct GPUSimConstants
+{
+	Vec3 gravity;								//0-12 bytes
+	float deltaSeconds = 0.f;					//12-16 bytes
+	float startColor[4] = { 0.f };				//16-32 bytes
+	int gravityScale = 0;						//32-36 bytes
+	unsigned int randInt = 0u;					//36-40 bytes
+	IntVec2 spriteDimensions;					//40-48 bytes
+	Vec4 pointAttractorOffsetAndStrength[8];	//48-176 bytes
+	Vec4 orbitAxis;								//176-192 bytes
+};
+
+struct AnimatedValuesConstants
+{
+	Vec4 velOverLifetimeXYKeys[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };							//0-128 bytes
+	Vec4 velOverLifetimeZAndSizeOverLifetimeXKeys[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };		//128-256 bytes
+	Vec4 colorOverLifetimeRGB[8];																//256-384 bytes
+	Vec4 colorOverLifetimeAlphaAndSizeOverLifetimeYKeys[8];										//384-512 bytes
+	Vec4 dragOverLifetimeRotOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };					//512-640 bytes
+	Vec4 orbitVelAndRadiusOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };					//640-768 bytes
+	unsigned int curveTypeBitFlags = 0;															//768-772 bytes
+	Vec3 padding;																				//772-784 bytes
+};
+
+struct SpawnDataConstants
+{
+	Vec2 lifetimeRange;						//0-8 bytes
+	Vec2 startSpeedRange;					//8-16 bytes
+	Vec2 startSizeRange;					//16-24 bytes
+	Vec2 startRotationRange;				//24-32 bytes
+	Vec3 offsetFromBase;					//32-44 bytes
+	unsigned int shapeType = 0;				//44-48 bytes
+	Vec3 boxDimensions;						//48-60 bytes
+	unsigned int sphereEmitFrom = 0;		//60-64 bytes
+	float sphereShapeRadius = 0.f;			//64-68 bytes
+	Vec3 boxForward;						//68-80 bytes
+	float coneShapeHalfAngle = 0.f;			//80-84 bytes
+	Vec3 worldPosition;						//84-96 bytes
+	unsigned int simSpace;					//96-100 bytes
+	Vec3 coneForward;						//100-112 bytes
+};
+
+struct CountConstants
+{
+	int emitCount = 0;			//0-4 bytes
+	int numParticles = 0;		//4-8 bytes
+	Vec2 padding;				//8-16 bytes
+};
+
+struct BillboardConstants
+{
+	Vec4 cameraPosition;		//0-16 bytes
+	Vec3 cameraUp;				//16-28 bytes
+	unsigned int renderMode;	//28-32 bytes
+};
+
+struct SortConstants
+{
+	//for odd-even sort
+	//Vec3 cameraPos;						//0-12 bytes
+	//unsigned int iterationNum = 0u;		//12-16 bytes
+	//unsigned int numParticles = 0u;		//16-20 bytes
+	//IntVec3 padding;						//20-32 bytes
+
+	//for bitonic sort
+	unsigned int numItemsToSort = 0;		//0-4 bytes
+	IntVec3 padding;						//4-16 bytes
+};
+
+struct SortData
+{
+	float distanceSq = 0.f;
+	float index = 0.f;
+};
+
+struct CPURenderConstants
+{
+	IntVec2 spritesheetLayout;												//0-8 bytes
+	Vec2 padding;															//8-16 bytes
+	Vec4 sizeXYOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };			//16-144 bytes
+	Vec4 orbitRadiusOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };		//144-276 bytes
+	Vec3 orbitAxis;															//276-288 bytes
+	unsigned int curveModeFlags = 0;										//288-292 bytes
+};
+
+struct IndirectDispatchData
+{
+	unsigned int threadGroupX = 1U;
+	unsigned int threadGroupY = 1U;
+	unsigned int threadGroupZ = 1U;
+};
+
+struct IndirectDrawData
+{
+	unsigned int vertexPerInstance = 0U;
+	unsigned int instanceCount = 0U;
+	unsigned int startVertexLocation = 0U;
+	unsigned int startInstanceLocation = 0U;
+};
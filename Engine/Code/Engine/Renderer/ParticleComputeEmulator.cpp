@@ -0,0 +1,436 @@
+#include <algorithm>
+#include <float.h>
+#include "Engine/Renderer/ParticleComputeEmulator.hpp"
+#include "Engine/Renderer/ParticleEmitterData.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "ThirdParty/Squirrel/RawNoise.hpp"
+
+constexpr unsigned int NUM_SPAWN_RANDOM_CHANNELS = 16;
+constexpr float DEAD_PARTICLE_LIFETIME = -1.f;
+constexpr int NUM_ENCODED_CURVE_KEYS = 8;
+constexpr int NUM_ENCODED_CURVE_KEYS_RANDOM_MODE = 4;
+
+ParticleComputeEmulator::ParticleComputeEmulator(const ParticleComputeEmulatorConfig& config)
+	:m_config(config)
+{
+	GUARANTEE_OR_DIE(m_config.m_particlesPerJob > 0, "Particles per job can't be 0");
+	Reset();
+}
+
+void ParticleComputeEmulator::Reset()
+{
+	m_particleData.clear();
+	m_particleData.resize(m_config.m_maxParticles);
+	m_deadParticleList.clear();
+	m_deadParticleList.reserve(m_config.m_maxParticles);
+	m_sortData.clear();
+	m_sortData.resize(m_config.m_maxParticles);
+
+	m_countBuffer = CountBuffer();
+	m_countBuffer.maxParticles = m_config.m_maxParticles;
+}
+
+void ParticleComputeEmulator::SetConstants(const GPUSimConstants& simConstants, const AnimatedValuesConstants& animConstants, const SpawnDataConstants& spawnConstants,
+	const BillboardConstants& billboardConstants)
+{
+	m_simConstants = simConstants;
+	m_animConstants = animConstants;
+	m_spawnConstants = spawnConstants;
+	m_billboardConstants = billboardConstants;
+
+	//decode the curves once per frame instead of per particle, using the same layout ParticleEmitter encodes them in
+	unsigned int flags = animConstants.curveTypeBitFlags;
+	DecodeCurve(m_velOverLifetimeX, animConstants.velOverLifetimeXYKeys, 0, flags, ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_X);
+	DecodeCurve(m_velOverLifetimeY, animConstants.velOverLifetimeXYKeys, 2, flags, ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_Y);
+	DecodeCurve(m_velOverLifetimeZ, animConstants.velOverLifetimeZAndSizeOverLifetimeXKeys, 0, flags, ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_Z);
+	DecodeCurve(m_dragOverLifetime, animConstants.dragOverLifetimeRotOverLifetime, 0, flags, ANIM_CURVE_BIT_FLAG_DRAG_OVERLIFE);
+	DecodeCurve(m_rotOverLifetime, animConstants.dragOverLifetimeRotOverLifetime, 2, flags, ANIM_CURVE_BIT_FLAG_ROT_OVERLIFE);
+	DecodeCurve(m_orbitVelOverLifetime, animConstants.orbitVelAndRadiusOverLifetime, 0, flags, ANIM_CURVE_BIT_FLAG_ORBIT_VEL_OVERLIFE);
+	DecodeCurve(m_orbitRadiusOverLifetime, animConstants.orbitVelAndRadiusOverLifetime, 2, flags, ANIM_CURVE_BIT_FLAG_ORBIT_RADIUS_OVERLIFE);
+
+	//color keys are (r, g, b, time) with alpha stored in the x of the alpha/sizeY entry
+	m_numColorKeys = 0;
+	for (int i = 0; i < NUM_ENCODED_CURVE_KEYS; i++)
+	{
+		float keyTime = animConstants.colorOverLifetimeRGB[i].w;
+		if (keyTime < 0.f || (i > 0 && keyTime <= m_colorKeyTimes[i - 1]))
+			break;
+
+		const Vec4& rgb = animConstants.colorOverLifetimeRGB[i];
+		m_colorKeys[i] = Vec4(rgb.x, rgb.y, rgb.z, animConstants.colorOverLifetimeAlphaAndSizeOverLifetimeYKeys[i].x);
+		m_colorKeyTimes[i] = keyTime;
+		m_numColorKeys++;
+	}
+}
+
+void ParticleComputeEmulator::Spawn(const CountConstants& countConstants)
+{
+	unsigned int particlesToEmit = countConstants.emitCount > 0 ? static_cast<unsigned int>(countConstants.emitCount) : 0u;
+	unsigned int slotsRemaining = GetSlotsRemaining();
+	if (particlesToEmit > slotsRemaining)
+		particlesToEmit = slotsRemaining;
+
+	for (unsigned int i = 0; i < particlesToEmit; i++)
+	{
+		//reuse dead slots first, then grow the list
+		unsigned int particleIndex = 0;
+		if (!m_deadParticleList.empty())
+		{
+			particleIndex = m_deadParticleList.back();
+			m_deadParticleList.pop_back();
+		}
+		else
+		{
+			particleIndex = m_countBuffer.lastAliveParticleIndex++;
+		}
+
+		InitializeSpawnedParticle(m_particleData[particleIndex], static_cast<unsigned int>(countConstants.numParticles) + i);
+	}
+
+	m_countBuffer.deadListSize = static_cast<unsigned int>(m_deadParticleList.size());
+}
+
+void ParticleComputeEmulator::Simulate()
+{
+	unsigned int numParticlesToSimulate = m_countBuffer.lastAliveParticleIndex;
+	if (m_config.m_jobSystem == nullptr || numParticlesToSimulate <= m_config.m_particlesPerJob)
+	{
+		std::vector<unsigned int> newDeadParticles;
+		SimulateParticleRange(0, numParticlesToSimulate, newDeadParticles);
+		m_deadParticleList.insert(m_deadParticleList.end(), newDeadParticles.begin(), newDeadParticles.end());
+	}
+	else
+	{
+		std::vector<Job*> simulateJobs;
+		simulateJobs.reserve((numParticlesToSimulate / m_config.m_particlesPerJob) + 1);
+		for (unsigned int startIndex = 0; startIndex < numParticlesToSimulate; startIndex += m_config.m_particlesPerJob)
+		{
+			unsigned int endIndex = std::min(startIndex + m_config.m_particlesPerJob, numParticlesToSimulate);
+			ParticleComputeSimulateJob* simulateJob = new ParticleComputeSimulateJob(this, startIndex, endIndex);
+			m_config.m_jobSystem->QueueJobs(simulateJob);
+			simulateJobs.push_back(simulateJob);
+		}
+
+		m_config.m_jobSystem->WaitForJobs(simulateJobs);
+
+		//append the dead lists in chunk order so the result doesn't depend on which worker finished first
+		for (int i = 0; i < simulateJobs.size(); i++)
+		{
+			ParticleComputeSimulateJob* simulateJob = static_cast<ParticleComputeSimulateJob*>(simulateJobs[i]);
+			m_deadParticleList.insert(m_deadParticleList.end(), simulateJob->m_newDeadParticles.begin(), simulateJob->m_newDeadParticles.end());
+			delete simulateJob;
+		}
+	}
+
+	m_countBuffer.deadListSize = static_cast<unsigned int>(m_deadParticleList.size());
+}
+
+void ParticleComputeEmulator::FinishSimulation()
+{
+	m_countBuffer.listSize = m_countBuffer.lastAliveParticleIndex;
+	m_countBuffer.deadListSize = static_cast<unsigned int>(m_deadParticleList.size());
+}
+
+void ParticleComputeEmulator::Sort()
+{
+	//ascending by distance like SortLib, index breaks ties so the result is deterministic
+	std::sort(m_sortData.begin(), m_sortData.begin() + m_countBuffer.listSize,
+		[](const SortData& a, const SortData& b)
+		{
+			if (a.distanceSq != b.distanceSq)
+				return a.distanceSq < b.distanceSq;
+			return a.index < b.index;
+		}
+	);
+}
+
+CountBuffer ParticleComputeEmulator::GetCountBuffer() const
+{
+	return m_countBuffer;
+}
+
+unsigned int ParticleComputeEmulator::GetSlotsRemaining() const
+{
+	return (m_countBuffer.maxParticles - m_countBuffer.lastAliveParticleIndex) + static_cast<unsigned int>(m_deadParticleList.size());
+}
+
+const Particle* ParticleComputeEmulator::GetParticleData() const
+{
+	return m_particleData.data();
+}
+
+const SortData* ParticleComputeEmulator::GetSortData() const
+{
+	return m_sortData.data();
+}
+
+const unsigned int* ParticleComputeEmulator::GetDeadParticleList() const
+{
+	return m_deadParticleList.data();
+}
+
+const GPUSimConstants& ParticleComputeEmulator::GetSimConstants() const
+{
+	return m_simConstants;
+}
+
+const AnimatedValuesConstants& ParticleComputeEmulator::GetAnimatedValuesConstants() const
+{
+	return m_animConstants;
+}
+
+const BillboardConstants& ParticleComputeEmulator::GetBillboardConstants() const
+{
+	return m_billboardConstants;
+}
+
+void ParticleComputeEmulator::InitializeSpawnedParticle(Particle& particle, unsigned int particleID) const
+{
+	particle = Particle();
+	particle.m_particleID = particleID;
+	particle.m_position = m_spawnConstants.offsetFromBase;
+	if (m_spawnConstants.simSpace == static_cast<unsigned int>(SimulationSpace::WORLD))
+	{
+		particle.m_position += m_spawnConstants.worldPosition;
+	}
+
+	switch (static_cast<EmitterShape>(m_spawnConstants.shapeType))
+	{
+	case EmitterShape::CONE:
+	{
+		float halfAngle = m_spawnConstants.coneShapeHalfAngle * 0.5f;
+		float baseYaw = m_spawnConstants.coneForward.GetAngleAboutZDegrees();
+		float basePitch = m_spawnConstants.coneForward.GetAngleAboutYDegrees();
+		float randomYaw = GetSpawnRandomFloatInRange(baseYaw - halfAngle, baseYaw + halfAngle, particleID, 0);
+		float randomPitch = GetSpawnRandomFloatInRange(basePitch - halfAngle, basePitch + halfAngle, particleID, 1);
+		particle.m_velocity = EulerAngles(randomYaw, randomPitch, 0.f).GetAsMatrix_XFwd_YLeft_ZUp().GetIBasis3D();
+		break;
+	}
+	case EmitterShape::SPHERE:
+	{
+		float randomYaw = GetSpawnRandomFloatInRange(0.f, 360.f, particleID, 0);
+		float randomPitch = GetSpawnRandomFloatInRange(0.f, 360.f, particleID, 1);
+		float randomRoll = GetSpawnRandomFloatInRange(0.f, 360.f, particleID, 2);
+		Vec3 randomDirection = EulerAngles(randomYaw, randomPitch, randomRoll).GetAsMatrix_XFwd_YLeft_ZUp().GetIBasis3D();
+		float distanceFromCenter = m_spawnConstants.sphereEmitFrom == 1 ? m_spawnConstants.sphereShapeRadius :
+			GetSpawnRandomFloatInRange(0.f, m_spawnConstants.sphereShapeRadius, particleID, 3);
+		particle.m_velocity = randomDirection;
+		particle.m_position += distanceFromCenter * randomDirection;
+		break;
+	}
+	case EmitterShape::BOX:
+	{
+		const Vec3& dimensions = m_spawnConstants.boxDimensions;
+		float u = GetSpawnRandomFloatInRange(0.f, 1.f, particleID, 0);
+		float v = GetSpawnRandomFloatInRange(0.f, 1.f, particleID, 1);
+		particle.m_velocity = m_spawnConstants.boxForward;
+		particle.m_position += Vec3((u - 0.5f) * dimensions.x, (v - 0.5f) * dimensions.y, -dimensions.z * 0.5f);
+		break;
+	}
+	default:
+		ERROR_RECOVERABLE("Unknown emitter shape type in particle compute emulator");
+		break;
+	}
+
+	particle.m_velocity *= GetSpawnRandomFloatInRange(m_spawnConstants.startSpeedRange.x, m_spawnConstants.startSpeedRange.y, particleID, 4);
+	particle.m_rotation = GetSpawnRandomFloatInRange(m_spawnConstants.startRotationRange.x, m_spawnConstants.startRotationRange.y, particleID, 5);
+	particle.m_lifeTime = GetSpawnRandomFloatInRange(m_spawnConstants.lifetimeRange.x, m_spawnConstants.lifetimeRange.y, particleID, 6);
+	particle.m_size = GetSpawnRandomFloatInRange(m_spawnConstants.startSizeRange.x, m_spawnConstants.startSizeRange.y, particleID, 7);
+	particle.m_orbitalAngle = GetSpawnRandomFloatInRange(0.f, 360.f, particleID, 8);
+	for (int i = 0; i < 4; i++)
+	{
+		particle.m_color[i] = m_simConstants.startColor[i];
+	}
+}
+
+void ParticleComputeEmulator::SimulateParticleRange(unsigned int startIndex, unsigned int endIndex, std::vector<unsigned int>& out_newDeadParticles)
+{
+	Vec3 cameraPosition = Vec3(m_billboardConstants.cameraPosition.x, m_billboardConstants.cameraPosition.y, m_billboardConstants.cameraPosition.z);
+	bool isLocalSpace = m_spawnConstants.simSpace == static_cast<unsigned int>(SimulationSpace::LOCAL);
+
+	for (unsigned int i = startIndex; i < endIndex; i++)
+	{
+		Particle& particle = m_particleData[i];
+		SortData& sortEntry = m_sortData[i];
+		sortEntry.index = static_cast<float>(i);
+
+		//already in the dead list, waiting to be reused by a spawn
+		if (particle.m_lifeTime == DEAD_PARTICLE_LIFETIME)
+		{
+			sortEntry.distanceSq = FLT_MAX;
+			continue;
+		}
+
+		SimulateParticle(particle);
+		if (!particle.IsAlive())
+		{
+			//collapse the quad so the draw over the full list size doesn't show it
+			particle.m_lifeTime = DEAD_PARTICLE_LIFETIME;
+			particle.m_size = 0.f;
+			out_newDeadParticles.push_back(i);
+			sortEntry.distanceSq = FLT_MAX;
+			continue;
+		}
+
+		Vec3 worldPosition = isLocalSpace ? particle.m_position + m_spawnConstants.worldPosition : particle.m_position;
+		sortEntry.distanceSq = GetDistanceSquared3D(cameraPosition, worldPosition);
+	}
+}
+
+void ParticleComputeEmulator::SimulateParticle(Particle& particle) const
+{
+	float deltaSeconds = m_simConstants.deltaSeconds;
+	particle.m_age += deltaSeconds;
+	float normalizedAge = particle.GetNormalizedAge();
+	unsigned int particleID = particle.m_particleID;
+
+	Vec3 velOverTime = Vec3(GetCurveValue(m_velOverLifetimeX, normalizedAge, particleID), GetCurveValue(m_velOverLifetimeY, normalizedAge, particleID),
+		GetCurveValue(m_velOverLifetimeZ, normalizedAge, particleID));
+
+	Vec3 velTowardsPointAttractors;
+	for (int i = 0; i < 8; i++)
+	{
+		const Vec4& attractor = m_simConstants.pointAttractorOffsetAndStrength[i];
+		if (attractor.w == 0.f)
+			continue;
+
+		Vec3 particleToAttractor = Vec3(attractor.x, attractor.y, attractor.z) - particle.m_position;
+		float distanceToAttractor = particleToAttractor.GetLength();
+		if (distanceToAttractor <= 0.f)
+			distanceToAttractor = 1.f;
+		float strengthBasedOnDistance = attractor.w / ((distanceToAttractor + 1.f) * (distanceToAttractor + 1.f));
+		velTowardsPointAttractors += (particleToAttractor / distanceToAttractor) * strengthBasedOnDistance;
+	}
+
+	Vec3 gravitationalForce = m_simConstants.gravity * static_cast<float>(m_simConstants.gravityScale);
+	Vec3 dragForce = GetCurveValue(m_dragOverLifetime, normalizedAge, particleID) * -1.f * particle.m_velocity;
+	Vec3 acceleration = gravitationalForce + dragForce + velOverTime + velTowardsPointAttractors;
+	particle.m_rotation += GetCurveValue(m_rotOverLifetime, normalizedAge, particleID) * deltaSeconds;
+	particle.m_orbitalAngle += GetCurveValue(m_orbitVelOverLifetime, normalizedAge, particleID) * deltaSeconds;
+	particle.m_orbitalRadius += GetCurveValue(m_orbitRadiusOverLifetime, normalizedAge, particleID) * deltaSeconds;
+	particle.m_velocity += acceleration * deltaSeconds;
+	particle.m_position += particle.m_velocity * deltaSeconds;
+	GetColorForAge(normalizedAge, particle.m_color);
+}
+
+float ParticleComputeEmulator::GetSpawnRandomFloatInRange(float minInclusive, float maxInclusive, unsigned int particleID, unsigned int channel) const
+{
+	int noiseIndex = static_cast<int>(particleID * NUM_SPAWN_RANDOM_CHANNELS + channel);
+	return minInclusive + (Get1dNoiseZeroToOne(noiseIndex, m_simConstants.randInt) * (maxInclusive - minInclusive));
+}
+
+float ParticleComputeEmulator::GetCurveValue(const EmulatedAnimCurve& curve, float normalizedAge, unsigned int particleID) const
+{
+	if (curve.m_numCurveOneKeys == 0)
+		return 0.f;
+
+	int curveOnePrevKey = 0, curveOneNextKey = 0;
+	GetKeysForAge(curve.m_curveOneTimes, curve.m_numCurveOneKeys, normalizedAge, curveOnePrevKey, curveOneNextKey);
+	float fromValue = curve.m_curveOneValues[curveOnePrevKey];
+	float toValue = curve.m_curveOneValues[curveOneNextKey];
+
+	//same per particle noise as AnimatedCurve::GetInterpolatedAnimValueFromCurve
+	if (curve.m_isRandomBetweenCurves && curve.m_numCurveTwoKeys > 0)
+	{
+		int curveTwoPrevKey = 0, curveTwoNextKey = 0;
+		GetKeysForAge(curve.m_curveTwoTimes, curve.m_numCurveTwoKeys, normalizedAge, curveTwoPrevKey, curveTwoNextKey);
+		float randomFraction = Get1dNoiseZeroToOne(static_cast<int>(particleID));
+		fromValue = Interpolate(fromValue, curve.m_curveTwoValues[curveTwoPrevKey], randomFraction);
+		toValue = Interpolate(toValue, curve.m_curveTwoValues[curveTwoNextKey], randomFraction);
+	}
+
+	float fraction = GetFractionWithin(normalizedAge, curve.m_curveOneTimes[curveOnePrevKey], curve.m_curveOneTimes[curveOneNextKey]);
+	return Interpolate(fromValue, toValue, fraction);
+}
+
+void ParticleComputeEmulator::GetColorForAge(float normalizedAge, float* out_color) const
+{
+	if (m_numColorKeys == 0)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			out_color[i] = m_simConstants.startColor[i];
+		}
+		return;
+	}
+
+	int prevKey = 0, nextKey = 0;
+	GetKeysForAge(m_colorKeyTimes, m_numColorKeys, normalizedAge, prevKey, nextKey);
+	float fraction = ClampZeroToOne(GetFractionWithin(normalizedAge, m_colorKeyTimes[prevKey], m_colorKeyTimes[nextKey]));
+	const Vec4& fromColor = m_colorKeys[prevKey];
+	const Vec4& toColor = m_colorKeys[nextKey];
+	out_color[0] = Interpolate(fromColor.x, toColor.x, fraction);
+	out_color[1] = Interpolate(fromColor.y, toColor.y, fraction);
+	out_color[2] = Interpolate(fromColor.z, toColor.z, fraction);
+	out_color[3] = Interpolate(fromColor.w, toColor.w, fraction);
+}
+
+void ParticleComputeEmulator::DecodeCurve(EmulatedAnimCurve& out_curve, const Vec4* encodedKeys, size_t offsetInEachEntry, unsigned int bitFlags, unsigned int bitFlagForThisCurve)
+{
+	//keys are (value, time) pairs at float offset 0 or 2 of each entry, curve two starts at entry 4 when randomizing between curves.
+	//unused entries are either the -1 marker or zeroed, so stop at the first key whose time doesn't increase
+	out_curve = EmulatedAnimCurve();
+	out_curve.m_isRandomBetweenCurves = (bitFlags & bitFlagForThisCurve) != 0;
+	int maxKeysPerCurve = out_curve.m_isRandomBetweenCurves ? NUM_ENCODED_CURVE_KEYS_RANDOM_MODE : NUM_ENCODED_CURVE_KEYS;
+
+	for (int i = 0; i < maxKeysPerCurve; i++)
+	{
+		const float* key = (&encodedKeys[i].x) + offsetInEachEntry;
+		if (key[1] < 0.f || (i > 0 && key[1] <= out_curve.m_curveOneTimes[i - 1]))
+			break;
+
+		out_curve.m_curveOneValues[i] = key[0];
+		out_curve.m_curveOneTimes[i] = key[1];
+		out_curve.m_numCurveOneKeys++;
+	}
+
+	if (!out_curve.m_isRandomBetweenCurves)
+		return;
+
+	for (int i = 0; i < NUM_ENCODED_CURVE_KEYS_RANDOM_MODE; i++)
+	{
+		const float* key = (&encodedKeys[i + NUM_ENCODED_CURVE_KEYS_RANDOM_MODE].x) + offsetInEachEntry;
+		if (key[1] < 0.f || (i > 0 && key[1] <= out_curve.m_curveTwoTimes[i - 1]))
+			break;
+
+		out_curve.m_curveTwoValues[i] = key[0];
+		out_curve.m_curveTwoTimes[i] = key[1];
+		out_curve.m_numCurveTwoKeys++;
+	}
+}
+
+void ParticleComputeEmulator::GetKeysForAge(const float* keyTimes, int numKeys, float normalizedAge, int& out_prevKey, int& out_nextKey)
+{
+	//same key search as GetAnimationFramesGivenNormalizedAge
+	out_prevKey = 0;
+	out_nextKey = numKeys - 1;
+	for (int i = 0; i < numKeys; i++)
+	{
+		if (normalizedAge < keyTimes[i])
+		{
+			out_nextKey = i;
+			out_prevKey = i > 0 ? i - 1 : 0;
+			break;
+		}
+	}
+}
+
+ParticleComputeSimulateJob::ParticleComputeSimulateJob(ParticleComputeEmulator* emulator, unsigned int startIndex, unsigned int endIndex)
+	:m_emulator(emulator), m_startIndex(startIndex), m_endIndex(endIndex)
+{
+}
+
+void ParticleComputeSimulateJob::Execute()
+{
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
+	m_emulator->SimulateParticleRange(m_startIndex, m_endIndex, m_newDeadParticles);
+}
+
+void ParticleComputeSimulateJob::OnFinished()
+{
+}
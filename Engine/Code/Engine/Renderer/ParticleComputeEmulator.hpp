@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include "Engine/Renderer/ParticleComputeData.hpp"
+#include "Engine/Renderer/Particle.hpp"
+#include "Engine/Core/Job.hpp"
+
+class JobSystem;
+
+//cpu reference implementation of the spawn/simulate/finish/sort compute stages of the gpu particle pipeline
+//works on the same constant and buffer layouts the compute shaders use, so it can validate the gpu path or stand in for it
+struct ParticleComputeEmulatorConfig
+{
+	unsigned int m_maxParticles = 0;
+	JobSystem* m_jobSystem = nullptr;
+	unsigned int m_particlesPerJob = SIMULATION_THREAD_COUNT * 16;
+};
+
+struct EmulatedAnimCurve
+{
+	float m_curveOneValues[8] = { 0.f };
+	float m_curveOneTimes[8] = { 0.f };
+	float m_curveTwoValues[4] = { 0.f };
+	float m_curveTwoTimes[4] = { 0.f };
+	int m_numCurveOneKeys = 0;
+	int m_numCurveTwoKeys = 0;
+	bool m_isRandomBetweenCurves = false;
+};
+
+class ParticleComputeEmulator
+{
+	friend class ParticleComputeSimulateJob;
+public:
+	ParticleComputeEmulator(const ParticleComputeEmulatorConfig& config);
+	~ParticleComputeEmulator() = default;
+
+	void Reset();
+	void SetConstants(const GPUSimConstants& simConstants, const AnimatedValuesConstants& animConstants, const SpawnDataConstants& spawnConstants,
+		const BillboardConstants& billboardConstants);
+
+	//same order the compute shaders are dispatched in
+	void Spawn(const CountConstants& countConstants);
+	void Simulate();
+	void FinishSimulation();
+	void Sort();
+
+	CountBuffer GetCountBuffer() const;
+	unsigned int GetSlotsRemaining() const;
+	const Particle* GetParticleData() const;
+	const SortData* GetSortData() const;
+	const unsigned int* GetDeadParticleList() const;
+	const GPUSimConstants& GetSimConstants() const;
+	const AnimatedValuesConstants& GetAnimatedValuesConstants() const;
+	const BillboardConstants& GetBillboardConstants() const;
+
+private:
+	void InitializeSpawnedParticle(Particle& particle, unsigned int particleID) const;
+	void SimulateParticleRange(unsigned int startIndex, unsigned int endIndex, std::vector<unsigned int>& out_newDeadParticles);
+	void SimulateParticle(Particle& particle) const;
+	float GetSpawnRandomFloatInRange(float minInclusive, float maxInclusive, unsigned int particleID, unsigned int channel) const;
+	float GetCurveValue(const EmulatedAnimCurve& curve, float normalizedAge, unsigned int particleID) const;
+	void GetColorForAge(float normalizedAge, float* out_color) const;
+
+	static void DecodeCurve(EmulatedAnimCurve& out_curve, const Vec4* encodedKeys, size_t offsetInEachEntry, unsigned int bitFlags, unsigned int bitFlagForThisCurve);
+	static void GetKeysForAge(const float* keyTimes, int numKeys, float normalizedAge, int& out_prevKey, int& out_nextKey);
+
+private:
+	ParticleComputeEmulatorConfig m_config;
+	std::vector<Particle> m_particleData;
+	std::vector<unsigned int> m_deadParticleList;
+	std::vector<SortData> m_sortData;
+	CountBuffer m_countBuffer;
+
+	GPUSimConstants m_simConstants;
+	AnimatedValuesConstants m_animConstants;
+	SpawnDataConstants m_spawnConstants;
+	BillboardConstants m_billboardConstants;
+
+	EmulatedAnimCurve m_velOverLifetimeX;
+	EmulatedAnimCurve m_velOverLifetimeY;
+	EmulatedAnimCurve m_velOverLifetimeZ;
+	EmulatedAnimCurve m_dragOverLifetime;
+	EmulatedAnimCurve m_rotOverLifetime;
+	EmulatedAnimCurve m_orbitVelOverLifetime;
+	EmulatedAnimCurve m_orbitRadiusOverLifetime;
+	Vec4 m_colorKeys[8];
+	float m_colorKeyTimes[8] = { 0.f };
+	int m_numColorKeys = 0;
+};
+
+class ParticleComputeSimulateJob : public Job
+{
+	friend class ParticleComputeEmulator;
+public:
+	ParticleComputeSimulateJob(ParticleComputeEmulator* emulator, unsigned int startIndex, unsigned int endIndex);
+
+private:
+	ParticleComputeEmulator* m_emulator = nullptr;
+	unsigned int m_startIndex = 0;
+	unsigned int m_endIndex = 0;
+	std::vector<unsigned int> m_newDeadParticles;
+
+private:
+	void Execute() override;
+	void OnFinished() override;
+};
@@ -1,6 +1,12 @@
 #include <d3d11.h>
 #include <algorithm>
+#include <float.h>
 #include "Engine/Renderer/ParticleEmitter.hpp"
+#include "Engine/Renderer/ParticleComputeData.hpp"
+#include "Engine/Renderer/ParticleComputeEmulator.hpp"
+#include "Engine/Renderer/ParticleIndirectArgsShader.hpp"
+#include "Engine/Renderer/GPUReadbackRing.hpp"
+#include "Engine/Renderer/ParticleRenderBatcher.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/ConstantBuffer.hpp"
@@ -30,123 +36,8 @@ constexpr int GPU_SPAWN_PARTICLES_BUFFER_SLOT = 6;
 constexpr int GPU_COUNT_BUFFER_SLOT = 5;
 constexpr int GPU_BILLBOARD_BUFFER_SLOT = 4;
 constexpr int GPU_SYNC_FRAME_COUNT = 60;
-
-//the below constants values NEED to be the same as the constants defined in CommonCS.hlsl
-constexpr unsigned int SPAWN_THREAD_COUNT = 128;
-constexpr unsigned int SIMULATION_THREAD_COUNT = 128;
-constexpr unsigned int FINISH_SIM_THREAD_COUNT = 128;
-constexpr unsigned int SORT_THREAD_COUNT = 32;
-
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_X = 1;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_Y = 2;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_VEL_OVERLIFE_Z = 4;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_SIZE_OVERLIFE_X = 8;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_SIZE_OVERLIFE_Y = 16;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_DRAG_OVERLIFE = 32;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_ROT_OVERLIFE = 64;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_COLOR_OVERLIFE = 128;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_ORBIT_VEL_OVERLIFE = 256;
-constexpr unsigned int ANIM_CURVE_BIT_FLAG_ORBIT_RADIUS_OVERLIFE = 512;
-
-struct GPUSimConstants
-{
-	Vec3 gravity;								//0-12 bytes
-	float deltaSeconds = 0.f;					//12-16 bytes
-	float startColor[4] = { 0.f };				//16-32 bytes
-	int gravityScale = 0;						//32-36 bytes
-	unsigned int randInt = 0u;					//36-40 bytes
-	IntVec2 spriteDimensions;					//40-48 bytes
-	Vec4 pointAttractorOffsetAndStrength[8];	//48-176 bytes
-	Vec4 orbitAxis;								//176-192 bytes
-};
-
-struct AnimatedValuesConstants
-{
-	Vec4 velOverLifetimeXYKeys[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };							//0-128 bytes
-	Vec4 velOverLifetimeZAndSizeOverLifetimeXKeys[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };		//128-256 bytes
-	Vec4 colorOverLifetimeRGB[8];																//256-384 bytes
-	Vec4 colorOverLifetimeAlphaAndSizeOverLifetimeYKeys[8];										//384-512 bytes
-	Vec4 dragOverLifetimeRotOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };					//512-640 bytes
-	Vec4 orbitVelAndRadiusOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };					//640-768 bytes
-	unsigned int curveTypeBitFlags = 0;															//768-772 bytes
-	Vec3 padding;																				//772-784 bytes
-};
-
-struct SpawnDataConstants
-{
-	Vec2 lifetimeRange;						//0-8 bytes
-	Vec2 startSpeedRange;					//8-16 bytes
-	Vec2 startSizeRange;					//16-24 bytes
-	Vec2 startRotationRange;				//24-32 bytes
-	Vec3 offsetFromBase;					//32-44 bytes
-	unsigned int shapeType = 0;				//44-48 bytes
-	Vec3 boxDimensions;						//48-60 bytes
-	unsigned int sphereEmitFrom = 0;		//60-64 bytes
-	float sphereShapeRadius = 0.f;			//64-68 bytes
-	Vec3 boxForward;						//68-80 bytes
-	float coneShapeHalfAngle = 0.f;			//80-84 bytes
-	Vec3 worldPosition;						//84-96 bytes
-	unsigned int simSpace;					//96-100 bytes
-	Vec3 coneForward;						//100-112 bytes
-};
-
-struct CountConstants
-{
-	int emitCount = 0;			//0-4 bytes
-	int numParticles = 0;		//4-8 bytes
-	Vec2 padding;				//8-16 bytes
-};
-
-struct BillboardConstants
-{
-	Vec4 cameraPosition;		//0-16 bytes
-	Vec3 cameraUp;				//16-28 bytes
-	unsigned int renderMode;	//28-32 bytes
-};
-
-struct SortConstants
-{
-	//for odd-even sort
-	//Vec3 cameraPos;						//0-12 bytes
-	//unsigned int iterationNum = 0u;		//12-16 bytes
-	//unsigned int numParticles = 0u;		//16-20 bytes
-	//IntVec3 padding;						//20-32 bytes
-
-	//for bitonic sort
-	unsigned int numItemsToSort = 0;		//0-4 bytes
-	IntVec3 padding;						//4-16 bytes
-};
-
-struct SortData
-{
-	float distanceSq = 0.f;
-	float index = 0.f;
-};
-
-struct CPURenderConstants
-{
-	IntVec2 spritesheetLayout;												//0-8 bytes
-	Vec2 padding;															//8-16 bytes
-	Vec4 sizeXYOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };			//16-144 bytes
-	Vec4 orbitRadiusOverLifetime[8] = { Vec4(-1.f, -1.f, -1.f, -1.f) };		//144-276 bytes
-	Vec3 orbitAxis;															//276-288 bytes
-	unsigned int curveModeFlags = 0;										//288-292 bytes
-};
-
-struct IndirectDispatchData
-{
-	unsigned int threadGroupX = 1U;
-	unsigned int threadGroupY = 1U;
-	unsigned int threadGroupZ = 1U;
-};
-
-struct IndirectDrawData
-{
-	unsigned int vertexPerInstance = 0U;
-	unsigned int instanceCount = 0U;
-	unsigned int startVertexLocation = 0U;
-	unsigned int startInstanceLocation = 0U;
-};
+constexpr int GPU_READBACK_RING_SIZE = 3;
+static_assert(SIMULATION_THREAD_COUNT == 128, "SIMULATION_THREAD_COUNT must match the define in ParticleIndirectArgsShader.hpp");
 
 ParticleEmitter::ParticleEmitter(ParticleSystem* parentParticleSystem, const XmlElement* emitterElement)
 	:m_particleSystem(parentParticleSystem), m_renderer(m_particleSystem->m_renderer), m_jobSystem(m_particleSystem->m_jobSystem), m_gpuParticles(m_particleSystem->m_gpuParticles)
@@ -225,7 +116,9 @@ void ParticleEmitter::SpawnParticle(float deltaSeconds, const Camera& camera)
 		}
 	}
 
-	if (m_gpuParticles)
+	if (m_gpuParticles && m_computeEmulator)
+		SpawnParticlesOnEmulator(particlesToEmit, deltaSeconds, camera);
+	else if (m_gpuParticles)
 		SpawnParticlesOnGPU(particlesToEmit, deltaSeconds, camera);
 	else
 		SpawnParticlesOnCPU(particlesToEmit, deltaSeconds);
@@ -280,19 +173,26 @@ void ParticleEmitter::SpawnParticlesOnGPU(unsigned int particlesToEmit, float de
 
 	UpdateAndBindGPUSimConstants(deltaSeconds, camera);
 
-#if defined(_DEBUG)
-	unsigned int deadListCount = 0;
-	m_renderer->CopyGPUStructCount(m_particleCount, 0, m_deadParticleListUAV);
-	m_renderer->CopyGPUToCPU(&deadListCount, sizeof(int), m_particleCount);
-	GUARANTEE_RECOVERABLE(deadListCount == m_currentCountBuffer.deadListSize, "Mismatch in dead particle list count");
-	/*if (deadListCount != m_currentCountBuffer.deadListSize)
+	//stepping through frames in debug mode can afford a full sync, so validate the dead list against exact counts there
+	if (m_debugMode)
 	{
-		m_renderer->StartRenderDocFrameCapture();
-	}*/
-#endif
+		unsigned int deadListCount = 0;
+		m_renderer->CopyOverResourcesInGPU(m_stagingCountBuffer, m_countBuffer);
+		m_renderer->CopyGPUToCPU(&m_currentCountBuffer, sizeof(CountBuffer), m_stagingCountBuffer);
+		m_spawnedParticlesAtLastReadback = (unsigned int)m_currentTotalSpawnedParticles;
+		m_renderer->CopyGPUStructCount(m_particleCount, 0, m_deadParticleListUAV);
+		m_renderer->CopyGPUToCPU(&deadListCount, sizeof(int), m_particleCount);
+		GUARANTEE_RECOVERABLE(deadListCount == m_currentCountBuffer.deadListSize, "Mismatch in dead particle list count");
+	}
 
+	//the count buffer is a few frames old, particles emitted since then may already hold slots it reports as free.
+	//particles that died since only free up more slots, so this never over spawns
+	unsigned int particlesInFlight = (unsigned int)m_currentTotalSpawnedParticles - m_spawnedParticlesAtLastReadback;
 	int slotsRemaining = (m_currentCountBuffer.maxParticles - m_currentCountBuffer.lastAliveParticleIndex) + m_currentCountBuffer.deadListSize;
 	GUARANTEE_OR_DIE(slotsRemaining >= 0, "Slots can't be negative");
+	slotsRemaining -= (int)particlesInFlight;
+	if (slotsRemaining < 0)
+		slotsRemaining = 0;
 	if (particlesToEmit > (unsigned int)slotsRemaining)
 		particlesToEmit = slotsRemaining;
 
@@ -325,6 +225,32 @@ void ParticleEmitter::SpawnParticlesOnGPU(unsigned int particlesToEmit, float de
 	m_debugData.m_numParticlesSpawned += particlesToEmit;
 }
 
+void ParticleEmitter::SpawnParticlesOnEmulator(unsigned int particlesToEmit, float deltaSeconds, const Camera& camera)
+{
+	if (m_debugMode && !m_debugStepNow)
+		return;
+
+	SpawnDataConstants spawnConstants;
+	GPUSimConstants simConstants;
+	AnimatedValuesConstants animValueConstants;
+	BillboardConstants billboardConstants;
+	BuildGPUSimConstants(deltaSeconds, camera, spawnConstants, simConstants, animValueConstants, billboardConstants);
+	m_computeEmulator->SetConstants(simConstants, animValueConstants, spawnConstants, billboardConstants);
+
+	//the emulator count buffer is always current, so there is no stale readback to account for
+	unsigned int slotsRemaining = m_computeEmulator->GetSlotsRemaining();
+	if (particlesToEmit > slotsRemaining)
+		particlesToEmit = slotsRemaining;
+
+	CountConstants constant;
+	constant.emitCount = particlesToEmit;
+	constant.numParticles = m_currentTotalSpawnedParticles;
+	m_computeEmulator->Spawn(constant);
+	m_currentTotalSpawnedParticles += particlesToEmit;
+
+	m_debugData.m_numParticlesSpawned += particlesToEmit;
+}
+
 void ParticleEmitter::UpdateStatsFromGPU()
 {
 	m_debugData.m_aliveParticles = m_currentCountBuffer.listSize - m_currentCountBuffer.deadListSize;
@@ -360,6 +286,7 @@ void ParticleEmitter::ReleaseResources()
 	DX_SAFE_RELEASE(m_stagingCountBuffer);
 	DX_SAFE_RELEASE(m_cpuParticleIndicies);
 	DX_SAFE_RELEASE(m_dataToSort);
+	DX_SAFE_RELEASE(m_indirectArgsBuffer);
 
 	//release UAVs and SRVs
 	DX_SAFE_RELEASE(m_particleDataVSSRV);
@@ -372,6 +299,7 @@ void ParticleEmitter::ReleaseResources()
 	DX_SAFE_RELEASE(m_cpuParticleIndexSRV);
 	DX_SAFE_RELEASE(m_dataToSortUAV);
 	DX_SAFE_RELEASE(m_sortedDataSRV);
+	DX_SAFE_RELEASE(m_indirectArgsUAV);
 
 	//release compute shaders
 	DX_SAFE_RELEASE(m_setupSimCS);
@@ -379,6 +307,8 @@ void ParticleEmitter::ReleaseResources()
 	DX_SAFE_RELEASE(m_simulateCS);
 	DX_SAFE_RELEASE(m_finishSimCS);
 	DX_SAFE_RELEASE(m_sortCS);
+	DX_SAFE_RELEASE(m_indirectArgsCS);
+	DX_SAFE_RELEASE(m_sortPadCS);
 
 	delete m_gpuSimCBO;
 	m_gpuSimCBO = nullptr;
@@ -394,13 +324,24 @@ void ParticleEmitter::ReleaseResources()
 	m_gpuSortCBO = nullptr;
 	delete m_cpuParticlesCBO;
 	m_cpuParticlesCBO = nullptr;
+	delete m_computeEmulator;
+	m_computeEmulator = nullptr;
+	delete m_countReadbackRing;
+	m_countReadbackRing = nullptr;
+	delete m_readbackBackend;
+	m_readbackBackend = nullptr;
 }
 
 void ParticleEmitter::CreateResources()
 {
 	m_particleTexture = m_renderer->CreateOrGetTextureFromFile(m_emitterData.m_textureFilepath.c_str());
 
-	if (m_gpuParticles)
+	if (m_gpuParticles && m_particleSystem->m_particlesManager->IsEmulatingGPUSimulation())
+	{
+		InitializeEmulatedSimulationResources();
+		m_currentCountBuffer = m_computeEmulator->GetCountBuffer();
+	}
+	else if (m_gpuParticles)
 	{
 		InitializeGPUSimulationResource();
 		InitializeGPUSortResources();
@@ -416,6 +357,7 @@ void ParticleEmitter::CreateResources()
 		m_renderer->CreateShaderResourceView(&m_cpuParticleIndexSRV, m_cpuParticleIndicies);
 		m_gpuBillboardCBO = m_renderer->CreateConstantBuffer(sizeof(BillboardConstants));
 		m_cpuParticlesCBO = m_renderer->CreateConstantBuffer(sizeof(CPURenderConstants));
+		UpdateCPURenderConstants();
 		m_particles.reserve(m_emitterData.m_maxParticles);
 	}
 }
@@ -472,10 +414,28 @@ int ParticleEmitter::PartitionParticleListForSort(int minParticleListIndex, int
 
 void ParticleEmitter::RunBitonicSort()
 {
+	//the list only grows by spawned slots, so stale list size plus particles spawned since is an upper bound
+	unsigned int particlesInFlight = (unsigned int)m_currentTotalSpawnedParticles - m_spawnedParticlesAtLastReadback;
+	unsigned int maxListSize = static_cast<unsigned int>(m_emitterData.m_maxParticles);
 	SortConstants sortCB;
-	sortCB.numItemsToSort = m_currentCountBuffer.listSize;
+	sortCB.numItemsToSort = m_computeEmulator ? m_currentCountBuffer.listSize : std::min(m_currentCountBuffer.listSize + particlesInFlight, maxListSize);
 	m_renderer->CopyCPUToGPU(&sortCB, sizeof(SortConstants), m_gpuSortCBO);
 
+	//entries between the exact gpu list size and that bound can still hold keys of particles that died since, so they
+	//get an FLT_MAX key first and sort behind every live particle
+	if (!m_computeEmulator && sortCB.numItemsToSort > 0)
+	{
+		m_renderer->BindComputeShader(m_sortPadCS);
+		m_renderer->BindComputeShaderUAV(m_countBufferUAV, 0);
+		m_renderer->BindComputeShaderUAV(m_dataToSortUAV, 1);
+		unsigned int padThreadGroupCount = (sortCB.numItemsToSort + SIMULATION_THREAD_COUNT - 1) / SIMULATION_THREAD_COUNT;
+		m_renderer->DispatchComputeShader(padThreadGroupCount, 1, 1);
+
+		m_renderer->BindComputeShader(nullptr);
+		m_renderer->BindComputeShaderUAV(m_nullUAV, 0);
+		m_renderer->BindComputeShaderUAV(m_nullUAV, 1);
+	}
+
 	m_bitonicSort.run(m_emitterData.m_maxParticles, m_dataToSortUAV, m_gpuSortCBO->m_buffer);
 }
 
@@ -503,6 +463,16 @@ void ParticleEmitter::RunBitonicSort()
 
 void ParticleEmitter::RenderGPUParticles() const
 {
+	if (m_computeEmulator)
+	{
+		//fill the buffers the compute stages would have left on the gpu
+		m_renderer->CopyCPUToGPU(m_computeEmulator->GetParticleData(), sizeof(Particle) * m_currentCountBuffer.listSize, m_particleVertexDataVSCopy);
+		m_renderer->CopyCPUToGPU(m_computeEmulator->GetSortData(), sizeof(SortData) * m_currentCountBuffer.listSize, m_dataToSort);
+		m_renderer->CopyCPUToGPU(&m_computeEmulator->GetSimConstants(), sizeof(GPUSimConstants), m_gpuSimCBO);
+		m_renderer->CopyCPUToGPU(&m_computeEmulator->GetAnimatedValuesConstants(), sizeof(AnimatedValuesConstants), m_gpuAnimatedValuesCBO);
+		m_renderer->CopyCPUToGPU(&m_computeEmulator->GetBillboardConstants(), sizeof(BillboardConstants), m_gpuBillboardCBO);
+	}
+
 	m_renderer->BindModelConstants();
 	m_renderer->BindShader(m_gpuParticleShader);
 	m_renderer->BindConstantBuffer(GPU_CONSTANT_BUFFER_SLOT, m_gpuSimCBO);
@@ -515,11 +485,18 @@ void ParticleEmitter::RenderGPUParticles() const
 	m_renderer->GetDeviceContext()->VSSetShaderResources(1, 2, srvToBind);
 	m_renderer->BindTexture(m_particleTexture, 0, true);
 
-	m_renderer->GetDeviceContext()->Draw(m_currentCountBuffer.listSize * 6, 0);
+	if (m_computeEmulator)
+	{
+		m_renderer->GetDeviceContext()->Draw(m_currentCountBuffer.listSize * 6, 0);
+	}
+	else
+	{
+		m_renderer->DrawIndirect(m_indirectArgsBuffer, sizeof(IndirectDispatchData));
+	}
 	m_renderer->BindShaderByName("Default");
 
 	//frame capture began in SpawnParticlesOnGPU()
-	if (m_debugMode)
+	if (m_debugMode && !m_computeEmulator)
 	{
 		m_renderer->EndRenderDocFrameCapture();
 	}
@@ -528,6 +505,23 @@ void ParticleEmitter::RenderGPUParticles() const
 void ParticleEmitter::RenderCPUParticles() const
 {
 	m_renderer->CopyCPUToGPU(m_particles.data(), sizeof(m_particles[0]) * m_particles.size(), m_cpuParticleIndicies);
+	BindCPUParticleRenderState();
+	m_renderer->GetDeviceContext()->VSSetShaderResources(2, 1, &m_cpuParticleIndexSRV);
+	m_renderer->GetDeviceContext()->Draw((int)m_particles.size() * 6, 0);
+	m_renderer->BindShaderByName("Default");
+}
+
+void ParticleEmitter::BindCommonRenderState() const
+{
+	m_renderer->SetModelMatrix(m_emitterData.m_simulationSpace == SimulationSpace::LOCAL ? GetModelMatrix() : Mat44::IDENTITY);
+	m_renderer->SetModelColor(m_emitterData.m_startColor);
+	m_renderer->SetDepthStencilState(DepthTest::LESSEQUAL, false);
+	m_renderer->SetBlendMode(m_emitterData.m_blendMode);
+}
+
+void ParticleEmitter::BindCPUParticleRenderState() const
+{
+	BindCommonRenderState();
 	UpdateAndBindCPURenderConstants();
 	m_renderer->BindModelConstants();
 	m_renderer->BindShader(m_cpuParticleShader);
@@ -536,26 +530,73 @@ void ParticleEmitter::RenderCPUParticles() const
 	m_renderer->GetDeviceContext()->IASetInputLayout(nullptr);
 	m_renderer->GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	m_renderer->GetDeviceContext()->VSSetShaderResources(1, 1, &(m_particleSystem->m_particlePool->m_particlePoolSRV));
-	m_renderer->GetDeviceContext()->VSSetShaderResources(2, 1, &m_cpuParticleIndexSRV);
 	m_renderer->BindTexture(m_particleTexture, 0, true);
-	m_renderer->GetDeviceContext()->Draw((int)m_particles.size() * 6, 0);
-	m_renderer->BindShaderByName("Default");
+}
+
+ParticleRenderItem ParticleEmitter::GetRenderItem() const
+{
+	ParticleRenderItem item;
+	item.m_emitter = this;
+	item.m_canBatch = !m_gpuParticles;
+	item.m_key.m_texture = m_particleTexture;
+	item.m_key.m_blendMode = m_emitterData.m_blendMode;
+	item.m_key.m_needsSorting = m_emitterData.m_blendMode != BlendMode::ADDITIVE;
+	if (m_gpuParticles)
+		return item;
+
+	item.m_key.m_shader = m_cpuParticleShader;
+	item.m_key.m_particlePool = m_particleSystem->m_particlePool;
+	item.m_key.m_renderMode = static_cast<unsigned int>(m_emitterData.m_renderMode);
+	item.m_key.m_modelColor = m_emitterData.m_startColor;
+	item.m_key.m_modelTranslation = m_emitterData.m_simulationSpace == SimulationSpace::LOCAL ? m_particleSystem->m_position : Vec3();
+	item.m_key.m_renderConstants = &m_cpuRenderConstants;
+	item.m_key.m_renderConstantsHash = m_cpuRenderConstantsHash;
+	item.m_particleIndices = m_particles.data();
+	item.m_numParticles = (unsigned int)m_particles.size();
+	return item;
 }
 
 void ParticleEmitter::InitializeGPUSortResources()
 {
 	m_bitonicSort.init(m_renderer);
 
-	m_renderer->CreateD3DUnorderedAccessBuffer(&m_dataToSort, sizeof(SortData) * m_emitterData.m_maxParticles, sizeof(SortData), nullptr);
+	std::vector<SortData> initialSortData(m_emitterData.m_maxParticles);
+	for (int i = 0; i < initialSortData.size(); i++)
+	{
+		initialSortData[i].distanceSq = FLT_MAX;
+		initialSortData[i].index = static_cast<float>(i);
+	}
+	m_renderer->CreateD3DUnorderedAccessBuffer(&m_dataToSort, sizeof(SortData) * m_emitterData.m_maxParticles, sizeof(SortData), initialSortData.data());
 	m_renderer->CreateUnorderedAccessView(&m_dataToSortUAV, m_dataToSort, UAVType::REGULAR);
 	m_renderer->CreateShaderResourceView(&m_sortedDataSRV, m_dataToSort);
 
 	m_gpuSortCBO = m_renderer->CreateConstantBuffer(sizeof(SortConstants));
 }
 
+void ParticleEmitter::InitializeEmulatedSimulationResources()
+{
+	ParticleComputeEmulatorConfig emulatorConfig;
+	emulatorConfig.m_maxParticles = m_emitterData.m_maxParticles;
+	emulatorConfig.m_jobSystem = m_jobSystem;
+	m_computeEmulator = new ParticleComputeEmulator(emulatorConfig);
+
+	//only the buffers read by the particle vertex shader are needed, they are written from the cpu every frame
+	m_renderer->CreateD3DUnorderedAccessBuffer(&m_particleVertexDataVSCopy, sizeof(Particle) * m_emitterData.m_maxParticles, sizeof(Particle), nullptr, true);
+	m_renderer->CreateShaderResourceView(&m_particleDataVSSRV, m_particleVertexDataVSCopy);
+	m_renderer->CreateD3DUnorderedAccessBuffer(&m_dataToSort, sizeof(SortData) * m_emitterData.m_maxParticles, sizeof(SortData), nullptr, true);
+	m_renderer->CreateShaderResourceView(&m_sortedDataSRV, m_dataToSort);
+	m_gpuParticleShader = m_renderer->CreateOrGetShader("Data/Shaders/Particles");
+
+	m_gpuSimCBO = m_renderer->CreateConstantBuffer(sizeof(GPUSimConstants));
+	m_gpuAnimatedValuesCBO = m_renderer->CreateConstantBuffer(sizeof(AnimatedValuesConstants));
+	m_gpuBillboardCBO = m_renderer->CreateConstantBuffer(sizeof(BillboardConstants));
+}
+
 void ParticleEmitter::UpdateParticles(float deltaSeconds, const Camera& camera)
 {
-	if (m_gpuParticles)
+	if (m_gpuParticles && m_computeEmulator)
+		UpdateOnEmulator();
+	else if (m_gpuParticles)
 		UpdateOnGPU(deltaSeconds, camera);
 	else
 		UpdateOnCPU(deltaSeconds, camera);
@@ -611,10 +652,8 @@ void ParticleEmitter::UpdateOnGPU(float deltaSeconds, const Camera& camera)
 	if (m_debugMode && !m_debugStepNow)
 		return;
 
-	//get total num of particles in list after spawn stage
-	CountBuffer countBuffer;
-	m_renderer->CopyOverResourcesInGPU(m_stagingCountBuffer, m_countBuffer);
-	m_renderer->CopyGPUToCPU(&countBuffer, sizeof(CountBuffer), m_stagingCountBuffer);
+	//size the simulate dispatch from the post spawn list size on the gpu
+	WriteIndirectArgsOnGPU();
 
 	//bind resources and dispatch simulate cs
 	m_renderer->BindComputeShader(m_simulateCS);
@@ -622,9 +661,7 @@ void ParticleEmitter::UpdateOnGPU(float deltaSeconds, const Camera& camera)
 	m_renderer->BindComputeShaderUAV(m_deadParticleListUAV, 1);
 	m_renderer->BindComputeShaderUAV(m_countBufferUAV, 2);
 	m_renderer->BindComputeShaderUAV(m_dataToSortUAV, 3);
-	unsigned int simThreadGroupCount = static_cast<unsigned int>(ceilf((float)countBuffer.listSize / (float)SIMULATION_THREAD_COUNT));
-	simThreadGroupCount = Clamp(simThreadGroupCount, 1U, UINT32_MAX);
-	m_renderer->DispatchComputeShader(simThreadGroupCount, 1, 1);
+	m_renderer->DispatchIndirectComputeShader(m_indirectArgsBuffer, 0);
 
 	//clear uavs
 	m_renderer->BindComputeShaderUAV(m_nullUAV, 0);
@@ -634,9 +671,12 @@ void ParticleEmitter::UpdateOnGPU(float deltaSeconds, const Camera& camera)
 
 	m_renderer->CopyOverResourcesInGPU(m_particleVertexDataVSCopy, m_particleData);
 
-	//copy count buffer data for use in render and sort
-	m_renderer->CopyOverResourcesInGPU(m_stagingCountBuffer, m_countBuffer);
-	m_renderer->CopyGPUToCPU(&m_currentCountBuffer, sizeof(CountBuffer), m_stagingCountBuffer);
+	//draw args from the post simulate list size
+	WriteIndirectArgsOnGPU();
+
+	//queue this frame's counts and pick up whichever earlier readbacks the gpu has finished
+	m_countReadbackRing->QueueReadback(m_countBuffer, (unsigned int)m_currentTotalSpawnedParticles);
+	UpdateCountsFromReadback();
 
 	//run sort
 	if (m_emitterData.m_sortParticles)
@@ -649,6 +689,43 @@ void ParticleEmitter::UpdateOnGPU(float deltaSeconds, const Camera& camera)
 	m_debugStepNow = false;
 }
 
+void ParticleEmitter::WriteIndirectArgsOnGPU()
+{
+	m_renderer->BindComputeShader(m_indirectArgsCS);
+	m_renderer->BindComputeShaderUAV(m_countBufferUAV, 0);
+	m_renderer->BindComputeShaderUAV(m_indirectArgsUAV, 1);
+	m_renderer->DispatchComputeShader(1, 1, 1);
+
+	m_renderer->BindComputeShader(nullptr);
+	m_renderer->BindComputeShaderUAV(m_nullUAV, 0);
+	m_renderer->BindComputeShaderUAV(m_nullUAV, 1);
+}
+
+void ParticleEmitter::UpdateCountsFromReadback()
+{
+	if (m_countReadbackRing->PollReadbacks())
+	{
+		m_countReadbackRing->GetLatestData(m_currentCountBuffer);
+		m_spawnedParticlesAtLastReadback = m_countReadbackRing->GetLatestTag();
+	}
+}
+
+void ParticleEmitter::UpdateOnEmulator()
+{
+	if (m_debugMode && !m_debugStepNow)
+		return;
+
+	m_computeEmulator->Simulate();
+	m_computeEmulator->FinishSimulation();
+	m_currentCountBuffer = m_computeEmulator->GetCountBuffer();
+
+	if (m_emitterData.m_sortParticles)
+	{
+		m_computeEmulator->Sort();
+	}
+	m_debugStepNow = false;
+}
+
 void ParticleEmitter::AddVertsForParticle(std::vector<Vertex_PCU>& cpuMeshVertices, std::vector<unsigned int>& cpuMeshIndices, Vertex_PCU sampleVert, const Particle& particle, const Vec3& cameraPos, const Vec3& cameraUp)
 {
 	Vec3 upVector, rightVector, forwardVector;
@@ -707,13 +784,9 @@ void ParticleEmitter::Render() const
 	if (m_emitterData.m_stopRender)
 		return;
 
-	m_renderer->SetModelMatrix(m_emitterData.m_simulationSpace == SimulationSpace::LOCAL ? GetModelMatrix() : Mat44::IDENTITY);
-	m_renderer->SetModelColor(m_emitterData.m_startColor);
-	m_renderer->SetDepthStencilState(DepthTest::LESSEQUAL, false);
-	m_renderer->SetBlendMode(m_emitterData.m_blendMode);
-
 	if (m_gpuParticles)
 	{
+		BindCommonRenderState();
 		RenderGPUParticles();
 	}
 	else
@@ -757,12 +830,23 @@ void ParticleEmitter::InitializeGPUSimulationResource()
 	countBuffer.maxParticles = m_emitterData.m_maxParticles;
 	m_renderer->CreateD3DUnorderedAccessBuffer(&m_countBuffer, sizeof(CountBuffer), sizeof(CountBuffer), &countBuffer);
 	m_renderer->CreateD3DStagingBuffer(&m_stagingCountBuffer, sizeof(CountBuffer), sizeof(CountBuffer));
+	IndirectDispatchData dispatchArgs;
+	IndirectDrawData drawArgs;
+	unsigned char initialIndirectArgs[sizeof(IndirectDispatchData) + sizeof(IndirectDrawData)];
+	memcpy(initialIndirectArgs, &dispatchArgs, sizeof(IndirectDispatchData));
+	memcpy(initialIndirectArgs + sizeof(IndirectDispatchData), &drawArgs, sizeof(IndirectDrawData));
+	m_renderer->CreateD3DIndirectArgsBuffer(&m_indirectArgsBuffer, sizeof(initialIndirectArgs), sizeof(unsigned int), initialIndirectArgs);
+
+	m_readbackBackend = new RendererReadbackBackend(m_renderer);
+	m_countReadbackRing = new GPUReadbackRing(m_readbackBackend, sizeof(CountBuffer), GPU_READBACK_RING_SIZE);
+	m_spawnedParticlesAtLastReadback = (unsigned int)m_currentTotalSpawnedParticles;
 
 	m_renderer->CreateUnorderedAccessView(&m_particleDataUAV, m_particleData, UAVType::REGULAR);
 	m_renderer->CreateUnorderedAccessView(&m_deadParticleListUAV, m_deadParticleIndexList, UAVType::APPEND);
 	m_renderer->CreateUnorderedAccessView(&m_afterSpawnAliveParticleListUAV, m_afterSpawnAliveParticleList, UAVType::REGULAR);
 	m_renderer->CreateUnorderedAccessView(&m_afterSimAliveParticleListUAV, m_afterSimAliveParticleList, UAVType::REGULAR);
 	m_renderer->CreateUnorderedAccessView(&m_countBufferUAV, m_countBuffer, UAVType::REGULAR);
+	m_renderer->CreateUnorderedAccessView(&m_indirectArgsUAV, m_indirectArgsBuffer, UAVType::RAW);
 
 	m_renderer->BindComputeShaderUAV(m_deadParticleListUAV, 0, 0);
 
@@ -771,6 +855,8 @@ void ParticleEmitter::InitializeGPUSimulationResource()
 	m_renderer->CreateAndCompileComputeShader("Data/Shaders/SpawnCS.hlsl", &m_spawnCS);
 	m_renderer->CreateAndCompileComputeShader("Data/Shaders/SimulateCS.hlsl", &m_simulateCS);
 	m_renderer->CreateAndCompileComputeShader("Data/Shaders/OddEvenSortCS.hlsl", &m_sortCS);
+	m_renderer->CreateAndCompileComputeShaderFromSource("ParticleIndirectArgsCS", particleIndirectArgsShaderSource, &m_indirectArgsCS);
+	m_renderer->CreateAndCompileComputeShaderFromSource("ParticleSortPadCS", particleSortPadShaderSource, &m_sortPadCS);
 	m_gpuParticleShader = m_renderer->CreateOrGetShader("Data/Shaders/Particles");
 
 	//create constant buffer
@@ -783,8 +869,26 @@ void ParticleEmitter::InitializeGPUSimulationResource()
 
 void ParticleEmitter::UpdateAndBindGPUSimConstants(float deltaSeconds, const Camera& camera)
 {
-	//update and bind spawn constants
 	SpawnDataConstants spawnConstants;
+	GPUSimConstants simConstants;
+	AnimatedValuesConstants animValueConstants;
+	BillboardConstants billboardConstants;
+	BuildGPUSimConstants(deltaSeconds, camera, spawnConstants, simConstants, animValueConstants, billboardConstants);
+
+	m_renderer->CopyCPUToGPU(&spawnConstants, sizeof(SpawnDataConstants), m_gpuSpawnParticlesCBO);
+	m_renderer->BindConstantBufferToComputeShader(GPU_SPAWN_PARTICLES_BUFFER_SLOT, m_gpuSpawnParticlesCBO);
+	m_renderer->CopyCPUToGPU(&simConstants, sizeof(GPUSimConstants), m_gpuSimCBO);
+	m_renderer->BindConstantBufferToComputeShader(GPU_CONSTANT_BUFFER_SLOT, m_gpuSimCBO);
+	m_renderer->CopyCPUToGPU(&animValueConstants, sizeof(AnimatedValuesConstants), m_gpuAnimatedValuesCBO);
+	m_renderer->BindConstantBufferToComputeShader(GPU_ANIMATED_VALUE_BUFFER_SLOT, m_gpuAnimatedValuesCBO);
+	m_renderer->CopyCPUToGPU(&billboardConstants, sizeof(BillboardConstants), m_gpuBillboardCBO);
+	m_renderer->BindConstantBufferToComputeShader(GPU_BILLBOARD_BUFFER_SLOT, m_gpuBillboardCBO);
+}
+
+void ParticleEmitter::BuildGPUSimConstants(float deltaSeconds, const Camera& camera, SpawnDataConstants& spawnConstants, GPUSimConstants& simConstants,
+	AnimatedValuesConstants& animValueConstants, BillboardConstants& billboardConstants) const
+{
+	//spawn constants
 	spawnConstants.lifetimeRange = Vec2(m_emitterData.m_particleLifetime.m_min, m_emitterData.m_particleLifetime.m_max);
 	spawnConstants.startSpeedRange = Vec2(m_emitterData.m_startSpeed.m_min, m_emitterData.m_startSpeed.m_max);
 	spawnConstants.startSizeRange = Vec2(m_emitterData.m_startSize.m_min, m_emitterData.m_startSize.m_max);
@@ -811,12 +915,9 @@ void ParticleEmitter::UpdateAndBindGPUSimConstants(float deltaSeconds, const Cam
 		spawnConstants.boxDimensions = box->m_dimensions;
 		spawnConstants.boxForward = box->m_forward;
 	}
-	m_renderer->CopyCPUToGPU(&spawnConstants, sizeof(SpawnDataConstants), m_gpuSpawnParticlesCBO);
-	m_renderer->BindConstantBufferToComputeShader(GPU_SPAWN_PARTICLES_BUFFER_SLOT, m_gpuSpawnParticlesCBO);
 
 	//simulation constant data
 	RandomNumberGenerator rng;
-	GPUSimConstants simConstants;
 	simConstants.gravity = Vec3(0.f, 0.f, -10.f);
 	simConstants.deltaSeconds = deltaSeconds;
 	m_emitterData.m_startColor.GetAsFloats(simConstants.startColor);
@@ -831,12 +932,8 @@ void ParticleEmitter::UpdateAndBindGPUSimConstants(float deltaSeconds, const Cam
 			attractor.m_offsetFromEmitter.z, attractor.m_strength);
 	}
 	simConstants.orbitAxis = Vec4(m_emitterData.m_orbitalVelocityAxis, 0.f);
-	m_renderer->CopyCPUToGPU(&simConstants, sizeof(GPUSimConstants), m_gpuSimCBO);
-	m_renderer->BindConstantBufferToComputeShader(GPU_CONSTANT_BUFFER_SLOT, m_gpuSimCBO);
 
 	//animated properties constant data
-	AnimatedValuesConstants animValueConstants;
-
 	//encode all "over lifetime" properties in the constant buffer
 	//velOverLifetimeXYKeys = vec4(velX value, velX time, velY value, velY time)
 	//velOverLifetimeZAndSizeOverLifetimeKeys = vec4(velZ value, velZ time, sizeX value, sizeX time);
@@ -886,21 +983,16 @@ void ParticleEmitter::UpdateAndBindGPUSimConstants(float deltaSeconds, const Cam
 		animValueConstants.colorOverLifetimeAlphaAndSizeOverLifetimeYKeys[i].x = floatColorVals[3];
 		animValueConstants.colorOverLifetimeAlphaAndSizeOverLifetimeYKeys[i].y = colorKeys[i].GetTime();
 	}
-	m_renderer->CopyCPUToGPU(&animValueConstants, sizeof(AnimatedValuesConstants), m_gpuAnimatedValuesCBO);
-	m_renderer->BindConstantBufferToComputeShader(GPU_ANIMATED_VALUE_BUFFER_SLOT, m_gpuAnimatedValuesCBO);
 
 	//billboard constant data
-	BillboardConstants billboardConstants;
 	Vec3 camPos = camera.GetPosition();
 	Vec3 camUp = camera.GetUpVector();
 	billboardConstants.cameraPosition =  Vec4(camPos.x, camPos.y, camPos.z, 0.f);
 	billboardConstants.cameraUp = Vec3(camUp.x, camUp.y, camUp.z);
 	billboardConstants.renderMode = static_cast<unsigned int>(m_emitterData.m_renderMode);
-	m_renderer->CopyCPUToGPU(&billboardConstants, sizeof(BillboardConstants), m_gpuBillboardCBO);
-	m_renderer->BindConstantBufferToComputeShader(4, m_gpuBillboardCBO);
 }
 
-void ParticleEmitter::UpdateAndBindCPURenderConstants() const
+void ParticleEmitter::UpdateCPURenderConstants()
 {
 	CPURenderConstants constants;
 	constants.spritesheetLayout = m_emitterData.m_isSpriteSheetTexture ? m_emitterData.m_spriteSheetGridLayout : IntVec2::ONE;
@@ -916,7 +1008,13 @@ void ParticleEmitter::UpdateAndBindCPURenderConstants() const
 		constants.curveModeFlags, ANIM_CURVE_BIT_FLAG_ORBIT_RADIUS_OVERLIFE, m_emitterData.m_orbitalRadiusModifier);
 
 	constants.orbitAxis = m_emitterData.m_orbitalVelocityAxis;
-	m_renderer->CopyCPUToGPU(&constants, sizeof(CPURenderConstants), m_cpuParticlesCBO);
+	m_cpuRenderConstants = constants;
+	m_cpuRenderConstantsHash = ParticleRenderBatcher::HashRenderConstants(m_cpuRenderConstants);
+}
+
+void ParticleEmitter::UpdateAndBindCPURenderConstants() const
+{
+	m_renderer->CopyCPUToGPU(&m_cpuRenderConstants, sizeof(CPURenderConstants), m_cpuParticlesCBO);
 
 	//use the gpu cbo for the billboard constants as well
 	BillboardConstants billboardConstants;
@@ -963,6 +1061,16 @@ ParticleEmitterData ParticleEmitter::GetEmitterData() const
 	return m_emitterData;
 }
 
+int ParticleEmitter::GetDrawOrder() const
+{
+	return m_emitterData.m_drawOrder;
+}
+
+bool ParticleEmitter::IsRenderingStopped() const
+{
+	return m_emitterData.m_stopRender;
+}
+
 Mat44 ParticleEmitter::GetModelMatrix() const
 {
 	return Mat44::CreateTranslation3D(m_particleSystem->m_position);
@@ -982,4 +1090,16 @@ void ParticleEmitter::UpdateEmitterData(const ParticleEmitterData& updatedData)
 {
 	m_emitterData = updatedData;
 	m_particleTexture = m_renderer->CreateOrGetTextureFromFile(m_emitterData.m_textureFilepath.c_str());
+	UpdateCPURenderConstants();
+}
+
+void ParticleEmitter::ReloadEmitterData(const ParticleEmitterData& reloadedData)
+{
+	//every buffer is sized by max particles, anything else is picked up by the running emitter
+	bool buffersFit = reloadedData.m_maxParticles == m_emitterData.m_maxParticles;
+	UpdateEmitterData(reloadedData);
+	if (!buffersFit)
+	{
+		Restart();
+	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Renderer/ParticleEmitterData.hpp"
+#include "Engine/Renderer/ParticleComputeData.hpp"
+#include "Engine/Renderer/ParticleRenderBatcher.hpp"
 #include "Engine/Core/Job.hpp"
 #include "Engine/Math/IntRange.hpp"
 #include "Engine/Math/Mat44.hpp"
@@ -17,6 +19,9 @@ class JobSystem;
 class Shader;
 class Texture;
 class ParticleSystem;
+class ParticleComputeEmulator;
+class GPUReadbackBackend;
+class GPUReadbackRing;
 
 struct Particle;
 struct ParticleEmitterData;
@@ -34,14 +39,6 @@ struct ParticleEmitterDebugData
 	bool m_isGPUSim = false;
 };
 
-struct CountBuffer
-{
-	unsigned int maxParticles = 0u;
-	unsigned int listSize = 0u;
-	unsigned int deadListSize = 0u;
-	unsigned int lastAliveParticleIndex = 0u;
-};
-
 class ParticleEmitter
 {
 public:
@@ -50,15 +47,20 @@ public:
 
 	void Update(float deltaSeconds, const Camera& camera);
 	void UpdateEmitterData(const ParticleEmitterData& updatedData);
+	void ReloadEmitterData(const ParticleEmitterData& reloadedData);		//keeps the buffers and particles unless max particles changed
 	void AddVertsForParticle(std::vector<Vertex_PCU>& cpuMeshVertices, std::vector<unsigned int>& cpuMeshIndices, Vertex_PCU sampleVert,
 		const Particle& particle, const Vec3& cameraPos, const Vec3& cameraUp);
 	void Render() const;
+	void BindCPUParticleRenderState() const;
+	ParticleRenderItem GetRenderItem() const;
 	void Restart();
 	void ChangeEmitterType(bool gpuEmitter);
 	void SetJobSystem(JobSystem* jobSystem);
 
 	ParticleEmitterDebugData GetDebugData() const;
 	ParticleEmitterData GetEmitterData() const;
+	int GetDrawOrder() const;
+	bool IsRenderingStopped() const;
 	Mat44 GetModelMatrix() const;
 
 	void ToggleDebugMode();
@@ -68,16 +70,24 @@ private:
 	void CreateResources();
 	void InitializeGPUSimulationResource();
 	void InitializeGPUSortResources();
+	void InitializeEmulatedSimulationResources();
 
 	void BuildCPUMesh(const Camera& camera);
 	void SpawnParticle(float deltaSeconds, const Camera& camera);
 	void SpawnParticlesOnCPU(unsigned int particlesToEmit, float deltaSeconds);
 	void SpawnParticlesOnGPU(unsigned int particlesToEmit, float deltaSeconds, const Camera& camera);
+	void SpawnParticlesOnEmulator(unsigned int particlesToEmit, float deltaSeconds, const Camera& camera);
 
 	void UpdateParticles(float deltaSeconds, const Camera& camera);
 	void UpdateOnCPU(float deltaSeconds, const Camera& camera);
 	void UpdateOnGPU(float deltaSeconds, const Camera& camera);
+	void UpdateOnEmulator();
+	void WriteIndirectArgsOnGPU();
+	void UpdateCountsFromReadback();
 	void UpdateAndBindGPUSimConstants(float deltaSeconds, const Camera& camera);
+	void BuildGPUSimConstants(float deltaSeconds, const Camera& camera, SpawnDataConstants& spawnConstants, GPUSimConstants& simConstants,
+		AnimatedValuesConstants& animValueConstants, BillboardConstants& billboardConstants) const;
+	void UpdateCPURenderConstants();
 	void UpdateAndBindCPURenderConstants() const;
 
 	void SortParticlesBasedOnDistanceFromCamera(int minParticleListIndex, int maxParticleListIndex);
@@ -91,6 +101,7 @@ private:
 	
 	void RenderGPUParticles() const;
 	void RenderCPUParticles() const;
+	void BindCommonRenderState() const;
 
 	void DebugPrintParticleData(const Particle& particle);
 	void UpdateDebugData();
@@ -117,6 +128,8 @@ private:
 	unsigned int m_numIndices = 0u;
 	float m_burstIntervalTimer = 999999.f;		//setting this timer high such that the burst particles emitted on the first frame
 	ConstantBuffer* m_cpuParticlesCBO = nullptr;
+	CPURenderConstants m_cpuRenderConstants;
+	unsigned int m_cpuRenderConstantsHash = 0;
 	ID3D11Buffer* m_cpuParticleIndicies = nullptr;
 	ID3D11ShaderResourceView* m_cpuParticleIndexSRV = nullptr;
 	Shader* m_cpuParticleShader = nullptr;
@@ -145,6 +158,7 @@ private:
 	ID3D11Buffer* m_countBuffer = nullptr;
 	ID3D11Buffer* m_stagingCountBuffer = nullptr;
 	ID3D11Buffer* m_dataToSort = nullptr;
+	ID3D11Buffer* m_indirectArgsBuffer = nullptr;
 
 	ID3D11UnorderedAccessView* m_particleDataUAV = nullptr;
 	ID3D11UnorderedAccessView* m_deadParticleListUAV = nullptr;
@@ -153,6 +167,7 @@ private:
 	ID3D11UnorderedAccessView* m_countBufferUAV = nullptr;
 	ID3D11UnorderedAccessView* m_dataToSortUAV = nullptr;
 	ID3D11UnorderedAccessView* m_sortedParticleListUAV = nullptr;
+	ID3D11UnorderedAccessView* m_indirectArgsUAV = nullptr;
 	ID3D11UnorderedAccessView* m_nullUAV = nullptr;
 	ID3D11ShaderResourceView* m_sortedDataSRV = nullptr;
 	ID3D11ShaderResourceView* m_particleDataVSSRV = nullptr;
@@ -163,6 +178,8 @@ private:
 	ID3D11ComputeShader* m_simulateCS = nullptr;
 	ID3D11ComputeShader* m_finishSimCS = nullptr;
 	ID3D11ComputeShader* m_sortCS = nullptr;
+	ID3D11ComputeShader* m_indirectArgsCS = nullptr;
+	ID3D11ComputeShader* m_sortPadCS = nullptr;
 	Shader* m_gpuParticleShader = nullptr;
 
 	ConstantBuffer* m_gpuSimCBO = nullptr;
@@ -173,6 +190,14 @@ private:
 	ConstantBuffer* m_gpuSortCBO = nullptr;
 
 	SortLib m_bitonicSort;
+
+	//count buffer readbacks arrive a few frames late instead of stalling, spawning budgets against the stale counts
+	GPUReadbackBackend* m_readbackBackend = nullptr;
+	GPUReadbackRing* m_countReadbackRing = nullptr;
+	unsigned int m_spawnedParticlesAtLastReadback = 0;
+
+	//cpu emulation of the compute stages, only created when the particles manager is set to emulate gpu particles
+	ParticleComputeEmulator* m_computeEmulator = nullptr;
 };
 
 template <typename T>
@@ -0,0 +1,59 @@
+#pragma once
+
+//writes the simulate dispatch args and the particle draw args from the gpu count buffer, so neither needs a cpu readback.
+//args buffer layout is IndirectDispatchData followed by IndirectDrawData, SIMULATION_THREAD_COUNT must match ParticleComputeData.hpp
+const char* particleIndirectArgsShaderSource = R"(
+	#define SIMULATION_THREAD_COUNT 128
+
+	struct CountBuffer
+	{
+		uint maxParticles;
+		uint listSize;
+		uint deadListSize;
+		uint lastAliveParticleIndex;
+	};
+
+	RWStructuredBuffer<CountBuffer> countBuffer : register(u0);
+	RWByteAddressBuffer indirectArgs : register(u1);
+
+	[numthreads(1, 1, 1)]
+	void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+	{
+		uint listSize = countBuffer[0].listSize;
+		uint simulateThreadGroups = max(1, (listSize + SIMULATION_THREAD_COUNT - 1) / SIMULATION_THREAD_COUNT);
+
+		//IndirectDispatchData
+		indirectArgs.Store3(0, uint3(simulateThreadGroups, 1, 1));
+
+		//IndirectDrawData, 6 verts per particle quad
+		indirectArgs.Store4(12, uint4(listSize * 6, 1, 0, 0));
+	}
+)";
+
+//resets every sort entry past the exact gpu list size to an FLT_MAX key, so whatever the simulate pass left there from an
+//earlier, bigger list sorts to the end instead of in between live particles. dispatched over the cpu's upper bound of the list
+const char* particleSortPadShaderSource = R"(
+	#define SIMULATION_THREAD_COUNT 128
+	#define FLT_MAX 3.402823466e+38f
+
+	struct CountBuffer
+	{
+		uint maxParticles;
+		uint listSize;
+		uint deadListSize;
+		uint lastAliveParticleIndex;
+	};
+
+	RWStructuredBuffer<CountBuffer> countBuffer : register(u0);
+	RWStructuredBuffer<float2> sortData : register(u1);		//SortData, distanceSq then index
+
+	[numthreads(SIMULATION_THREAD_COUNT, 1, 1)]
+	void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+	{
+		uint sortIndex = dispatchThreadId.x;
+		if (sortIndex >= countBuffer[0].listSize && sortIndex < countBuffer[0].maxParticles)
+		{
+			sortData[sortIndex] = float2(FLT_MAX, (float)sortIndex);
+		}
+	}
+)";
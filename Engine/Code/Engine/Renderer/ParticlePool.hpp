@@ -29,6 +29,8 @@ public:
 	unsigned int GetNumMaxParticles() const;
 	ID3D11Buffer* m_particlePoolData = nullptr;
 	ID3D11ShaderResourceView* m_particlePoolSRV = nullptr;
+	ID3D11Buffer* m_batchedIndexData = nullptr;				//particle indices for a batched draw, sized to the whole pool
+	ID3D11ShaderResourceView* m_batchedIndexSRV = nullptr;
 	unsigned int GetCurrentListSize();
 
 public:
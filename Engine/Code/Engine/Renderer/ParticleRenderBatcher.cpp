@@ -0,0 +1,212 @@
+#include <string.h>
+#include "Engine/Renderer/ParticleRenderBatcher.hpp"
+
+bool ParticleBatchKey::operator==(const ParticleBatchKey& compare) const
+{
+	if (m_texture != compare.m_texture || m_shader != compare.m_shader || m_particlePool != compare.m_particlePool)
+		return false;
+	if (m_blendMode != compare.m_blendMode || m_needsSorting != compare.m_needsSorting || m_renderMode != compare.m_renderMode)
+		return false;
+	if (m_modelColor != compare.m_modelColor || !(m_modelTranslation == compare.m_modelTranslation))
+		return false;
+	if (m_renderConstantsHash != compare.m_renderConstantsHash)
+		return false;
+	if (m_renderConstants == compare.m_renderConstants)
+		return true;
+	if (m_renderConstants == nullptr || compare.m_renderConstants == nullptr)
+		return false;
+
+	//same hash, make sure the curves actually match
+	return memcmp(m_renderConstants, compare.m_renderConstants, sizeof(CPURenderConstants)) == 0;
+}
+
+bool ParticleBatchKey::operator!=(const ParticleBatchKey& compare) const
+{
+	return !(*this == compare);
+}
+
+void ParticleRenderCommandRecorder::Reset()
+{
+	m_commands.clear();
+	m_indexData.clear();
+	m_numDrawCalls = 0;
+	m_numStateChanges = 0;
+	m_numUploads = 0;
+}
+
+void ParticleRenderCommandRecorder::RecordCommand(const ParticleRenderCommand& command)
+{
+	switch (command.m_type)
+	{
+	case ParticleRenderCommandType::BIND_STATE:
+		m_numStateChanges++;
+		break;
+	case ParticleRenderCommandType::UPLOAD_INDICES:
+		m_numUploads++;
+		break;
+	case ParticleRenderCommandType::DRAW:
+	case ParticleRenderCommandType::DRAW_EMITTER:
+		m_numDrawCalls++;
+		break;
+	default:
+		break;
+	}
+
+	m_commands.push_back(command);
+}
+
+unsigned int ParticleRenderCommandRecorder::AppendIndexData(const unsigned int* indices, unsigned int numIndices)
+{
+	unsigned int firstIndex = (unsigned int)m_indexData.size();
+	m_indexData.insert(m_indexData.end(), indices, indices + numIndices);
+	return firstIndex;
+}
+
+const std::vector<ParticleRenderCommand>& ParticleRenderCommandRecorder::GetCommands() const
+{
+	return m_commands;
+}
+
+const std::vector<unsigned int>& ParticleRenderCommandRecorder::GetIndexData() const
+{
+	return m_indexData;
+}
+
+int ParticleRenderCommandRecorder::GetNumDrawCalls() const
+{
+	return m_numDrawCalls;
+}
+
+int ParticleRenderCommandRecorder::GetNumStateChanges() const
+{
+	return m_numStateChanges;
+}
+
+int ParticleRenderCommandRecorder::GetNumUploads() const
+{
+	return m_numUploads;
+}
+
+static bool IsOrderIndependentBlendMode(BlendMode blendMode)
+{
+	return blendMode == BlendMode::ADDITIVE || blendMode == BlendMode::OPAQUE;
+}
+
+void ParticleRenderBatcher::BeginFrame()
+{
+	m_items.clear();
+	m_batches.clear();
+}
+
+void ParticleRenderBatcher::AddItem(const ParticleRenderItem& item)
+{
+	int itemIndex = (int)m_items.size();
+	m_items.push_back(item);
+
+	if (item.m_canBatch)
+	{
+		//walk back over batches whose draw order doesn't matter, stop at the first one that does. only additive and opaque
+		//particles come out the same drawn in any order, alpha blended ones only merge into the batch right before them
+		bool isItemOrderIndependent = !item.m_key.m_needsSorting && IsOrderIndependentBlendMode(item.m_key.m_blendMode);
+		for (int i = (int)m_batches.size() - 1; i >= 0; i--)
+		{
+			ParticleRenderBatch& batch = m_batches[i];
+			if (batch.m_canBatch && batch.m_key == item.m_key)
+			{
+				batch.m_itemIndices.push_back(itemIndex);
+				batch.m_numParticles += item.m_numParticles;
+				return;
+			}
+
+			if (!isItemOrderIndependent || !batch.m_canBatch || batch.m_key.m_needsSorting || !IsOrderIndependentBlendMode(batch.m_key.m_blendMode))
+				break;
+		}
+	}
+
+	ParticleRenderBatch newBatch;
+	newBatch.m_key = item.m_key;
+	newBatch.m_stateEmitter = item.m_emitter;
+	newBatch.m_itemIndices.push_back(itemIndex);
+	newBatch.m_numParticles = item.m_numParticles;
+	newBatch.m_canBatch = item.m_canBatch;
+	m_batches.push_back(newBatch);
+}
+
+void ParticleRenderBatcher::RecordCommands(ParticleRenderCommandRecorder& recorder) const
+{
+	const ParticleRenderBatch* lastBoundBatch = nullptr;
+	for (int batchIndex = 0; batchIndex < m_batches.size(); batchIndex++)
+	{
+		const ParticleRenderBatch& batch = m_batches[batchIndex];
+		if (!batch.m_canBatch)
+		{
+			//emitter binds and draws by itself, nothing bound before it can be relied on after
+			ParticleRenderCommand drawEmitter;
+			drawEmitter.m_type = ParticleRenderCommandType::DRAW_EMITTER;
+			drawEmitter.m_batchIndex = batchIndex;
+			drawEmitter.m_emitter = batch.m_stateEmitter;
+			recorder.RecordCommand(drawEmitter);
+			lastBoundBatch = nullptr;
+			continue;
+		}
+
+		if (batch.m_numParticles == 0)
+			continue;
+
+		if (lastBoundBatch == nullptr || lastBoundBatch->m_key != batch.m_key)
+		{
+			ParticleRenderCommand bindState;
+			bindState.m_type = ParticleRenderCommandType::BIND_STATE;
+			bindState.m_batchIndex = batchIndex;
+			bindState.m_emitter = batch.m_stateEmitter;
+			bindState.m_particlePool = batch.m_key.m_particlePool;
+			recorder.RecordCommand(bindState);
+			lastBoundBatch = &batch;
+		}
+
+		unsigned int firstIndex = (unsigned int)recorder.GetIndexData().size();
+		for (int i = 0; i < batch.m_itemIndices.size(); i++)
+		{
+			const ParticleRenderItem& item = m_items[batch.m_itemIndices[i]];
+			recorder.AppendIndexData(item.m_particleIndices, item.m_numParticles);
+		}
+
+		ParticleRenderCommand upload;
+		upload.m_type = ParticleRenderCommandType::UPLOAD_INDICES;
+		upload.m_batchIndex = batchIndex;
+		upload.m_particlePool = batch.m_key.m_particlePool;
+		upload.m_firstIndex = firstIndex;
+		upload.m_numIndices = batch.m_numParticles;
+		recorder.RecordCommand(upload);
+
+		ParticleRenderCommand draw;
+		draw.m_type = ParticleRenderCommandType::DRAW;
+		draw.m_batchIndex = batchIndex;
+		draw.m_particlePool = batch.m_key.m_particlePool;
+		draw.m_numVertices = batch.m_numParticles * 6;
+		recorder.RecordCommand(draw);
+	}
+}
+
+const std::vector<ParticleRenderBatch>& ParticleRenderBatcher::GetBatches() const
+{
+	return m_batches;
+}
+
+int ParticleRenderBatcher::GetNumItems() const
+{
+	return (int)m_items.size();
+}
+
+unsigned int ParticleRenderBatcher::HashRenderConstants(const CPURenderConstants& constants)
+{
+	//fnv-1a over the raw constant bytes
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&constants);
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < sizeof(CPURenderConstants); i++)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/ParticleComputeData.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+class Texture;
+class Shader;
+class ParticlePool;
+class ParticleEmitter;
+
+//everything that has to match for two cpu particle emitters to be drawn with a single upload and draw call
+struct ParticleBatchKey
+{
+	const Texture* m_texture = nullptr;
+	const Shader* m_shader = nullptr;
+	const ParticlePool* m_particlePool = nullptr;
+	BlendMode m_blendMode = BlendMode::ALPHA;
+	bool m_needsSorting = false;									//draw order matters, only merges with the batch drawn right before it
+	unsigned int m_renderMode = 0;
+	Rgba8 m_modelColor;
+	Vec3 m_modelTranslation;										//zero for world space emitters
+	const CPURenderConstants* m_renderConstants = nullptr;
+	unsigned int m_renderConstantsHash = 0;
+
+	bool operator==(const ParticleBatchKey& compare) const;
+	bool operator!=(const ParticleBatchKey& compare) const;
+};
+
+struct ParticleRenderItem
+{
+	ParticleBatchKey m_key;
+	const ParticleEmitter* m_emitter = nullptr;
+	const unsigned int* m_particleIndices = nullptr;
+	unsigned int m_numParticles = 0;
+	bool m_canBatch = true;											//gpu emitters own their buffers and always draw on their own
+};
+
+struct ParticleRenderBatch
+{
+	ParticleBatchKey m_key;
+	const ParticleEmitter* m_stateEmitter = nullptr;				//first emitter in the batch, its constants are bound for the whole batch
+	std::vector<int> m_itemIndices;
+	unsigned int m_numParticles = 0;
+	bool m_canBatch = true;
+};
+
+enum class ParticleRenderCommandType
+{
+	BIND_STATE,
+	UPLOAD_INDICES,
+	DRAW,
+	DRAW_EMITTER
+};
+
+struct ParticleRenderCommand
+{
+	ParticleRenderCommandType m_type = ParticleRenderCommandType::DRAW;
+	int m_batchIndex = -1;
+	const ParticleEmitter* m_emitter = nullptr;
+	const ParticlePool* m_particlePool = nullptr;
+	unsigned int m_firstIndex = 0;									//into ParticleRenderCommandRecorder::GetIndexData()
+	unsigned int m_numIndices = 0;
+	unsigned int m_numVertices = 0;
+};
+
+//cpu side list of what the particle render pass will do, recorded first and submitted after so it can be inspected without a device
+class ParticleRenderCommandRecorder
+{
+public:
+	void Reset();
+	void RecordCommand(const ParticleRenderCommand& command);
+	unsigned int AppendIndexData(const unsigned int* indices, unsigned int numIndices);
+
+	const std::vector<ParticleRenderCommand>& GetCommands() const;
+	const std::vector<unsigned int>& GetIndexData() const;
+	int GetNumDrawCalls() const;
+	int GetNumStateChanges() const;
+	int GetNumUploads() const;
+
+private:
+	std::vector<ParticleRenderCommand> m_commands;
+	std::vector<unsigned int> m_indexData;
+	int m_numDrawCalls = 0;
+	int m_numStateChanges = 0;
+	int m_numUploads = 0;
+};
+
+//groups emitters by batch key into as few draws as possible, items must be added in the order they would have been drawn in
+class ParticleRenderBatcher
+{
+public:
+	void BeginFrame();
+	void AddItem(const ParticleRenderItem& item);
+	void RecordCommands(ParticleRenderCommandRecorder& recorder) const;
+
+	const std::vector<ParticleRenderBatch>& GetBatches() const;
+	int GetNumItems() const;
+
+	static unsigned int HashRenderConstants(const CPURenderConstants& constants);
+
+private:
+	std::vector<ParticleRenderItem> m_items;
+	std::vector<ParticleRenderBatch> m_batches;
+};
@@ -17,6 +17,7 @@ ParticleSystem::ParticleSystem(ParticlesManager* manager, ParticlePool* particle
 		ParticleEmitter* newEmitter = new ParticleEmitter(this, nullptr);
 		m_emitters.push_back(newEmitter);
 	}
+	SortEmittersByDrawOrder();
 }
 
 ParticleSystem::~ParticleSystem()
@@ -39,24 +40,27 @@ void ParticleSystem::Update(float deltaSeconds, const Camera& camera)
 
 void ParticleSystem::Render()
 {
-	std::vector<ParticleEmitter*> sortedDrawOrderEmitters = m_emitters;
-	std::sort(sortedDrawOrderEmitters.begin(), sortedDrawOrderEmitters.end(),
+	for (int i = 0; i < m_emittersInDrawOrder.size(); i++)
+	{
+		m_emittersInDrawOrder[i]->Render();
+	}
+}
+
+void ParticleSystem::SortEmittersByDrawOrder()
+{
+	m_emittersInDrawOrder = m_emitters;
+	std::stable_sort(m_emittersInDrawOrder.begin(), m_emittersInDrawOrder.end(),
 		[](const ParticleEmitter* a, const ParticleEmitter* b)
 		{
-			return a->GetEmitterData().m_drawOrder < b->GetEmitterData().m_drawOrder;
+			return a->GetDrawOrder() < b->GetDrawOrder();
 		}
 	);
-
-	for (int i = 0; i < sortedDrawOrderEmitters.size(); i++)
-	{
-		sortedDrawOrderEmitters[i]->Render();
-	}
 }
 
 void ParticleSystem::LoadFromFile(const char* filepath)
 {
-	tinyxml2::XMLDocument doc;
-	tinyxml2::XMLError status = doc.LoadFile(filepath);
+	XmlDocument doc;
+	tinyxml2::XMLError status = LoadXmlDocument(doc, filepath);
 	GUARANTEE_OR_DIE(status == tinyxml2::XML_SUCCESS, "Failed to particle system data file");
 	XmlElement* rootElement = doc.RootElement();
 	m_position = ParseXmlAttribute(*rootElement, "basePosition", m_position);
@@ -70,6 +74,49 @@ void ParticleSystem::LoadFromFile(const char* filepath)
 	}
 }
 
+bool ParticleSystem::ReloadFromFile()
+{
+	XmlDocument doc;
+	if (LoadXmlDocument(doc, m_filepath) != tinyxml2::XML_SUCCESS || doc.RootElement() == nullptr)
+	{
+		DebuggerPrintf("Couldn't reload particle system \"%s\", keeping the loaded version\n", m_filepath.c_str());
+		return false;
+	}
+
+	//the position is left alone, the game has probably moved the system since it was created
+	std::vector<const XmlElement*> emitterElements;
+	for (const XmlElement* childEmitterElement = doc.RootElement()->FirstChildElement(); childEmitterElement; childEmitterElement = childEmitterElement->NextSiblingElement())
+	{
+		emitterElements.push_back(childEmitterElement);
+	}
+
+	if (emitterElements.size() == m_emitters.size())
+	{
+		for (int i = 0; i < m_emitters.size(); i++)
+		{
+			ParticleEmitterData reloadedData;
+			reloadedData.LoadEmitterDataFromElement(*emitterElements[i]);
+			m_emitters[i]->ReloadEmitterData(reloadedData);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < m_emitters.size(); i++)
+		{
+			delete m_emitters[i];
+		}
+		m_emitters.clear();
+
+		for (int i = 0; i < emitterElements.size(); i++)
+		{
+			m_emitters.push_back(new ParticleEmitter(this, emitterElements[i]));
+		}
+	}
+
+	SortEmittersByDrawOrder();
+	return true;
+}
+
 Vec3 ParticleSystem::GetPosition() const
 {
 	return m_position;
@@ -97,6 +144,7 @@ void ParticleSystem::UpdateEmitterData(const std::vector<ParticleEmitterData>& e
 	{
 		m_emitters[i]->UpdateEmitterData(emitterData[i]);
 	}
+	SortEmittersByDrawOrder();
 }
 
 void ParticleSystem::Restart()
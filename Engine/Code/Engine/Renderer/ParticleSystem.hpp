@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/FileWatcher.hpp"
 
 class ParticleEmitter;
 class Camera;
@@ -21,16 +22,19 @@ private:
 	void Update(float deltaSeconds, const Camera& camera);
 	void Render();
 	void LoadFromFile(const char* filepath);
+	void SortEmittersByDrawOrder();
 
 public:
 	ParticlesManager* m_particlesManager = nullptr;
 	std::vector<ParticleEmitter*> m_emitters;
+	std::vector<ParticleEmitter*> m_emittersInDrawOrder;
 	Renderer* m_renderer = nullptr;
 	JobSystem* m_jobSystem = nullptr;
 	Vec3 m_position;
 	bool m_gpuParticles = false;
 	ParticlePool* m_particlePool = nullptr;
 	std::string m_filepath;
+	FileWatchID m_fileWatchID = INVALID_FILE_WATCH_ID;
 
 public:
 	Vec3 GetPosition() const;
@@ -38,6 +42,7 @@ public:
 	std::vector<ParticleEmitterData> GetEmitterDataForAllEmitters() const;
 	void UpdateEmitterData(const std::vector<ParticleEmitterData>& emitterData);
 	void Restart();
+	bool ReloadFromFile();		//applies an edited data file to the running system, false if the file doesn't parse
 	void ToggleDebugMode();
 	void DebugGPUUpdateStepNow();
 };
\ No newline at end of file
@@ -8,15 +8,23 @@
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/Particle.hpp"
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/FrameAllocator.hpp"
 #include "Engine/Core/ProfileLogScope.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
+#include "Engine/Core/FileWatcher.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 
 ParticlesManager::ParticlesManager(const ParticlesManagerConfig& config)
 	:m_config(config)
 {
+	m_aliveParticlesStat = RegisterGaugeStat("particles.alive");
+	m_cpuSystemsStat = RegisterGaugeStat("particles.cpu_systems");
+	m_gpuSystemsStat = RegisterGaugeStat("particles.gpu_systems");
 }
 
 void ParticlesManager::Startup()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
 	unsigned int particlesPerPool = m_config.m_maxParticles / m_config.m_numPools;
 	m_allCPUParticleSystems = new ParticleSystemList[m_config.m_numPools];
 
@@ -26,6 +34,8 @@ void ParticlesManager::Startup()
 		ParticlePool* newPool = new ParticlePool(particlesPerPool, i);
 		m_config.m_renderer->CreateD3DUnorderedAccessBuffer(&(newPool->m_particlePoolData), sizeof(Particle) * particlesPerPool, sizeof(Particle), nullptr, true);
 		m_config.m_renderer->CreateShaderResourceView(&(newPool->m_particlePoolSRV), newPool->m_particlePoolData);
+		m_config.m_renderer->CreateD3DUnorderedAccessBuffer(&(newPool->m_batchedIndexData), sizeof(unsigned int) * particlesPerPool, sizeof(unsigned int), nullptr, true);
+		m_config.m_renderer->CreateShaderResourceView(&(newPool->m_batchedIndexSRV), newPool->m_batchedIndexData);
 		m_particlePools.push_back(newPool);
 	}
 }
@@ -38,6 +48,8 @@ void ParticlesManager::Shutdown()
 	{
 		DX_SAFE_RELEASE(m_particlePools[i]->m_particlePoolSRV);
 		DX_SAFE_RELEASE(m_particlePools[i]->m_particlePoolData);
+		DX_SAFE_RELEASE(m_particlePools[i]->m_batchedIndexSRV);
+		DX_SAFE_RELEASE(m_particlePools[i]->m_batchedIndexData);
 		delete m_particlePools[i];
 	}
 	m_particlePools.clear();
@@ -45,6 +57,7 @@ void ParticlesManager::Shutdown()
 
 ParticleSystem* ParticlesManager::CreateParticleSystem(const char* dataFilepath, const Vec3& position, bool gpuParticles, bool defaultSystem)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
 	ParticleSystem* newParticleSystem = nullptr;
 	if (gpuParticles)
 	{
@@ -57,12 +70,18 @@ ParticleSystem* ParticlesManager::CreateParticleSystem(const char* dataFilepath,
 		newParticleSystem = new ParticleSystem(this, m_particlePools[bestPoolIndex], m_config.m_renderer, m_config.m_jobSystem, position, dataFilepath, false, defaultSystem);
 		m_allCPUParticleSystems[bestPoolIndex].push_back(newParticleSystem);
 	}
+
+	if (m_config.m_fileWatcher && !defaultSystem)
+	{
+		newParticleSystem->m_fileWatchID = m_config.m_fileWatcher->WatchFile(newParticleSystem->m_filepath, &ParticlesManager::OnParticleSystemFileChanged, newParticleSystem);
+	}
 	return newParticleSystem;
 }
 
 void ParticlesManager::UpdateParticleSystems(float deltaSeconds, const Camera& camera)
 {
-	std::vector<Job*> queuedUpdateJobs;
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
+	FrameVector<Job*> queuedUpdateJobs;
 	queuedUpdateJobs.reserve(m_config.m_numPools);
 
 	//issue an update job for the gpu particles
@@ -92,75 +111,77 @@ void ParticlesManager::UpdateParticleSystems(float deltaSeconds, const Camera& c
 
 	//PROFILE_LOG_SCOPE(Synctime)
 	{
-		while (!queuedUpdateJobs.empty())
+		m_config.m_jobSystem->WaitForJobs(queuedUpdateJobs.data(), (int)queuedUpdateJobs.size());
+		for (int i = 0; i < queuedUpdateJobs.size(); i++)
 		{
-			UpdateParticlesJob* finishedJob = dynamic_cast<UpdateParticlesJob*>(m_config.m_jobSystem->RetrieveFinishedJob());
-			while (finishedJob != nullptr)
-			{
-				if (finishedJob)
-				{
-					for (auto iter = queuedUpdateJobs.begin(); iter != queuedUpdateJobs.end();)
-					{
-						if (finishedJob == *iter)
-						{
-							queuedUpdateJobs.erase(iter);
-							break;
-						}
-						else
-						{
-							++iter;
-						}
-					}
-
-					delete finishedJob;
-				}
-
-				finishedJob = dynamic_cast<UpdateParticlesJob*>(m_config.m_jobSystem->RetrieveFinishedJob());
-			}
+			delete queuedUpdateJobs[i];
 		}
 	}
+
+	ParticlesDebugData debugData = GetDebugData();
+	SetStatGauge(m_aliveParticlesStat, debugData.m_aliveParticles);
+	SetStatGauge(m_cpuSystemsStat, debugData.m_numCPUsystems);
+	SetStatGauge(m_gpuSystemsStat, debugData.m_numGPUsystems);
 }
 
 void ParticlesManager::RenderParticleSystems(const Camera& camera)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
 	m_config.m_renderer->BindShaderByName("Default");
-	std::vector<ParticleSystem*> allParticleSystems;
+	m_systemsInRenderOrder.clear();
+	Vec3 camPos = camera.GetPosition();
 	for (int i = 0; i < m_config.m_numPools; i++)
 	{
 		m_config.m_renderer->CopyCPUToGPU(m_particlePools[i]->GetParticleList(), sizeof(Particle) * m_particlePools[i]->GetCurrentListSize(), m_particlePools[i]->m_particlePoolData);
-		ParticleSystemList poolSystems = m_allCPUParticleSystems[i];
-		allParticleSystems.insert(allParticleSystems.end(), poolSystems.begin(), poolSystems.end());
+		const ParticleSystemList& poolSystems = m_allCPUParticleSystems[i];
+		for (int j = 0; j < poolSystems.size(); j++)
+		{
+			m_systemsInRenderOrder.push_back(std::make_pair(GetDistanceSquared3D(camPos, poolSystems[j]->GetPosition()), poolSystems[j]));
+		}
 	}
 
-	allParticleSystems.insert(allParticleSystems.end(), m_allGPUParticleSystems.begin(), m_allGPUParticleSystems.end());
+	for (int i = 0; i < m_allGPUParticleSystems.size(); i++)
+	{
+		m_systemsInRenderOrder.push_back(std::make_pair(GetDistanceSquared3D(camPos, m_allGPUParticleSystems[i]->GetPosition()), m_allGPUParticleSystems[i]));
+	}
 
 	//sort particle systems based on distance from camera in descending order
-	Vec3 camPos = camera.GetPosition();
-	std::sort(allParticleSystems.begin(), allParticleSystems.end(),
-		[camPos](const ParticleSystem* a, const ParticleSystem* b)
+	std::sort(m_systemsInRenderOrder.begin(), m_systemsInRenderOrder.end(),
+		[](const std::pair<float, ParticleSystem*>& a, const std::pair<float, ParticleSystem*>& b)
 		{
-			float aDistFromCam = GetDistanceSquared3D(camPos, a->GetPosition());
-			float bDistFromCam = GetDistanceSquared3D(camPos, b->GetPosition());
-			return aDistFromCam > bDistFromCam;
+			return a.first > b.first;
 		}
 	);
 
-	//render particle systems
-	for (int i = 0; i < allParticleSystems.size(); i++)
+	//group emitters that can share a draw, then record and submit
+	m_renderBatcher.BeginFrame();
+	for (int i = 0; i < m_systemsInRenderOrder.size(); i++)
 	{
-		allParticleSystems[i]->Render();
+		const std::vector<ParticleEmitter*>& emitters = m_systemsInRenderOrder[i].second->m_emittersInDrawOrder;
+		for (int j = 0; j < emitters.size(); j++)
+		{
+			if (emitters[j]->IsRenderingStopped())
+				continue;
+
+			m_renderBatcher.AddItem(emitters[j]->GetRenderItem());
+		}
 	}
+
+	m_renderCommands.Reset();
+	m_renderBatcher.RecordCommands(m_renderCommands);
+	SubmitRenderCommands(m_renderCommands);
 }
 
 void ParticlesManager::KillParticleSystem(const ParticleSystem* systemToKill)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
 	if (systemToKill->m_gpuParticles)
 	{
 		for (int i = 0; i < m_allGPUParticleSystems.size(); i++)
 		{
 			if (m_allGPUParticleSystems[i] == systemToKill)
 			{
-				delete m_allGPUParticleSystems[i];
+				DeleteParticleSystem(m_allGPUParticleSystems[i]);
 				m_allGPUParticleSystems.erase(m_allGPUParticleSystems.begin() + i);
 				return;
 			}
@@ -174,7 +195,7 @@ void ParticlesManager::KillParticleSystem(const ParticleSystem* systemToKill)
 		{
 			if (particleSystems[i] == systemToKill)
 			{
-				delete particleSystems[i];
+				DeleteParticleSystem(particleSystems[i]);
 				particleSystems.erase(particleSystems.begin() + i);
 				return;
 			}
@@ -184,19 +205,20 @@ void ParticlesManager::KillParticleSystem(const ParticleSystem* systemToKill)
 
 void ParticlesManager::KillAllParticleSystems()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
 	for (int i = 0; i < m_config.m_numPools; i++)
 	{
 		ParticleSystemList& particleSystems = m_allCPUParticleSystems[i];
 		for (int j = 0; j < particleSystems.size(); j++)
 		{
-			delete particleSystems[j];
+			DeleteParticleSystem(particleSystems[j]);
 		}
 		particleSystems.clear();
 	}
 
 	for (int i = 0; i < m_allGPUParticleSystems.size(); i++)
 	{
-		delete m_allGPUParticleSystems[i];
+		DeleteParticleSystem(m_allGPUParticleSystems[i]);
 	}
 	m_allGPUParticleSystems.clear();
 }
@@ -245,6 +267,47 @@ ParticleSystem* ParticlesManager::ChangeParticleSystemType(ParticleSystem* parti
 	return changedSystem;
 }
 
+bool ParticlesManager::IsEmulatingGPUSimulation() const
+{
+	return m_config.m_emulateGPUParticles;
+}
+
+const ParticleRenderCommandRecorder& ParticlesManager::GetLastFrameRenderCommands() const
+{
+	return m_renderCommands;
+}
+
+void ParticlesManager::SubmitRenderCommands(const ParticleRenderCommandRecorder& commands)
+{
+	Renderer* renderer = m_config.m_renderer;
+	const std::vector<ParticleRenderCommand>& commandList = commands.GetCommands();
+	const std::vector<unsigned int>& indexData = commands.GetIndexData();
+	for (int i = 0; i < commandList.size(); i++)
+	{
+		const ParticleRenderCommand& command = commandList[i];
+		switch (command.m_type)
+		{
+		case ParticleRenderCommandType::BIND_STATE:
+			command.m_emitter->BindCPUParticleRenderState();
+			renderer->GetDeviceContext()->VSSetShaderResources(2, 1, &(command.m_particlePool->m_batchedIndexSRV));
+			break;
+		case ParticleRenderCommandType::UPLOAD_INDICES:
+			renderer->CopyCPUToGPU(indexData.data() + command.m_firstIndex, sizeof(unsigned int) * command.m_numIndices, command.m_particlePool->m_batchedIndexData);
+			break;
+		case ParticleRenderCommandType::DRAW:
+			renderer->GetDeviceContext()->Draw(command.m_numVertices, 0);
+			break;
+		case ParticleRenderCommandType::DRAW_EMITTER:
+			command.m_emitter->Render();
+			break;
+		default:
+			break;
+		}
+	}
+
+	renderer->BindShaderByName("Default");
+}
+
 int ParticlesManager::GetBestParticlePoolIndex()
 {
 	constexpr int minParticlesDiff = 100;
@@ -268,6 +331,22 @@ int ParticlesManager::GetBestParticlePoolIndex()
 	return indexOfBestPool;
 }
 
+void ParticlesManager::DeleteParticleSystem(ParticleSystem* particleSystem)
+{
+	if (particleSystem->m_fileWatchID != INVALID_FILE_WATCH_ID)
+	{
+		m_config.m_fileWatcher->UnwatchFile(particleSystem->m_fileWatchID);
+	}
+	delete particleSystem;
+}
+
+void ParticlesManager::OnParticleSystemFileChanged(const std::string& filePath, void* userData)
+{
+	UNUSED(filePath);
+	ParticleSystem* particleSystem = (ParticleSystem*)userData;
+	particleSystem->ReloadFromFile();
+}
+
 UpdateParticlesJob::UpdateParticlesJob(ParticleSystemList& particleSystems, float deltaSeconds, const Camera& camera)
 	:m_particleSystems(particleSystems), m_deltaSeconds(deltaSeconds), m_camera(camera)
 {
@@ -275,6 +354,7 @@ UpdateParticlesJob::UpdateParticlesJob(ParticleSystemList& particleSystems, floa
 
 void UpdateParticlesJob::Execute()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::PARTICLES)
 	//PROFILE_LOG_SCOPE(UpdateJob)
 	{
 		for (int i = 0; i < m_particleSystems.size(); i++)
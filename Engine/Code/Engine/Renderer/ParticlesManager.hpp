@@ -1,12 +1,15 @@
 #pragma once
 #include <vector>
 #include "Engine/Renderer/ParticlePool.hpp"
+#include "Engine/Renderer/ParticleRenderBatcher.hpp"
 #include "Engine/Core/Job.hpp"
+#include "Engine/Core/StatsRegistry.hpp"
 
 class ParticleSystem;
 class Camera;
 class Renderer;
 class JobSystem;
+class FileWatcher;
 class VertexBuffer;
 class IndexBuffer;
 struct Vec3;
@@ -19,6 +22,8 @@ struct ParticlesManagerConfig
 	int m_numPools = 0;
 	Renderer* m_renderer = nullptr;
 	JobSystem* m_jobSystem = nullptr;
+	bool m_emulateGPUParticles = false;		//run the gpu particle compute stages on the cpu instead, see ParticleComputeEmulator
+	FileWatcher* m_fileWatcher = nullptr;		//when set, systems reload their data file when it changes
 };
 
 struct ParticlesDebugData
@@ -44,6 +49,8 @@ public:
 	void KillAllParticleSystems();
 	ParticlesDebugData GetDebugData();
 	ParticleSystem* ChangeParticleSystemType(ParticleSystem* particleSystemToChange);
+	bool IsEmulatingGPUSimulation() const;
+	const ParticleRenderCommandRecorder& GetLastFrameRenderCommands() const;
 
 private:
 	ParticlesManagerConfig m_config;
@@ -51,8 +58,20 @@ private:
 	ParticleSystemList* m_allCPUParticleSystems = nullptr;
 	ParticleSystemList m_allGPUParticleSystems;
 
+	//kept across frames so the per frame sort and batching doesn't reallocate
+	std::vector<std::pair<float, ParticleSystem*>> m_systemsInRenderOrder;
+	ParticleRenderBatcher m_renderBatcher;
+	ParticleRenderCommandRecorder m_renderCommands;
+
+	StatID m_aliveParticlesStat = INVALID_STAT_ID;
+	StatID m_cpuSystemsStat = INVALID_STAT_ID;
+	StatID m_gpuSystemsStat = INVALID_STAT_ID;
+
 private:
 	int GetBestParticlePoolIndex();
+	void DeleteParticleSystem(ParticleSystem* particleSystem);
+	static void OnParticleSystemFileChanged(const std::string& filePath, void* userData);
+	void SubmitRenderCommands(const ParticleRenderCommandRecorder& commands);
 };
 
 class UpdateParticlesJob : public Job 
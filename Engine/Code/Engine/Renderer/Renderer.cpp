@@ -14,6 +14,7 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/MemoryTracker.hpp"
 #include "Engine/Renderer/Window.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/Shader.hpp"
@@ -27,7 +28,10 @@
 #include "Engine/Core/Vertex_PNCU.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/TextureView.hpp"
+#include "Engine/Renderer/TextureFile.hpp"
+#include "Engine/Renderer/TextureCooker.hpp"
 #include "Game/EngineBuildPreferences.hpp"
+#include <algorithm>
 
 #ifdef ENGINE_DEBUG_RENDER
 #include <dxgidebug.h>
@@ -71,6 +75,9 @@ DXGI_FORMAT LocalToD3D11(eTextureFormat format)
 	case eTextureFormat::R8G8B8A8_UNORM: return DXGI_FORMAT_R8G8B8A8_UNORM;
 	case eTextureFormat::D24_UNORM_S8_UINT: return DXGI_FORMAT_D24_UNORM_S8_UINT;
 	case eTextureFormat::R24G8_TYPELESS: return DXGI_FORMAT_R24G8_TYPELESS;
+	case eTextureFormat::BC1_UNORM: return DXGI_FORMAT_BC1_UNORM;
+	case eTextureFormat::BC3_UNORM: return DXGI_FORMAT_BC3_UNORM;
+	case eTextureFormat::BC7_UNORM: return DXGI_FORMAT_BC7_UNORM;
 	default: ERROR_AND_DIE("Unsupported format");
 	}
 }
@@ -114,6 +121,7 @@ Renderer::Renderer(const RendererConfig& config)
 
 void Renderer::Startup()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 #ifdef ENGINE_DEBUG_RENDER
 	//get dxgi debug interface
 	m_dxgiDebugLibModule = (void*)::LoadLibraryA("dxgidebug.dll");
@@ -166,11 +174,13 @@ void Renderer::Startup()
 
 void Renderer::BeginFrame()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	DebugRenderBeginFrame();
 }
 
 void Renderer::EndFrame()
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	Sleep(0);
 	DebugRenderEndFrame();
 	CopyTexture(m_backBuffer, m_defaultColorTarget[m_activeColorTargetIndex]);
@@ -189,6 +199,17 @@ void Renderer::EndFrame()
 
 void Renderer::Shutdown()
 {
+	for (int i = 0; i < m_fileWatches.size(); i++)
+	{
+		m_config.m_fileWatcher->UnwatchFile(m_fileWatches[i]);
+	}
+	m_fileWatches.clear();
+	for (int i = 0; i < m_cookedTextureSources.size(); i++)
+	{
+		delete m_cookedTextureSources[i];
+	}
+	m_cookedTextureSources.clear();
+
 	for (int i = 0; i < m_loadedTextures.size(); i++)
 	{
 		delete m_loadedTextures[i];
@@ -303,6 +324,7 @@ ID3D11DeviceContext* Renderer::GetDeviceContext() const
 
 void Renderer::DrawVertexArray(int numVertexes, const Vertex_PCU* vertexes)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	BindModelConstants();
 
 	size_t size = sizeof(*vertexes) * numVertexes;
@@ -312,6 +334,7 @@ void Renderer::DrawVertexArray(int numVertexes, const Vertex_PCU* vertexes)
 
 void Renderer::DrawVertexArray(int numVertexes, const Vertex_PNCU* vertexes)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	BindModelConstants();
 	BindLightConstants();
 
@@ -334,8 +357,15 @@ void Renderer::DrawIndexed(unsigned int numIndices, unsigned int startIndexInInd
 	m_deviceContext->DrawIndexed(numIndices, startIndexInIndexList, startVertexInVertexList);
 }
 
+void Renderer::DrawIndirect(ID3D11Buffer* indirectArgsBuffer, unsigned int byteOffset)
+{
+	//args are laid out as IndirectDrawData (vertex count per instance, instance count, start vertex, start instance)
+	m_deviceContext->DrawInstancedIndirect(indirectArgsBuffer, byteOffset);
+}
+
 Texture* Renderer::CreateSkyboxTexture(const char* skyboxName, const char* front, const char* back, const char* left, const char* right, const char* top, const char* bottom)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	Texture* skybox = GetTextureForFileName(skyboxName);
 
 	if (!skybox)
@@ -400,6 +430,7 @@ Texture* Renderer::CreateSkyboxTexture(const char* skyboxName, const char* front
 
 Texture* Renderer::CreateTexture(const TextureCreateInfo& createInfo)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	ID3D11Texture2D* handle = createInfo.m_handle;
 
 	if (handle == nullptr)
@@ -407,7 +438,7 @@ Texture* Renderer::CreateTexture(const TextureCreateInfo& createInfo)
 		D3D11_TEXTURE2D_DESC pTextureDesc = { 0 };
 		pTextureDesc.Width = createInfo.m_dimensions.x;
 		pTextureDesc.Height = createInfo.m_dimensions.y;
-		pTextureDesc.MipLevels = 1;
+		pTextureDesc.MipLevels = createInfo.m_numMips;
 		pTextureDesc.ArraySize = 1;
 		pTextureDesc.Format = LocalToD3D11(createInfo.m_format);
 		pTextureDesc.SampleDesc.Count = 1;
@@ -423,6 +454,18 @@ Texture* Renderer::CreateTexture(const TextureCreateInfo& createInfo)
 			pInitialDataPtr = &pIntialData;
 		}
 
+		std::vector<D3D11_SUBRESOURCE_DATA> mipInitialData;
+		if (createInfo.m_mips != nullptr)
+		{
+			mipInitialData.resize(createInfo.m_numMips);
+			for (unsigned int mipIndex = 0; mipIndex < createInfo.m_numMips; mipIndex++)
+			{
+				mipInitialData[mipIndex].pSysMem = createInfo.m_mips[mipIndex].m_data;
+				mipInitialData[mipIndex].SysMemPitch = createInfo.m_mips[mipIndex].m_rowPitch;
+			}
+			pInitialDataPtr = mipInitialData.data();
+		}
+
 		HRESULT textureResult =  m_device->CreateTexture2D(&pTextureDesc, pInitialDataPtr, &handle);
 		if (!SUCCEEDED(textureResult))
 		{
@@ -443,6 +486,7 @@ Texture* Renderer::CreateTexture(const TextureCreateInfo& createInfo)
 	tex->m_format = createInfo.m_format;
 	tex->m_texture = handle;
 	tex->m_allowedBinds = createInfo.m_bindFlags;
+	tex->m_numMips = createInfo.m_numMips;
 	return tex;
 }
 
@@ -490,6 +534,7 @@ BitmapFont* Renderer::CreateBitmapFont(const char* fontFilePath)
 
 Texture* Renderer::CreateOrGetTextureFromFile(char const* imageFilePath)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	// See if we already have this texture previously loaded
 	Texture* existingTexture = GetTextureForFileName(imageFilePath);
 	if (existingTexture)
@@ -502,9 +547,92 @@ Texture* Renderer::CreateOrGetTextureFromFile(char const* imageFilePath)
 	return newTexture;
 }
 
+Texture* Renderer::CreateOrGetTextureFromImage(const Image& image)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	//images built in memory (atlas pages etc.) are cached under their image name like files are
+	Texture* existingTexture = GetTextureForFileName(image.GetImageFilePath().c_str());
+	if (existingTexture)
+	{
+		return existingTexture;
+	}
+
+	Texture* newTexture = CreateTextureFromImage(image);
+	m_loadedTextures.push_back(newTexture);
+	SetDebugName(newTexture->m_texture, newTexture->m_name.c_str());
+	return newTexture;
+}
+
+struct CookedTextureSource
+{
+	std::string m_sourceImagePath;
+	std::string m_cookedFilePath;
+	texture_cook_options m_cookOptions;
+};
+
+Texture* Renderer::CreateOrGetTextureFromCookedFile(const char* cookedFilePath, const char* sourceImagePath, const texture_cook_options* cookOptions)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	Texture* existingTexture = GetTextureForFileName(cookedFilePath);
+	if (existingTexture)
+	{
+		return existingTexture;
+	}
+
+	Texture* newTexture = CreateTextureFromCookedFile(cookedFilePath);
+	if (newTexture == nullptr)
+	{
+		return nullptr;
+	}
+
+	m_loadedTextures.push_back(newTexture);
+	SetDebugName(newTexture->m_texture, newTexture->m_name.c_str());
+	WatchAssetFile(newTexture->m_name);
+	if (sourceImagePath && m_config.m_fileWatcher)
+	{
+		CookedTextureSource* cookedSource = new CookedTextureSource{ sourceImagePath, newTexture->m_name, cookOptions ? *cookOptions : texture_cook_options() };
+		m_cookedTextureSources.push_back(cookedSource);
+		WatchAssetFile(sourceImagePath);
+	}
+	return newTexture;
+}
+
+void Renderer::CreateOrGetTexturesFromFiles(const std::vector<std::string>& imageFilePaths, JobSystem* jobSystem, std::vector<Texture*>* out_textures)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	std::vector<std::string> filesToLoad;
+	for (int i = 0; i < imageFilePaths.size(); i++)
+	{
+		if (!GetTextureForFileName(imageFilePaths[i].c_str()) && std::find(filesToLoad.begin(), filesToLoad.end(), imageFilePaths[i]) == filesToLoad.end())
+		{
+			filesToLoad.push_back(imageFilePaths[i]);
+		}
+	}
+
+	std::vector<Image*> images;
+	LoadImages(filesToLoad, images, jobSystem);
+	for (int i = 0; i < images.size(); i++)
+	{
+		Texture* newTexture = CreateTextureFromImage(*images[i]);
+		m_loadedTextures.push_back(newTexture);
+		SetDebugName(newTexture->m_texture, newTexture->m_name.c_str());
+		WatchAssetFile(newTexture->m_name);
+		delete images[i];
+	}
+
+	if (out_textures)
+	{
+		out_textures->clear();
+		for (int i = 0; i < imageFilePaths.size(); i++)
+		{
+			out_textures->push_back(GetTextureForFileName(imageFilePaths[i].c_str()));
+		}
+	}
+}
 
 BitmapFont* Renderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	// See if we already have this texture previously loaded
 	BitmapFont* existingFontTexture = GetBitmpaFontForFileName(bitmapFontFilePathWithNoExtension);
 	if (existingFontTexture)
@@ -526,11 +654,76 @@ Texture* Renderer::CreateTextureFromFile(char const* imageFilePath, bool saveTex
 	{
 		m_loadedTextures.push_back(newTexture);
 		SetDebugName(newTexture->m_texture, newTexture->m_name.c_str());
+		WatchAssetFile(newTexture->m_name);
 	}
 
 	return newTexture;
 }
 
+Texture* Renderer::CreateTextureFromCookedFile(const char* cookedFilePath)
+{
+	TextureFileView cookedTexture;
+	if (!cookedTexture.Open(cookedFilePath))
+	{
+		return nullptr;
+	}
+
+	//the mips go to the gpu straight from the mapping, which only has to last until the texture is created
+	TextureMipData mips[TEXTURE_FILE_MAX_MIPS];
+	for (unsigned int mipIndex = 0; mipIndex < cookedTexture.GetNumMips(); mipIndex++)
+	{
+		mips[mipIndex].m_data = cookedTexture.GetMipData(mipIndex);
+		mips[mipIndex].m_rowPitch = cookedTexture.GetMip(mipIndex).m_rowPitch;
+	}
+
+	TextureCreateInfo ci{};
+	ci.m_name = cookedFilePath;
+	ci.m_dimensions = cookedTexture.GetDimensions();
+	ci.m_format = cookedTexture.GetFormat();
+	ci.m_mips = mips;
+	ci.m_numMips = cookedTexture.GetNumMips();
+
+	Texture* newTexture = CreateTexture(ci);
+	newTexture->m_isCooked = true;
+	return newTexture;
+}
+
+bool Renderer::ReloadTexture(Texture* texture)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	Texture* reloadedTexture = nullptr;
+	if (texture->m_isCooked)
+	{
+		reloadedTexture = CreateTextureFromCookedFile(texture->m_name.c_str());
+	}
+	else
+	{
+		Image image(IntVec2(1, 1), Rgba8::WHITE);
+		if (image.LoadFromFile(texture->m_name.c_str()))
+		{
+			reloadedTexture = CreateTextureFromImage(image);
+		}
+	}
+
+	if (reloadedTexture == nullptr)
+	{
+		DebuggerPrintf("Couldn't reload texture \"%s\", keeping the loaded version\n", texture->m_name.c_str());
+		return false;
+	}
+
+	//immutable textures can't be rewritten, so the new d3d texture moves into the existing object and the old one
+	//leaves with the temporary. views are recreated on the next bind
+	std::swap(texture->m_texture, reloadedTexture->m_texture);
+	std::swap(texture->m_views, reloadedTexture->m_views);
+	texture->m_dimensions = reloadedTexture->m_dimensions;
+	texture->m_format = reloadedTexture->m_format;
+	texture->m_numMips = reloadedTexture->m_numMips;
+	delete reloadedTexture;
+
+	SetDebugName(texture->m_texture, texture->m_name.c_str());
+	return true;
+}
+
 
 Texture* Renderer::CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData)
 {
@@ -709,7 +902,7 @@ void Renderer::CreateAndSetRasterizerState()
 	m_deviceContext->RSSetState(m_rasterizerState);
 }
 
-void Renderer::CreateInputLayout(Shader* shader, bool isLitShader)
+bool Renderer::CreateInputLayout(Shader* shader, bool isLitShader, bool isFatal)
 {
 	std::vector<D3D11_INPUT_ELEMENT_DESC> inputElementDesc;
 	inputElementDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 });
@@ -730,12 +923,20 @@ void Renderer::CreateInputLayout(Shader* shader, bool isLitShader)
 
 	if (!SUCCEEDED(hr))
 	{
+		if (!isFatal)
+		{
+			DebuggerPrintf("Error while creating input layout for the vertex shader of \"%s\"\n", shader->GetName().c_str());
+			return false;
+		}
 		ERROR_AND_DIE("Error while creating input layout for the vertex shader");
 	}
+
+	return true;
 }
 
 Shader* Renderer::CreateOrGetShader(const char* shaderName)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	Shader* existingShader = GetShaderForName(shaderName);
 	if (existingShader)
 		return existingShader;
@@ -812,15 +1013,117 @@ Shader* Renderer::CreateShader(const char* shaderName)
 	fileName.append(".hlsl");
 	std::string shaderSource;
 	FileReadToString(shaderSource, fileName);
-	return CreateShader(shaderName, shaderSource.c_str());
+	Shader* newShader = CreateShader(shaderName, shaderSource.c_str());
+	WatchAssetFile(fileName);
+	return newShader;
+}
+
+bool Renderer::ReloadShader(Shader* shader)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	const char* shaderName = shader->GetName().c_str();
+	std::string shaderSource;
+	if (!TryFileReadToString(shaderSource, shader->GetName() + ".hlsl"))
+	{
+		DebuggerPrintf("Couldn't read \"%s.hlsl\", keeping the loaded version\n", shaderName);
+		return false;
+	}
+
+	//everything is built on the side first so a typo in the file leaves the working shader in place
+	Shader* reloadedShader = new Shader(shader->m_config);
+	std::vector<uint8_t> pixelShaderByteCode;
+	bool isReloaded = CompileShaderToByteCode(m_vertexShaderByteCode, shaderName, shaderSource.c_str(), shader->m_config.m_vertexEntryPoint.c_str(), "vs_5_0", false) &&
+		CompileShaderToByteCode(pixelShaderByteCode, shaderName, shaderSource.c_str(), shader->m_config.m_pixelEntryPoint.c_str(), "ps_5_0", false) &&
+		SUCCEEDED(m_device->CreateVertexShader(m_vertexShaderByteCode.data(), m_vertexShaderByteCode.size(), NULL, &(reloadedShader->m_vertexShader))) &&
+		SUCCEEDED(m_device->CreatePixelShader(pixelShaderByteCode.data(), pixelShaderByteCode.size(), NULL, &(reloadedShader->m_pixelShader))) &&
+		CreateInputLayout(reloadedShader, strstr(shaderName, "Lit") != nullptr, false);
+	if (!isReloaded)
+	{
+		DebuggerPrintf("Couldn't reload shader \"%s\", keeping the loaded version\n", shaderName);
+		delete reloadedShader;
+		return false;
+	}
+
+	std::swap(shader->m_vertexShader, reloadedShader->m_vertexShader);
+	std::swap(shader->m_pixelShader, reloadedShader->m_pixelShader);
+	std::swap(shader->m_inputLayout, reloadedShader->m_inputLayout);
+	delete reloadedShader;
+
+	if (m_currentShader == shader)
+	{
+		BindShader(shader);
+	}
+	return true;
+}
+
+void Renderer::WatchAssetFile(const std::string& filePath)
+{
+	if (m_config.m_fileWatcher)
+	{
+		m_fileWatches.push_back(m_config.m_fileWatcher->WatchFile(filePath, &Renderer::OnAssetFileChanged, this));
+	}
+}
+
+void Renderer::OnAssetFileChanged(const std::string& filePath, void* userData)
+{
+	Renderer* renderer = (Renderer*)userData;
+	renderer->ReloadAssetFile(filePath);
+}
+
+void Renderer::ReloadAssetFile(const std::string& filePath)
+{
+	for (int i = 0; i < m_loadedTextures.size(); i++)
+	{
+		if (m_loadedTextures[i]->m_name == filePath)
+		{
+			ReloadTexture(m_loadedTextures[i]);
+		}
+	}
+
+	for (int i = 0; i < m_loadedShaders.size(); i++)
+	{
+		if (m_loadedShaders[i]->GetName() + ".hlsl" == filePath)
+		{
+			ReloadShader(m_loadedShaders[i]);
+		}
+	}
+
+	for (int i = 0; i < m_cookedTextureSources.size(); i++)
+	{
+		if (m_cookedTextureSources[i]->m_sourceImagePath == filePath)
+		{
+			RecookTexture(*m_cookedTextureSources[i]);
+		}
+	}
+}
+
+void Renderer::RecookTexture(const CookedTextureSource& cookedSource)
+{
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	const char* sourceImagePath = cookedSource.m_sourceImagePath.c_str();
+	const char* cookedFilePath = cookedSource.m_cookedFilePath.c_str();
+	Image image(IntVec2(1, 1), Rgba8::WHITE);
+	if (!image.LoadFromFile(sourceImagePath) || !CookTexture(image, cookedFilePath, cookedSource.m_cookOptions))
+	{
+		DebuggerPrintf("Couldn't cook \"%s\" again from \"%s\", keeping the loaded version\n", cookedFilePath, sourceImagePath);
+		return;
+	}
+
+	//the new cook is a change to the watched cooked file, which reloads the texture like any other change
+	DebuggerPrintf("Cooked \"%s\" again from \"%s\"\n", cookedFilePath, sourceImagePath);
 }
 
 void Renderer::CreateAndCompileComputeShader(char const* shaderName, ID3D11ComputeShader** pComputeShader, const char* entryName)
 {
-	std::vector<uint8_t> shaderByteCode;
 	std::string shaderSource;
 	FileReadToString(shaderSource, shaderName);
-	CompileShaderToByteCode(shaderByteCode, shaderName, shaderSource.c_str(), entryName, "cs_5_0");
+	CreateAndCompileComputeShaderFromSource(shaderName, shaderSource.c_str(), pComputeShader, entryName);
+}
+
+void Renderer::CreateAndCompileComputeShaderFromSource(char const* shaderName, char const* shaderSource, ID3D11ComputeShader** pComputeShader, const char* entryName)
+{
+	std::vector<uint8_t> shaderByteCode;
+	CompileShaderToByteCode(shaderByteCode, shaderName, shaderSource, entryName, "cs_5_0");
 	HRESULT result = m_device->CreateComputeShader(shaderByteCode.data(), shaderByteCode.size(), nullptr, pComputeShader);
 	if (!SUCCEEDED(result))
 	{
@@ -828,7 +1131,7 @@ void Renderer::CreateAndCompileComputeShader(char const* shaderName, ID3D11Compu
 	}
 }
 
-bool Renderer::CompileShaderToByteCode(std::vector<unsigned char>& outByteCode, char const* name, char const* source, char const* entryPoint, char const* target)
+bool Renderer::CompileShaderToByteCode(std::vector<unsigned char>& outByteCode, char const* name, char const* source, char const* entryPoint, char const* target, bool isFatal)
 {
 	UINT shaderCompileFlags = 0;
 #ifdef  ENGINE_DEBUG_RENDER
@@ -847,12 +1150,20 @@ bool Renderer::CompileShaderToByteCode(std::vector<unsigned char>& outByteCode,
 
 	if (!SUCCEEDED(compileResult))
 	{
-		const char* compileErrorString = reinterpret_cast<const char*>(errorBlob->GetBufferPointer());
 		std::string completeErrorString = "Failed to compile: ";
 		completeErrorString.append(name);
-		completeErrorString.append(compileErrorString);
-		errorBlob->Release();
-		ERROR_AND_DIE(compileErrorString);
+		if (errorBlob)
+		{
+			completeErrorString.append("\n");
+			completeErrorString.append(reinterpret_cast<const char*>(errorBlob->GetBufferPointer()));
+			errorBlob->Release();
+		}
+		if (!isFatal)
+		{
+			DebuggerPrintf("%s\n", completeErrorString.c_str());
+			return false;
+		}
+		ERROR_AND_DIE(completeErrorString);
 	}
 
 	outByteCode.resize(shaderBlob->GetBufferSize());
@@ -864,6 +1175,7 @@ bool Renderer::CompileShaderToByteCode(std::vector<unsigned char>& outByteCode,
 
 VertexBuffer* Renderer::CreateVertexBuffer(const size_t size, unsigned int stride)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	VertexBuffer* newBuffer = new VertexBuffer(size, stride);
 	CreateD3DVertexBuffer(size, newBuffer);
 	return newBuffer;
@@ -932,6 +1244,7 @@ void Renderer::DrawVertexBuffer(VertexBuffer* vbo, int vertexCount, int vertexOf
 
 ConstantBuffer* Renderer::CreateConstantBuffer(const size_t size)
 {
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
 	ConstantBuffer* newBuffer = new ConstantBuffer(size);
 	CreateD3DConstantBuffer(size, newBuffer);
 	return newBuffer;
@@ -979,9 +1292,10 @@ void Renderer::BindConstantBufferToComputeShader(int slot, ConstantBuffer* cbo)
 	m_deviceContext->CSSetConstantBuffers(slot, 1, &(cbo->m_buffer));
 }
 
-IndexBuffer* Renderer::CreateIndexBuffer(const size_t size)
+IndexBuffer* Renderer::CreateIndexBuffer(const size_t size, unsigned int stride)
 {
-	IndexBuffer* indexBuffer = new IndexBuffer(size);
+	MEMORY_TAG_SCOPE(MemoryTag::RENDERER)
+	IndexBuffer* indexBuffer = new IndexBuffer(size, stride);
 	CreateD3DIndexBuffer(size, indexBuffer);
 	return indexBuffer;
 }
@@ -1078,7 +1392,7 @@ void Renderer::CreateUnorderedAccessView(ID3D11UnorderedAccessView** pResourceVi
 		uavDesc.Format = DXGI_FORMAT_R32_TYPELESS;
 		uavDesc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
 		uavDesc.Buffer.FirstElement = 0;
-		uavDesc.Buffer.NumElements = 1;		//hard cording this here, not sure if this is right or not
+		uavDesc.Buffer.NumElements = resourceDesc.ByteWidth / 4;		//raw views address the buffer in 32 bit elements
 	}
 	
 
@@ -1171,6 +1485,26 @@ void Renderer::CopyGPUToCPU(void* data, const size_t copySize, ID3D11Buffer* pSo
 	m_deviceContext->Unmap(pSourceBuffer, 0);
 }
 
+bool Renderer::TryCopyGPUToCPU(void* data, const size_t copySize, ID3D11Buffer* pSourceBuffer)
+{
+	//returns false instead of stalling if the gpu hasn't finished writing the buffer yet
+	D3D11_MAPPED_SUBRESOURCE mappedResources = { 0 };
+	HRESULT result = m_deviceContext->Map(pSourceBuffer, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedResources);
+	if (result == DXGI_ERROR_WAS_STILL_DRAWING)
+	{
+		return false;
+	}
+	if (!SUCCEEDED(result))
+	{
+		ERROR_RECOVERABLE("Failed to map buffer for reading");
+		return false;
+	}
+
+	memcpy(data, mappedResources.pData, copySize);
+	m_deviceContext->Unmap(pSourceBuffer, 0);
+	return true;
+}
+
 void Renderer::BindModelConstants()
 {
 	ModelConstants modelConstants;
@@ -1221,7 +1555,7 @@ void Renderer::CopyCPUToGPU(const void* data, size_t size, IndexBuffer* ibo)
 
 void Renderer::BindIndexBuffer(IndexBuffer* ibo)
 {
-	m_deviceContext->IASetIndexBuffer(ibo->m_buffer, DXGI_FORMAT_R32_UINT, 0);
+	m_deviceContext->IASetIndexBuffer(ibo->m_buffer, ibo->m_stride == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
 }
 
 void Renderer::SetDebugName(ID3D11DeviceChild* object, const char* name)
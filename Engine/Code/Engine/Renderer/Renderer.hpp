@@ -3,7 +3,9 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Math/IntVec2.hpp"
+#include "Engine/Core/FileWatcher.hpp"
 #include "ThirdParty/RenderDoc/renderdoc_app.h"
+#include <string>
 #include <vector>
 
 #define DX_SAFE_RELEASE(dxObject)	\
@@ -19,6 +21,8 @@
 
 class Window;
 class Texture;
+struct texture_cook_options;
+struct CookedTextureSource;
 class BitmapFont;
 struct ID3D11Device;
 struct ID3D11DeviceContext;
@@ -41,6 +45,7 @@ class VertexBuffer;
 class Shader;
 class ConstantBuffer;
 class Image;
+class JobSystem;
 class IndexBuffer;
 struct Vertex_PNCU;
 struct TextureCreateInfo;
@@ -112,6 +117,7 @@ struct RendererConfig
 {
 	Window* m_window = nullptr;
 	const char* m_defaultShader = nullptr;
+	FileWatcher* m_fileWatcher = nullptr;		//when set, textures and shaders loaded from files reload when the file changes
 };
 
 enum class eMemoryHint : int
@@ -143,9 +149,16 @@ public:
 	void DrawVertexArray(int numVertexes, const Vertex_PNCU* vertexes);
 	void DrawIndexed(int numIndices);
 	void DrawIndexed(unsigned int numIndices, unsigned int startIndexInIndexList, int startVertexInVertexList);
+	void DrawIndirect(ID3D11Buffer* indirectArgsBuffer, unsigned int byteOffset);
 
 	Texture* CreateTexture(const TextureCreateInfo& createInfo);
 	Texture* CreateOrGetTextureFromFile(char const* imageFilePath);
+	Texture* CreateOrGetTextureFromImage(const Image& image);
+	//mips and block compression as cooked, nullptr if unreadable. with a source image and a file watcher, a change to the
+	//source cooks the file again (default options if none are given) and the texture reloads from the new cook
+	Texture* CreateOrGetTextureFromCookedFile(const char* cookedFilePath, const char* sourceImagePath = nullptr, const texture_cook_options* cookOptions = nullptr);
+	//for loading screens, decodes all the files at once on the job system and only creates the textures here
+	void CreateOrGetTexturesFromFiles(const std::vector<std::string>& imageFilePaths, JobSystem* jobSystem, std::vector<Texture*>* out_textures = nullptr);
 	BitmapFont* CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension);
 	Texture* CreateSkyboxTexture(const char* skyboxName, const char* front, const char* back, const char* left, const char* right,
 		const char* top, const char* bottom);
@@ -154,16 +167,22 @@ public:
 	const Shader* GetDefaultShader() const;
 
 	VertexBuffer* CreateVertexBuffer(const size_t size, unsigned int stride);
-	IndexBuffer* CreateIndexBuffer(const size_t size);
+	IndexBuffer* CreateIndexBuffer(const size_t size, unsigned int stride = sizeof(unsigned int));
 	ConstantBuffer* CreateConstantBuffer(const size_t size);
 	void CreateAndCompileComputeShader(char const* shaderName, ID3D11ComputeShader** pComputeShader, const char* entryName = "CSMain");
+	void CreateAndCompileComputeShaderFromSource(char const* shaderName, char const* shaderSource, ID3D11ComputeShader** pComputeShader, const char* entryName = "CSMain");
 	void CreateShaderResourceView(ID3D11ShaderResourceView** pResourceView, ID3D11Buffer* pShaderResource);
 	void CreateD3DUnorderedAccessBuffer(ID3D11Buffer** pBuffer, const size_t totalBufferSize, const size_t stride, const void* initialData, bool cpuWriteAccess = false);
 	void CreateUnorderedAccessView(ID3D11UnorderedAccessView** pResourceView, ID3D11Buffer* pUnorderedResource, UAVType type);
 	void CreateD3DStagingBuffer(ID3D11Buffer** pBuffer, const size_t totalBufferSize, const size_t stride);
 	void CreateD3DIndirectArgsBuffer(ID3D11Buffer** pBuffer, const size_t totalBufferSize, const size_t stride, const void* initialData);
 	void CreateD3DShaderResource(ID3D11Buffer** pBuffer, const size_t totalBufferSize, const size_t stride, const void* initialData);
-	bool CompileShaderToByteCode(std::vector<unsigned char>& outByteCode, char const* name, char const* source, char const* entryPoint, char const* target);
+	bool CompileShaderToByteCode(std::vector<unsigned char>& outByteCode, char const* name, char const* source, char const* entryPoint, char const* target, bool isFatal = true);
+
+	//replace the gpu resources behind an existing texture or shader with the file's current contents, everything holding
+	//the pointer sees the new version. a file that doesn't load keeps the old version and returns false
+	bool ReloadTexture(Texture* texture);
+	bool ReloadShader(Shader* shader);
 
 	void BindTexture(const Texture* texture, unsigned int slot = 0, bool bindToVS = false);
 	void BindVertexBuffer(VertexBuffer* vbo);
@@ -184,6 +203,7 @@ public:
 	void CopyCPUToGPU(const void* data, size_t size, ConstantBuffer* cbo);
 	void CopyCPUToGPU(const void* data, const size_t size, ID3D11Buffer* pDestinationBuffer);
 	void CopyGPUToCPU(void* data, const size_t copySize, ID3D11Buffer* pSourceBuffer);
+	bool TryCopyGPUToCPU(void* data, const size_t copySize, ID3D11Buffer* pSourceBuffer);
 	void CopyGPUStructCount(ID3D11Buffer* pDestCountBuffer, unsigned int byteOffset, ID3D11UnorderedAccessView* pSrcUAV);
 	void CopyOverResourcesInGPU(ID3D11Buffer* pDestResource, ID3D11Buffer* pSourceResource);
 
@@ -214,6 +234,7 @@ private:
 	Texture* CreateTextureFromFile(char const* imageFilePath, bool saveTexture = true);
 	Texture* CreateTextureFromData(char const* name, IntVec2 dimensions, int bytesPerTexel, uint8_t* texelData);
 	Texture* CreateTextureFromImage(const Image& image);
+	Texture* CreateTextureFromCookedFile(const char* cookedFilePath);
 	BitmapFont* GetBitmpaFontForFileName(const char* fontFilePath);
 	BitmapFont* CreateBitmapFont(const char* fontFilePath);
 
@@ -221,13 +242,18 @@ private:
 	void CreateBackBuffer();
 	void DefineViewport(const AABB2& camViewport);
 	void CreateAndSetRasterizerState();
-	void CreateInputLayout(Shader* shader, bool isLitShader);
+	bool CreateInputLayout(Shader* shader, bool isLitShader, bool isFatal = true);
 	void CreateDepthStencilTextureAndView();
 
 	Shader* GetShaderForName(const char* shaderName);
 	Shader* CreateShader(const char* shaderName);
 	Shader* CreateShader(char const* shaderName, char const* shaderSource);
 
+	void WatchAssetFile(const std::string& filePath);
+	static void OnAssetFileChanged(const std::string& filePath, void* userData);
+	void ReloadAssetFile(const std::string& filePath);
+	void RecookTexture(const CookedTextureSource& cookedSource);
+
 	void CreateD3DVertexBuffer(const size_t size, VertexBuffer* vbo);
 	void CreateD3DConstantBuffer(const size_t size, ConstantBuffer* cbo);
 	void CreateD3DIndexBuffer(const size_t size, IndexBuffer* ibo);
@@ -247,6 +273,8 @@ private:
 	Texture* m_defaultTexture = nullptr;
 	std::vector<BitmapFont*> m_loadedFonts;
 	std::vector<Shader*> m_loadedShaders;
+	std::vector<FileWatchID> m_fileWatches;
+	std::vector<CookedTextureSource*> m_cookedTextureSources;		//only kept while there is a file watcher
 	const Shader* m_currentShader = nullptr;
 	const Shader* m_defaultShader = nullptr;
 	std::vector<uint8_t> m_vertexShaderByteCode = {};
@@ -12,6 +12,12 @@ void SpriteDefinition::GetUVs(Vec2& out_uvAtMins, Vec2& out_uvAtMaxs) const
 	out_uvAtMaxs = m_uvAtMaxs;
 }
 
+void SpriteDefinition::RemapUVs(const AABB2& containingUVBounds)
+{
+	m_uvAtMins = containingUVBounds.GetPointAtUV(m_uvAtMins);
+	m_uvAtMaxs = containingUVBounds.GetPointAtUV(m_uvAtMaxs);
+}
+
 AABB2 SpriteDefinition::GetUVs() const
 {
 	return AABB2(m_uvAtMins, m_uvAtMaxs);
@@ -10,6 +10,7 @@ class SpriteDefinition
 public:
 	explicit SpriteDefinition(const SpriteSheet& spriteSheet, int spriteIndex, const Vec2& uvAtMins, const Vec2& uvAtMaxs);
 	void GetUVs(Vec2& out_uvAtMins, Vec2& out_uvAtMaxs) const;
+	void RemapUVs(const AABB2& containingUVBounds);
 	AABB2 GetUVs() const;
 	const SpriteSheet& GetSpriteSheet() const;
 	Texture& GetTexture() const;
@@ -1,16 +1,32 @@
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Engine/Renderer/SpriteDefinition.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
 
 SpriteSheet::SpriteSheet(Texture& texture, const IntVec2& simpleGridLayout)
-	:m_texture(texture), m_size(simpleGridLayout)
+	:m_texture(&texture), m_size(simpleGridLayout)
 {
-	GenerateSpriteDefinitions(simpleGridLayout);
+	GenerateSpriteDefinitions(simpleGridLayout, m_texture->GetDimensions());
+}
+
+SpriteSheet::SpriteSheet(const TextureAtlas& atlas, const TextureAtlasEntry& atlasEntry, const IntVec2& simpleGridLayout)
+	:m_texture(atlas.GetTextureForEntry(atlasEntry)), m_size(simpleGridLayout)
+{
+	GUARANTEE_OR_DIE(m_texture, Stringf("No atlas texture for sprite sheet \"%s\"", atlasEntry.m_sourcePath.c_str()));
+
+	//lay the grid out over the original image, then move every sprite into the entry's spot in the atlas
+	GenerateSpriteDefinitions(simpleGridLayout, atlasEntry.m_dimensions);
+	for (int i = 0; i < m_spriteDefinitions.size(); i++)
+	{
+		m_spriteDefinitions[i].RemapUVs(atlasEntry.m_uvBounds);
+	}
 }
 
 Texture& SpriteSheet::GetTexture() const
 {
-	return m_texture;
+	return *m_texture;
 }
 
 int SpriteSheet::GetNumSprites() const
@@ -33,10 +49,9 @@ AABB2 SpriteSheet::GetSpriteUVs(int spriteIndex) const
 	return m_spriteDefinitions[spriteIndex].GetUVs();
 }
 
-void SpriteSheet::GenerateSpriteDefinitions(IntVec2 gridLayout)
+void SpriteSheet::GenerateSpriteDefinitions(IntVec2 gridLayout, IntVec2 textureDimensions)
 {
 	int spriteIndex = 0;
-	IntVec2 textureDimensions = m_texture.GetDimensions();
 	float singleSpriteWidth = (float)(textureDimensions.x / gridLayout.x);
 	float singleSpriteHeight = (float)(textureDimensions.y / gridLayout.y);
 	for (int y = gridLayout.y - 1; y >= 0; y--)
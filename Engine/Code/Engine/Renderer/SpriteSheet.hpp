@@ -5,11 +5,14 @@
 #include <vector>
 
 //class SpriteDefinition;
+class TextureAtlas;
+struct TextureAtlasEntry;
 
 class SpriteSheet
 {
 public:
 	explicit SpriteSheet(Texture& texture, const IntVec2& simpleGridLayout);
+	explicit SpriteSheet(const TextureAtlas& atlas, const TextureAtlasEntry& atlasEntry, const IntVec2& simpleGridLayout);
 	Texture& GetTexture() const;
 	IntVec2 GetSize() const { return m_size; }
 	int GetNumSprites() const;
@@ -19,10 +22,10 @@ public:
 
 protected:
 	IntVec2 m_size = IntVec2::ZERO;
-	Texture& m_texture;
+	Texture* m_texture = nullptr;
 	std::vector<SpriteDefinition> m_spriteDefinitions;
 
 private:
-	void GenerateSpriteDefinitions(IntVec2 gridLayout);
+	void GenerateSpriteDefinitions(IntVec2 gridLayout, IntVec2 textureDimensions);
 	void ConvertSpriteBoundsToUVs(Vec2& lowerBound, Vec2& upperBound, IntVec2 textureDimensions);
 };
\ No newline at end of file
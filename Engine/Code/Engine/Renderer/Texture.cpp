@@ -11,6 +11,9 @@ DXGI_FORMAT TextureLocalToD3D11(eTextureFormat format)
 	case eTextureFormat::R8G8B8A8_UNORM: return DXGI_FORMAT_R8G8B8A8_UNORM;
 	case eTextureFormat::D24_UNORM_S8_UINT: return DXGI_FORMAT_D24_UNORM_S8_UINT;
 	case eTextureFormat::R24G8_TYPELESS: return DXGI_FORMAT_R24G8_TYPELESS;
+	case eTextureFormat::BC1_UNORM: return DXGI_FORMAT_BC1_UNORM;
+	case eTextureFormat::BC3_UNORM: return DXGI_FORMAT_BC3_UNORM;
+	case eTextureFormat::BC7_UNORM: return DXGI_FORMAT_BC7_UNORM;
 	default: ERROR_AND_DIE("Unsupported format");
 	}
 }
@@ -88,7 +91,7 @@ TextureView* Texture::FindOrCreateView(const TextureViewInfo& info)
 		{
 			desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
 			desc.Texture2D.MostDetailedMip = 0;
-			desc.Texture2D.MipLevels = 1;
+			desc.Texture2D.MipLevels = m_numMips;
 			break;
 		}
 		case eTextureType::TEXTURE_ARRAY_2D:
@@ -96,7 +99,7 @@ TextureView* Texture::FindOrCreateView(const TextureViewInfo& info)
 			desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
 			desc.Texture2DArray.ArraySize = m_arraySize;
 			desc.Texture2DArray.FirstArraySlice = 0;
-			desc.Texture2DArray.MipLevels = 1;
+			desc.Texture2DArray.MipLevels = m_numMips;
 			desc.Texture2DArray.MostDetailedMip = 0;
 			break;
 		}
@@ -27,6 +27,15 @@ enum class eTextureFormat : int
 	R8G8B8A8_UNORM,
 	D24_UNORM_S8_UINT,
 	R24G8_TYPELESS,
+	BC1_UNORM,
+	BC3_UNORM,
+	BC7_UNORM,
+};
+
+struct TextureMipData
+{
+	const void* m_data = nullptr;
+	unsigned int m_rowPitch = 0;
 };
 
 struct TextureCreateInfo
@@ -40,6 +49,8 @@ struct TextureCreateInfo
 	unsigned int m_textureArraySize = 1;
 	const void* m_initialData = nullptr;
 	size_t m_initialDataByteSize = 0;
+	const TextureMipData* m_mips = nullptr;		//a full chain of initial data, used instead of m_initialData
+	unsigned int m_numMips = 1;
 	ID3D11Texture2D* m_handle = nullptr;
 };
 
@@ -64,6 +75,7 @@ private:
 
 public:
 	IntVec2	GetDimensions() const { return m_dimensions; }
+	unsigned int GetNumMips() const { return m_numMips; }
 	std::string const& GetImageFilePath() const { return m_name; }
 	TextureView* GetShaderResourceView();
 	TextureView* GetDepthStencilView();
@@ -79,5 +91,7 @@ protected:
 	eTextureBindFlags m_allowedBinds = TEXTURE_BIND_NONE;
 	eTextureType m_textureType = eTextureType::TEXTURE_2D;
 	unsigned int m_arraySize = 1;
+	unsigned int m_numMips = 1;
+	bool m_isCooked = false;			//m_name is a cooked texture file rather than an image to decode
 	std::vector<TextureView*> m_views;
 };
\ No newline at end of file
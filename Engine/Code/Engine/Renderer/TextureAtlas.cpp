@@ -0,0 +1,342 @@
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "ThirdParty/ImGUI/imstb_rectpack.h"
+#include "Engine/Renderer/TextureAtlas.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+constexpr uint32_t COOKED_ATLAS_FOURCC = 0x534c5441;		//"ATLS"
+constexpr uint32_t COOKED_ATLAS_VERSION = 1;
+
+TextureAtlas::TextureAtlas(const TextureAtlasConfig& config)
+	:m_config(config)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	for (int i = 0; i < m_sourceImages.size(); i++)
+	{
+		delete m_sourceImages[i];
+	}
+	m_sourceImages.clear();
+	ClearPages();
+}
+
+int TextureAtlas::AddImageFromFile(const char* imageFilePath)
+{
+	const TextureAtlasEntry* existingEntry = FindEntry(imageFilePath);
+	if (existingEntry)
+	{
+		return (int)(existingEntry - m_entries.data());
+	}
+
+	Image* image = new Image(imageFilePath);
+	int entryIndex = AddRect(imageFilePath, image->GetDimensions());
+	m_sourceImages[entryIndex] = image;
+	return entryIndex;
+}
+
+int TextureAtlas::AddRect(const char* sourcePath, const IntVec2& dimensions)
+{
+	GUARANTEE_OR_DIE(!m_isPacked, "Can't add to a texture atlas after it has been packed");
+
+	TextureAtlasEntry entry;
+	entry.m_sourcePath = sourcePath;
+	entry.m_dimensions = dimensions;
+	m_entries.push_back(entry);
+	m_sourceImages.push_back(nullptr);
+	return (int)m_entries.size() - 1;
+}
+
+bool TextureAtlas::Pack()
+{
+	int pageWidth = m_config.m_pageDimensions.x;
+	int pageHeight = m_config.m_pageDimensions.y;
+	int padding = m_config.m_padding;
+
+	std::vector<stbrp_node> nodes(pageWidth);
+	std::vector<stbrp_rect> rectsToPack;
+	rectsToPack.reserve(m_entries.size());
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		stbrp_rect rect = {};
+		rect.id = i;
+		rect.w = m_entries[i].m_dimensions.x + padding * 2;
+		rect.h = m_entries[i].m_dimensions.y + padding * 2;
+		if (rect.w > pageWidth || rect.h > pageHeight)
+		{
+			ERROR_RECOVERABLE(Stringf("\"%s\" is larger than the texture atlas page", m_entries[i].m_sourcePath.c_str()));
+			return false;
+		}
+		rectsToPack.push_back(rect);
+	}
+
+	//fill one page at a time, whatever doesn't fit moves on to the next page
+	m_numPages = 0;
+	while (!rectsToPack.empty())
+	{
+		if (m_numPages >= m_config.m_maxPages)
+		{
+			ERROR_RECOVERABLE(Stringf("Texture atlas \"%s\" needs more than %d pages", m_config.m_name.c_str(), m_config.m_maxPages));
+			return false;
+		}
+
+		stbrp_context context;
+		stbrp_init_target(&context, pageWidth, pageHeight, nodes.data(), (int)nodes.size());
+		stbrp_pack_rects(&context, rectsToPack.data(), (int)rectsToPack.size());
+
+		std::vector<stbrp_rect> leftoverRects;
+		for (int i = 0; i < rectsToPack.size(); i++)
+		{
+			const stbrp_rect& rect = rectsToPack[i];
+			if (!rect.was_packed)
+			{
+				leftoverRects.push_back(rect);
+				continue;
+			}
+
+			TextureAtlasEntry& entry = m_entries[rect.id];
+			entry.m_pageIndex = m_numPages;
+			entry.m_texelOffset = IntVec2(rect.x + padding, rect.y + padding);
+			UpdateEntryUVBounds(entry);
+		}
+
+		rectsToPack.swap(leftoverRects);
+		m_numPages++;
+	}
+
+	m_isPacked = true;
+	return true;
+}
+
+void TextureAtlas::BuildPageImages()
+{
+	GUARANTEE_OR_DIE(m_isPacked, "Texture atlas has to be packed before building its pages");
+	ClearPages();
+
+	std::vector<Rgba8> clearTexels((size_t)m_config.m_pageDimensions.x * (size_t)m_config.m_pageDimensions.y, Rgba8(0, 0, 0, 0));
+	for (int pageIndex = 0; pageIndex < m_numPages; pageIndex++)
+	{
+		std::string pageName = Stringf("%s_%d", m_config.m_name.c_str(), pageIndex);
+		m_pageImages.push_back(new Image(pageName.c_str(), m_config.m_pageDimensions, clearTexels));
+	}
+
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		if (m_sourceImages[i])
+		{
+			CopyImageIntoPage(*m_sourceImages[i], m_entries[i], *m_pageImages[m_entries[i].m_pageIndex]);
+		}
+	}
+}
+
+void TextureAtlas::CreatePageTextures(Renderer& renderer)
+{
+	m_pageTextures.clear();
+	for (int i = 0; i < m_pageImages.size(); i++)
+	{
+		m_pageTextures.push_back(renderer.CreateOrGetTextureFromImage(*m_pageImages[i]));
+	}
+}
+
+bool TextureAtlas::SaveCookedAtlas(const char* filepath) const
+{
+	if (!m_isPacked || m_pageImages.size() != m_numPages)
+	{
+		ERROR_RECOVERABLE(Stringf("Texture atlas \"%s\" has to be packed and built before it can be saved", m_config.m_name.c_str()));
+		return false;
+	}
+
+	std::vector<uint8_t> buffer;
+	BufferWriter writer(buffer);
+	writer.SetEndianess(EndianMode::LITTLE);
+	writer.AppendUnsignedInt32(COOKED_ATLAS_FOURCC);
+	writer.AppendUnsignedInt32(COOKED_ATLAS_VERSION);
+	writer.AppendLengthPrecededString(m_config.m_name);
+	writer.AppendIntVec2(m_config.m_pageDimensions);
+	writer.AppendInt32(m_config.m_padding);
+	writer.AppendInt32(m_numPages);
+	writer.AppendUnsignedInt32((uint32_t)m_entries.size());
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		const TextureAtlasEntry& entry = m_entries[i];
+		writer.AppendLengthPrecededString(entry.m_sourcePath);
+		writer.AppendIntVec2(entry.m_dimensions);
+		writer.AppendIntVec2(entry.m_texelOffset);
+		writer.AppendInt32(entry.m_pageIndex);
+	}
+
+	for (int pageIndex = 0; pageIndex < m_pageImages.size(); pageIndex++)
+	{
+		const Rgba8* texels = static_cast<const Rgba8*>(m_pageImages[pageIndex]->GetRawData());
+		size_t numTexels = (size_t)m_config.m_pageDimensions.x * (size_t)m_config.m_pageDimensions.y;
+		for (size_t texelIndex = 0; texelIndex < numTexels; texelIndex++)
+		{
+			writer.AppendRgba8(texels[texelIndex]);
+		}
+	}
+
+	return BufferWriteToFile(buffer, filepath) == 0;
+}
+
+bool TextureAtlas::LoadCookedAtlas(const char* filepath)
+{
+	//the page texels are read straight out of the mapping, nothing is copied besides what ends up in the images
+	MappedFile mappedFile;
+	if (!mappedFile.Open(filepath, FileAccessPattern::SEQUENTIAL))
+		return false;
+
+	BufferParser parser(mappedFile.GetBytes());
+	parser.SetEndianess(EndianMode::LITTLE);
+	if (parser.ReadUnsignedInt32() != COOKED_ATLAS_FOURCC || parser.ReadUnsignedInt32() != COOKED_ATLAS_VERSION)
+	{
+		ERROR_RECOVERABLE(Stringf("\"%s\" is not a cooked texture atlas of the current version", filepath));
+		return false;
+	}
+
+	for (int i = 0; i < m_sourceImages.size(); i++)
+	{
+		delete m_sourceImages[i];
+	}
+	m_sourceImages.clear();
+	m_entries.clear();
+	ClearPages();
+
+	parser.ReadLengthPrecededString(m_config.m_name);
+	m_config.m_pageDimensions = parser.ReadIntVec2();
+	m_config.m_padding = parser.ReadInt32();
+	m_numPages = parser.ReadInt32();
+	uint32_t numEntries = parser.ReadUnsignedInt32();
+	for (uint32_t i = 0; i < numEntries; i++)
+	{
+		TextureAtlasEntry entry;
+		parser.ReadLengthPrecededString(entry.m_sourcePath);
+		entry.m_dimensions = parser.ReadIntVec2();
+		entry.m_texelOffset = parser.ReadIntVec2();
+		entry.m_pageIndex = parser.ReadInt32();
+		UpdateEntryUVBounds(entry);
+		m_entries.push_back(entry);
+		m_sourceImages.push_back(nullptr);
+	}
+
+	size_t numTexels = (size_t)m_config.m_pageDimensions.x * (size_t)m_config.m_pageDimensions.y;
+	std::vector<Rgba8> pageTexels(numTexels);
+	for (int pageIndex = 0; pageIndex < m_numPages; pageIndex++)
+	{
+		for (size_t texelIndex = 0; texelIndex < numTexels; texelIndex++)
+		{
+			pageTexels[texelIndex] = parser.ReadRgba8();
+		}
+		std::string pageName = Stringf("%s_%d", m_config.m_name.c_str(), pageIndex);
+		m_pageImages.push_back(new Image(pageName.c_str(), m_config.m_pageDimensions, pageTexels));
+	}
+
+	m_isPacked = true;
+	return true;
+}
+
+int TextureAtlas::GetNumEntries() const
+{
+	return (int)m_entries.size();
+}
+
+int TextureAtlas::GetNumPages() const
+{
+	return m_numPages;
+}
+
+bool TextureAtlas::IsPacked() const
+{
+	return m_isPacked;
+}
+
+const TextureAtlasEntry& TextureAtlas::GetEntry(int entryIndex) const
+{
+	return m_entries[entryIndex];
+}
+
+const TextureAtlasEntry* TextureAtlas::FindEntry(const char* sourcePath) const
+{
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		if (m_entries[i].m_sourcePath == sourcePath)
+			return &m_entries[i];
+	}
+
+	return nullptr;
+}
+
+const Image* TextureAtlas::GetPageImage(int pageIndex) const
+{
+	if (pageIndex < 0 || pageIndex >= m_pageImages.size())
+		return nullptr;
+
+	return m_pageImages[pageIndex];
+}
+
+Texture* TextureAtlas::GetPageTexture(int pageIndex) const
+{
+	if (pageIndex < 0 || pageIndex >= m_pageTextures.size())
+		return nullptr;
+
+	return m_pageTextures[pageIndex];
+}
+
+Texture* TextureAtlas::GetTextureForEntry(const TextureAtlasEntry& entry) const
+{
+	return GetPageTexture(entry.m_pageIndex);
+}
+
+AABB2 TextureAtlas::RemapUVs(const TextureAtlasEntry& entry, const AABB2& sourceUVs)
+{
+	return entry.m_uvBounds.GetBoxWithin(sourceUVs);
+}
+
+Vec2 TextureAtlas::RemapUV(const TextureAtlasEntry& entry, const Vec2& sourceUV)
+{
+	return entry.m_uvBounds.GetPointAtUV(sourceUV);
+}
+
+void TextureAtlas::ClearPages()
+{
+	for (int i = 0; i < m_pageImages.size(); i++)
+	{
+		delete m_pageImages[i];
+	}
+	m_pageImages.clear();
+
+	//textures are owned by the renderer
+	m_pageTextures.clear();
+}
+
+void TextureAtlas::UpdateEntryUVBounds(TextureAtlasEntry& entry) const
+{
+	Vec2 pageDimensions = Vec2(m_config.m_pageDimensions);
+	Vec2 uvMins = Vec2((float)entry.m_texelOffset.x / pageDimensions.x, (float)entry.m_texelOffset.y / pageDimensions.y);
+	Vec2 uvMaxs = Vec2((float)(entry.m_texelOffset.x + entry.m_dimensions.x) / pageDimensions.x,
+		(float)(entry.m_texelOffset.y + entry.m_dimensions.y) / pageDimensions.y);
+	entry.m_uvBounds = AABB2(uvMins, uvMaxs);
+}
+
+void TextureAtlas::CopyImageIntoPage(const Image& sourceImage, const TextureAtlasEntry& entry, Image& page) const
+{
+	//copy the padded rect, clamping into the source so the border repeats the image's edge texels
+	IntVec2 sourceDimensions = sourceImage.GetDimensions();
+	int padding = m_config.m_padding;
+	for (int y = -padding; y < entry.m_dimensions.y + padding; y++)
+	{
+		int sourceY = Clamp(y, 0, sourceDimensions.y - 1);
+		for (int x = -padding; x < entry.m_dimensions.x + padding; x++)
+		{
+			int sourceX = Clamp(x, 0, sourceDimensions.x - 1);
+			Rgba8 texel = sourceImage.GetTexelColor(IntVec2(sourceX, sourceY));
+			page.SetTexelColor(IntVec2(entry.m_texelOffset.x + x, entry.m_texelOffset.y + y), texel);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/AABB2.hpp"
+
+class Image;
+class Texture;
+class Renderer;
+
+struct TextureAtlasConfig
+{
+	std::string m_name = "TextureAtlas";
+	IntVec2 m_pageDimensions = IntVec2(2048, 2048);
+	int m_padding = 2;						//edge texels repeated around each image so filtering doesn't bleed into neighbours
+	int m_maxPages = 4;
+};
+
+struct TextureAtlasEntry
+{
+	std::string m_sourcePath;
+	IntVec2 m_dimensions;
+	IntVec2 m_texelOffset;					//bottom left of the image in the page, excluding padding
+	int m_pageIndex = -1;
+	AABB2 m_uvBounds;
+};
+
+//packs many small textures into a few shared pages at load time so emitters and sprites can share binds and draws.
+//packing and uv remapping only need the image dimensions, so they work without a renderer
+class TextureAtlas
+{
+public:
+	TextureAtlas(const TextureAtlasConfig& config);
+	~TextureAtlas();
+
+	int AddImageFromFile(const char* imageFilePath);
+	int AddRect(const char* sourcePath, const IntVec2& dimensions);
+	bool Pack();
+	void BuildPageImages();
+	void CreatePageTextures(Renderer& renderer);
+
+	bool SaveCookedAtlas(const char* filepath) const;
+	bool LoadCookedAtlas(const char* filepath);
+
+	int GetNumEntries() const;
+	int GetNumPages() const;
+	bool IsPacked() const;
+	const TextureAtlasEntry& GetEntry(int entryIndex) const;
+	const TextureAtlasEntry* FindEntry(const char* sourcePath) const;
+	const Image* GetPageImage(int pageIndex) const;
+	Texture* GetPageTexture(int pageIndex) const;
+	Texture* GetTextureForEntry(const TextureAtlasEntry& entry) const;
+
+	//maps uvs in the source texture's 0-1 space into the atlas page
+	static AABB2 RemapUVs(const TextureAtlasEntry& entry, const AABB2& sourceUVs);
+	static Vec2 RemapUV(const TextureAtlasEntry& entry, const Vec2& sourceUV);
+
+private:
+	void ClearPages();
+	void UpdateEntryUVBounds(TextureAtlasEntry& entry) const;
+	void CopyImageIntoPage(const Image& sourceImage, const TextureAtlasEntry& entry, Image& page) const;
+
+private:
+	TextureAtlasConfig m_config;
+	std::vector<TextureAtlasEntry> m_entries;
+	std::vector<Image*> m_sourceImages;			//parallel to m_entries, null for rects added without texels
+	std::vector<Image*> m_pageImages;
+	std::vector<Texture*> m_pageTextures;
+	int m_numPages = 0;
+	bool m_isPacked = false;
+};
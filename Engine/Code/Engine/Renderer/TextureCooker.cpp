@@ -0,0 +1,1193 @@
+#include "Engine/Renderer/TextureCooker.hpp"
+#include "Engine/Renderer/TextureFile.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define TEXTURE_COOKER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+constexpr float KAISER_FILTER_RADIUS = 3.f;		//in destination texels
+constexpr float KAISER_FILTER_ALPHA = 4.f;
+constexpr float TEXTURE_COOKER_PI = 3.14159265f;
+constexpr int BC7_MODE_5 = 5;
+constexpr int BC7_MODE_6 = 6;
+static const int BC7_WEIGHTS_2_BIT[4] = { 0, 21, 43, 64 };
+static const int BC7_WEIGHTS_4_BIT[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+//----------------------------------------------------------------------------------------------------------------------
+//mips
+
+//one filter per axis, every destination texel reads numTaps source texels starting at its first tap
+struct MipFilterAxis
+{
+	int m_numTaps = 0;
+	std::vector<int> m_firstTaps;
+	std::vector<float> m_weights;
+};
+
+static float ComputeBesselI0(float x)
+{
+	float sum = 1.f;
+	float term = 1.f;
+	float halfX = 0.5f * x;
+	for (int k = 1; k < 32 && term > sum * 1e-7f; k++)
+	{
+		term *= (halfX / (float)k) * (halfX / (float)k);
+		sum += term;
+	}
+	return sum;
+}
+
+static float ComputeKaiserSincWeight(float distance)
+{
+	if (fabsf(distance) >= KAISER_FILTER_RADIUS)
+		return 0.f;
+
+	float sinc = distance == 0.f ? 1.f : sinf(TEXTURE_COOKER_PI * distance) / (TEXTURE_COOKER_PI * distance);
+	float t = distance / KAISER_FILTER_RADIUS;
+	return sinc * ComputeBesselI0(KAISER_FILTER_ALPHA * sqrtf(1.f - t * t)) / ComputeBesselI0(KAISER_FILTER_ALPHA);
+}
+
+static void BuildMipFilterAxis(eMipFilter filter, int srcSize, int dstSize, MipFilterAxis& out_axis)
+{
+	//texel i covers [i, i + 1) in its level, scale takes destination units to source units
+	float scale = (float)srcSize / (float)dstSize;
+	float support = filter == eMipFilter::KAISER ? KAISER_FILTER_RADIUS * scale : 0.5f * scale;
+	out_axis.m_numTaps = (int)ceilf(2.f * support) + 1;
+	out_axis.m_firstTaps.resize(dstSize);
+	out_axis.m_weights.resize((size_t)dstSize * out_axis.m_numTaps);
+	for (int dst = 0; dst < dstSize; dst++)
+	{
+		float center = ((float)dst + 0.5f) * scale;
+		int firstTap = (int)floorf(center - support);
+		float* weights = &out_axis.m_weights[(size_t)dst * out_axis.m_numTaps];
+		float weightSum = 0.f;
+		for (int tap = 0; tap < out_axis.m_numTaps; tap++)
+		{
+			float srcCenter = (float)(firstTap + tap) + 0.5f;
+			if (filter == eMipFilter::KAISER)
+			{
+				weights[tap] = ComputeKaiserSincWeight((srcCenter - center) / scale);
+			}
+			else
+			{
+				float overlap = fminf(srcCenter + 0.5f, center + support) - fmaxf(srcCenter - 0.5f, center - support);
+				weights[tap] = fmaxf(overlap, 0.f);
+			}
+			weightSum += weights[tap];
+		}
+		for (int tap = 0; tap < out_axis.m_numTaps; tap++)
+		{
+			weights[tap] /= weightSum;
+		}
+		out_axis.m_firstTaps[dst] = firstTap;
+	}
+}
+
+//separable, edges clamp. runs in float so the negative lobes of the kaiser filter survive until the final rounding
+static void DownsampleFiltered(eMipFilter filter, const Rgba8* src, const IntVec2& srcDims, Rgba8* dst, const IntVec2& dstDims)
+{
+	MipFilterAxis axisX;
+	MipFilterAxis axisY;
+	BuildMipFilterAxis(filter, srcDims.x, dstDims.x, axisX);
+	BuildMipFilterAxis(filter, srcDims.y, dstDims.y, axisY);
+
+	std::vector<float> rows((size_t)dstDims.x * srcDims.y * 4);
+	for (int y = 0; y < srcDims.y; y++)
+	{
+		const Rgba8* srcRow = src + (size_t)y * srcDims.x;
+		float* rowOut = &rows[(size_t)y * dstDims.x * 4];
+		for (int x = 0; x < dstDims.x; x++)
+		{
+			const float* weights = &axisX.m_weights[(size_t)x * axisX.m_numTaps];
+			float sum[4] = {};
+			for (int tap = 0; tap < axisX.m_numTaps; tap++)
+			{
+				const Rgba8& texel = srcRow[Clamp(axisX.m_firstTaps[x] + tap, 0, srcDims.x - 1)];
+				sum[0] += weights[tap] * texel.r;
+				sum[1] += weights[tap] * texel.g;
+				sum[2] += weights[tap] * texel.b;
+				sum[3] += weights[tap] * texel.a;
+			}
+			memcpy(rowOut + x * 4, sum, sizeof(sum));
+		}
+	}
+
+	std::vector<float> sum((size_t)dstDims.x * 4);
+	for (int y = 0; y < dstDims.y; y++)
+	{
+		const float* weights = &axisY.m_weights[(size_t)y * axisY.m_numTaps];
+		std::fill(sum.begin(), sum.end(), 0.f);
+		for (int tap = 0; tap < axisY.m_numTaps; tap++)
+		{
+			const float* row = &rows[(size_t)Clamp(axisY.m_firstTaps[y] + tap, 0, srcDims.y - 1) * dstDims.x * 4];
+			for (int i = 0; i < dstDims.x * 4; i++)
+			{
+				sum[i] += weights[tap] * row[i];
+			}
+		}
+		unsigned char* dstRow = (unsigned char*)(dst + (size_t)y * dstDims.x);
+		for (int i = 0; i < dstDims.x * 4; i++)
+		{
+			dstRow[i] = (unsigned char)Clamp(sum[i] + 0.5f, 0.f, 255.f);
+		}
+	}
+}
+
+//exact halving, the common case for power of two textures
+static void DownsampleBoxEven(const Rgba8* src, const IntVec2& srcDims, Rgba8* dst, const IntVec2& dstDims)
+{
+	for (int y = 0; y < dstDims.y; y++)
+	{
+		const unsigned char* row0 = (const unsigned char*)(src + (size_t)(2 * y) * srcDims.x);
+		const unsigned char* row1 = (const unsigned char*)(src + (size_t)(2 * y + 1) * srcDims.x);
+		unsigned char* dstRow = (unsigned char*)(dst + (size_t)y * dstDims.x);
+		int x = 0;
+#if defined(TEXTURE_COOKER_USE_SSE2)
+		//4 source texels from each row become 2 destination texels
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rounding = _mm_set1_epi16(2);
+		for (; x + 2 <= dstDims.x; x += 2)
+		{
+			__m128i top = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+			__m128i bottom = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+			__m128i left = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+			__m128i right = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+			__m128i sums = _mm_add_epi16(_mm_unpacklo_epi64(left, right), _mm_unpackhi_epi64(left, right));
+			sums = _mm_srli_epi16(_mm_add_epi16(sums, rounding), 2);
+			_mm_storel_epi64((__m128i*)(dstRow + x * 4), _mm_packus_epi16(sums, sums));
+		}
+#endif
+		for (; x < dstDims.x; x++)
+		{
+			for (int channel = 0; channel < 4; channel++)
+			{
+				int sum = row0[x * 8 + channel] + row0[x * 8 + 4 + channel] + row1[x * 8 + channel] + row1[x * 8 + 4 + channel];
+				dstRow[x * 4 + channel] = (unsigned char)((sum + 2) >> 2);
+			}
+		}
+	}
+}
+
+void GenerateMips(const Image& image, eMipFilter filter, std::vector<Image>& out_mips)
+{
+	out_mips.clear();
+	out_mips.push_back(image);
+	IntVec2 srcDims = image.GetDimensions();
+	std::vector<Rgba8> texels;
+	while (srcDims.x > 1 || srcDims.y > 1)
+	{
+		IntVec2 dstDims(srcDims.x > 1 ? srcDims.x / 2 : 1, srcDims.y > 1 ? srcDims.y / 2 : 1);
+		texels.resize((size_t)dstDims.x * dstDims.y);
+		const Rgba8* srcTexels = (const Rgba8*)out_mips.back().GetRawData();
+		if (filter == eMipFilter::BOX && srcDims.x % 2 == 0 && srcDims.y % 2 == 0)
+		{
+			DownsampleBoxEven(srcTexels, srcDims, texels.data(), dstDims);
+		}
+		else
+		{
+			DownsampleFiltered(filter, srcTexels, srcDims, texels.data(), dstDims);
+		}
+		std::string mipName = Stringf("%s_mip%i", image.GetImageFilePath().c_str(), (int)out_mips.size());
+		out_mips.push_back(Image(mipName.c_str(), dstDims, texels));
+		srcDims = dstDims;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//block compression
+
+static void GatherBlock(const Rgba8* texels, const IntVec2& dimensions, int blockX, int blockY, Rgba8* out_block)
+{
+	for (int y = 0; y < 4; y++)
+	{
+		int srcY = blockY * 4 + y < dimensions.y ? blockY * 4 + y : dimensions.y - 1;
+		for (int x = 0; x < 4; x++)
+		{
+			int srcX = blockX * 4 + x < dimensions.x ? blockX * 4 + x : dimensions.x - 1;
+			out_block[y * 4 + x] = texels[(size_t)srcY * dimensions.x + srcX];
+		}
+	}
+}
+
+//principal axis of the block's colors through power iteration, numChannels is 3 or 4
+static void ComputeBlockPrincipalAxis(const Rgba8* block, int numChannels, float* out_mean, float* out_axis)
+{
+	float values[16][4];
+	for (int i = 0; i < 16; i++)
+	{
+		values[i][0] = block[i].r;
+		values[i][1] = block[i].g;
+		values[i][2] = block[i].b;
+		values[i][3] = block[i].a;
+	}
+
+	for (int c = 0; c < numChannels; c++)
+	{
+		out_mean[c] = 0.f;
+		for (int i = 0; i < 16; i++)
+		{
+			out_mean[c] += values[i][c];
+		}
+		out_mean[c] /= 16.f;
+	}
+
+	float covariance[4][4] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		for (int row = 0; row < numChannels; row++)
+		{
+			for (int column = row; column < numChannels; column++)
+			{
+				covariance[row][column] += (values[i][row] - out_mean[row]) * (values[i][column] - out_mean[column]);
+			}
+		}
+	}
+	for (int row = 0; row < numChannels; row++)
+	{
+		for (int column = 0; column < row; column++)
+		{
+			covariance[row][column] = covariance[column][row];
+		}
+	}
+
+	//start from the diagonal of the bounding box, it is rarely far off and never orthogonal to a real axis
+	for (int c = 0; c < numChannels; c++)
+	{
+		float minValue = 255.f;
+		float maxValue = 0.f;
+		for (int i = 0; i < 16; i++)
+		{
+			minValue = fminf(minValue, values[i][c]);
+			maxValue = fmaxf(maxValue, values[i][c]);
+		}
+		out_axis[c] = maxValue - minValue + 1e-3f;
+	}
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		float next[4] = {};
+		float length = 0.f;
+		for (int row = 0; row < numChannels; row++)
+		{
+			for (int column = 0; column < numChannels; column++)
+			{
+				next[row] += covariance[row][column] * out_axis[column];
+			}
+			length = fmaxf(length, fabsf(next[row]));
+		}
+		if (length < 1e-6f)
+			break;
+
+		for (int c = 0; c < numChannels; c++)
+		{
+			out_axis[c] = next[c] / length;
+		}
+	}
+}
+
+//endpoints at the extremes of the block's projection onto its principal axis
+static void ComputeBlockEndpoints(const Rgba8* block, int numChannels, float* out_endpoint0, float* out_endpoint1)
+{
+	float mean[4] = {};
+	float axis[4] = {};
+	ComputeBlockPrincipalAxis(block, numChannels, mean, axis);
+	float axisLengthSquared = 0.f;
+	for (int c = 0; c < numChannels; c++)
+	{
+		axisLengthSquared += axis[c] * axis[c];
+	}
+	float minT = 0.f;
+	float maxT = 0.f;
+	for (int i = 0; i < 16; i++)
+	{
+		const unsigned char* texel = &block[i].r;
+		float t = 0.f;
+		for (int c = 0; c < numChannels; c++)
+		{
+			t += ((float)texel[c] - mean[c]) * axis[c];
+		}
+		t /= axisLengthSquared > 0.f ? axisLengthSquared : 1.f;
+		minT = fminf(minT, t);
+		maxT = fmaxf(maxT, t);
+	}
+	for (int c = 0; c < numChannels; c++)
+	{
+		out_endpoint0[c] = Clamp(mean[c] + axis[c] * maxT, 0.f, 255.f);
+		out_endpoint1[c] = Clamp(mean[c] + axis[c] * minT, 0.f, 255.f);
+	}
+}
+
+//solves for the two endpoints that best fit the texels given their palette weights (weight of endpoint 1, 0 to 1)
+static bool FitBlockEndpoints(const Rgba8* block, int numChannels, const float* weights, float* out_endpoint0, float* out_endpoint1)
+{
+	float aa = 0.f;
+	float ab = 0.f;
+	float bb = 0.f;
+	float ax[4] = {};
+	float bx[4] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		float a = 1.f - weights[i];
+		float b = weights[i];
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		const unsigned char* texel = &block[i].r;
+		for (int c = 0; c < numChannels; c++)
+		{
+			ax[c] += a * texel[c];
+			bx[c] += b * texel[c];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (fabsf(determinant) < 1e-6f)
+		return false;
+
+	for (int c = 0; c < numChannels; c++)
+	{
+		out_endpoint0[c] = Clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.f, 255.f);
+		out_endpoint1[c] = Clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.f, 255.f);
+	}
+	return true;
+}
+
+static uint16_t PackRgb565(const float* rgb)
+{
+	int r = (int)(rgb[0] * 31.f / 255.f + 0.5f);
+	int g = (int)(rgb[1] * 63.f / 255.f + 0.5f);
+	int b = (int)(rgb[2] * 31.f / 255.f + 0.5f);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRgb565(uint16_t color, int* out_rgb)
+{
+	int r = (color >> 11) & 31;
+	int g = (color >> 5) & 63;
+	int b = color & 31;
+	out_rgb[0] = (r << 3) | (r >> 2);
+	out_rgb[1] = (g << 2) | (g >> 4);
+	out_rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void BuildColorPalette(uint16_t color0, uint16_t color1, bool allowThreeColorMode, int out_palette[4][4])
+{
+	UnpackRgb565(color0, out_palette[0]);
+	UnpackRgb565(color1, out_palette[1]);
+	out_palette[0][3] = 255;
+	out_palette[1][3] = 255;
+	bool isFourColorMode = !allowThreeColorMode || color0 > color1;
+	for (int c = 0; c < 3; c++)
+	{
+		if (isFourColorMode)
+		{
+			out_palette[2][c] = (2 * out_palette[0][c] + out_palette[1][c] + 1) / 3;
+			out_palette[3][c] = (out_palette[0][c] + 2 * out_palette[1][c] + 1) / 3;
+		}
+		else
+		{
+			out_palette[2][c] = (out_palette[0][c] + out_palette[1][c] + 1) / 2;
+			out_palette[3][c] = 0;
+		}
+	}
+	out_palette[2][3] = 255;
+	out_palette[3][3] = isFourColorMode ? 255 : 0;
+}
+
+//always four color mode, so the same block works for BC3 where the decoder ignores the endpoint order
+static int ComputeColorIndices(const Rgba8* block, uint16_t color0, uint16_t color1, uint32_t& out_indices)
+{
+	int palette[4][4];
+	BuildColorPalette(color0, color1, false, palette);
+	int totalError = 0;
+	out_indices = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int bestError = INT_MAX;
+		int bestIndex = 0;
+		for (int p = 0; p < 4; p++)
+		{
+			int dr = block[i].r - palette[p][0];
+			int dg = block[i].g - palette[p][1];
+			int db = block[i].b - palette[p][2];
+			int error = dr * dr + dg * dg + db * db;
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+		totalError += bestError;
+		out_indices |= (uint32_t)bestIndex << (i * 2);
+	}
+	return totalError;
+}
+
+static void EncodeColorBlock(const Rgba8* block, int refinementPasses, uint8_t* out_block)
+{
+	static const float PALETTE_WEIGHTS[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeBlockEndpoints(block, 3, endpoint0, endpoint1);
+	uint16_t color0 = PackRgb565(endpoint0);
+	uint16_t color1 = PackRgb565(endpoint1);
+	uint32_t indices = 0;
+	int error = ComputeColorIndices(block, color0, color1, indices);
+	for (int pass = 0; pass < refinementPasses && error > 0; pass++)
+	{
+		float weights[16];
+		for (int i = 0; i < 16; i++)
+		{
+			weights[i] = PALETTE_WEIGHTS[(indices >> (i * 2)) & 3];
+		}
+		if (!FitBlockEndpoints(block, 3, weights, endpoint0, endpoint1))
+			break;
+
+		uint16_t refinedColor0 = PackRgb565(endpoint0);
+		uint16_t refinedColor1 = PackRgb565(endpoint1);
+		uint32_t refinedIndices = 0;
+		int refinedError = ComputeColorIndices(block, refinedColor0, refinedColor1, refinedIndices);
+		if (refinedError >= error)
+			break;
+
+		color0 = refinedColor0;
+		color1 = refinedColor1;
+		indices = refinedIndices;
+		error = refinedError;
+	}
+
+	//BC1 decoders read color0 <= color1 as the three color mode, so the larger endpoint has to come first
+	if (color0 < color1)
+	{
+		uint16_t swap = color0;
+		color0 = color1;
+		color1 = swap;
+		indices ^= 0x55555555;
+	}
+	else if (color0 == color1)
+	{
+		indices = 0;
+	}
+
+	out_block[0] = (uint8_t)(color0 & 0xff);
+	out_block[1] = (uint8_t)(color0 >> 8);
+	out_block[2] = (uint8_t)(color1 & 0xff);
+	out_block[3] = (uint8_t)(color1 >> 8);
+	memcpy(out_block + 4, &indices, sizeof(indices));
+}
+
+static void BuildAlphaPalette(int alpha0, int alpha1, int* out_palette)
+{
+	out_palette[0] = alpha0;
+	out_palette[1] = alpha1;
+	if (alpha0 > alpha1)
+	{
+		for (int i = 1; i < 7; i++)
+		{
+			out_palette[i + 1] = ((7 - i) * alpha0 + i * alpha1 + 3) / 7;
+		}
+	}
+	else
+	{
+		for (int i = 1; i < 5; i++)
+		{
+			out_palette[i + 1] = ((5 - i) * alpha0 + i * alpha1 + 2) / 5;
+		}
+		out_palette[6] = 0;
+		out_palette[7] = 255;
+	}
+}
+
+static int ComputeAlphaIndices(const Rgba8* block, int alpha0, int alpha1, uint64_t& out_indices)
+{
+	int palette[8];
+	BuildAlphaPalette(alpha0, alpha1, palette);
+	int totalError = 0;
+	out_indices = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int bestError = INT_MAX;
+		int bestIndex = 0;
+		for (int p = 0; p < 8; p++)
+		{
+			int error = (block[i].a - palette[p]) * (block[i].a - palette[p]);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+		totalError += bestError;
+		out_indices |= (uint64_t)bestIndex << (i * 3);
+	}
+	return totalError;
+}
+
+//tries both BC4 style palettes: eight interpolated values, or six plus exact 0 and 255 for cutout edges
+static void EncodeAlphaBlock(const Rgba8* block, uint8_t* out_block)
+{
+	int minAlpha = 255;
+	int maxAlpha = 0;
+	int minInnerAlpha = 255;
+	int maxInnerAlpha = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int alpha = block[i].a;
+		minAlpha = alpha < minAlpha ? alpha : minAlpha;
+		maxAlpha = alpha > maxAlpha ? alpha : maxAlpha;
+		if (alpha != 0 && alpha != 255)
+		{
+			minInnerAlpha = alpha < minInnerAlpha ? alpha : minInnerAlpha;
+			maxInnerAlpha = alpha > maxInnerAlpha ? alpha : maxInnerAlpha;
+		}
+	}
+
+	int alpha0 = maxAlpha;
+	int alpha1 = minAlpha;
+	uint64_t indices = 0;
+	int error = ComputeAlphaIndices(block, alpha0, alpha1, indices);
+	if (error > 0)
+	{
+		if (minInnerAlpha > maxInnerAlpha)
+		{
+			minInnerAlpha = maxInnerAlpha = minAlpha;
+		}
+		uint64_t sixValueIndices = 0;
+		int sixValueError = ComputeAlphaIndices(block, minInnerAlpha, maxInnerAlpha, sixValueIndices);
+		if (sixValueError < error)
+		{
+			alpha0 = minInnerAlpha;
+			alpha1 = maxInnerAlpha;
+			indices = sixValueIndices;
+		}
+	}
+
+	out_block[0] = (uint8_t)alpha0;
+	out_block[1] = (uint8_t)alpha1;
+	for (int i = 0; i < 6; i++)
+	{
+		out_block[2 + i] = (uint8_t)(indices >> (i * 8));
+	}
+}
+
+//mode 6 stores rgba endpoints at 7 bits plus a shared low bit per endpoint and a 4 bit index per texel, so every
+//block gets the full 16 step palette in all four channels
+struct Bc7Mode6Block
+{
+	int m_endpoints[2][4] = {};		//7 bit
+	int m_pBits[2] = {};
+	int m_indices[16] = {};
+	int m_error = INT_MAX;
+};
+
+static void QuantizeBc7Mode6Endpoint(const float* endpoint, int pBit, int* out_endpoint)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		out_endpoint[c] = Clamp((int)floorf((endpoint[c] - (float)pBit) * 0.5f + 0.5f), 0, 127);
+	}
+}
+
+//indices come from projecting onto the endpoint line, then the two nearest palette entries are checked exactly
+static void ComputeBc7Mode6Indices(const Rgba8* block, Bc7Mode6Block& inout_block)
+{
+	int palette[16][4];
+	int endpoint0[4];
+	int endpoint1[4];
+	for (int c = 0; c < 4; c++)
+	{
+		endpoint0[c] = (inout_block.m_endpoints[0][c] << 1) | inout_block.m_pBits[0];
+		endpoint1[c] = (inout_block.m_endpoints[1][c] << 1) | inout_block.m_pBits[1];
+	}
+	for (int p = 0; p < 16; p++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			palette[p][c] = ((64 - BC7_WEIGHTS_4_BIT[p]) * endpoint0[c] + BC7_WEIGHTS_4_BIT[p] * endpoint1[c] + 32) >> 6;
+		}
+	}
+
+	float direction[4];
+	float directionLengthSquared = 0.f;
+	for (int c = 0; c < 4; c++)
+	{
+		direction[c] = (float)(endpoint1[c] - endpoint0[c]);
+		directionLengthSquared += direction[c] * direction[c];
+	}
+	float projectionScale = directionLengthSquared > 0.f ? 15.f / directionLengthSquared : 0.f;
+
+	inout_block.m_error = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		const unsigned char* texel = &block[i].r;
+		float t = 0.f;
+		for (int c = 0; c < 4; c++)
+		{
+			t += ((float)texel[c] - (float)endpoint0[c]) * direction[c];
+		}
+		int firstCandidate = Clamp((int)(t * projectionScale), 0, 14);
+		int bestError = INT_MAX;
+		for (int p = firstCandidate; p <= firstCandidate + 1; p++)
+		{
+			int error = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				error += (texel[c] - palette[p][c]) * (texel[c] - palette[p][c]);
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				inout_block.m_indices[i] = p;
+			}
+		}
+		inout_block.m_error += bestError;
+	}
+}
+
+static void WriteBits(uint8_t* out_block, int& inout_bitOffset, uint32_t value, int numBits)
+{
+	for (int bit = 0; bit < numBits; bit++, inout_bitOffset++)
+	{
+		out_block[inout_bitOffset >> 3] |= (uint8_t)(((value >> bit) & 1) << (inout_bitOffset & 7));
+	}
+}
+
+static uint32_t ReadBits(const uint8_t* block, int& inout_bitOffset, int numBits)
+{
+	uint32_t value = 0;
+	for (int bit = 0; bit < numBits; bit++, inout_bitOffset++)
+	{
+		value |= (uint32_t)((block[inout_bitOffset >> 3] >> (inout_bitOffset & 7)) & 1) << bit;
+	}
+	return value;
+}
+
+static void FindBc7Mode6Block(const Rgba8* block, int refinementPasses, Bc7Mode6Block& out_best)
+{
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeBlockEndpoints(block, 4, endpoint0, endpoint1);
+
+	for (int pBits = 0; pBits < 4 && out_best.m_error > 0; pBits++)
+	{
+		Bc7Mode6Block candidate;
+		candidate.m_pBits[0] = pBits & 1;
+		candidate.m_pBits[1] = pBits >> 1;
+		QuantizeBc7Mode6Endpoint(endpoint0, candidate.m_pBits[0], candidate.m_endpoints[0]);
+		QuantizeBc7Mode6Endpoint(endpoint1, candidate.m_pBits[1], candidate.m_endpoints[1]);
+		ComputeBc7Mode6Indices(block, candidate);
+		for (int pass = 0; pass < refinementPasses && candidate.m_error > 0; pass++)
+		{
+			float weights[16];
+			for (int i = 0; i < 16; i++)
+			{
+				weights[i] = (float)BC7_WEIGHTS_4_BIT[candidate.m_indices[i]] / 64.f;
+			}
+			float refined0[4];
+			float refined1[4];
+			if (!FitBlockEndpoints(block, 4, weights, refined0, refined1))
+				break;
+
+			Bc7Mode6Block refined = candidate;
+			QuantizeBc7Mode6Endpoint(refined0, refined.m_pBits[0], refined.m_endpoints[0]);
+			QuantizeBc7Mode6Endpoint(refined1, refined.m_pBits[1], refined.m_endpoints[1]);
+			ComputeBc7Mode6Indices(block, refined);
+			if (refined.m_error >= candidate.m_error)
+				break;
+
+			candidate = refined;
+		}
+		if (candidate.m_error < out_best.m_error)
+		{
+			out_best = candidate;
+		}
+	}
+}
+
+static void WriteBc7Mode6Block(Bc7Mode6Block& block, uint8_t* out_block)
+{
+	//the first index is stored without its top bit, so it has to land in the lower half of the palette
+	if (block.m_indices[0] >= 8)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			int swap = block.m_endpoints[0][c];
+			block.m_endpoints[0][c] = block.m_endpoints[1][c];
+			block.m_endpoints[1][c] = swap;
+		}
+		int swapPBit = block.m_pBits[0];
+		block.m_pBits[0] = block.m_pBits[1];
+		block.m_pBits[1] = swapPBit;
+		for (int i = 0; i < 16; i++)
+		{
+			block.m_indices[i] = 15 - block.m_indices[i];
+		}
+	}
+
+	memset(out_block, 0, 16);
+	int bitOffset = 0;
+	WriteBits(out_block, bitOffset, 1 << BC7_MODE_6, BC7_MODE_6 + 1);
+	for (int c = 0; c < 4; c++)
+	{
+		WriteBits(out_block, bitOffset, block.m_endpoints[0][c], 7);
+		WriteBits(out_block, bitOffset, block.m_endpoints[1][c], 7);
+	}
+	WriteBits(out_block, bitOffset, block.m_pBits[0], 1);
+	WriteBits(out_block, bitOffset, block.m_pBits[1], 1);
+	WriteBits(out_block, bitOffset, block.m_indices[0], 3);
+	for (int i = 1; i < 16; i++)
+	{
+		WriteBits(out_block, bitOffset, block.m_indices[i], 4);
+	}
+}
+
+//mode 5 keeps alpha on its own line, 7 bit rgb and 8 bit alpha endpoints with a 2 bit index each. mode 6 has to
+//put rgb and alpha on one line, which falls apart on cutout edges where color and alpha change independently
+struct Bc7Mode5Block
+{
+	int m_colorEndpoints[2][3] = {};		//7 bit
+	int m_alphaEndpoints[2] = {};
+	int m_colorIndices[16] = {};
+	int m_alphaIndices[16] = {};
+	int m_error = INT_MAX;
+};
+
+static int ExpandBc7Mode5Color(int quantizedColor)
+{
+	return (quantizedColor << 1) | (quantizedColor >> 6);
+}
+
+static int ComputeBc7Mode5ColorIndices(const Rgba8* block, const int endpoints[2][3], int* out_indices)
+{
+	int palette[4][3];
+	for (int p = 0; p < 4; p++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			palette[p][c] = ((64 - BC7_WEIGHTS_2_BIT[p]) * ExpandBc7Mode5Color(endpoints[0][c]) + BC7_WEIGHTS_2_BIT[p] * ExpandBc7Mode5Color(endpoints[1][c]) + 32) >> 6;
+		}
+	}
+
+	int totalError = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int bestError = INT_MAX;
+		for (int p = 0; p < 4; p++)
+		{
+			int dr = block[i].r - palette[p][0];
+			int dg = block[i].g - palette[p][1];
+			int db = block[i].b - palette[p][2];
+			int error = dr * dr + dg * dg + db * db;
+			if (error < bestError)
+			{
+				bestError = error;
+				out_indices[i] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+static int ComputeBc7Mode5AlphaIndices(const Rgba8* block, const int endpoints[2], int* out_indices)
+{
+	int palette[4];
+	for (int p = 0; p < 4; p++)
+	{
+		palette[p] = ((64 - BC7_WEIGHTS_2_BIT[p]) * endpoints[0] + BC7_WEIGHTS_2_BIT[p] * endpoints[1] + 32) >> 6;
+	}
+
+	int totalError = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int bestError = INT_MAX;
+		for (int p = 0; p < 4; p++)
+		{
+			int error = (block[i].a - palette[p]) * (block[i].a - palette[p]);
+			if (error < bestError)
+			{
+				bestError = error;
+				out_indices[i] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+static void FindBc7Mode5Block(const Rgba8* block, int refinementPasses, Bc7Mode5Block& out_best)
+{
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeBlockEndpoints(block, 3, endpoint0, endpoint1);
+	for (int c = 0; c < 3; c++)
+	{
+		out_best.m_colorEndpoints[0][c] = (int)(endpoint0[c] * 127.f / 255.f + 0.5f);
+		out_best.m_colorEndpoints[1][c] = (int)(endpoint1[c] * 127.f / 255.f + 0.5f);
+	}
+	int colorError = ComputeBc7Mode5ColorIndices(block, out_best.m_colorEndpoints, out_best.m_colorIndices);
+	for (int pass = 0; pass < refinementPasses && colorError > 0; pass++)
+	{
+		float weights[16];
+		for (int i = 0; i < 16; i++)
+		{
+			weights[i] = (float)BC7_WEIGHTS_2_BIT[out_best.m_colorIndices[i]] / 64.f;
+		}
+		if (!FitBlockEndpoints(block, 3, weights, endpoint0, endpoint1))
+			break;
+
+		int refinedEndpoints[2][3];
+		int refinedIndices[16];
+		for (int c = 0; c < 3; c++)
+		{
+			refinedEndpoints[0][c] = (int)(endpoint0[c] * 127.f / 255.f + 0.5f);
+			refinedEndpoints[1][c] = (int)(endpoint1[c] * 127.f / 255.f + 0.5f);
+		}
+		int refinedError = ComputeBc7Mode5ColorIndices(block, refinedEndpoints, refinedIndices);
+		if (refinedError >= colorError)
+			break;
+
+		memcpy(out_best.m_colorEndpoints, refinedEndpoints, sizeof(refinedEndpoints));
+		memcpy(out_best.m_colorIndices, refinedIndices, sizeof(refinedIndices));
+		colorError = refinedError;
+	}
+
+	//alpha endpoints are stored at full precision, so the block's own range is already the best start
+	out_best.m_alphaEndpoints[0] = 255;
+	out_best.m_alphaEndpoints[1] = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		out_best.m_alphaEndpoints[0] = block[i].a < out_best.m_alphaEndpoints[0] ? block[i].a : out_best.m_alphaEndpoints[0];
+		out_best.m_alphaEndpoints[1] = block[i].a > out_best.m_alphaEndpoints[1] ? block[i].a : out_best.m_alphaEndpoints[1];
+	}
+	int alphaError = ComputeBc7Mode5AlphaIndices(block, out_best.m_alphaEndpoints, out_best.m_alphaIndices);
+	out_best.m_error = colorError + alphaError;
+}
+
+static void WriteBc7Mode5Block(Bc7Mode5Block& block, uint8_t* out_block)
+{
+	//both index sets drop the top bit of their first index, each flips its own endpoints to make room
+	if (block.m_colorIndices[0] >= 2)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			int swap = block.m_colorEndpoints[0][c];
+			block.m_colorEndpoints[0][c] = block.m_colorEndpoints[1][c];
+			block.m_colorEndpoints[1][c] = swap;
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			block.m_colorIndices[i] = 3 - block.m_colorIndices[i];
+		}
+	}
+	if (block.m_alphaIndices[0] >= 2)
+	{
+		int swap = block.m_alphaEndpoints[0];
+		block.m_alphaEndpoints[0] = block.m_alphaEndpoints[1];
+		block.m_alphaEndpoints[1] = swap;
+		for (int i = 0; i < 16; i++)
+		{
+			block.m_alphaIndices[i] = 3 - block.m_alphaIndices[i];
+		}
+	}
+
+	memset(out_block, 0, 16);
+	int bitOffset = 0;
+	WriteBits(out_block, bitOffset, 1 << BC7_MODE_5, BC7_MODE_5 + 1);
+	WriteBits(out_block, bitOffset, 0, 2);		//no channel rotation
+	for (int c = 0; c < 3; c++)
+	{
+		WriteBits(out_block, bitOffset, block.m_colorEndpoints[0][c], 7);
+		WriteBits(out_block, bitOffset, block.m_colorEndpoints[1][c], 7);
+	}
+	WriteBits(out_block, bitOffset, block.m_alphaEndpoints[0], 8);
+	WriteBits(out_block, bitOffset, block.m_alphaEndpoints[1], 8);
+	for (int i = 0; i < 16; i++)
+	{
+		WriteBits(out_block, bitOffset, block.m_colorIndices[i], i == 0 ? 1 : 2);
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		WriteBits(out_block, bitOffset, block.m_alphaIndices[i], i == 0 ? 1 : 2);
+	}
+}
+
+static void EncodeBc7Block(const Rgba8* block, int refinementPasses, uint8_t* out_block)
+{
+	Bc7Mode6Block mode6Block;
+	FindBc7Mode6Block(block, refinementPasses, mode6Block);
+
+	bool hasVaryingAlpha = false;
+	for (int i = 1; i < 16; i++)
+	{
+		hasVaryingAlpha |= block[i].a != block[0].a;
+	}
+	if (hasVaryingAlpha && mode6Block.m_error > 0)
+	{
+		Bc7Mode5Block mode5Block;
+		FindBc7Mode5Block(block, refinementPasses, mode5Block);
+		if (mode5Block.m_error < mode6Block.m_error)
+		{
+			WriteBc7Mode5Block(mode5Block, out_block);
+			return;
+		}
+	}
+	WriteBc7Mode6Block(mode6Block, out_block);
+}
+
+static void DecodeColorBlock(const uint8_t* block, bool allowThreeColorMode, Rgba8* out_texels)
+{
+	uint16_t color0 = (uint16_t)(block[0] | (block[1] << 8));
+	uint16_t color1 = (uint16_t)(block[2] | (block[3] << 8));
+	uint32_t indices;
+	memcpy(&indices, block + 4, sizeof(indices));
+	int palette[4][4];
+	BuildColorPalette(color0, color1, allowThreeColorMode, palette);
+	for (int i = 0; i < 16; i++)
+	{
+		const int* color = palette[(indices >> (i * 2)) & 3];
+		out_texels[i] = Rgba8((unsigned char)color[0], (unsigned char)color[1], (unsigned char)color[2], (unsigned char)color[3]);
+	}
+}
+
+static void DecodeAlphaBlock(const uint8_t* block, Rgba8* inout_texels)
+{
+	int palette[8];
+	BuildAlphaPalette(block[0], block[1], palette);
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		indices |= (uint64_t)block[2 + i] << (i * 8);
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		inout_texels[i].a = (unsigned char)palette[(indices >> (i * 3)) & 7];
+	}
+}
+
+//modes 5 and 6, which is all the encoder writes. anything else decodes as magenta so it can't pass a psnr check
+static void DecodeBc7Block(const uint8_t* block, Rgba8* out_texels)
+{
+	int bitOffset = 0;
+	if ((block[0] & 0x7f) == (1 << BC7_MODE_6))
+	{
+		bitOffset = BC7_MODE_6 + 1;
+		int endpoints[2][4];
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] = (int)ReadBits(block, bitOffset, 7) << 1;
+			endpoints[1][c] = (int)ReadBits(block, bitOffset, 7) << 1;
+		}
+		int pBit0 = (int)ReadBits(block, bitOffset, 1);
+		int pBit1 = (int)ReadBits(block, bitOffset, 1);
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] |= pBit0;
+			endpoints[1][c] |= pBit1;
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			int weight = BC7_WEIGHTS_4_BIT[ReadBits(block, bitOffset, i == 0 ? 3 : 4)];
+			unsigned char color[4];
+			for (int c = 0; c < 4; c++)
+			{
+				color[c] = (unsigned char)(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+			}
+			out_texels[i] = Rgba8(color[0], color[1], color[2], color[3]);
+		}
+		return;
+	}
+
+	if ((block[0] & 0x3f) == (1 << BC7_MODE_5))
+	{
+		bitOffset = BC7_MODE_5 + 1;
+		int rotation = (int)ReadBits(block, bitOffset, 2);
+		int colorEndpoints[2][3];
+		for (int c = 0; c < 3; c++)
+		{
+			colorEndpoints[0][c] = ExpandBc7Mode5Color((int)ReadBits(block, bitOffset, 7));
+			colorEndpoints[1][c] = ExpandBc7Mode5Color((int)ReadBits(block, bitOffset, 7));
+		}
+		int alphaEndpoint0 = (int)ReadBits(block, bitOffset, 8);
+		int alphaEndpoint1 = (int)ReadBits(block, bitOffset, 8);
+		for (int i = 0; i < 16; i++)
+		{
+			int weight = BC7_WEIGHTS_2_BIT[ReadBits(block, bitOffset, i == 0 ? 1 : 2)];
+			for (int c = 0; c < 3; c++)
+			{
+				(&out_texels[i].r)[c] = (unsigned char)(((64 - weight) * colorEndpoints[0][c] + weight * colorEndpoints[1][c] + 32) >> 6);
+			}
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			int weight = BC7_WEIGHTS_2_BIT[ReadBits(block, bitOffset, i == 0 ? 1 : 2)];
+			out_texels[i].a = (unsigned char)(((64 - weight) * alphaEndpoint0 + weight * alphaEndpoint1 + 32) >> 6);
+			if (rotation > 0)
+			{
+				unsigned char swap = out_texels[i].a;
+				out_texels[i].a = (&out_texels[i].r)[rotation - 1];
+				(&out_texels[i].r)[rotation - 1] = swap;
+			}
+		}
+		return;
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		out_texels[i] = Rgba8::MAGENTA;
+	}
+}
+
+static int GetBlockSize(eTextureFormat format)
+{
+	switch (format)
+	{
+	case eTextureFormat::BC1_UNORM: return 8;
+	case eTextureFormat::BC3_UNORM: return 16;
+	case eTextureFormat::BC7_UNORM: return 16;
+	default: ERROR_AND_DIE("Not a block compressed format");
+	}
+}
+
+void CompressTexels(eTextureFormat format, const Rgba8* texels, const IntVec2& dimensions, std::vector<uint8_t>& out_blocks, int refinementPasses)
+{
+	int blockSize = GetBlockSize(format);
+	int numBlocksWide = (dimensions.x + 3) / 4;
+	int numBlocksHigh = (dimensions.y + 3) / 4;
+	out_blocks.resize((size_t)numBlocksWide * numBlocksHigh * blockSize);
+	Rgba8 block[16];
+	for (int blockY = 0; blockY < numBlocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < numBlocksWide; blockX++)
+		{
+			GatherBlock(texels, dimensions, blockX, blockY, block);
+			uint8_t* blockOut = &out_blocks[((size_t)blockY * numBlocksWide + blockX) * blockSize];
+			switch (format)
+			{
+			case eTextureFormat::BC1_UNORM:
+				EncodeColorBlock(block, refinementPasses, blockOut);
+				break;
+			case eTextureFormat::BC3_UNORM:
+				EncodeAlphaBlock(block, blockOut);
+				EncodeColorBlock(block, refinementPasses, blockOut + 8);
+				break;
+			default:
+				EncodeBc7Block(block, refinementPasses, blockOut);
+				break;
+			}
+		}
+	}
+}
+
+void DecompressTexels(eTextureFormat format, const uint8_t* blocks, const IntVec2& dimensions, std::vector<Rgba8>& out_texels)
+{
+	int blockSize = GetBlockSize(format);
+	int numBlocksWide = (dimensions.x + 3) / 4;
+	int numBlocksHigh = (dimensions.y + 3) / 4;
+	out_texels.resize((size_t)dimensions.x * dimensions.y);
+	Rgba8 block[16];
+	for (int blockY = 0; blockY < numBlocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < numBlocksWide; blockX++)
+		{
+			const uint8_t* blockIn = &blocks[((size_t)blockY * numBlocksWide + blockX) * blockSize];
+			switch (format)
+			{
+			case eTextureFormat::BC1_UNORM:
+				DecodeColorBlock(blockIn, true, block);
+				break;
+			case eTextureFormat::BC3_UNORM:
+				DecodeColorBlock(blockIn + 8, false, block);
+				DecodeAlphaBlock(blockIn, block);
+				break;
+			default:
+				DecodeBc7Block(blockIn, block);
+				break;
+			}
+
+			for (int y = 0; y < 4 && blockY * 4 + y < dimensions.y; y++)
+			{
+				for (int x = 0; x < 4 && blockX * 4 + x < dimensions.x; x++)
+				{
+					out_texels[(size_t)(blockY * 4 + y) * dimensions.x + blockX * 4 + x] = block[y * 4 + x];
+				}
+			}
+		}
+	}
+}
+
+float ComputePSNR(const Rgba8* texels, const Rgba8* referenceTexels, size_t numTexels, bool includeAlpha)
+{
+	int numChannels = includeAlpha ? 4 : 3;
+	double squaredErrorSum = 0.0;
+	for (size_t i = 0; i < numTexels; i++)
+	{
+		const unsigned char* texel = &texels[i].r;
+		const unsigned char* referenceTexel = &referenceTexels[i].r;
+		for (int c = 0; c < numChannels; c++)
+		{
+			double difference = (double)texel[c] - (double)referenceTexel[c];
+			squaredErrorSum += difference * difference;
+		}
+	}
+	if (squaredErrorSum == 0.0 || numTexels == 0)
+		return 99.f;
+
+	double meanSquaredError = squaredErrorSum / (double)(numTexels * numChannels);
+	return (float)(10.0 * log10(255.0 * 255.0 / meanSquaredError));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool CookTexture(const Image& image, const char* cookedFilePath, const texture_cook_options& options)
+{
+	bool isBlockCompressed = options.m_format != eTextureFormat::R8G8B8A8_UNORM;
+	GUARANTEE_OR_DIE(!isBlockCompressed || options.m_format == eTextureFormat::BC1_UNORM || options.m_format == eTextureFormat::BC3_UNORM ||
+		options.m_format == eTextureFormat::BC7_UNORM, Stringf("Can't cook \"%s\" to that format", cookedFilePath));
+
+	//d3d11 wants the top level of a block compressed texture in whole blocks, the smaller mips are exempt
+	IntVec2 dimensions = image.GetDimensions();
+	if (isBlockCompressed && (dimensions.x % 4 != 0 || dimensions.y % 4 != 0))
+	{
+		ERROR_RECOVERABLE(Stringf("Can't block compress \"%s\", %ix%i is not a multiple of 4", image.GetImageFilePath().c_str(), dimensions.x, dimensions.y));
+		return false;
+	}
+
+	std::vector<Image> mips;
+	if (options.m_generateMips)
+	{
+		GenerateMips(image, options.m_mipFilter, mips);
+	}
+	else
+	{
+		mips.push_back(image);
+	}
+
+	std::vector<std::vector<uint8_t>> compressedMips(mips.size());
+	std::vector<const void*> mipData(mips.size());
+	std::vector<size_t> mipSizes(mips.size());
+	for (int mipIndex = 0; mipIndex < (int)mips.size(); mipIndex++)
+	{
+		IntVec2 mipDimensions = mips[mipIndex].GetDimensions();
+		if (isBlockCompressed)
+		{
+			CompressTexels(options.m_format, (const Rgba8*)mips[mipIndex].GetRawData(), mipDimensions, compressedMips[mipIndex], options.m_refinementPasses);
+			mipData[mipIndex] = compressedMips[mipIndex].data();
+			mipSizes[mipIndex] = compressedMips[mipIndex].size();
+		}
+		else
+		{
+			mipData[mipIndex] = mips[mipIndex].GetRawData();
+			mipSizes[mipIndex] = (size_t)mipDimensions.x * mipDimensions.y * sizeof(Rgba8);
+		}
+	}
+
+	return WriteTextureFile(cookedFilePath, options.m_format, dimensions, (unsigned int)mips.size(), mipData.data(), mipSizes.data());
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "Engine/Core/Image.hpp"
+#include "Engine/Renderer/Texture.hpp"
+
+enum class eMipFilter
+{
+	BOX,			//2x2 average, cheapest
+	KAISER,			//kaiser windowed sinc, sharper mips without the aliasing a box lets through
+};
+
+struct texture_cook_options
+{
+	eTextureFormat m_format = eTextureFormat::BC7_UNORM;		//R8G8B8A8_UNORM, BC1_UNORM (no alpha), BC3_UNORM or BC7_UNORM
+	bool m_generateMips = true;
+	eMipFilter m_mipFilter = eMipFilter::KAISER;
+	int m_refinementPasses = 2;			//least squares endpoint refits per block, 0 keeps the first pca fit
+};
+
+//every level down to 1x1, starting with a copy of the image itself. odd sizes round down and the filter is
+//stretched over the leftover texel so nothing shifts
+void GenerateMips(const Image& image, eMipFilter filter, std::vector<Image>& out_mips);
+
+//4x4 blocks in row order, edge blocks repeat the last row and column. BC7 only writes modes 5 and 6, the single
+//subset ones
+void CompressTexels(eTextureFormat format, const Rgba8* texels, const IntVec2& dimensions, std::vector<uint8_t>& out_blocks, int refinementPasses = 2);
+void DecompressTexels(eTextureFormat format, const uint8_t* blocks, const IntVec2& dimensions, std::vector<Rgba8>& out_texels);
+
+//peak signal to noise ratio in dB over rgb, or rgba. identical texels return 99
+float ComputePSNR(const Rgba8* texels, const Rgba8* referenceTexels, size_t numTexels, bool includeAlpha);
+
+//the whole offline step, decoded image in, cooked file out. images are in the same row order the renderer uploads
+bool CookTexture(const Image& image, const char* cookedFilePath, const texture_cook_options& options = texture_cook_options());
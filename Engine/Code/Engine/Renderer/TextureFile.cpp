@@ -0,0 +1,153 @@
+#include "Engine/Renderer/TextureFile.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Core/BinaryFileUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+constexpr uint64_t TEXTURE_FILE_CHECKSUM_SEED = 0xcbf29ce484222325ull;
+
+static uint64_t AlignTextureFileOffset(uint64_t offset)
+{
+	return (offset + TEXTURE_FILE_SECTION_ALIGNMENT - 1) & ~(uint64_t)(TEXTURE_FILE_SECTION_ALIGNMENT - 1);
+}
+
+static bool IsCookableTextureFormat(int format)
+{
+	switch ((eTextureFormat)format)
+	{
+	case eTextureFormat::R8G8B8A8_UNORM:
+	case eTextureFormat::BC1_UNORM:
+	case eTextureFormat::BC3_UNORM:
+	case eTextureFormat::BC7_UNORM:
+		return true;
+	default:
+		return false;
+	}
+}
+
+unsigned int GetTextureRowPitch(eTextureFormat format, int width)
+{
+	int numBlocksWide = (width + 3) / 4;
+	switch (format)
+	{
+	case eTextureFormat::BC1_UNORM: return numBlocksWide * 8;
+	case eTextureFormat::BC3_UNORM: return numBlocksWide * 16;
+	case eTextureFormat::BC7_UNORM: return numBlocksWide * 16;
+	default: return width * 4;
+	}
+}
+
+size_t GetTextureMipSize(eTextureFormat format, const IntVec2& dimensions)
+{
+	bool isBlockCompressed = format == eTextureFormat::BC1_UNORM || format == eTextureFormat::BC3_UNORM || format == eTextureFormat::BC7_UNORM;
+	size_t numRows = isBlockCompressed ? (dimensions.y + 3) / 4 : dimensions.y;
+	return (size_t)GetTextureRowPitch(format, dimensions.x) * numRows;
+}
+
+bool TextureFileView::Open(const char* filepath, bool verifyChecksum)
+{
+	Close();
+	if (!m_mappedFile.Open(filepath, FileAccessPattern::SEQUENTIAL))
+		return false;
+
+	const uint8_t* fileData = m_mappedFile.GetData();
+	size_t fileSize = m_mappedFile.GetSize();
+	const TextureFileHeader* header = (const TextureFileHeader*)fileData;
+	if (fileSize < sizeof(TextureFileHeader) || header->m_fourCC != TEXTURE_FILE_FOURCC || header->m_version != TEXTURE_FILE_VERSION || header->m_headerSize != sizeof(TextureFileHeader))
+	{
+		ERROR_RECOVERABLE(Stringf("\"%s\" is not a cooked texture of the current version", filepath));
+		Close();
+		return false;
+	}
+
+	uint64_t mipsSize = (uint64_t)header->m_numMips * sizeof(TextureFileMip);
+	bool isValid = IsCookableTextureFormat(header->m_format) && header->m_width > 0 && header->m_height > 0 && header->m_numMips > 0 &&
+		header->m_numMips <= TEXTURE_FILE_MAX_MIPS && header->m_fileSize == fileSize && header->m_mipsOffset % TEXTURE_FILE_SECTION_ALIGNMENT == 0 &&
+		header->m_mipsOffset + mipsSize <= fileSize;
+	IntVec2 mipDimensions((int)header->m_width, (int)header->m_height);
+	for (unsigned int mipIndex = 0; isValid && mipIndex < header->m_numMips; mipIndex++)
+	{
+		const TextureFileMip& mip = ((const TextureFileMip*)(fileData + header->m_mipsOffset))[mipIndex];
+		eTextureFormat format = (eTextureFormat)header->m_format;
+		isValid = mip.m_dataOffset % TEXTURE_FILE_SECTION_ALIGNMENT == 0 && mip.m_dataOffset + mip.m_dataSize <= fileSize &&
+			mip.m_dataSize == GetTextureMipSize(format, mipDimensions) && mip.m_rowPitch == GetTextureRowPitch(format, mipDimensions.x);
+		mipDimensions = IntVec2(mipDimensions.x > 1 ? mipDimensions.x / 2 : 1, mipDimensions.y > 1 ? mipDimensions.y / 2 : 1);
+	}
+	if (!isValid)
+	{
+		ERROR_RECOVERABLE(Stringf("Cooked texture \"%s\" is malformed or has an unsupported format", filepath));
+		Close();
+		return false;
+	}
+
+	if (verifyChecksum)
+	{
+		const TextureFileMip* mips = (const TextureFileMip*)(fileData + header->m_mipsOffset);
+		uint64_t checksum = ComputeFileChecksum(mips, (size_t)mipsSize, TEXTURE_FILE_CHECKSUM_SEED);
+		for (unsigned int mipIndex = 0; mipIndex < header->m_numMips; mipIndex++)
+		{
+			checksum = ComputeFileChecksum(fileData + mips[mipIndex].m_dataOffset, mips[mipIndex].m_dataSize, checksum);
+		}
+		if (checksum != header->m_checksum)
+		{
+			ERROR_RECOVERABLE(Stringf("Cooked texture \"%s\" failed its checksum", filepath));
+			Close();
+			return false;
+		}
+	}
+
+	m_header = header;
+	m_mips = (const TextureFileMip*)(fileData + header->m_mipsOffset);
+	return true;
+}
+
+void TextureFileView::Close()
+{
+	m_mappedFile.Close();
+	m_header = nullptr;
+	m_mips = nullptr;
+}
+
+bool WriteTextureFile(const char* filepath, eTextureFormat format, const IntVec2& dimensions, unsigned int numMips, const void* const* mipData,
+	const size_t* mipSizes)
+{
+	GUARANTEE_OR_DIE(IsCookableTextureFormat((int)format), Stringf("Unsupported format while writing cooked texture \"%s\"", filepath));
+	GUARANTEE_OR_DIE(numMips > 0 && numMips <= TEXTURE_FILE_MAX_MIPS, Stringf("Cooked texture \"%s\" has %u mips", filepath, numMips));
+
+	TextureFileHeader header;
+	header.m_format = (int32_t)format;
+	header.m_width = (uint32_t)dimensions.x;
+	header.m_height = (uint32_t)dimensions.y;
+	header.m_numMips = numMips;
+	header.m_mipsOffset = AlignTextureFileOffset(sizeof(TextureFileHeader));
+
+	TextureFileMip mips[TEXTURE_FILE_MAX_MIPS];
+	IntVec2 mipDimensions = dimensions;
+	uint64_t dataOffset = header.m_mipsOffset + numMips * sizeof(TextureFileMip);
+	for (unsigned int mipIndex = 0; mipIndex < numMips; mipIndex++)
+	{
+		GUARANTEE_OR_DIE(mipSizes[mipIndex] == GetTextureMipSize(format, mipDimensions), Stringf("Mip %u of \"%s\" has the wrong size", mipIndex, filepath));
+		mips[mipIndex].m_dataOffset = AlignTextureFileOffset(dataOffset);
+		mips[mipIndex].m_dataSize = (uint32_t)mipSizes[mipIndex];
+		mips[mipIndex].m_rowPitch = GetTextureRowPitch(format, mipDimensions.x);
+		dataOffset = mips[mipIndex].m_dataOffset + mipSizes[mipIndex];
+		mipDimensions = IntVec2(mipDimensions.x > 1 ? mipDimensions.x / 2 : 1, mipDimensions.y > 1 ? mipDimensions.y / 2 : 1);
+	}
+	header.m_fileSize = dataOffset;
+
+	header.m_checksum = ComputeFileChecksum(mips, numMips * sizeof(TextureFileMip), TEXTURE_FILE_CHECKSUM_SEED);
+	for (unsigned int mipIndex = 0; mipIndex < numMips; mipIndex++)
+	{
+		header.m_checksum = ComputeFileChecksum(mipData[mipIndex], mipSizes[mipIndex], header.m_checksum);
+	}
+
+	SectionedFileWriter fileWriter;
+	fileWriter.Open(filepath);
+	fileWriter.WriteSection(0, &header, sizeof(header));
+	fileWriter.WriteSection(header.m_mipsOffset, mips, numMips * sizeof(TextureFileMip));
+	for (unsigned int mipIndex = 0; mipIndex < numMips; mipIndex++)
+	{
+		fileWriter.WriteSection(mips[mipIndex].m_dataOffset, mipData[mipIndex], mipSizes[mipIndex]);
+	}
+	return fileWriter.Close();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+
+enum class eTextureFormat : int;
+
+constexpr uint32_t TEXTURE_FILE_FOURCC = 0x58455443;		//"CTEX"
+constexpr uint16_t TEXTURE_FILE_VERSION = 1;
+constexpr size_t TEXTURE_FILE_SECTION_ALIGNMENT = 16;
+constexpr int TEXTURE_FILE_MAX_MIPS = 16;
+
+//one mip level, already in the layout the gpu wants. row pitch is the bytes per row of texels, or per row of
+//4x4 blocks for the compressed formats
+struct TextureFileMip
+{
+	uint64_t m_dataOffset = 0;
+	uint32_t m_dataSize = 0;
+	uint32_t m_rowPitch = 0;
+};
+static_assert(sizeof(TextureFileMip) == 16, "TextureFileMip layout changed, bump TEXTURE_FILE_VERSION");
+
+//little endian, the mip table follows the header and the mips follow the table from largest to smallest
+struct TextureFileHeader
+{
+	uint32_t m_fourCC = TEXTURE_FILE_FOURCC;
+	uint16_t m_version = TEXTURE_FILE_VERSION;
+	uint16_t m_headerSize = (uint16_t)sizeof(TextureFileHeader);
+	int32_t m_format = 0;				//eTextureFormat
+	uint32_t m_width = 0;
+	uint32_t m_height = 0;
+	uint32_t m_numMips = 0;
+	uint64_t m_mipsOffset = 0;
+	uint64_t m_fileSize = 0;
+	uint64_t m_checksum = 0;			//over the mip table and the mip data
+};
+static_assert(sizeof(TextureFileHeader) == 48, "TextureFileHeader layout changed, bump TEXTURE_FILE_VERSION");
+
+//a cooked texture used straight out of a memory mapping, the mip pointers stay valid until the view is closed
+class TextureFileView
+{
+public:
+	bool Open(const char* filepath, bool verifyChecksum = true);
+	void Close();
+	bool IsOpen() const { return m_mappedFile.IsOpen(); }
+
+	const TextureFileHeader& GetHeader() const { return *m_header; }
+	eTextureFormat GetFormat() const { return (eTextureFormat)m_header->m_format; }
+	IntVec2 GetDimensions() const { return IntVec2((int)m_header->m_width, (int)m_header->m_height); }
+	unsigned int GetNumMips() const { return m_header->m_numMips; }
+	const TextureFileMip& GetMip(unsigned int mipIndex) const { return m_mips[mipIndex]; }
+	const void* GetMipData(unsigned int mipIndex) const { return m_mappedFile.GetData() + m_mips[mipIndex].m_dataOffset; }
+
+private:
+	MappedFile m_mappedFile;
+	const TextureFileHeader* m_header = nullptr;
+	const TextureFileMip* m_mips = nullptr;
+};
+
+//mipData and mipSizes hold numMips entries, largest mip first
+bool WriteTextureFile(const char* filepath, eTextureFormat format, const IntVec2& dimensions, unsigned int numMips, const void* const* mipData,
+	const size_t* mipSizes);
+unsigned int GetTextureRowPitch(eTextureFormat format, int width);
+size_t GetTextureMipSize(eTextureFormat format, const IntVec2& dimensions);